@@ -0,0 +1,61 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumPackageRegionCommandlet.h"
+#include "CesiumEditor.h"
+#include "CesiumRegionPackager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+
+UCesiumPackageRegionCommandlet::UCesiumPackageRegionCommandlet() {
+  this->IsClient = false;
+  this->IsEditor = true;
+  this->IsServer = false;
+  this->LogToConsole = true;
+}
+
+int32 UCesiumPackageRegionCommandlet::Main(const FString& Params) {
+  FString mapName;
+  if (!FParse::Value(*Params, TEXT("Map="), mapName)) {
+    UE_LOG(
+        LogCesiumEditor,
+        Error,
+        TEXT("Choose the level to package with -Map=<package name>."));
+    return 1;
+  }
+
+  UPackage* pPackage = LoadPackage(nullptr, *mapName, LOAD_None);
+  UWorld* pWorld = pPackage ? UWorld::FindWorldInPackage(pPackage) : nullptr;
+  if (!pWorld) {
+    UE_LOG(
+        LogCesiumEditor,
+        Error,
+        TEXT("Could not load the level %s"),
+        *mapName);
+    return 1;
+  }
+
+  pWorld->AddToRoot();
+  pWorld->WorldType = EWorldType::Editor;
+  FWorldContext& context = GEngine->CreateNewWorldContext(EWorldType::Editor);
+  context.SetCurrentWorld(pWorld);
+
+  if (!pWorld->bIsWorldInitialized) {
+    pWorld->InitWorld(UWorld::InitializationValues()
+                          .AllowAudioPlayback(false)
+                          .CreatePhysicsScene(false)
+                          .CreateNavigation(false)
+                          .CreateAISystem(false)
+                          .ShouldSimulatePhysics(false));
+  }
+  pWorld->UpdateWorldComponents(true, false);
+
+  const bool succeeded = CesiumRegionPackager::packageWorld(*pWorld, *Params);
+
+  GEngine->DestroyWorldContext(pWorld);
+  pWorld->DestroyWorld(false);
+  pWorld->RemoveFromRoot();
+
+  return succeeded ? 0 : 1;
+}
@@ -0,0 +1,28 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "CoreMinimal.h"
+#include "CesiumPackageRegionCommandlet.generated.h"
+
+/**
+ * Downloads what the tilesets of a level need within a cartographic polygon,
+ * for use without a network connection. For example:
+ *
+ * UnrealEditor-Cmd.exe Project.uproject -run=CesiumPackageRegion
+ *     -Map=/Game/Maps/Site -Polygon=SiteBoundary -MaximumScreenSpaceError=8
+ *     -Archive=D:/SitePackage
+ *
+ * The parameters other than Map are those of the `cesium.region.package`
+ * console command; see CesiumRegionPackager.
+ */
+UCLASS()
+class UCesiumPackageRegionCommandlet : public UCommandlet {
+  GENERATED_BODY()
+
+public:
+  UCesiumPackageRegionCommandlet();
+
+  virtual int32 Main(const FString& Params) override;
+};
@@ -194,6 +194,9 @@ public class CesiumRuntime : ModuleRules
                     "MaterialEditor"
                 }
             );
+
+            // Stands in for a tile server in the HTTP request tests.
+            PrivateDependencyModuleNames.Add("HTTPServer");
         }
 
         DynamicallyLoadedModuleNames.AddRange(
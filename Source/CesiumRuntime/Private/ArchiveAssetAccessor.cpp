@@ -0,0 +1,578 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "ArchiveAssetAccessor.h"
+#include "Async/MappedFileHandle.h"
+#include "CesiumRuntime.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/UniquePtr.h"
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/IAssetRequest.h>
+#include <CesiumAsync/IAssetResponse.h>
+#include <cctype>
+#include <cstring>
+#include <uriparser/Uri.h>
+#include <vector>
+
+using namespace CesiumAsync;
+
+namespace {
+
+const char fileProtocol[] = "file:///";
+
+// The extensions of the files that are treated as archives.
+const char* const archiveExtensions[] = {".3tz", ".zip"};
+
+constexpr uint32 EndOfCentralDirectorySignature = 0x06054b50;
+constexpr uint32 Zip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+constexpr uint32 Zip64EndOfCentralDirectorySignature = 0x06064b50;
+constexpr uint32 CentralDirectoryHeaderSignature = 0x02014b50;
+constexpr uint32 LocalFileHeaderSignature = 0x04034b50;
+
+constexpr uint64 EndOfCentralDirectorySize = 22;
+constexpr uint64 Zip64EndOfCentralDirectoryLocatorSize = 20;
+constexpr uint64 Zip64EndOfCentralDirectorySize = 56;
+constexpr uint64 CentralDirectoryHeaderSize = 46;
+constexpr uint64 LocalFileHeaderSize = 30;
+constexpr uint64 MaximumCommentSize = 0xFFFF;
+
+constexpr uint16 Zip64ExtraFieldId = 0x0001;
+constexpr uint32 Zip64Placeholder = 0xFFFFFFFF;
+
+constexpr uint16 EncryptedFlag = 0x0001;
+constexpr uint16 StoredMethod = 0;
+constexpr uint16 DeflatedMethod = 8;
+
+// Zip entries are raw deflate streams, without a zlib header, which zlib
+// inflates when given a negative window size.
+constexpr int32 RawDeflateWindowBits = -15;
+
+uint16 readUint16(const uint8* p) { return uint16(p[0] | p[1] << 8); }
+
+uint32 readUint32(const uint8* p) {
+  return uint32(p[0]) | uint32(p[1]) << 8 | uint32(p[2]) << 16 |
+         uint32(p[3]) << 24;
+}
+
+uint64 readUint64(const uint8* p) {
+  return uint64(readUint32(p)) | uint64(readUint32(p + 4)) << 32;
+}
+
+bool isFile(const std::string& url) {
+  return url.compare(0, sizeof(fileProtocol) - 1, fileProtocol) == 0;
+}
+
+std::string convertFileUriToFilename(const std::string& url) {
+  // Both functions require an output buffer with space for at most
+  // length(url)+1 characters.
+  std::string result(url.size() + 1, '\0');
+
+#ifdef _WIN32
+  int errorCode = uriUriStringToWindowsFilenameA(url.c_str(), result.data());
+#else
+  int errorCode = uriUriStringToUnixFilenameA(url.c_str(), result.data());
+#endif
+
+  if (errorCode != URI_SUCCESS) {
+    return std::string();
+  }
+
+  size_t end = result.find('\0');
+  if (end != std::string::npos) {
+    result.resize(end);
+  }
+
+  size_t pos = result.find("?");
+  if (pos != std::string::npos) {
+    result.erase(pos);
+  }
+
+  return result;
+}
+
+/**
+ * Splits the filename of a file inside an archive, such as
+ * `/data/city.3tz/content/tile.glb`, into the filename of the archive and
+ * the name of the entry within it, which always uses forward slashes.
+ * Returns false if the filename does not refer to a file inside an archive.
+ */
+bool splitArchiveFilename(
+    const std::string& filename,
+    std::string& archiveFilename,
+    std::string& entryName) {
+  for (size_t i = 0; i < filename.size(); ++i) {
+    if (filename[i] != '/' && filename[i] != '\\') {
+      continue;
+    }
+
+    for (const char* extension : archiveExtensions) {
+      size_t length = std::strlen(extension);
+      if (i < length) {
+        continue;
+      }
+
+      bool matches = true;
+      for (size_t j = 0; j < length && matches; ++j) {
+        matches = std::tolower(static_cast<unsigned char>(
+                      filename[i - length + j])) == extension[j];
+      }
+
+      if (matches) {
+        archiveFilename = filename.substr(0, i);
+        entryName = filename.substr(i + 1);
+        for (char& c : entryName) {
+          if (c == '\\') {
+            c = '/';
+          }
+        }
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+class ArchiveEntryResponse : public IAssetRequest, public IAssetResponse {
+public:
+  ArchiveEntryResponse(const std::string& url, uint16_t statusCode)
+      : _url(url), _statusCode(statusCode), _pOwner(), _data(), _inflated() {}
+
+  /**
+   * Creates a response whose data is part of the given owner, such as a
+   * memory-mapped archive, which it keeps alive.
+   */
+  ArchiveEntryResponse(
+      const std::string& url,
+      const std::shared_ptr<const void>& pOwner,
+      const gsl::span<const std::byte>& data)
+      : _url(url),
+        _statusCode(200),
+        _pOwner(pOwner),
+        _data(data),
+        _inflated() {}
+
+  /** Creates a response that owns its data. */
+  ArchiveEntryResponse(const std::string& url, std::vector<std::byte>&& data)
+      : _url(url),
+        _statusCode(200),
+        _pOwner(),
+        _data(),
+        _inflated(std::move(data)) {
+    this->_data = gsl::span<const std::byte>(this->_inflated);
+  }
+
+  virtual const std::string& method() const override { return getMethod; }
+
+  virtual const std::string& url() const override { return this->_url; }
+
+  virtual const HttpHeaders& headers() const override { return emptyHeaders; }
+
+  virtual const IAssetResponse* response() const override { return this; }
+
+  virtual uint16_t statusCode() const override { return this->_statusCode; }
+
+  virtual std::string contentType() const override { return std::string(); }
+
+  virtual gsl::span<const std::byte> data() const override {
+    return this->_data;
+  }
+
+private:
+  static const std::string getMethod;
+  static const HttpHeaders emptyHeaders;
+
+  std::string _url;
+  uint16_t _statusCode;
+  std::shared_ptr<const void> _pOwner;
+  gsl::span<const std::byte> _data;
+  std::vector<std::byte> _inflated;
+};
+
+const std::string ArchiveEntryResponse::getMethod = "GET";
+const HttpHeaders ArchiveEntryResponse::emptyHeaders{};
+
+} // namespace
+
+class ArchiveAssetAccessor::Archive {
+public:
+  struct Entry {
+    uint64 localHeaderOffset;
+    uint64 compressedSize;
+    uint64 uncompressedSize;
+    uint16 method;
+    bool encrypted;
+  };
+
+  /**
+   * Maps the archive with the given filename and indexes its central
+   * directory. Returns nullptr if it cannot be read or is not a zip file.
+   */
+  static std::shared_ptr<Archive>
+  open(const std::string& filename, const FFileStatData& statData) {
+    TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::OpenArchive);
+
+    std::shared_ptr<Archive> pArchive = std::make_shared<Archive>();
+    pArchive->_statData = statData;
+    FString unrealFilename = UTF8_TO_TCHAR(filename.c_str());
+
+    pArchive->_pMappedFile.Reset(
+        FPlatformFileManager::Get().GetPlatformFile().OpenMapped(
+            *unrealFilename));
+    if (pArchive->_pMappedFile) {
+      pArchive->_pMappedRegion.Reset(pArchive->_pMappedFile->MapRegion());
+    }
+
+    if (pArchive->_pMappedRegion) {
+      pArchive->_pData = pArchive->_pMappedRegion->GetMappedPtr();
+      pArchive->_size = uint64(pArchive->_pMappedRegion->GetMappedSize());
+    } else if (FFileHelper::LoadFileToArray(
+                   pArchive->_loadedData,
+                   *unrealFilename,
+                   FILEREAD_Silent)) {
+      // The archive cannot be mapped, for example because it is in a pak
+      // file, so it is read into memory instead.
+      pArchive->_pData = pArchive->_loadedData.GetData();
+      pArchive->_size = uint64(pArchive->_loadedData.Num());
+    } else {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("Could not open the archive %s"),
+          *unrealFilename);
+      return nullptr;
+    }
+
+    if (!pArchive->indexCentralDirectory()) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("%s is not a valid zip archive"),
+          *unrealFilename);
+      return nullptr;
+    }
+
+    return pArchive;
+  }
+
+  ~Archive() {
+    // The region must be unmapped before the file is closed.
+    this->_pMappedRegion.Reset();
+    this->_pMappedFile.Reset();
+  }
+
+  /**
+   * Determines whether the file has the modification time and size it had
+   * when it was opened.
+   */
+  bool isCurrent(const FFileStatData& statData) const {
+    return statData.ModificationTime == this->_statData.ModificationTime &&
+           statData.FileSize == this->_statData.FileSize;
+  }
+
+  /** Finds the entry with the given name, or returns nullptr. */
+  const Entry* find(const std::string& name) const {
+    auto it = this->_entries.find(name);
+    return it == this->_entries.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * Gets the bytes of the given entry as they are stored in the archive,
+   * which may be compressed. Returns false if the entry's local header is
+   * invalid.
+   */
+  bool getStoredData(const Entry& entry, gsl::span<const std::byte>& data)
+      const {
+    const uint64 offset = entry.localHeaderOffset;
+    if (offset > this->_size ||
+        this->_size - offset < LocalFileHeaderSize ||
+        readUint32(this->_pData + offset) != LocalFileHeaderSignature) {
+      return false;
+    }
+
+    const uint64 dataOffset = offset + LocalFileHeaderSize +
+                              readUint16(this->_pData + offset + 26) +
+                              readUint16(this->_pData + offset + 28);
+    if (dataOffset > this->_size ||
+        this->_size - dataOffset < entry.compressedSize) {
+      return false;
+    }
+
+    data = gsl::span<const std::byte>(
+        reinterpret_cast<const std::byte*>(this->_pData + dataOffset),
+        size_t(entry.compressedSize));
+    return true;
+  }
+
+private:
+  bool indexCentralDirectory() {
+    const uint8* pData = this->_pData;
+    const uint64 size = this->_size;
+    if (size < EndOfCentralDirectorySize) {
+      return false;
+    }
+
+    // The end of central directory record is followed only by a comment of
+    // at most 64 KiB, so search backwards for it from the end of the file.
+    const uint64 searchEnd = size - EndOfCentralDirectorySize;
+    const uint64 searchStart =
+        searchEnd > MaximumCommentSize ? searchEnd - MaximumCommentSize : 0;
+    uint64 endOfCentralDirectory = MAX_uint64;
+    for (uint64 i = searchEnd + 1; i-- > searchStart;) {
+      if (readUint32(pData + i) == EndOfCentralDirectorySignature) {
+        endOfCentralDirectory = i;
+        break;
+      }
+    }
+
+    if (endOfCentralDirectory == MAX_uint64) {
+      return false;
+    }
+
+    const uint8* pEnd = pData + endOfCentralDirectory;
+    uint64 entryCount = readUint16(pEnd + 10);
+    uint64 directorySize = readUint32(pEnd + 12);
+    uint64 directoryOffset = readUint32(pEnd + 16);
+
+    // Archives larger than 4 GiB, or with more than 65535 entries, store the
+    // real values in a ZIP64 record found through a locator just before the
+    // end of central directory record.
+    if (endOfCentralDirectory >= Zip64EndOfCentralDirectoryLocatorSize &&
+        readUint32(pEnd - Zip64EndOfCentralDirectoryLocatorSize) ==
+            Zip64EndOfCentralDirectoryLocatorSignature) {
+      const uint64 zip64Offset =
+          readUint64(pEnd - Zip64EndOfCentralDirectoryLocatorSize + 8);
+      if (zip64Offset > size ||
+          size - zip64Offset < Zip64EndOfCentralDirectorySize ||
+          readUint32(pData + zip64Offset) !=
+              Zip64EndOfCentralDirectorySignature) {
+        return false;
+      }
+
+      entryCount = readUint64(pData + zip64Offset + 32);
+      directorySize = readUint64(pData + zip64Offset + 40);
+      directoryOffset = readUint64(pData + zip64Offset + 48);
+    }
+
+    if (directoryOffset > size || size - directoryOffset < directorySize) {
+      return false;
+    }
+
+    this->_entries.reserve(size_t(
+        FMath::Min(entryCount, directorySize / CentralDirectoryHeaderSize)));
+
+    uint64 offset = directoryOffset;
+    const uint64 directoryEnd = directoryOffset + directorySize;
+    for (uint64 i = 0; i < entryCount; ++i) {
+      const uint8* pHeader = pData + offset;
+      if (directoryEnd - offset < CentralDirectoryHeaderSize ||
+          readUint32(pHeader) != CentralDirectoryHeaderSignature) {
+        return false;
+      }
+
+      const uint16 nameLength = readUint16(pHeader + 28);
+      const uint16 extraLength = readUint16(pHeader + 30);
+      const uint16 commentLength = readUint16(pHeader + 32);
+      const uint64 headerSize = CentralDirectoryHeaderSize + nameLength +
+                                extraLength + commentLength;
+      if (directoryEnd - offset < headerSize) {
+        return false;
+      }
+
+      const uint16 flags = readUint16(pHeader + 8);
+      Entry entry{
+          readUint32(pHeader + 42),
+          readUint32(pHeader + 20),
+          readUint32(pHeader + 24),
+          readUint16(pHeader + 10),
+          (flags & EncryptedFlag) != 0};
+
+      const uint8* pExtra = pHeader + CentralDirectoryHeaderSize + nameLength;
+      readZip64ExtraField(pExtra, pExtra + extraLength, entry);
+
+      const char* pName = reinterpret_cast<const char*>(
+          pHeader + CentralDirectoryHeaderSize);
+      offset += headerSize;
+
+      // Directories have entries of their own, which are never requested.
+      if (nameLength == 0 || pName[nameLength - 1] == '/') {
+        continue;
+      }
+
+      this->_entries.emplace(std::string(pName, nameLength), entry);
+    }
+
+    return true;
+  }
+
+  /**
+   * Replaces the sizes and offset of the given entry that do not fit in 32
+   * bits with their values from the entry's ZIP64 extra field.
+   */
+  static void
+  readZip64ExtraField(const uint8* pExtra, const uint8* pEnd, Entry& entry) {
+    while (pEnd - pExtra >= 4) {
+      const uint16 id = readUint16(pExtra);
+      const uint16 length = readUint16(pExtra + 2);
+      const uint8* pField = pExtra + 4;
+      if (pEnd - pField < length) {
+        return;
+      }
+
+      if (id == Zip64ExtraFieldId) {
+        // The field contains only the values that overflowed, in this order.
+        const uint8* pFieldEnd = pField + length;
+        uint64* values[] = {
+            &entry.uncompressedSize,
+            &entry.compressedSize,
+            &entry.localHeaderOffset};
+        for (uint64* pValue : values) {
+          if (*pValue == Zip64Placeholder && pFieldEnd - pField >= 8) {
+            *pValue = readUint64(pField);
+            pField += 8;
+          }
+        }
+        return;
+      }
+
+      pExtra = pField + length;
+    }
+  }
+
+  FFileStatData _statData;
+  TUniquePtr<IMappedFileHandle> _pMappedFile;
+  TUniquePtr<IMappedFileRegion> _pMappedRegion;
+  TArray64<uint8> _loadedData;
+
+  const uint8* _pData = nullptr;
+  uint64 _size = 0;
+
+  std::unordered_map<std::string, Entry> _entries;
+};
+
+ArchiveAssetAccessor::ArchiveAssetAccessor(
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor)
+    : _pAssetAccessor(pAssetAccessor), _archivesLock(), _archives() {}
+
+ArchiveAssetAccessor::~ArchiveAssetAccessor() = default;
+
+Future<std::shared_ptr<IAssetRequest>> ArchiveAssetAccessor::get(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers) {
+  std::string archiveFilename;
+  std::string entryName;
+  if (!isFile(url) || !splitArchiveFilename(
+                          convertFileUriToFilename(url),
+                          archiveFilename,
+                          entryName)) {
+    return this->_pAssetAccessor->get(asyncSystem, url, headers);
+  }
+
+  return asyncSystem.runInWorkerThread(
+      [this,
+       url,
+       archiveFilename = std::move(archiveFilename),
+       entryName = std::move(entryName)]() -> std::shared_ptr<IAssetRequest> {
+        TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::ReadArchiveEntry);
+
+        std::shared_ptr<Archive> pArchive = this->getArchive(archiveFilename);
+        const Archive::Entry* pEntry =
+            pArchive ? pArchive->find(entryName) : nullptr;
+        if (!pEntry) {
+          return std::make_shared<ArchiveEntryResponse>(url, 404);
+        }
+
+        gsl::span<const std::byte> stored;
+        if (pEntry->encrypted || !pArchive->getStoredData(*pEntry, stored)) {
+          UE_LOG(
+              LogCesium,
+              Warning,
+              TEXT("Could not read %s from the archive %s"),
+              UTF8_TO_TCHAR(entryName.c_str()),
+              UTF8_TO_TCHAR(archiveFilename.c_str()));
+          return std::make_shared<ArchiveEntryResponse>(url, 500);
+        }
+
+        if (pEntry->method == StoredMethod) {
+          return std::make_shared<ArchiveEntryResponse>(url, pArchive, stored);
+        }
+
+        std::vector<std::byte> inflated(size_t(pEntry->uncompressedSize));
+        if (pEntry->method != DeflatedMethod ||
+            pEntry->uncompressedSize > uint64(MAX_int32) ||
+            stored.size() > size_t(MAX_int32) ||
+            !FCompression::UncompressMemory(
+                NAME_Zlib,
+                inflated.data(),
+                int32(inflated.size()),
+                stored.data(),
+                int32(stored.size()),
+                COMPRESS_NoFlags,
+                RawDeflateWindowBits)) {
+          UE_LOG(
+              LogCesium,
+              Warning,
+              TEXT(
+                  "Could not decompress %s from the archive %s, which uses compression method %d"),
+              UTF8_TO_TCHAR(entryName.c_str()),
+              UTF8_TO_TCHAR(archiveFilename.c_str()),
+              int32(pEntry->method));
+          return std::make_shared<ArchiveEntryResponse>(url, 500);
+        }
+
+        return std::make_shared<ArchiveEntryResponse>(
+            url,
+            std::move(inflated));
+      });
+}
+
+Future<std::shared_ptr<IAssetRequest>> ArchiveAssetAccessor::request(
+    const AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  if (verb == "GET") {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  return this->_pAssetAccessor
+      ->request(asyncSystem, verb, url, headers, contentPayload);
+}
+
+void ArchiveAssetAccessor::tick() noexcept { this->_pAssetAccessor->tick(); }
+
+std::shared_ptr<ArchiveAssetAccessor::Archive>
+ArchiveAssetAccessor::getArchive(const std::string& filename) {
+  const FFileStatData statData =
+      FPlatformFileManager::Get().GetPlatformFile().GetStatData(
+          UTF8_TO_TCHAR(filename.c_str()));
+
+  // Opening an archive only reads its central directory, so other requests
+  // are not held up for long.
+  FScopeLock lock(&this->_archivesLock);
+
+  auto it = this->_archives.find(filename);
+  if (it != this->_archives.end()) {
+    if (it->second->isCurrent(statData)) {
+      return it->second;
+    }
+
+    // The archive has been rewritten or removed since it was opened. The
+    // responses that still refer to the old mapping keep it alive.
+    this->_archives.erase(it);
+  }
+
+  // Failures are not remembered, so an archive that is written after it was
+  // first requested can still be opened.
+  std::shared_ptr<Archive> pArchive = Archive::open(filename, statData);
+  if (pArchive) {
+    this->_archives.emplace(filename, pArchive);
+  }
+
+  return pArchive;
+}
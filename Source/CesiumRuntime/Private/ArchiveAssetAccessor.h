@@ -0,0 +1,68 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/CriticalSection.h"
+#include <CesiumAsync/IAssetAccessor.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * An asset accessor that serves files from inside 3D Tiles archives (`.3tz`)
+ * and other zip files, so that a tileset with millions of small files can be
+ * deployed as a single file.
+ *
+ * A request for a `file:///` URL with a path such as
+ * `C:/Data/city.3tz/content/tile.glb` is served from the `content/tile.glb`
+ * entry of `C:/Data/city.3tz`. The tileset itself is loaded from
+ * `file:///C:/Data/city.3tz/tileset.json`, so that the URLs of its content
+ * resolve to entries of the same archive. All other requests are passed to
+ * the underlying accessor.
+ *
+ * Each archive is memory-mapped, and an index of its central directory is
+ * built, when it is first requested. The archive then stays open until its
+ * modification time or size changes, when it is opened again for the next
+ * request. Entries may be stored or deflated. Stored entries,
+ * which are the norm for `.3tz` files, are served directly from the mapped
+ * file without being copied.
+ *
+ * Requests are served on worker threads, so this accessor must outlive them.
+ */
+class ArchiveAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  explicit ArchiveAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor);
+  virtual ~ArchiveAssetAccessor() override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers)
+      override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  virtual void tick() noexcept override;
+
+private:
+  class Archive;
+
+  /**
+   * Gets the archive with the given filename, opening and indexing it if this
+   * is the first request for it or if the file has changed since it was
+   * opened. Returns nullptr if it cannot be opened.
+   */
+  std::shared_ptr<Archive> getArchive(const std::string& filename);
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> _pAssetAccessor;
+
+  FCriticalSection _archivesLock;
+  std::unordered_map<std::string, std::shared_ptr<Archive>> _archives;
+};
@@ -0,0 +1,395 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "AsyncCacheDatabase.h"
+#include "CesiumRuntime.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+#include <CesiumAsync/CacheItem.h>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+using namespace CesiumAsync;
+
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Cache Writes Queued"),
+    STAT_CesiumCacheWritesQueued,
+    STATGROUP_Cesium);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Cache Writes Dropped"),
+    STAT_CesiumCacheWritesDropped,
+    STATGROUP_Cesium);
+DECLARE_MEMORY_STAT(
+    TEXT("Cache Write Queue Bytes"),
+    STAT_CesiumCacheWriteQueueBytes,
+    STATGROUP_Cesium);
+
+namespace {
+
+/** The most entries that are written between checks for a prune or a stop. */
+constexpr size_t BatchSize = 64;
+
+struct QueuedEntry {
+  std::string key;
+  std::time_t expiryTime;
+  std::string url;
+  std::string requestMethod;
+  HttpHeaders requestHeaders;
+  uint16_t statusCode;
+  HttpHeaders responseHeaders;
+  std::vector<std::byte> responseData;
+};
+
+} // namespace
+
+class AsyncCacheDatabase::WriterThread : public FRunnable {
+public:
+  WriterThread(
+      std::function<std::shared_ptr<ICacheDatabase>()>&& createDatabase,
+      int64 maximumQueuedBytes)
+      : _createDatabase(std::move(createDatabase)),
+        _maximumQueuedBytes(maximumQueuedBytes),
+        _pWakeEvent(FPlatformProcess::GetSynchEventFromPool()),
+        _opened(false),
+        _writing(false),
+        _pruneRequested(false),
+        _stopping(false),
+        _queuedBytes(0),
+        _clears(0) {
+    this->_pThread = FRunnableThread::Create(
+        this,
+        TEXT("CesiumCacheWriter"),
+        0,
+        TPri_BelowNormal);
+
+    if (!this->_pThread) {
+      // Without a writer thread, the cache is opened now, and written to by
+      // the threads that store entries.
+      this->_stopping = true;
+      this->open();
+    }
+  }
+
+  virtual ~WriterThread() override {
+    this->stop();
+    FPlatformProcess::ReturnSynchEventToPool(this->_pWakeEvent);
+  }
+
+  void stop() {
+    if (this->_pThread) {
+      this->_pThread->Kill(true);
+      delete this->_pThread;
+      this->_pThread = nullptr;
+    }
+  }
+
+  std::optional<CacheItem> get(const std::string& key) {
+    std::shared_ptr<ICacheDatabase> pDatabase;
+    {
+      FScopeLock lock(&this->_lock);
+      auto it = this->_queuedByKey.find(key);
+      if (it != this->_queuedByKey.end()) {
+        const QueuedEntry& entry = *it->second;
+        return CacheItem(
+            entry.expiryTime,
+            CacheRequest(
+                HttpHeaders(entry.requestHeaders),
+                std::string(entry.requestMethod),
+                std::string(entry.url)),
+            CacheResponse(
+                entry.statusCode,
+                HttpHeaders(entry.responseHeaders),
+                std::vector<std::byte>(entry.responseData)));
+      }
+      pDatabase = this->_pDatabase;
+    }
+
+    return pDatabase ? pDatabase->getEntry(key) : std::nullopt;
+  }
+
+  bool store(std::shared_ptr<const QueuedEntry>&& pEntry) {
+    const int64 bytes = int64(pEntry->responseData.size());
+    std::shared_ptr<ICacheDatabase> pDatabase;
+    {
+      FScopeLock lock(&this->_lock);
+      if (!this->_stopping) {
+        if (!this->_queue.empty() &&
+            this->_queuedBytes + bytes > this->_maximumQueuedBytes) {
+          INC_DWORD_STAT(STAT_CesiumCacheWritesDropped);
+          return false;
+        }
+
+        this->_queuedBytes += bytes;
+        this->_queuedByKey[pEntry->key] = pEntry;
+        this->_queue.emplace_back(std::move(pEntry));
+        INC_DWORD_STAT(STAT_CesiumCacheWritesQueued);
+        INC_MEMORY_STAT_BY(STAT_CesiumCacheWriteQueueBytes, bytes);
+        this->_pWakeEvent->Trigger();
+        return true;
+      }
+      pDatabase = this->_pDatabase;
+    }
+
+    return pDatabase && write(*pDatabase, *pEntry);
+  }
+
+  void requestPrune() {
+    std::shared_ptr<ICacheDatabase> pDatabase;
+    {
+      FScopeLock lock(&this->_lock);
+      if (!this->_stopping) {
+        this->_pruneRequested = true;
+        this->_pWakeEvent->Trigger();
+        return;
+      }
+      pDatabase = this->_pDatabase;
+    }
+
+    if (pDatabase) {
+      pDatabase->prune();
+    }
+  }
+
+  bool clear() {
+    // Holding the write lock waits for a batch that the writer thread is
+    // writing. A batch that it has taken from the queue, but not started
+    // writing, is dropped when it sees that the clear count has changed.
+    this->waitUntilOpened();
+    FScopeLock writeLock(&this->_writeLock);
+
+    std::shared_ptr<ICacheDatabase> pDatabase;
+    {
+      FScopeLock lock(&this->_lock);
+      ++this->_clears;
+      for (const std::shared_ptr<const QueuedEntry>& pEntry : this->_queue) {
+        this->dequeued(*pEntry);
+      }
+      this->_queue.clear();
+      this->_queuedByKey.clear();
+      pDatabase = this->_pDatabase;
+    }
+
+    return pDatabase && pDatabase->clearAll();
+  }
+
+  void flush() {
+    while (true) {
+      {
+        FScopeLock lock(&this->_lock);
+        if (this->_opened && this->_queue.empty() && !this->_writing) {
+          return;
+        }
+      }
+      FPlatformProcess::Sleep(0.001f);
+    }
+  }
+
+  virtual uint32 Run() override {
+    this->open();
+
+    std::vector<std::shared_ptr<const QueuedEntry>> batch;
+    batch.reserve(BatchSize);
+
+    while (true) {
+      bool prune = false;
+      uint64 clears = 0;
+      {
+        FScopeLock lock(&this->_lock);
+        clears = this->_clears;
+        while (!this->_queue.empty() && batch.size() < BatchSize) {
+          batch.emplace_back(std::move(this->_queue.front()));
+          this->_queue.pop_front();
+        }
+
+        // Pruning waits until the queue is empty, so that it never holds up
+        // the writing of new entries.
+        if (batch.empty()) {
+          if (this->_stopping) {
+            return 0;
+          }
+          prune = this->_pruneRequested;
+          this->_pruneRequested = false;
+        }
+
+        this->_writing = !batch.empty() || prune;
+      }
+
+      if (!batch.empty()) {
+        {
+          FScopeLock writeLock(&this->_writeLock);
+          bool cleared;
+          {
+            FScopeLock lock(&this->_lock);
+            cleared = this->_clears != clears;
+          }
+
+          if (this->_pDatabase && !cleared) {
+            for (const std::shared_ptr<const QueuedEntry>& pEntry : batch) {
+              write(*this->_pDatabase, *pEntry);
+            }
+          }
+        }
+
+        // The entries stay findable until they are in the cache.
+        FScopeLock lock(&this->_lock);
+        for (const std::shared_ptr<const QueuedEntry>& pEntry : batch) {
+          auto it = this->_queuedByKey.find(pEntry->key);
+          if (it != this->_queuedByKey.end() && it->second == pEntry) {
+            this->_queuedByKey.erase(it);
+          }
+          this->dequeued(*pEntry);
+        }
+        batch.clear();
+        this->_writing = false;
+      } else if (prune) {
+        {
+          FScopeLock writeLock(&this->_writeLock);
+          if (this->_pDatabase) {
+            this->_pDatabase->prune();
+          }
+        }
+
+        FScopeLock lock(&this->_lock);
+        this->_writing = false;
+      } else {
+        this->_pWakeEvent->Wait();
+      }
+    }
+  }
+
+  virtual void Stop() override {
+    FScopeLock lock(&this->_lock);
+    this->_stopping = true;
+    this->_pWakeEvent->Trigger();
+  }
+
+private:
+  static bool write(ICacheDatabase& database, const QueuedEntry& entry) {
+    return database.storeEntry(
+        entry.key,
+        entry.expiryTime,
+        entry.url,
+        entry.requestMethod,
+        entry.requestHeaders,
+        entry.statusCode,
+        entry.responseHeaders,
+        gsl::span<const std::byte>(entry.responseData));
+  }
+
+  void open() {
+    FScopeLock writeLock(&this->_writeLock);
+    std::shared_ptr<ICacheDatabase> pDatabase;
+    try {
+      pDatabase = this->_createDatabase();
+    } catch (const std::exception& e) {
+      UE_LOG(
+          LogCesium,
+          Error,
+          TEXT("Could not open the request cache: %s"),
+          UTF8_TO_TCHAR(e.what()));
+    }
+    this->_createDatabase = nullptr;
+
+    FScopeLock lock(&this->_lock);
+    this->_pDatabase = pDatabase;
+    this->_opened = true;
+  }
+
+  /** Updates the queue size after an entry leaves the queue. */
+  void dequeued(const QueuedEntry& entry) {
+    const int64 bytes = int64(entry.responseData.size());
+    this->_queuedBytes -= bytes;
+    DEC_DWORD_STAT(STAT_CesiumCacheWritesQueued);
+    DEC_MEMORY_STAT_BY(STAT_CesiumCacheWriteQueueBytes, bytes);
+  }
+
+  void waitUntilOpened() {
+    while (true) {
+      {
+        FScopeLock lock(&this->_lock);
+        if (this->_opened) {
+          return;
+        }
+      }
+      FPlatformProcess::Sleep(0.001f);
+    }
+  }
+
+  std::function<std::shared_ptr<ICacheDatabase>()> _createDatabase;
+  int64 _maximumQueuedBytes;
+
+  FRunnableThread* _pThread;
+  FEvent* _pWakeEvent;
+
+  // Guards everything below, except that the writer thread uses
+  // _pDatabase without it once the cache has been opened.
+  FCriticalSection _lock;
+
+  // Held while the cache is opened, written to or pruned, so that clearing it
+  // can wait for them.
+  FCriticalSection _writeLock;
+
+  std::shared_ptr<ICacheDatabase> _pDatabase;
+  bool _opened;
+  bool _writing;
+  bool _pruneRequested;
+  bool _stopping;
+  std::deque<std::shared_ptr<const QueuedEntry>> _queue;
+  std::unordered_map<std::string, std::shared_ptr<const QueuedEntry>>
+      _queuedByKey;
+  int64 _queuedBytes;
+
+  // The number of times the cache has been cleared, so that the writer thread
+  // can tell whether it was cleared after it took a batch from the queue.
+  uint64 _clears;
+};
+
+AsyncCacheDatabase::AsyncCacheDatabase(
+    std::function<std::shared_ptr<ICacheDatabase>()>&& createDatabase,
+    int64 maximumQueuedBytes)
+    : _pWriterThread(std::make_unique<WriterThread>(
+          std::move(createDatabase),
+          maximumQueuedBytes)) {}
+
+AsyncCacheDatabase::~AsyncCacheDatabase() = default;
+
+std::optional<CacheItem>
+AsyncCacheDatabase::getEntry(const std::string& key) const {
+  return this->_pWriterThread->get(key);
+}
+
+bool AsyncCacheDatabase::storeEntry(
+    const std::string& key,
+    std::time_t expiryTime,
+    const std::string& url,
+    const std::string& requestMethod,
+    const HttpHeaders& requestHeaders,
+    uint16_t statusCode,
+    const HttpHeaders& responseHeaders,
+    const gsl::span<const std::byte>& responseData) {
+  return this->_pWriterThread->store(std::make_shared<const QueuedEntry>(
+      QueuedEntry{
+          key,
+          expiryTime,
+          url,
+          requestMethod,
+          requestHeaders,
+          statusCode,
+          responseHeaders,
+          std::vector<std::byte>(responseData.begin(), responseData.end())}));
+}
+
+bool AsyncCacheDatabase::prune() {
+  this->_pWriterThread->requestPrune();
+  return true;
+}
+
+bool AsyncCacheDatabase::clearAll() { return this->_pWriterThread->clear(); }
+
+void AsyncCacheDatabase::flush() { this->_pWriterThread->flush(); }
+
+void AsyncCacheDatabase::shutdown() { this->_pWriterThread->stop(); }
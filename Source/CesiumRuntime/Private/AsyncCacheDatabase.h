@@ -0,0 +1,72 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/Platform.h"
+#include <CesiumAsync/ICacheDatabase.h>
+#include <functional>
+#include <memory>
+
+/**
+ * A request cache that opens, writes to and prunes another cache on a
+ * dedicated thread, so that no request waits for any of them.
+ *
+ * Until the other cache has been opened, every lookup misses. Stored entries
+ * wait in a queue, limited in size, from which the thread writes them in
+ * batches, and are found by lookups while they wait. While the queue is
+ * full, further entries are not cached. A prune only asks the thread to
+ * prune once it has written the queued entries.
+ */
+class AsyncCacheDatabase : public CesiumAsync::ICacheDatabase {
+public:
+  /**
+   * Starts opening a cache on the writer thread.
+   *
+   * @param createDatabase Creates the cache, on the writer thread.
+   * @param maximumQueuedBytes The largest total size of the responses that
+   * may wait to be written.
+   */
+  AsyncCacheDatabase(
+      std::function<std::shared_ptr<CesiumAsync::ICacheDatabase>()>&&
+          createDatabase,
+      int64 maximumQueuedBytes);
+  virtual ~AsyncCacheDatabase() override;
+
+  virtual std::optional<CesiumAsync::CacheItem>
+  getEntry(const std::string& key) const override;
+
+  virtual bool storeEntry(
+      const std::string& key,
+      std::time_t expiryTime,
+      const std::string& url,
+      const std::string& requestMethod,
+      const CesiumAsync::HttpHeaders& requestHeaders,
+      uint16_t statusCode,
+      const CesiumAsync::HttpHeaders& responseHeaders,
+      const gsl::span<const std::byte>& responseData) override;
+
+  virtual bool prune() override;
+
+  /**
+   * Removes the queued entries and everything in the cache, waiting for the
+   * cache to be opened if necessary.
+   */
+  virtual bool clearAll() override;
+
+  /**
+   * Waits until the cache has been opened, and every entry queued so far has
+   * been written.
+   */
+  void flush();
+
+  /**
+   * Writes the queued entries and stops the writer thread. Entries stored
+   * afterward are written by the thread that stores them.
+   */
+  void shutdown();
+
+private:
+  class WriterThread;
+
+  std::unique_ptr<WriterThread> _pWriterThread;
+};
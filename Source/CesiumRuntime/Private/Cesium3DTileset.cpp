@@ -14,6 +14,7 @@
 #include "CesiumBoundingVolumeComponent.h"
 #include "CesiumCamera.h"
 #include "CesiumCameraManager.h"
+#include "CesiumCameraPrediction.h"
 #include "CesiumCommon.h"
 #include "CesiumCustomVersion.h"
 #include "CesiumGeospatial/GlobeTransforms.h"
@@ -24,13 +25,24 @@
 #include "CesiumGltfPrimitiveComponent.h"
 #include "CesiumIonClient/Connection.h"
 #include "CesiumLifetime.h"
+#include "CesiumLodImportance.h"
+#include "CesiumLodImportanceVolume.h"
+#include "CesiumMemoryBudget.h"
 #include "CesiumRasterOverlay.h"
+#include "CesiumRegionPreload.h"
+#include "CesiumRequestScheduler.h"
 #include "CesiumRuntime.h"
 #include "CesiumRuntimeSettings.h"
+#include "CesiumSceneCaptureLodComponent.h"
+#include "CesiumScreenSpaceErrorController.h"
 #include "CesiumTextureUtility.h"
 #include "CesiumTileExcluder.h"
+#include "CesiumTileLoadThrottle.h"
+#include "CesiumTilesetStatistics.h"
 #include "CesiumViewExtension.h"
+#include "CesiumWarmStart.h"
 #include "Components/SceneCaptureComponent2D.h"
+#include "Containers/Ticker.h"
 #include "CreateGltfOptions.h"
 #include "Engine/Engine.h"
 #include "Engine/LocalPlayer.h"
@@ -41,13 +53,16 @@
 #include "Engine/World.h"
 #include "EngineUtils.h"
 #include "GameFramework/PlayerController.h"
+#include "HAL/PlatformProcess.h"
 #include "Kismet/GameplayStatics.h"
 #include "LevelSequenceActor.h"
 #include "LevelSequencePlayer.h"
 #include "Math/UnrealMathUtility.h"
+#include "Misc/App.h"
 #include "PixelFormat.h"
 #include "StereoRendering.h"
 #include "VecMath.h"
+#include <cmath>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <memory>
 #include <spdlog/spdlog.h>
@@ -83,13 +98,30 @@ ACesium3DTileset::ACesium3DTileset()
       _lastTilesWaitingForOcclusionResults(0),
       _lastMaxDepthVisited(0),
 
+      _timeToFirstFullView(-1.0),
+      _previousTimeToFirstFullView(-1.0),
+
       _captureMovieMode{false},
       _beforeMoviePreloadAncestors{PreloadAncestors},
       _beforeMoviePreloadSiblings{PreloadSiblings},
       _beforeMovieLoadingDescendantLimit{LoadingDescendantLimit},
       _beforeMovieUseLodTransitions{true},
 
-      _tilesetsBeingDestroyed(0) {
+      _tilesetsBeingDestroyed(0),
+
+      _memoryBudgetImportance(0.0),
+      _memoryBudgetAllocation(-1),
+      _budgetedCachedBytes(-1),
+
+      _pStatistics(MakeUnique<CesiumTilesetStatistics>()),
+      _pRegionPreload(nullptr),
+      _pCameraPrediction(MakeUnique<CesiumCameraPrediction>()),
+      _pScreenSpaceErrorController(
+          MakeUnique<CesiumScreenSpaceErrorController>()),
+      _pTileLoadThrottle(MakeUnique<CesiumTileLoadThrottle>()),
+      _pLodImportance(MakeUnique<CesiumLodImportance>()),
+      _lastUpdateMilliseconds(0.0),
+      _requestGroup(0) {
 
   PrimaryActorTick.bCanEverTick = true;
   PrimaryActorTick.TickGroup = ETickingGroup::TG_PostUpdateWork;
@@ -322,6 +354,130 @@ void ACesium3DTileset::SetCesiumIonServer(UCesiumIonServer* Server) {
   }
 }
 
+int64 ACesium3DTileset::GetMemoryBudgetAllocation() const {
+  return this->_memoryBudgetAllocation;
+}
+
+int64 ACesium3DTileset::GetEffectiveMaximumCachedBytes() const {
+  return this->_budgetedCachedBytes >= 0 ? this->_budgetedCachedBytes
+                                         : this->MaximumCachedBytes;
+}
+
+double ACesium3DTileset::GetEffectiveMaximumScreenSpaceError() const {
+  const double adaptive =
+      this->_pScreenSpaceErrorController->getScreenSpaceError();
+  if (this->AdaptiveScreenSpaceError.Enabled && adaptive >= 0.0) {
+    return adaptive;
+  }
+  return this->MaximumScreenSpaceError;
+}
+
+ECesiumAdaptiveScreenSpaceErrorReason
+ACesium3DTileset::GetAdaptiveScreenSpaceErrorReason() const {
+  return this->_pScreenSpaceErrorController->getReason();
+}
+
+int32 ACesium3DTileset::GetEffectiveMaximumSimultaneousTileLoads() const {
+  return this->_pTileLoadThrottle->getSimultaneousTileLoads(
+      this->LoadingPriorityMode,
+      this->MaximumSimultaneousTileLoads);
+}
+
+float ACesium3DTileset::GetMemoryBudgetImportance() const {
+  return float(this->_memoryBudgetImportance);
+}
+
+int64 ACesium3DTileset::GetLoadedBytes() const {
+  return this->_pTileset ? this->_pTileset->getTotalDataBytes() : 0;
+}
+
+int64 ACesium3DTileset::GetEstimatedGpuBytes() const {
+  return this->_memoryUsage.getGpuBytes();
+}
+
+int64 ACesium3DTileset::GetVertexBufferBytes() const {
+  return this->_memoryUsage.vertexBufferBytes;
+}
+
+int64 ACesium3DTileset::GetIndexBufferBytes() const {
+  return this->_memoryUsage.indexBufferBytes;
+}
+
+int64 ACesium3DTileset::GetTextureBytes() const {
+  return this->_memoryUsage.getTextureBytes();
+}
+
+int64 ACesium3DTileset::GetTextureBytesForGroup(
+    TEnumAsByte<TextureGroup> Group) const {
+  if (Group < 0 || Group >= TEXTUREGROUP_MAX) {
+    return 0;
+  }
+  return this->_memoryUsage.textureBytes[Group];
+}
+
+int64 ACesium3DTileset::GetMetadataTextureBytes() const {
+  return this->_memoryUsage.metadataTextureBytes;
+}
+
+int64 ACesium3DTileset::GetCollisionBytes() const {
+  return this->_memoryUsage.collisionBytes;
+}
+
+int64 ACesium3DTileset::GetGltfBytes() const {
+  return this->_memoryUsage.gltfBytes;
+}
+
+double ACesium3DTileset::GetTilesLoadedPerSecond() const {
+  return this->_pStatistics->getTilesLoadedPerSecond();
+}
+
+double ACesium3DTileset::GetTilesUnloadedPerSecond() const {
+  return this->_pStatistics->getTilesUnloadedPerSecond();
+}
+
+double ACesium3DTileset::GetBytesReceivedPerSecond() const {
+  return this->_pStatistics->getBytesReceivedPerSecond();
+}
+
+double ACesium3DTileset::GetLastUpdateMilliseconds() const {
+  return this->_lastUpdateMilliseconds;
+}
+
+int64 ACesium3DTileset::GetNumberOfTilesRendered() const {
+  return this->_pStatistics->getTilesRendered();
+}
+
+int64 ACesium3DTileset::GetWorkerThreadTileLoadQueueLength() const {
+  return this->_pStatistics->getWorkerThreadTileLoadQueueLength();
+}
+
+int64 ACesium3DTileset::GetMainThreadTileLoadQueueLength() const {
+  return this->_pStatistics->getMainThreadTileLoadQueueLength();
+}
+
+FCesiumTileLoadLatency
+ACesium3DTileset::GetTileLoadLatency(ECesiumTileLoadStage Stage) const {
+  return this->_pStatistics->getLatency(Stage);
+}
+
+void ACesium3DTileset::ResetTileLoadLatency() {
+  this->_pStatistics->resetLatency();
+}
+
+double ACesium3DTileset::GetTimeToFirstFullView() const {
+  return this->_timeToFirstFullView;
+}
+
+void ACesium3DTileset::addMemoryUsage(const CesiumMemoryUsage& usage) {
+  this->_memoryUsage += usage;
+  usage.incrementStats();
+}
+
+void ACesium3DTileset::removeMemoryUsage(const CesiumMemoryUsage& usage) {
+  this->_memoryUsage -= usage;
+  usage.decrementStats();
+}
+
 void ACesium3DTileset::SetMaximumScreenSpaceError(
     double InMaximumScreenSpaceError) {
   if (MaximumScreenSpaceError != InMaximumScreenSpaceError) {
@@ -330,6 +486,19 @@ void ACesium3DTileset::SetMaximumScreenSpaceError(
   }
 }
 
+void ACesium3DTileset::SetLoadingPriorityMode(
+    ECesiumLoadingPriorityMode InLoadingPriorityMode) {
+  if (this->LoadingPriorityMode != InLoadingPriorityMode) {
+    UE_LOG(
+        LogCesium,
+        Verbose,
+        TEXT("Tileset %s loading priority mode is %s"),
+        *this->GetName(),
+        *UEnum::GetValueAsString(InLoadingPriorityMode));
+    this->LoadingPriorityMode = InLoadingPriorityMode;
+  }
+}
+
 bool ACesium3DTileset::GetEnableOcclusionCulling() const {
   return GetDefault<UCesiumRuntimeSettings>()
              ->EnableExperimentalOcclusionCullingFeature &&
@@ -672,6 +841,20 @@ void ACesium3DTileset::NotifyHit(
   // std::cout << "Hit face index 2: " << detailedHit.FaceIndex << std::endl;
 }
 
+namespace {
+
+CesiumMemoryUsage getRasterMemoryUsage(
+    const CesiumTextureUtility::ReferenceCountedUnrealTexture& texture) {
+  CesiumMemoryUsage usage;
+  UTexture2D* pUnrealTexture = texture.getUnrealTexture();
+  TextureGroup group = pUnrealTexture ? TextureGroup(pUnrealTexture->LODGroup)
+                                      : TEXTUREGROUP_World;
+  usage.textureBytes[group] = texture.getSizeBytes();
+  return usage;
+}
+
+} // namespace
+
 class UnrealResourcePreparer
     : public Cesium3DTilesSelection::IPrepareRendererResources {
 public:
@@ -684,6 +867,12 @@ public:
       Cesium3DTilesSelection::TileLoadResult&& tileLoadResult,
       const glm::dmat4& transform,
       const std::any& rendererOptions) override {
+    double requestStarted =
+        tileLoadResult.pCompletedRequest
+            ? this->_pActor->_pStatistics->takeRequestStartTime(
+                  tileLoadResult.pCompletedRequest->url())
+            : -1.0;
+
     CesiumGltf::Model* pModel =
         std::get_if<CesiumGltf::Model>(&tileLoadResult.contentKind);
     if (!pModel)
@@ -710,6 +899,11 @@ public:
 
     TUniquePtr<UCesiumGltfComponent::HalfConstructed> pHalf =
         UCesiumGltfComponent::CreateOffGameThread(transform, options);
+    pHalf->LoadTimes.requestStarted = requestStarted;
+    pHalf->LoadTimes.loadThreadFinished = FPlatformTime::Seconds();
+    if (tileLoadResult.pCompletedRequest) {
+      pHalf->ContentUrl = tileLoadResult.pCompletedRequest->url();
+    }
 
     return asyncSystem.createResolvedFuture(
         Cesium3DTilesSelection::TileLoadResultAndRenderResources{
@@ -727,7 +921,7 @@ public:
               pLoadThreadResult));
       Cesium3DTilesSelection::TileRenderContent& renderContent =
           *content.getRenderContent();
-      return UCesiumGltfComponent::CreateOnGameThread(
+      UCesiumGltfComponent* pGltf = UCesiumGltfComponent::CreateOnGameThread(
           renderContent.getModel(),
           this->_pActor,
           std::move(pHalf),
@@ -738,6 +932,12 @@ public:
           this->_pActor->GetCustomDepthParameters(),
           tile,
           this->_pActor->GetCreateNavCollision());
+      if (pGltf) {
+        pGltf->LoadTimes.mainThreadFinished = FPlatformTime::Seconds();
+        this->_pActor->addMemoryUsage(pGltf->MemoryUsage);
+      }
+      this->_pActor->_pStatistics->recordTileLoaded();
+      return pGltf;
     }
     // UE_LOG(LogCesium, VeryVerbose, TEXT("No content for tile"));
     return nullptr;
@@ -755,6 +955,9 @@ public:
     } else if (pMainThreadResult) {
       UCesiumGltfComponent* pGltf =
           reinterpret_cast<UCesiumGltfComponent*>(pMainThreadResult);
+      this->_pActor->removeMemoryUsage(pGltf->MemoryUsage);
+      this->_pActor->_pStatistics->recordTileUnloaded();
+      this->_pActor->_pLodImportance->unloadTile(tile);
       CesiumLifetime::destroyComponentRecursively(pGltf);
     }
   }
@@ -817,6 +1020,8 @@ public:
       return nullptr;
     }
 
+    this->_pActor->addMemoryUsage(getRasterMemoryUsage(*pTexture));
+
     // Don't let this ReferenceCountedUnrealTexture be destroyed when the
     // intrusive pointer goes out of scope.
     pTexture->addReference();
@@ -838,6 +1043,7 @@ public:
       CesiumTextureUtility::ReferenceCountedUnrealTexture* pTexture =
           static_cast<CesiumTextureUtility::ReferenceCountedUnrealTexture*>(
               pMainThreadResult);
+      this->_pActor->removeMemoryUsage(getRasterMemoryUsage(*pTexture));
       pTexture->releaseReference();
     }
   }
@@ -935,6 +1141,17 @@ void ACesium3DTileset::UpdateLoadStatus() {
     // Tileset just finished loading, we broadcast the update
     UE_LOG(LogCesium, Verbose, TEXT("Broadcasting OnTileLoaded"));
     OnTilesetLoaded.Broadcast();
+
+    if (this->_timeToFirstFullView < 0.0) {
+      this->_timeToFirstFullView =
+          std::chrono::duration<double>(
+              std::chrono::high_resolution_clock::now() - this->_startTime)
+              .count();
+      CesiumWarmStart::reportTimeToFirstFullView(
+          *this,
+          this->_timeToFirstFullView,
+          this->_previousTimeToFirstFullView);
+    }
   }
 }
 
@@ -982,8 +1199,38 @@ void ACesium3DTileset::LoadTileset() {
 
   const TSharedRef<CesiumViewExtension, ESPMode::ThreadSafe>&
       cesiumViewExtension = getCesiumViewExtension();
-  const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor =
-      getAssetAccessor();
+  this->_pStatistics->reset(this->GetName());
+
+  // Attribute this tileset's requests to it, so that the ones still queued
+  // can be canceled when it is destroyed.
+  const std::shared_ptr<CesiumRequestScheduler>& pScheduler =
+      CesiumRequestScheduler::getInstance();
+  this->_requestGroup = pScheduler->createGroup();
+  std::shared_ptr<CesiumAsync::IAssetAccessor> pAssetAccessor =
+      pScheduler->createGroupAssetAccessor(
+          getAssetAccessor(),
+          this->_requestGroup);
+
+  // In play, request the tiles that were shown when play last ended as soon
+  // as the tileset starts loading. The prefetched requests are not counted in
+  // the statistics below, so they do not skew the tile load latencies.
+  this->_previousTimeToFirstFullView = -1.0;
+  if (pWorld->IsGameWorld() &&
+      GetDefault<UCesiumRuntimeSettings>()->EnableWarmStart) {
+    std::optional<CesiumWarmStart::Snapshot> maybeSnapshot =
+        CesiumWarmStart::loadSnapshot(
+            CesiumWarmStart::getSnapshotFilename(*this));
+    if (maybeSnapshot) {
+      this->_previousTimeToFirstFullView = maybeSnapshot->timeToFirstFullView;
+      pAssetAccessor = CesiumWarmStart::createAssetAccessor(
+          pAssetAccessor,
+          std::move(maybeSnapshot->urls));
+    }
+  }
+
+  // Count the bytes received by this tileset's requests separately from those
+  // of other tilesets.
+  pAssetAccessor = this->_pStatistics->createAssetAccessor(pAssetAccessor);
   const CesiumAsync::AsyncSystem& asyncSystem = getAsyncSystem();
 
   // Both the feature flag and the CesiumViewExtension are global, not owned by
@@ -1067,6 +1314,7 @@ void ACesium3DTileset::LoadTileset() {
           : nullptr};
 
   this->_startTime = std::chrono::high_resolution_clock::now();
+  this->_timeToFirstFullView = -1.0;
 
   this->LoadProgress = 0;
 
@@ -1111,11 +1359,20 @@ void ACesium3DTileset::LoadTileset() {
             ENamedThreads::GameThread,
             [ueDetails = std::move(ueDetails)]() {
               OnCesium3DTilesetLoadFailure.Broadcast(ueDetails);
+
+              // A region cannot be preloaded without the tileset.json.
+              ACesium3DTileset* pTileset = ueDetails.Tileset.Get();
+              if (pTileset &&
+                  ueDetails.Type != ECesium3DTilesetLoadType::Unknown) {
+                pTileset->FinishRegionPreload(false);
+              }
             });
       };
 
   // Generous per-frame time limits for loading / unloading on main thread.
-  options.mainThreadLoadingTimeLimit = 5.0;
+  // The loading limit is scaled by the LoadingPriorityMode every frame.
+  options.mainThreadLoadingTimeLimit =
+      CesiumTileLoadThrottle::DefaultMainThreadLoadingMilliseconds;
   options.tileCacheUnloadTimeLimit = 5.0;
 
   options.contentOptions.generateMissingNormalsSmooth =
@@ -1150,6 +1407,8 @@ void ACesium3DTileset::LoadTileset() {
 
   options.contentOptions.applyTextureTransform = false;
 
+  options.maximumCachedBytes = this->GetEffectiveMaximumCachedBytes();
+
   switch (this->TilesetSource) {
   case ETilesetSource::FromUrl:
     UE_LOG(LogCesium, Log, TEXT("Loading tileset from URL %s"), *this->Url);
@@ -1202,6 +1461,8 @@ void ACesium3DTileset::LoadTileset() {
     }
   }
 
+  CesiumMemoryBudget::getInstance().registerTileset(this);
+
   switch (this->TilesetSource) {
   case ETilesetSource::FromUrl:
     UE_LOG(
@@ -1277,10 +1538,21 @@ void ACesium3DTileset::DestroyTileset() {
     }
   }
 
+  CesiumMemoryBudget::getInstance().unregisterTileset(this);
+  this->_memoryBudgetImportance = 0.0;
+
   if (!this->_pTileset) {
     return;
   }
 
+  // A region preload started before the tileset was loaded is kept, but one
+  // whose tiles are being destroyed fails.
+  this->FinishRegionPreload(false);
+
+  // The requests of this tileset that have not been sent yet are no longer
+  // needed.
+  CesiumRequestScheduler::getInstance()->cancelGroup(this->_requestGroup);
+
   // Don't allow this Cesium3DTileset to be fully destroyed until
   // any cesium-native Tilesets it created have wrapped up any async
   // operations in progress and have been fully destroyed.
@@ -1288,6 +1560,7 @@ void ACesium3DTileset::DestroyTileset() {
   ++this->_tilesetsBeingDestroyed;
   this->_pTileset->getAsyncDestructionCompleteEvent().thenInMainThread(
       [this]() { --this->_tilesetsBeingDestroyed; });
+  this->_pLodImportance->reset();
   this->_pTileset.Reset();
 
   switch (this->TilesetSource) {
@@ -1308,10 +1581,25 @@ void ACesium3DTileset::DestroyTileset() {
   }
 }
 
-std::vector<FCesiumCamera> ACesium3DTileset::GetCameras() const {
+std::vector<FCesiumCamera> ACesium3DTileset::GetCameras(float DeltaTime) {
   TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::CollectCameras)
   std::vector<FCesiumCamera> cameras = this->GetPlayerCameras();
 
+  if (this->PredictCameraMotion) {
+    CesiumCameraPrediction::Options options;
+    options.predictionSeconds = this->PredictionSeconds;
+    options.resolution = this->PredictedViewResolution;
+    options.divergenceDegrees = this->PredictionDivergenceDegrees;
+    std::vector<FCesiumCamera> predictions =
+        this->_pCameraPrediction->update(cameras, DeltaTime, options);
+    cameras.insert(
+        cameras.end(),
+        std::make_move_iterator(predictions.begin()),
+        std::make_move_iterator(predictions.end()));
+  } else {
+    this->_pCameraPrediction->reset();
+  }
+
   std::vector<FCesiumCamera> sceneCaptures = this->GetSceneCaptures();
   cameras.insert(
       cameras.end(),
@@ -1506,6 +1794,12 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetSceneCaptures() const {
       continue;
     }
 
+    const UCesiumSceneCaptureLodComponent* pLod =
+        pSceneCapture->FindComponentByClass<UCesiumSceneCaptureLodComponent>();
+    if (pLod && !pLod->SelectTiles) {
+      continue;
+    }
+
     USceneCaptureComponent2D* pSceneCaptureComponent =
         pSceneCapture->GetCaptureComponent2D();
     if (!pSceneCaptureComponent) {
@@ -1532,11 +1826,14 @@ std::vector<FCesiumCamera> ACesium3DTileset::GetSceneCaptures() const {
     FRotator captureRotation = pSceneCaptureComponent->GetComponentRotation();
     double captureFov = pSceneCaptureComponent->FOVAngle;
 
-    cameras.emplace_back(
+    FCesiumCamera& camera = cameras.emplace_back(
         renderTargetSize,
         captureLocation,
         captureRotation,
         captureFov);
+    if (pLod) {
+      camera.ScreenSpaceErrorMultiplier = pLod->ScreenSpaceErrorMultiplier;
+    }
   }
 
   return cameras;
@@ -1577,6 +1874,13 @@ ACesium3DTileset::CreateViewStateFromViewParameters(
   double verticalFieldOfView =
       atan(tan(horizontalFieldOfView * 0.5) / actualAspectRatio) * 2.0;
 
+  // The screen-space error of a tile is proportional to the viewport size, so
+  // scaling the size scales the screen-space error without changing what the
+  // camera sees.
+  if (camera.ScreenSpaceErrorMultiplier > 0.0) {
+    size *= camera.ScreenSpaceErrorMultiplier;
+  }
+
   FVector direction = camera.Rotation.RotateVector(FVector(1.0f, 0.0f, 0.0f));
   FVector up = camera.Rotation.RotateVector(FVector(0.0f, 0.0f, 1.0f));
 
@@ -1598,6 +1902,256 @@ ACesium3DTileset::CreateViewStateFromViewParameters(
       verticalFieldOfView);
 }
 
+std::optional<std::vector<Cesium3DTilesSelection::ViewState>>
+ACesium3DTileset::CreateViewStates(
+    const std::vector<FCesiumCamera>& cameras) const {
+  glm::dmat4 ueTilesetToUeWorld =
+      VecMath::createMatrix4D(this->GetActorTransform().ToMatrixWithScale());
+
+  const glm::dmat4& cesiumTilesetToUeTileset =
+      this->GetCesiumTilesetToUnrealRelativeWorldTransform();
+  glm::dmat4 unrealWorldToCesiumTileset =
+      glm::affineInverse(ueTilesetToUeWorld * cesiumTilesetToUeTileset);
+
+  if (glm::isnan(unrealWorldToCesiumTileset[3].x) ||
+      glm::isnan(unrealWorldToCesiumTileset[3].y) ||
+      glm::isnan(unrealWorldToCesiumTileset[3].z)) {
+    // Probably caused by a zero scale.
+    return std::nullopt;
+  }
+
+  std::vector<Cesium3DTilesSelection::ViewState> frustums;
+  frustums.reserve(cameras.size());
+  for (const FCesiumCamera& camera : cameras) {
+    frustums.push_back(
+        CreateViewStateFromViewParameters(camera, unrealWorldToCesiumTileset));
+  }
+  return frustums;
+}
+
+FCesiumLoadTilesForViewsResult ACesium3DTileset::LoadTilesForViews(
+    const std::vector<FCesiumCamera>& Views,
+    double MaximumScreenSpaceError,
+    int32 MaximumSimultaneousTileLoads,
+    double TimeoutSeconds) {
+  TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::LoadTilesForViews)
+
+  FCesiumLoadTilesForViewsResult result;
+
+  this->ResolveGeoreference();
+
+  if (!this->_pTileset) {
+    LoadTileset();
+    if (!this->_pTileset) {
+      return result;
+    }
+  }
+
+  // The adaptive screen-space error and the tile load throttle are about the
+  // frames being shown, and none are while this blocks, so the given limits
+  // are used instead of theirs. The next Tick applies theirs again.
+  updateTilesetOptionsFromProperties();
+  Cesium3DTilesSelection::TilesetOptions& options =
+      this->_pTileset->getOptions();
+  options.maximumScreenSpaceError = MaximumScreenSpaceError;
+  options.maximumSimultaneousTileLoads = MaximumSimultaneousTileLoads;
+  options.mainThreadLoadingTimeLimit = 0.0;
+
+  // Restore the original geometric errors of the tiles that LOD importance
+  // volumes scaled, and leave the tiles loaded meanwhile unscaled. The next
+  // Tick scales them again.
+  this->_pLodImportance->update(
+      {},
+      this->GetCesiumTilesetToUnrealRelativeWorldTransform(),
+      *this->_pTileset);
+
+  std::optional<std::vector<Cesium3DTilesSelection::ViewState>> maybeFrustums =
+      this->CreateViewStates(Views);
+  if (!maybeFrustums || maybeFrustums->empty()) {
+    return result;
+  }
+
+  // This does what updateViewOffline does, but with a deadline, and with the
+  // work of the engine loop that the requests depend on. The tiles are
+  // complete once none are queued or loading, and the raster overlay images
+  // draped over them once no requests are in flight.
+  const double deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+  double lastTime = FPlatformTime::Seconds();
+  while (true) {
+    const double now = FPlatformTime::Seconds();
+    const float deltaTime = float(now - lastTime);
+    lastTime = now;
+
+    getAssetAccessor()->tick();
+    FTSTicker::GetCoreTicker().Tick(deltaTime);
+    getAsyncSystem().dispatchMainThreadTasks();
+
+    const Cesium3DTilesSelection::ViewUpdateResult& viewUpdateResult =
+        this->_pTileset->updateView(*maybeFrustums, deltaTime);
+    result.TilesSelected =
+        int64(viewUpdateResult.tilesToRenderThisFrame.size());
+
+    const int64 requestsInFlight = this->_pStatistics->getRequestsInFlight();
+    if (requestsInFlight == 0 &&
+        this->_pTileset->computeLoadProgress() >= 100.0f) {
+      break;
+    }
+
+    if (now >= deadline) {
+      result.bTimedOut = true;
+      result.RequestsTimedOut = requestsInFlight;
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT(
+              "%s did not finish loading the tiles for %d views within %.0f seconds. %lld requests were still in flight."),
+          *this->GetName(),
+          int32(Views.size()),
+          TimeoutSeconds,
+          requestsInFlight);
+      break;
+    }
+
+    FPlatformProcess::Sleep(0.001f);
+  }
+
+  return result;
+}
+
+void ACesium3DTileset::SetRequestObserver(
+    std::function<void(const CesiumAsync::IAssetRequest&)> Observer) {
+  this->_pStatistics->setRequestObserver(std::move(Observer));
+}
+
+TFuture<bool> ACesium3DTileset::PreloadRegion(
+    const FVector& LongitudeLatitudeHeight,
+    double Radius,
+    double MaximumScreenSpaceError,
+    double ViewHeight,
+    TFunction<void(float)> OnProgress) {
+  this->FinishRegionPreload(false);
+
+  this->_pRegionPreload = MakeUnique<CesiumRegionPreload>(
+      CesiumRegionPreload::createViews(
+          *this,
+          LongitudeLatitudeHeight,
+          Radius,
+          ViewHeight),
+      MaximumScreenSpaceError,
+      MoveTemp(OnProgress));
+  TFuture<bool> future = this->_pRegionPreload->getFuture();
+
+  if (this->_pRegionPreload->getBatchViews().empty()) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT(
+            "%s cannot preload a region with no views. Check the radius, the view height, and that the tileset has a georeference."),
+        *this->GetName());
+    this->FinishRegionPreload(false);
+  }
+
+  return future;
+}
+
+float ACesium3DTileset::GetRegionPreloadProgress() const {
+  return this->_pRegionPreload ? this->_pRegionPreload->getProgress() : -1.0f;
+}
+
+void ACesium3DTileset::CancelRegionPreload() {
+  this->FinishRegionPreload(false);
+}
+
+void ACesium3DTileset::TickRegionPreload(float DeltaTime) {
+  TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::TickRegionPreload)
+
+  this->_pTileset->getOptions().maximumScreenSpaceError =
+      this->_pRegionPreload->getMaximumScreenSpaceError();
+
+  std::optional<std::vector<Cesium3DTilesSelection::ViewState>> maybeFrustums =
+      this->CreateViewStates(this->_pRegionPreload->getBatchViews());
+  if (!maybeFrustums) {
+    return;
+  }
+
+  // The selected tiles are loaded, but neither shown nor counted towards
+  // LoadProgress, which is about the usual cameras.
+  const Cesium3DTilesSelection::ViewUpdateResult& result =
+      this->_pTileset->updateView(*maybeFrustums, DeltaTime);
+  this->_pStatistics->update(result, DeltaTime);
+
+  if (this->_pRegionPreload->update(this->_pTileset->computeLoadProgress())) {
+    this->FinishRegionPreload(true);
+  }
+}
+
+void ACesium3DTileset::UpdateAdaptiveScreenSpaceError(float DeltaTime) {
+  CesiumScreenSpaceErrorController::Measurements measurements;
+  measurements.gameThreadMilliseconds = this->_lastUpdateMilliseconds;
+  measurements.estimatedGpuBytes = this->GetEstimatedGpuBytes();
+  measurements.loadQueueLength = this->GetWorkerThreadTileLoadQueueLength() +
+                                 this->GetMainThreadTileLoadQueueLength();
+
+  const ECesiumAdaptiveScreenSpaceErrorReason previousReason =
+      this->_pScreenSpaceErrorController->getReason();
+  this->_pScreenSpaceErrorController->update(
+      this->AdaptiveScreenSpaceError,
+      this->MaximumScreenSpaceError,
+      measurements,
+      DeltaTime);
+
+  const ECesiumAdaptiveScreenSpaceErrorReason reason =
+      this->_pScreenSpaceErrorController->getReason();
+  if (reason != previousReason) {
+    UE_LOG(
+        LogCesium,
+        Verbose,
+        TEXT("Tileset %s adaptive screen-space error is %.1f: %s"),
+        *this->GetName(),
+        this->_pScreenSpaceErrorController->getScreenSpaceError(),
+        *UEnum::GetValueAsString(reason));
+  }
+}
+
+void ACesium3DTileset::UpdateTileLoadThrottle() {
+  // Use the undilated frame time, because a slow-motion effect does not make
+  // frames any faster.
+  this->_pTileLoadThrottle->update(
+      this->LoadingPriorityMode,
+      this->MaximumSimultaneousTileLoads,
+      this->ThrottleTileLoadsByFrameTime,
+      this->TargetFrameTimeMilliseconds / 1000.0,
+      FApp::GetDeltaTime());
+}
+
+void ACesium3DTileset::UpdateLodImportance() {
+  std::vector<CesiumLodImportanceIndex::Volume> volumes;
+  if (this->EnableLodImportanceVolumes) {
+    for (TActorIterator<ACesiumLodImportanceVolume> it(this->GetWorld()); it;
+         ++it) {
+      std::optional<CesiumLodImportanceIndex::Volume> maybeVolume =
+          CesiumLodImportanceIndex::createVolume(**it);
+      if (maybeVolume) {
+        volumes.emplace_back(std::move(*maybeVolume));
+      }
+    }
+  }
+
+  this->_pLodImportance->update(
+      std::move(volumes),
+      this->GetCesiumTilesetToUnrealRelativeWorldTransform(),
+      *this->_pTileset);
+}
+
+void ACesium3DTileset::FinishRegionPreload(bool Succeeded) {
+  // Let go of the preload first, in case finishing it starts another.
+  TUniquePtr<CesiumRegionPreload> pRegionPreload =
+      MoveTemp(this->_pRegionPreload);
+  if (pRegionPreload) {
+    pRegionPreload->finish(Succeeded);
+  }
+}
+
 #if WITH_EDITOR
 std::vector<FCesiumCamera> ACesium3DTileset::GetEditorCameras() const {
   if (!GEditor) {
@@ -1799,13 +2353,16 @@ void applyActorCollisionSettings(
 void ACesium3DTileset::updateTilesetOptionsFromProperties() {
   Cesium3DTilesSelection::TilesetOptions& options =
       this->_pTileset->getOptions();
-  options.maximumScreenSpaceError =
-      static_cast<double>(this->MaximumScreenSpaceError);
-  options.maximumCachedBytes = this->MaximumCachedBytes;
+  options.maximumScreenSpaceError = this->GetEffectiveMaximumScreenSpaceError();
+  options.maximumCachedBytes = this->GetEffectiveMaximumCachedBytes();
   options.preloadAncestors = this->PreloadAncestors;
   options.preloadSiblings = this->PreloadSiblings;
   options.forbidHoles = this->ForbidHoles;
-  options.maximumSimultaneousTileLoads = this->MaximumSimultaneousTileLoads;
+  options.maximumSimultaneousTileLoads =
+      this->GetEffectiveMaximumSimultaneousTileLoads();
+  options.mainThreadLoadingTimeLimit =
+      this->_pTileLoadThrottle->getMainThreadLoadingMilliseconds(
+          this->LoadingPriorityMode);
   options.loadingDescendantLimit = this->LoadingDescendantLimit;
   options.enableFrustumCulling = this->EnableFrustumCulling;
   options.enableOcclusionCulling =
@@ -1880,6 +2437,21 @@ void ACesium3DTileset::updateLastViewUpdateResultState(
   }
 }
 
+void ACesium3DTileset::updateMemoryBudgetImportance(
+    const Cesium3DTilesSelection::ViewUpdateResult& result,
+    float deltaTime) {
+  float halfLife =
+      GetDefault<UCesiumRuntimeSettings>()->MemoryBudgetImportanceHalfLife;
+
+  // Exponential moving average, so that a tileset that stops being visible
+  // gradually gives up its share of the budget rather than all at once.
+  double alpha =
+      halfLife > 0.0f ? 1.0 - std::exp2(-deltaTime / halfLife) : 1.0;
+  this->_memoryBudgetImportance +=
+      alpha * (double(result.tilesToRenderThisFrame.size()) -
+               this->_memoryBudgetImportance);
+}
+
 void ACesium3DTileset::showTilesToRender(
     const std::vector<Cesium3DTilesSelection::Tile*>& tiles) {
   TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::ShowTilesToRender)
@@ -1914,6 +2486,11 @@ void ACesium3DTileset::showTilesToRender(
       continue;
     }
 
+    if (Gltf->LoadTimes.firstShown < 0.0) {
+      Gltf->LoadTimes.firstShown = FPlatformTime::Seconds();
+      this->_pStatistics->recordTileShown(Gltf->LoadTimes);
+    }
+
     applyActorCollisionSettings(BodyInstance, Gltf);
 
     if (Gltf->GetAttachParent() == nullptr) {
@@ -2022,33 +2599,31 @@ void ACesium3DTileset::Tick(float DeltaTime) {
     }
   }
 
+  CesiumMemoryBudget::getInstance().update();
+  this->UpdateAdaptiveScreenSpaceError(DeltaTime);
+  this->UpdateTileLoadThrottle();
   updateTilesetOptionsFromProperties();
+  this->UpdateLodImportance();
 
-  std::vector<FCesiumCamera> cameras = this->GetCameras();
-  if (cameras.empty()) {
+  if (this->_pRegionPreload) {
+    this->TickRegionPreload(DeltaTime);
     return;
   }
 
-  glm::dmat4 ueTilesetToUeWorld =
-      VecMath::createMatrix4D(this->GetActorTransform().ToMatrixWithScale());
-
-  const glm::dmat4& cesiumTilesetToUeTileset =
-      this->GetCesiumTilesetToUnrealRelativeWorldTransform();
-  glm::dmat4 unrealWorldToCesiumTileset =
-      glm::affineInverse(ueTilesetToUeWorld * cesiumTilesetToUeTileset);
+  const double updateStart = FPlatformTime::Seconds();
 
-  if (glm::isnan(unrealWorldToCesiumTileset[3].x) ||
-      glm::isnan(unrealWorldToCesiumTileset[3].y) ||
-      glm::isnan(unrealWorldToCesiumTileset[3].z)) {
-    // Probably caused by a zero scale.
+  std::vector<FCesiumCamera> cameras = this->GetCameras(DeltaTime);
+  if (cameras.empty()) {
     return;
   }
 
-  std::vector<Cesium3DTilesSelection::ViewState> frustums;
-  for (const FCesiumCamera& camera : cameras) {
-    frustums.push_back(
-        CreateViewStateFromViewParameters(camera, unrealWorldToCesiumTileset));
+  std::optional<std::vector<Cesium3DTilesSelection::ViewState>> maybeFrustums =
+      this->CreateViewStates(cameras);
+  if (!maybeFrustums) {
+    return;
   }
+  const std::vector<Cesium3DTilesSelection::ViewState>& frustums =
+      *maybeFrustums;
 
   const Cesium3DTilesSelection::ViewUpdateResult* pResult;
   if (this->_captureMovieMode) {
@@ -2059,6 +2634,8 @@ void ACesium3DTileset::Tick(float DeltaTime) {
     pResult = &this->_pTileset->updateView(frustums, DeltaTime);
   }
   updateLastViewUpdateResultState(*pResult);
+  this->_pStatistics->update(*pResult, DeltaTime);
+  updateMemoryBudgetImportance(*pResult, DeltaTime);
 
   removeCollisionForTiles(pResult->tilesFadingOut);
 
@@ -2093,10 +2670,53 @@ void ACesium3DTileset::Tick(float DeltaTime) {
     }
   }
 
+  this->_lastUpdateMilliseconds =
+      (FPlatformTime::Seconds() - updateStart) * 1000.0;
+
   this->UpdateLoadStatus();
 }
 
+void ACesium3DTileset::SaveWarmStartSnapshot() const {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  if (!this->_pTileset || !pSettings->EnableWarmStart) {
+    return;
+  }
+
+  // The tiles are selected for all views at once, so the snapshot holds the
+  // tiles shown to any of them.
+  CesiumWarmStart::Snapshot snapshot;
+  snapshot.timeToFirstFullView = this->_timeToFirstFullView;
+
+  TArray<UCesiumGltfComponent*> gltfComponents;
+  this->GetComponents<UCesiumGltfComponent>(gltfComponents);
+  for (UCesiumGltfComponent* pGltf : gltfComponents) {
+    if (int64(snapshot.urls.size()) >= pSettings->MaximumWarmStartTiles) {
+      break;
+    }
+    if (IsValid(pGltf) && pGltf->IsVisible() && !pGltf->ContentUrl.empty()) {
+      snapshot.urls.emplace_back(pGltf->ContentUrl);
+    }
+  }
+
+  // Keep the previous snapshot if nothing is shown, for example because the
+  // tileset is hidden.
+  if (snapshot.urls.empty()) {
+    return;
+  }
+
+  const FString filename = CesiumWarmStart::getSnapshotFilename(*this);
+  if (!CesiumWarmStart::saveSnapshot(filename, snapshot)) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT("Could not write the warm start snapshot %s"),
+        *filename);
+  }
+}
+
 void ACesium3DTileset::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+  this->SaveWarmStartSnapshot();
   this->DestroyTileset();
   AActor::EndPlay(EndPlayReason);
 }
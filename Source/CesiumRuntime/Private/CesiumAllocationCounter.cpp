@@ -0,0 +1,169 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumAllocationCounter.h"
+#include "CesiumRuntime.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include <algorithm>
+
+namespace {
+
+thread_local CesiumAllocationCounter::Counters* pCurrentCounters = nullptr;
+
+/**
+ * Forwards every call to the allocator that was GMalloc when it was
+ * installed, counting the allocations made by threads that have counters
+ * installed. Memory allocated before the proxy was installed can safely be
+ * freed through it, because all of it belongs to the same underlying
+ * allocator.
+ */
+class FCountingMallocProxy : public FMalloc {
+public:
+  explicit FCountingMallocProxy(FMalloc* pInner) : _pInner(pInner) {}
+
+  virtual void* Malloc(SIZE_T Count, uint32 Alignment) override {
+    void* pResult = this->_pInner->Malloc(Count, Alignment);
+    this->RecordAllocation(pResult, Count);
+    return pResult;
+  }
+
+  virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override {
+    void* pResult = this->_pInner->TryMalloc(Count, Alignment);
+    this->RecordAllocation(pResult, Count);
+    return pResult;
+  }
+
+  virtual void*
+  Realloc(void* Original, SIZE_T Count, uint32 Alignment) override {
+    this->RecordFree(Original);
+    void* pResult = this->_pInner->Realloc(Original, Count, Alignment);
+    this->RecordAllocation(pResult, Count);
+    return pResult;
+  }
+
+  virtual void*
+  TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override {
+    this->RecordFree(Original);
+    void* pResult = this->_pInner->TryRealloc(Original, Count, Alignment);
+    this->RecordAllocation(pResult, Count);
+    return pResult;
+  }
+
+  virtual void Free(void* Original) override {
+    this->RecordFree(Original);
+    this->_pInner->Free(Original);
+  }
+
+  virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override {
+    return this->_pInner->QuantizeSize(Count, Alignment);
+  }
+
+  virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override {
+    return this->_pInner->GetAllocationSize(Original, SizeOut);
+  }
+
+  virtual void Trim(bool bTrimThreadCaches) override {
+    this->_pInner->Trim(bTrimThreadCaches);
+  }
+
+  virtual void SetupTLSCachesOnCurrentThread() override {
+    this->_pInner->SetupTLSCachesOnCurrentThread();
+  }
+
+  virtual void ClearAndDisableTLSCachesOnCurrentThread() override {
+    this->_pInner->ClearAndDisableTLSCachesOnCurrentThread();
+  }
+
+  virtual void InitializeStatsMetadata() override {
+    this->_pInner->InitializeStatsMetadata();
+  }
+
+  virtual void UpdateStats() override { this->_pInner->UpdateStats(); }
+
+  virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override {
+    this->_pInner->GetAllocatorStats(OutStats);
+  }
+
+  virtual void DumpAllocatorStats(FOutputDevice& Ar) override {
+    this->_pInner->DumpAllocatorStats(Ar);
+  }
+
+  virtual bool IsInternallyThreadSafe() const override {
+    return this->_pInner->IsInternallyThreadSafe();
+  }
+
+  virtual bool ValidateHeap() override { return this->_pInner->ValidateHeap(); }
+
+  virtual const TCHAR* GetDescriptiveName() override {
+    return this->_pInner->GetDescriptiveName();
+  }
+
+  virtual void OnMallocInitialized() override {
+    this->_pInner->OnMallocInitialized();
+  }
+
+  virtual void OnPreFork() override { this->_pInner->OnPreFork(); }
+
+  virtual void OnPostFork() override { this->_pInner->OnPostFork(); }
+
+private:
+  void RecordAllocation(void* pAllocation, SIZE_T requestedSize) {
+    CesiumAllocationCounter::Counters* pCounters = pCurrentCounters;
+    if (!pCounters || !pAllocation) {
+      return;
+    }
+
+    SIZE_T size = requestedSize;
+    this->_pInner->GetAllocationSize(pAllocation, size);
+
+    ++pCounters->allocations;
+    pCounters->allocatedBytes += int64(size);
+    pCounters->liveBytes += int64(size);
+    pCounters->peakLiveBytes =
+        std::max(pCounters->peakLiveBytes, pCounters->liveBytes);
+  }
+
+  void RecordFree(void* pAllocation) {
+    CesiumAllocationCounter::Counters* pCounters = pCurrentCounters;
+    if (!pCounters || !pAllocation) {
+      return;
+    }
+
+    SIZE_T size = 0;
+    if (this->_pInner->GetAllocationSize(pAllocation, size)) {
+      pCounters->liveBytes -= int64(size);
+    }
+  }
+
+  FMalloc* _pInner;
+};
+
+bool Installed = false;
+
+} // namespace
+
+/*static*/ void CesiumAllocationCounter::installIfRequested() {
+  if (Installed || !GMalloc ||
+      !FParse::Param(FCommandLine::Get(), TEXT("CesiumCountAllocations"))) {
+    return;
+  }
+
+  // The proxy is never destroyed, because GMalloc is never restored.
+  GMalloc = new FCountingMallocProxy(GMalloc);
+  Installed = true;
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Counting allocations for Cesium benchmarks."));
+}
+
+/*static*/ bool CesiumAllocationCounter::isInstalled() { return Installed; }
+
+/*static*/ CesiumAllocationCounter::Counters*
+CesiumAllocationCounter::setCurrent(Counters* pCounters) {
+  Counters* pPrevious = pCurrentCounters;
+  pCurrentCounters = pCounters;
+  return pPrevious;
+}
@@ -0,0 +1,45 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/Platform.h"
+
+/**
+ * Counts the allocations made by the threads that ask for it, so that
+ * benchmarks can attribute allocations to the code they measure.
+ *
+ * Counting needs a proxy in front of GMalloc. It is installed by the
+ * CesiumRuntime module when it starts up, if the command line has
+ * `-CesiumCountAllocations`, and is never removed, so that GMalloc does not
+ * change while other threads use it. Without the option, nothing is counted.
+ */
+class CesiumAllocationCounter {
+public:
+  /**
+   * Allocation counts and sizes attributed to one thread. Sizes come from
+   * the underlying allocator where it can report them, so they include its
+   * rounding.
+   */
+  struct Counters {
+    int64 allocations = 0;
+    int64 allocatedBytes = 0;
+    int64 liveBytes = 0;
+    int64 peakLiveBytes = 0;
+  };
+
+  /**
+   * Installs the counting proxy in front of GMalloc if the command line asks
+   * for it. Called once, when the CesiumRuntime module starts up.
+   */
+  static void installIfRequested();
+
+  /** Determines whether allocations are being counted. */
+  static bool isInstalled();
+
+  /**
+   * Counts the current thread's allocations in the given counters, or stops
+   * counting them if the given counters are nullptr. Returns the previous
+   * counters.
+   */
+  static Counters* setCurrent(Counters* pCounters);
+};
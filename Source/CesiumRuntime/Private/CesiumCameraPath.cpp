@@ -0,0 +1,249 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumCameraPath.h"
+#include "Camera/PlayerCameraManager.h"
+#include "CesiumCamera.h"
+#include "CesiumGeoreference.h"
+#include "CesiumRuntime.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace {
+
+const TCHAR* CameraPathHeader = TEXT(
+    "Time,Longitude,Latitude,Height,Pitch,Yaw,Roll,FieldOfView,ViewportWidth,ViewportHeight");
+
+/**
+ * Records the pose of the first player's camera in the first game or PIE
+ * world, once per frame.
+ */
+class CameraPathRecorder {
+public:
+  void start(const FString& filename) {
+    if (this->_tickerHandle.IsValid()) {
+      this->stop();
+    }
+
+    this->_filename = filename;
+    this->_path.frames.Empty();
+    this->_time = 0.0;
+    this->_tickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateRaw(this, &CameraPathRecorder::tick));
+
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT("Recording camera path to %s"),
+        *this->_filename);
+  }
+
+  void stop() {
+    if (!this->_tickerHandle.IsValid()) {
+      UE_LOG(LogCesium, Warning, TEXT("No camera path is being recorded."));
+      return;
+    }
+
+    FTSTicker::GetCoreTicker().RemoveTicker(this->_tickerHandle);
+    this->_tickerHandle.Reset();
+
+    if (this->_path.save(this->_filename)) {
+      UE_LOG(
+          LogCesium,
+          Display,
+          TEXT("Wrote %d camera path frames to %s"),
+          this->_path.frames.Num(),
+          *this->_filename);
+    } else {
+      UE_LOG(
+          LogCesium,
+          Error,
+          TEXT("Could not write camera path to %s"),
+          *this->_filename);
+    }
+  }
+
+private:
+  bool tick(float deltaTime) {
+    UWorld* pWorld = nullptr;
+    for (const FWorldContext& context : GEngine->GetWorldContexts()) {
+      UWorld* pContextWorld = context.World();
+      if (pContextWorld && pContextWorld->IsGameWorld()) {
+        pWorld = pContextWorld;
+        break;
+      }
+    }
+
+    APlayerController* pController =
+        pWorld ? pWorld->GetFirstPlayerController() : nullptr;
+    if (!pController || !pController->PlayerCameraManager) {
+      return true;
+    }
+
+    ACesiumGeoreference* pGeoreference =
+        ACesiumGeoreference::GetDefaultGeoreference(pWorld);
+    if (!pGeoreference) {
+      return true;
+    }
+
+    FVector location;
+    FRotator rotation;
+    pController->GetPlayerViewPoint(location, rotation);
+
+    // The georeference transformations expect coordinates relative to the
+    // georeference's parent frame rather than the world.
+    const FTransform& georeferenceTransform =
+        pGeoreference->GetActorTransform();
+    FVector relativeLocation =
+        georeferenceTransform.InverseTransformPosition(location);
+    FRotator relativeRotation =
+        georeferenceTransform.InverseTransformRotation(rotation.Quaternion())
+            .Rotator();
+
+    int32 sizeX, sizeY;
+    pController->GetViewportSize(sizeX, sizeY);
+
+    CesiumCameraPathFrame& frame = this->_path.frames.Emplace_GetRef();
+    frame.time = this->_time;
+    frame.longitudeLatitudeHeight =
+        pGeoreference->TransformUnrealPositionToLongitudeLatitudeHeight(
+            relativeLocation);
+    frame.eastSouthUpRotation =
+        pGeoreference->TransformUnrealRotatorToEastSouthUp(
+            relativeRotation,
+            relativeLocation);
+    frame.fieldOfViewDegrees = pController->PlayerCameraManager->GetFOVAngle();
+    frame.viewportSize = FVector2D(sizeX, sizeY);
+
+    this->_time += deltaTime;
+    return true;
+  }
+
+  FString _filename;
+  CesiumCameraPath _path;
+  double _time = 0.0;
+  FTSTicker::FDelegateHandle _tickerHandle;
+};
+
+CameraPathRecorder recorder;
+
+FAutoConsoleCommand RecordCameraPathCommand(
+    TEXT("cesium.camerapath.record"),
+    TEXT(
+        "Starts recording the first player's camera to a camera path file. The optional argument is the path of the file, which defaults to Saved/Cesium/CameraPath.csv."),
+    FConsoleCommandWithArgsDelegate::CreateLambda(
+        [](const TArray<FString>& args) {
+          recorder.start(
+              args.Num() > 0 ? args[0]
+                             : FPaths::Combine(
+                                   FPaths::ProjectSavedDir(),
+                                   TEXT("Cesium"),
+                                   TEXT("CameraPath.csv")));
+        }));
+
+FAutoConsoleCommand StopCameraPathCommand(
+    TEXT("cesium.camerapath.stop"),
+    TEXT("Stops recording a camera path and writes it to its file."),
+    FConsoleCommandDelegate::CreateLambda([]() { recorder.stop(); }));
+
+} // namespace
+
+bool CesiumCameraPath::save(const FString& filename) const {
+  return FFileHelper::SaveStringToFile(this->toString(), *filename);
+}
+
+/*static*/ std::optional<CesiumCameraPath>
+CesiumCameraPath::load(const FString& filename) {
+  FString text;
+  if (!FFileHelper::LoadFileToString(text, *filename)) {
+    return std::nullopt;
+  }
+
+  return CesiumCameraPath::fromString(text);
+}
+
+FString CesiumCameraPath::toString() const {
+  FString result = CameraPathHeader;
+  result += TEXT("\n");
+
+  for (const CesiumCameraPathFrame& frame : this->frames) {
+    result += FString::Printf(
+        TEXT("%.6f,%.12f,%.12f,%.6f,%.6f,%.6f,%.6f,%.6f,%.0f,%.0f\n"),
+        frame.time,
+        frame.longitudeLatitudeHeight.X,
+        frame.longitudeLatitudeHeight.Y,
+        frame.longitudeLatitudeHeight.Z,
+        frame.eastSouthUpRotation.Pitch,
+        frame.eastSouthUpRotation.Yaw,
+        frame.eastSouthUpRotation.Roll,
+        frame.fieldOfViewDegrees,
+        frame.viewportSize.X,
+        frame.viewportSize.Y);
+  }
+
+  return result;
+}
+
+/*static*/ std::optional<CesiumCameraPath>
+CesiumCameraPath::fromString(const FString& text) {
+  TArray<FString> lines;
+  text.ParseIntoArrayLines(lines);
+
+  if (lines.Num() == 0 || lines[0].TrimStartAndEnd() != CameraPathHeader) {
+    return std::nullopt;
+  }
+
+  CesiumCameraPath path;
+  path.frames.Reserve(lines.Num() - 1);
+
+  for (int32 i = 1; i < lines.Num(); ++i) {
+    TArray<FString> values;
+    lines[i].ParseIntoArray(values, TEXT(","));
+    if (values.Num() == 0) {
+      continue;
+    }
+    if (values.Num() != 10) {
+      return std::nullopt;
+    }
+
+    CesiumCameraPathFrame& frame = path.frames.Emplace_GetRef();
+    frame.time = FCString::Atod(*values[0]);
+    frame.longitudeLatitudeHeight = FVector(
+        FCString::Atod(*values[1]),
+        FCString::Atod(*values[2]),
+        FCString::Atod(*values[3]));
+    frame.eastSouthUpRotation = FRotator(
+        FCString::Atod(*values[4]),
+        FCString::Atod(*values[5]),
+        FCString::Atod(*values[6]));
+    frame.fieldOfViewDegrees = FCString::Atod(*values[7]);
+    frame.viewportSize =
+        FVector2D(FCString::Atod(*values[8]), FCString::Atod(*values[9]));
+  }
+
+  return path;
+}
+
+/*static*/ FCesiumCamera CesiumCameraPath::toCamera(
+    const CesiumCameraPathFrame& frame,
+    const ACesiumGeoreference& georeference) {
+  const FTransform& georeferenceTransform = georeference.GetActorTransform();
+
+  FVector relativeLocation =
+      georeference.TransformLongitudeLatitudeHeightPositionToUnreal(
+          frame.longitudeLatitudeHeight);
+  FRotator relativeRotation = georeference.TransformEastSouthUpRotatorToUnreal(
+      frame.eastSouthUpRotation,
+      relativeLocation);
+
+  return FCesiumCamera(
+      frame.viewportSize,
+      georeferenceTransform.TransformPosition(relativeLocation),
+      georeferenceTransform.TransformRotation(relativeRotation.Quaternion())
+          .Rotator(),
+      frame.fieldOfViewDegrees);
+}
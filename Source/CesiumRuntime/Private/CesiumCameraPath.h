@@ -0,0 +1,76 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "Math/MathFwd.h"
+#include "Math/Rotator.h"
+#include "Math/Vector.h"
+#include "Math/Vector2D.h"
+#include <optional>
+
+class ACesiumGeoreference;
+struct FCesiumCamera;
+
+/**
+ * A single camera pose in a recorded camera path.
+ */
+struct CesiumCameraPathFrame {
+  /** The time since the start of the recording, in seconds. */
+  double time = 0.0;
+
+  /** The longitude and latitude in degrees, and the height in meters. */
+  FVector longitudeLatitudeHeight = FVector::ZeroVector;
+
+  /** The rotation relative to the local East-South-Up frame. */
+  FRotator eastSouthUpRotation = FRotator::ZeroRotator;
+
+  /** The horizontal field of view in degrees. */
+  double fieldOfViewDegrees = 90.0;
+
+  /** The pixel dimensions of the viewport. */
+  FVector2D viewportSize = FVector2D(1920.0, 1080.0);
+};
+
+/**
+ * A camera path that can be recorded from a running game and replayed later,
+ * for example by a benchmark. Poses are stored in globe coordinates, so a
+ * path can be replayed in a world with a different georeference origin.
+ *
+ * Paths are stored as CSV text with one frame per line. Camera paths can be
+ * recorded with the `cesium.camerapath.record` and `cesium.camerapath.stop`
+ * console commands.
+ */
+struct CesiumCameraPath {
+  TArray<CesiumCameraPathFrame> frames;
+
+  /**
+   * Writes this path to a file, returning false if the file could not be
+   * written.
+   */
+  bool save(const FString& filename) const;
+
+  /**
+   * Reads a path from a file, or returns std::nullopt if the file could not
+   * be read or is not a camera path.
+   */
+  static std::optional<CesiumCameraPath> load(const FString& filename);
+
+  /** Converts this path to the text written by `save`. */
+  FString toString() const;
+
+  /**
+   * Parses the text written by `save`, or returns std::nullopt if it is not a
+   * camera path.
+   */
+  static std::optional<CesiumCameraPath> fromString(const FString& text);
+
+  /**
+   * Creates the FCesiumCamera for the given frame, in the Unreal coordinates
+   * of the given georeference.
+   */
+  static FCesiumCamera toCamera(
+      const CesiumCameraPathFrame& frame,
+      const ACesiumGeoreference& georeference);
+};
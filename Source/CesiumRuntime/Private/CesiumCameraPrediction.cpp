@@ -0,0 +1,100 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumCameraPrediction.h"
+#include "CesiumRuntime.h"
+#include <cmath>
+
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Predicted Camera Views"),
+    STAT_CesiumPredictedCameraViews,
+    STATGROUP_Cesium);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Camera Prediction Divergences"),
+    STAT_CesiumCameraPredictionDivergences,
+    STATGROUP_Cesium);
+
+namespace {
+
+// The time constant, in seconds, over which a camera's velocity is smoothed.
+constexpr double VelocitySmoothingSeconds = 0.25;
+
+// How long a camera must move steadily before it is predicted, in seconds.
+constexpr double MinimumSteadySeconds = 0.25;
+
+// The largest change in speed, relative to the smoothed speed, that is still
+// considered steady.
+constexpr double SpeedTolerance = 0.5;
+
+} // namespace
+
+std::vector<FCesiumCamera> CesiumCameraPrediction::update(
+    const std::vector<FCesiumCamera>& cameras,
+    double deltaTime,
+    const Options& options) {
+  // The cameras are only identified by their order, so start over when they
+  // are added or removed.
+  if (cameras.size() != this->_tracks.size()) {
+    this->_tracks.clear();
+    for (const FCesiumCamera& camera : cameras) {
+      this->_tracks.push_back(Track{camera.Location, FVector::ZeroVector, 0.0});
+    }
+    return {};
+  }
+
+  if (deltaTime <= 0.0) {
+    return {};
+  }
+
+  const double minimumCosine =
+      std::cos(FMath::DegreesToRadians(options.divergenceDegrees));
+  const double smoothing =
+      1.0 - std::exp(-deltaTime / VelocitySmoothingSeconds);
+
+  std::vector<FCesiumCamera> predictions;
+  for (size_t i = 0; i < cameras.size(); ++i) {
+    const FCesiumCamera& camera = cameras[i];
+    Track& track = this->_tracks[i];
+
+    const FVector velocity = (camera.Location - track.location) / deltaTime;
+    track.location = camera.Location;
+
+    const double speed = velocity.Length();
+    const double smoothedSpeed = track.velocity.Length();
+    bool diverged = false;
+    if (smoothedSpeed >= options.minimumSpeed) {
+      diverged = speed <= 0.0 ||
+                 FVector::DotProduct(velocity, track.velocity) <
+                     minimumCosine * speed * smoothedSpeed ||
+                 std::abs(speed - smoothedSpeed) >
+                     SpeedTolerance * smoothedSpeed;
+    }
+
+    if (diverged) {
+      if (track.steadySeconds >= MinimumSteadySeconds) {
+        ++this->_divergenceCount;
+        INC_DWORD_STAT(STAT_CesiumCameraPredictionDivergences);
+      }
+      track.velocity = velocity;
+      track.steadySeconds = 0.0;
+      continue;
+    }
+
+    track.velocity += (velocity - track.velocity) * smoothing;
+    track.steadySeconds += deltaTime;
+
+    if (track.steadySeconds < MinimumSteadySeconds ||
+        track.velocity.Length() < options.minimumSpeed) {
+      continue;
+    }
+
+    FCesiumCamera& prediction = predictions.emplace_back(camera);
+    prediction.Location += track.velocity * options.predictionSeconds;
+    prediction.ViewportSize *= options.resolution;
+  }
+
+  INC_DWORD_STAT_BY(STAT_CesiumPredictedCameraViews, predictions.size());
+
+  return predictions;
+}
+
+void CesiumCameraPrediction::reset() { this->_tracks.clear(); }
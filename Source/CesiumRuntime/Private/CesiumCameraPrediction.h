@@ -0,0 +1,77 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumCamera.h"
+#include <vector>
+
+/**
+ * Predicts where cameras will be a short time from now by extrapolating
+ * their recent motion, so that a tileset can start loading the tiles they
+ * will need before they get there.
+ *
+ * Each camera's velocity is smoothed over a few frames. When a camera turns
+ * or changes speed by more than a tolerance, its prediction is dropped until
+ * its motion is steady again, so that the tileset stops selecting, and
+ * therefore stops loading, the tiles of a place the camera is no longer
+ * going to.
+ */
+class CesiumCameraPrediction {
+public:
+  struct Options {
+    /** How far ahead to predict each camera, in seconds. */
+    double predictionSeconds = 2.0;
+
+    /**
+     * The fraction of each camera's viewport size to give its predicted
+     * view, so that the tiles it needs are loaded in less detail than the
+     * camera's own.
+     */
+    double resolution = 0.5;
+
+    /**
+     * The angle in degrees by which a camera's direction of motion may
+     * change from its smoothed direction before its prediction is dropped.
+     */
+    double divergenceDegrees = 20.0;
+
+    /**
+     * The slowest speed, in Unreal units per second, at which a camera is
+     * predicted. Slower cameras do not move far enough to need a prediction.
+     */
+    double minimumSpeed = 500.0;
+  };
+
+  /**
+   * Updates the motion of the cameras and gets the predicted views of the
+   * ones that are moving steadily.
+   *
+   * @param cameras The cameras to predict, in the same order every frame.
+   * @param deltaTime The time since the previous update, in seconds.
+   * @param options The options for the prediction.
+   * @return The predicted views, which may be fewer than the cameras.
+   */
+  std::vector<FCesiumCamera> update(
+      const std::vector<FCesiumCamera>& cameras,
+      double deltaTime,
+      const Options& options);
+
+  /** Forgets the motion of every camera. */
+  void reset();
+
+  /**
+   * Gets the number of times a camera's motion has diverged from its
+   * prediction since this instance was created.
+   */
+  int64 getDivergenceCount() const { return this->_divergenceCount; }
+
+private:
+  struct Track {
+    FVector location;
+    FVector velocity;
+    double steadySeconds;
+  };
+
+  std::vector<Track> _tracks;
+  int64 _divergenceCount = 0;
+};
@@ -1,17 +1,30 @@
 // Copyright 2020-2024 CesiumGS, Inc. and Contributors
 
 #include "CesiumFlyToComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "CesiumCameraManager.h"
 #include "CesiumGeoreference.h"
 #include "CesiumGlobeAnchorComponent.h"
 #include "CesiumWgs84Ellipsoid.h"
 #include "Curves/CurveFloat.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
 #include "UObject/ConstructorHelpers.h"
 #include "VecMath.h"
 
+#include <algorithm>
+#include <cmath>
 #include <glm/gtx/quaternion.hpp>
 
+namespace {
+
+// The smallest fraction of the full resolution at which a virtual camera
+// loads tiles, however far ahead it is.
+constexpr double MinimumPrefetchResolution = 0.1;
+
+} // namespace
+
 UCesiumFlyToComponent::UCesiumFlyToComponent() {
   // Structure to hold one-time initialization
   struct FConstructorStatics {
@@ -155,6 +168,7 @@ void UCesiumFlyToComponent::FlyToLocationUnreal(
 
 void UCesiumFlyToComponent::InterruptFlight() {
   this->_flightInProgress = false;
+  this->RemovePrefetchCameras();
 
   UCesiumGlobeAnchorComponent* GlobeAnchor = this->GetGlobeAnchor();
   if (IsValid(GlobeAnchor)) {
@@ -196,20 +210,7 @@ void UCesiumFlyToComponent::TickComponent(
 
   this->_currentFlyTime += DeltaTime;
 
-  // In order to accelerate at start and slow down at end, we use a progress
-  // profile curve
-  float flyPercentage;
-  if (this->_currentFlyTime >= this->Duration) {
-    flyPercentage = 1.0f;
-  } else if (this->ProgressCurve) {
-    flyPercentage = glm::clamp(
-        this->ProgressCurve->GetFloatValue(
-            this->_currentFlyTime / this->Duration),
-        0.0f,
-        1.0f);
-  } else {
-    flyPercentage = this->_currentFlyTime / this->Duration;
-  }
+  float flyPercentage = this->ComputeFlyPercentage(this->_currentFlyTime);
 
   // If we reached the end, set actual destination location and
   // orientation
@@ -220,6 +221,7 @@ void UCesiumFlyToComponent::TickComponent(
     this->SetCurrentRotationEastSouthUp(this->_destinationRotation);
     this->_flightInProgress = false;
     this->_currentFlyTime = 0.0f;
+    this->RemovePrefetchCameras();
 
     // Trigger callback accessible from BP
     UE_LOG(LogCesium, Verbose, TEXT("Broadcasting OnFlightComplete"));
@@ -228,25 +230,9 @@ void UCesiumFlyToComponent::TickComponent(
     return;
   }
 
-  // Get altitude offset from profile curve if one is specified
-  double altitudeOffset = 0.0;
-  if (this->_maxHeight != 0.0 && this->HeightPercentageCurve) {
-    double curveOffset =
-        this->_maxHeight *
-        this->HeightPercentageCurve->GetFloatValue(flyPercentage);
-    altitudeOffset = curveOffset;
-  }
-
-  glm::dvec3 currentPositionEcef =
-      _currentCurve->getPosition(flyPercentage, altitudeOffset);
-
-  FVector currentPositionVector(
-      currentPositionEcef.x,
-      currentPositionEcef.y,
-      currentPositionEcef.z);
-
   // Set Location
-  GlobeAnchor->MoveToEarthCenteredEarthFixedPosition(currentPositionVector);
+  GlobeAnchor->MoveToEarthCenteredEarthFixedPosition(
+      this->ComputePositionEarthCenteredEarthFixed(flyPercentage));
 
   // Interpolate rotation in the ESU frame. The local ESU ControlRotation will
   // be transformed to the appropriate world rotation as we fly.
@@ -258,6 +244,13 @@ void UCesiumFlyToComponent::TickComponent(
 
   this->_previousPositionEcef =
       GlobeAnchor->GetEarthCenteredEarthFixedPosition();
+
+  this->UpdatePrefetchCameras();
+}
+
+void UCesiumFlyToComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+  this->RemovePrefetchCameras();
+  Super::EndPlay(EndPlayReason);
 }
 
 FQuat UCesiumFlyToComponent::GetCurrentRotationEastSouthUp() {
@@ -316,3 +309,151 @@ void UCesiumFlyToComponent::SetCurrentRotationEastSouthUp(
     this->GetGlobeAnchor()->SetEastSouthUpRotation(EastSouthUpRotation);
   }
 }
+
+float UCesiumFlyToComponent::ComputeFlyPercentage(float FlyTime) const {
+  // In order to accelerate at start and slow down at end, we use a progress
+  // profile curve
+  if (FlyTime >= this->Duration) {
+    return 1.0f;
+  } else if (this->ProgressCurve) {
+    return glm::clamp(
+        this->ProgressCurve->GetFloatValue(FlyTime / this->Duration),
+        0.0f,
+        1.0f);
+  } else {
+    return FlyTime / this->Duration;
+  }
+}
+
+FVector UCesiumFlyToComponent::ComputePositionEarthCenteredEarthFixed(
+    float FlyPercentage) const {
+  // Get altitude offset from profile curve if one is specified
+  double altitudeOffset = 0.0;
+  if (this->_maxHeight != 0.0 && this->HeightPercentageCurve) {
+    altitudeOffset = this->_maxHeight *
+                     this->HeightPercentageCurve->GetFloatValue(FlyPercentage);
+  }
+
+  glm::dvec3 positionEcef =
+      this->_currentCurve->getPosition(FlyPercentage, altitudeOffset);
+  return FVector(positionEcef.x, positionEcef.y, positionEcef.z);
+}
+
+TArray<FCesiumCamera> UCesiumFlyToComponent::CreatePrefetchCameras() {
+  TArray<FCesiumCamera> cameras;
+
+  UCesiumGlobeAnchorComponent* GlobeAnchor = this->GetGlobeAnchor();
+  ACesiumGeoreference* Georeference =
+      IsValid(GlobeAnchor) ? GlobeAnchor->ResolveGeoreference() : nullptr;
+  if (!IsValid(Georeference)) {
+    return cameras;
+  }
+
+  // Look ahead with the player's view if there is one.
+  double fieldOfViewDegrees = 90.0;
+  FVector2D viewportSize(1920.0, 1080.0);
+  const APawn* Pawn = Cast<APawn>(this->GetOwner());
+  const APlayerController* PlayerController =
+      IsValid(Pawn) ? Cast<APlayerController>(Pawn->Controller) : nullptr;
+  if (IsValid(PlayerController)) {
+    if (IsValid(PlayerController->PlayerCameraManager)) {
+      fieldOfViewDegrees = PlayerController->PlayerCameraManager->GetFOVAngle();
+    }
+    int32 sizeX = 0;
+    int32 sizeY = 0;
+    PlayerController->GetViewportSize(sizeX, sizeY);
+    if (sizeX > 0 && sizeY > 0) {
+      viewportSize = FVector2D(sizeX, sizeY);
+    }
+  }
+
+  const FTransform& georeferenceTransform = Georeference->GetActorTransform();
+  const int32 cameraCount = std::max(this->PrefetchCameraCount, 1);
+  const float timeRemaining = this->Duration - this->_currentFlyTime;
+
+  for (int32 i = 1; i <= cameraCount; ++i) {
+    // Once the look-ahead time reaches past the end of the flight, the
+    // remaining cameras would all sit at the destination, so place only one.
+    const float timeAhead = std::min(
+        this->PrefetchLookAheadSeconds * float(i) / float(cameraCount),
+        timeRemaining);
+    const float flyPercentage =
+        this->ComputeFlyPercentage(this->_currentFlyTime + timeAhead);
+
+    // The further ahead the point is, the less detail it needs now: the
+    // Actor's view will load more as it approaches.
+    double resolution = 1.0;
+    if (this->PrefetchResolutionHalfLifeSeconds > 0.0f) {
+      resolution = std::max(
+          std::pow(0.5, timeAhead / this->PrefetchResolutionHalfLifeSeconds),
+          MinimumPrefetchResolution);
+    }
+
+    const FVector relativeLocation =
+        Georeference->TransformEarthCenteredEarthFixedPositionToUnreal(
+            this->ComputePositionEarthCenteredEarthFixed(flyPercentage));
+    const FRotator relativeRotation =
+        Georeference->TransformEastSouthUpRotatorToUnreal(
+            FQuat::Slerp(
+                this->_sourceRotation,
+                this->_destinationRotation,
+                flyPercentage)
+                .Rotator(),
+            relativeLocation);
+
+    cameras.Emplace(
+        viewportSize * resolution,
+        georeferenceTransform.TransformPosition(relativeLocation),
+        georeferenceTransform.TransformRotation(relativeRotation.Quaternion())
+            .Rotator(),
+        fieldOfViewDegrees);
+
+    if (timeAhead >= timeRemaining) {
+      break;
+    }
+  }
+
+  return cameras;
+}
+
+void UCesiumFlyToComponent::UpdatePrefetchCameras() {
+  if (!this->PrefetchAlongPath) {
+    this->RemovePrefetchCameras();
+    return;
+  }
+
+  ACesiumCameraManager* pCameraManager = this->_pPrefetchCameraManager.Get();
+  if (!pCameraManager) {
+    pCameraManager = ACesiumCameraManager::GetDefaultCameraManager(this);
+    if (!IsValid(pCameraManager)) {
+      return;
+    }
+    this->_pPrefetchCameraManager = pCameraManager;
+    this->_prefetchCameraIds.Empty();
+  }
+
+  const TArray<FCesiumCamera> cameras = this->CreatePrefetchCameras();
+
+  for (int32 i = 0; i < cameras.Num(); ++i) {
+    if (i < this->_prefetchCameraIds.Num()) {
+      pCameraManager->UpdateCamera(this->_prefetchCameraIds[i], cameras[i]);
+    } else {
+      this->_prefetchCameraIds.Add(pCameraManager->AddCamera(cameras[i]));
+    }
+  }
+
+  while (this->_prefetchCameraIds.Num() > cameras.Num()) {
+    pCameraManager->RemoveCamera(this->_prefetchCameraIds.Pop());
+  }
+}
+
+void UCesiumFlyToComponent::RemovePrefetchCameras() {
+  if (ACesiumCameraManager* pCameraManager =
+          this->_pPrefetchCameraManager.Get()) {
+    for (int32 cameraId : this->_prefetchCameraIds) {
+      pCameraManager->RemoveCamera(cameraId);
+    }
+  }
+  this->_prefetchCameraIds.Empty();
+  this->_pPrefetchCameraManager = nullptr;
+}
@@ -9,6 +9,7 @@
 #include "CesiumGltfPointsComponent.h"
 #include "CesiumGltfPrimitiveComponent.h"
 #include "CesiumMaterialUserData.h"
+#include "CesiumMeshBuildStage.h"
 #include "CesiumRasterOverlays.h"
 #include "CesiumRuntime.h"
 #include "CesiumTextureUtility.h"
@@ -61,6 +62,7 @@
 #include <glm/mat3x3.hpp>
 #include <iostream>
 #include <type_traits>
+#include <unordered_set>
 
 #if WITH_EDITOR
 #include "ScopedTransaction.h"
@@ -1325,6 +1327,7 @@ static void loadPrimitive(
   if (primitive.mode == MeshPrimitive::Mode::TRIANGLES ||
       primitive.mode == MeshPrimitive::Mode::POINTS) {
     TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::CopyIndices)
+    CesiumMeshBuildStageScope stage(CesiumMeshBuildStage::CopyIndices);
     indices.SetNum(static_cast<TArray<uint32>::SizeType>(indicesView.size()));
 
     for (int32 i = 0; i < indicesView.size(); ++i) {
@@ -1333,6 +1336,7 @@ static void loadPrimitive(
   } else {
     // assume TRIANGLE_STRIP because all others are rejected earlier.
     TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::CopyIndices)
+    CesiumMeshBuildStageScope stage(CesiumMeshBuildStage::CopyIndices);
     indices.SetNum(
         static_cast<TArray<uint32>::SizeType>(3 * (indicesView.size() - 2)));
     for (int32 i = 0; i < indicesView.size() - 2; ++i) {
@@ -1362,9 +1366,15 @@ static void loadPrimitive(
       duplicateVertices ? indices.Num()
                         : static_cast<int>(positionView.size()));
 
+  if (ICesiumMeshBuildObserver* pObserver =
+          ICesiumMeshBuildObserver::getCurrent()) {
+    pObserver->onPrimitive(StaticMeshBuildVertices.Num());
+  }
+
   {
     if (duplicateVertices) {
       TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::CopyDuplicatedPositions)
+      CesiumMeshBuildStageScope stage(CesiumMeshBuildStage::CopyPositions);
       for (int i = 0; i < indices.Num(); ++i) {
         FStaticMeshBuildVertex& vertex = StaticMeshBuildVertices[i];
         uint32 vertexIndex = indices[i];
@@ -1380,6 +1390,7 @@ static void loadPrimitive(
       }
     } else {
       TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::CopyPositions)
+      CesiumMeshBuildStageScope stage(CesiumMeshBuildStage::CopyPositions);
       for (int i = 0; i < StaticMeshBuildVertices.Num(); ++i) {
         FStaticMeshBuildVertex& vertex = StaticMeshBuildVertices[i];
         const TMeshVector3& pos = positionView[i];
@@ -1565,6 +1576,7 @@ static void loadPrimitive(
       setUniformNormals(StaticMeshBuildVertices, upDir);
     } else {
       TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::ComputeFlatNormals)
+      CesiumMeshBuildStageScope stage(CesiumMeshBuildStage::ComputeFlatNormals);
       computeFlatNormals(StaticMeshBuildVertices);
     }
   }
@@ -1603,11 +1615,13 @@ static void loadPrimitive(
     // Use mikktspace to calculate the tangents.
     // Note that this assumes normals and UVs are already populated.
     TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::ComputeTangents)
+    CesiumMeshBuildStageScope stage(CesiumMeshBuildStage::ComputeTangents);
     computeTangentSpace(StaticMeshBuildVertices);
   }
 
   {
     TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::InitBuffers)
+    CesiumMeshBuildStageScope stage(CesiumMeshBuildStage::InitBuffers);
 
     // Set to full precision (32-bit) UVs. This is especially important for
     // metadata because integer feature IDs can and will lose meaningful
@@ -1675,6 +1689,7 @@ static void loadPrimitive(
       options.pMeshOptions->pNodeOptions->pModelOptions->createPhysicsMeshes) {
     if (StaticMeshBuildVertices.Num() != 0 && indices.Num() != 0) {
       TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::ChaosCook)
+      CesiumMeshBuildStageScope stage(CesiumMeshBuildStage::ChaosCook);
       primitiveResult.pCollisionMesh =
           StaticMeshBuildVertices.Num() < TNumericLimits<uint16>::Max()
               ? BuildChaosTriangleMeshes<uint16>(
@@ -2211,6 +2226,207 @@ loadModelMetadata(LoadModelResult& result, const CreateModelOptions& options) {
   PRAGMA_ENABLE_DEPRECATION_WARNINGS
 }
 
+namespace {
+
+using CesiumTextureUtility::ReferenceCountedUnrealTexture;
+using TextureSet = std::unordered_set<const ReferenceCountedUnrealTexture*>;
+
+void addTextureMemoryUsage(
+    CesiumMemoryUsage& usage,
+    TextureSet& countedTextures,
+    const CesiumTextureUtility::LoadedTextureResult* pLoadedTexture,
+    bool encodesMetadata) {
+  if (!pLoadedTexture || !pLoadedTexture->pTexture) {
+    return;
+  }
+
+  // The same texture may be used by multiple primitives in this model.
+  if (!countedTextures.insert(pLoadedTexture->pTexture.get()).second) {
+    return;
+  }
+
+  int64 sizeBytes = pLoadedTexture->pTexture->getSizeBytes();
+  if (encodesMetadata) {
+    usage.metadataTextureBytes += sizeBytes;
+  } else {
+    usage.textureBytes[pLoadedTexture->group] += sizeBytes;
+  }
+}
+
+void addPrimitiveMemoryUsage(
+    CesiumMemoryUsage& usage,
+    TextureSet& countedTextures,
+    const LoadPrimitiveResult& primitive) {
+  if (primitive.RenderData) {
+    for (const FStaticMeshLODResources& lod :
+         primitive.RenderData->LODResources) {
+      const FStaticMeshVertexBuffers& vertexBuffers = lod.VertexBuffers;
+      usage.vertexBufferBytes +=
+          int64(vertexBuffers.PositionVertexBuffer.GetNumVertices()) *
+              vertexBuffers.PositionVertexBuffer.GetStride() +
+          int64(vertexBuffers.StaticMeshVertexBuffer.GetResourceSize()) +
+          int64(vertexBuffers.ColorVertexBuffer.GetNumVertices()) *
+              vertexBuffers.ColorVertexBuffer.GetStride();
+      usage.indexBufferBytes += int64(lod.IndexBuffer.GetIndexDataSize());
+    }
+  }
+
+  if (primitive.pCollisionMesh) {
+    // This ignores the acceleration structure, so it is only an estimate.
+    const Chaos::FTrimeshIndexBuffer& elements =
+        primitive.pCollisionMesh->Elements();
+    int64 indexSize =
+        elements.RequiresLargeIndices() ? sizeof(int32) : sizeof(uint16);
+    usage.collisionBytes +=
+        int64(primitive.pCollisionMesh->Particles().Size()) *
+            sizeof(Chaos::FVec3f) +
+        int64(elements.GetNumTriangles()) * 3 * indexSize;
+  }
+
+  addTextureMemoryUsage(
+      usage,
+      countedTextures,
+      primitive.baseColorTexture.Get(),
+      false);
+  addTextureMemoryUsage(
+      usage,
+      countedTextures,
+      primitive.metallicRoughnessTexture.Get(),
+      false);
+  addTextureMemoryUsage(
+      usage,
+      countedTextures,
+      primitive.normalTexture.Get(),
+      false);
+  addTextureMemoryUsage(
+      usage,
+      countedTextures,
+      primitive.emissiveTexture.Get(),
+      false);
+  addTextureMemoryUsage(
+      usage,
+      countedTextures,
+      primitive.occlusionTexture.Get(),
+      false);
+  addTextureMemoryUsage(
+      usage,
+      countedTextures,
+      primitive.waterMaskTexture.Get(),
+      false);
+
+  for (const CesiumEncodedFeaturesMetadata::EncodedFeatureIdSet& featureIdSet :
+       primitive.EncodedFeatures.featureIdSets) {
+    if (featureIdSet.texture) {
+      addTextureMemoryUsage(
+          usage,
+          countedTextures,
+          featureIdSet.texture->pTexture.Get(),
+          true);
+    }
+  }
+
+  PRAGMA_DISABLE_DEPRECATION_WARNINGS
+  if (primitive.EncodedMetadata_DEPRECATED) {
+    for (const CesiumEncodedMetadataUtility::EncodedFeatureIdTexture&
+             featureIdTexture :
+         primitive.EncodedMetadata_DEPRECATED->encodedFeatureIdTextures) {
+      addTextureMemoryUsage(
+          usage,
+          countedTextures,
+          featureIdTexture.pTexture.Get(),
+          true);
+    }
+  }
+  PRAGMA_ENABLE_DEPRECATION_WARNINGS
+}
+
+/**
+ * Computes the memory that will be used by the renderer resources created
+ * from this load result, so that it can be tracked per tileset once the
+ * resources are created on the game thread.
+ */
+CesiumMemoryUsage
+computeMemoryUsage(const Model& model, const LoadModelResult& result) {
+  TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::ComputeMemoryUsage)
+
+  CesiumMemoryUsage usage;
+  TextureSet countedTextures;
+
+  for (const LoadNodeResult& node : result.nodeResults) {
+    if (node.meshResult) {
+      for (const LoadPrimitiveResult& primitive :
+           node.meshResult->primitiveResults) {
+        addPrimitiveMemoryUsage(usage, countedTextures, primitive);
+      }
+    }
+  }
+
+  for (const CesiumEncodedFeaturesMetadata::EncodedPropertyTable&
+           propertyTable : result.EncodedMetadata.propertyTables) {
+    for (const CesiumEncodedFeaturesMetadata::EncodedPropertyTableProperty&
+             property : propertyTable.properties) {
+      addTextureMemoryUsage(
+          usage,
+          countedTextures,
+          property.pTexture.Get(),
+          true);
+    }
+  }
+
+  for (const CesiumEncodedFeaturesMetadata::EncodedPropertyTexture&
+           propertyTexture : result.EncodedMetadata.propertyTextures) {
+    for (const CesiumEncodedFeaturesMetadata::EncodedPropertyTextureProperty&
+             property : propertyTexture.properties) {
+      addTextureMemoryUsage(
+          usage,
+          countedTextures,
+          property.pTexture.Get(),
+          true);
+    }
+  }
+
+  PRAGMA_DISABLE_DEPRECATION_WARNINGS
+  if (result.EncodedMetadata_DEPRECATED) {
+    for (const auto& featureTableIt :
+         result.EncodedMetadata_DEPRECATED->encodedFeatureTables) {
+      for (const CesiumEncodedMetadataUtility::EncodedMetadataProperty&
+               property : featureTableIt.Value.encodedProperties) {
+        addTextureMemoryUsage(
+            usage,
+            countedTextures,
+            property.pTexture.Get(),
+            true);
+      }
+    }
+
+    for (const auto& featureTextureIt :
+         result.EncodedMetadata_DEPRECATED->encodedFeatureTextures) {
+      for (const CesiumEncodedMetadataUtility::EncodedFeatureTextureProperty&
+               property : featureTextureIt.Value.properties) {
+        addTextureMemoryUsage(
+            usage,
+            countedTextures,
+            property.pTexture.Get(),
+            true);
+      }
+    }
+  }
+  PRAGMA_ENABLE_DEPRECATION_WARNINGS
+
+  // Pixel data that was handed off to the renderer has already been cleared,
+  // so this is what the model will continue to hold on the CPU.
+  for (const Buffer& buffer : model.buffers) {
+    usage.gltfBytes += int64(buffer.cesium.data.size());
+  }
+  for (const Image& image : model.images) {
+    usage.gltfBytes += int64(image.cesium.pixelData.size());
+  }
+
+  return usage;
+}
+
+} // namespace
+
 static void loadModelAnyThreadPart(
     LoadModelResult& result,
     const glm::dmat4x4& transform,
@@ -3458,6 +3674,9 @@ UCesiumGltfComponent::CreateOffGameThread(
       Options,
       textureResources);
 
+  pResult->loadModelResult.MemoryUsage =
+      computeMemoryUsage(*Options.pModel, pResult->loadModelResult);
+
   return pResult;
 }
 
@@ -3491,6 +3710,9 @@ UCesiumGltfComponent::CreateOffGameThread(
   Gltf->EncodedMetadata = std::move(pReal->loadModelResult.EncodedMetadata);
   Gltf->EncodedMetadata_DEPRECATED =
       std::move(pReal->loadModelResult.EncodedMetadata_DEPRECATED);
+  Gltf->MemoryUsage = pReal->loadModelResult.MemoryUsage;
+  Gltf->LoadTimes = pReal->LoadTimes;
+  Gltf->ContentUrl = std::move(pReal->ContentUrl);
 
   if (pBaseMaterial) {
     Gltf->BaseMaterial = pBaseMaterial;
@@ -6,7 +6,9 @@
 #include "Cesium3DTileset.h"
 #include "CesiumEncodedFeaturesMetadata.h"
 #include "CesiumEncodedMetadataUtility.h"
+#include "CesiumMemoryUsage.h"
 #include "CesiumModelMetadata.h"
+#include "CesiumTileLoadTimes.h"
 #include "Components/PrimitiveComponent.h"
 #include "Components/SceneComponent.h"
 #include "CoreMinimal.h"
@@ -14,6 +16,7 @@
 #include "Interfaces/IHttpRequest.h"
 #include <glm/mat4x4.hpp>
 #include <memory>
+#include <string>
 #include "CesiumGltfComponent.generated.h"
 
 class UMaterialInterface;
@@ -62,6 +65,18 @@ public:
   class HalfConstructed {
   public:
     virtual ~HalfConstructed() = default;
+
+    /**
+     * The times at which this tile reached each stage of its lifecycle so
+     * far.
+     */
+    CesiumTileLoadTimes LoadTimes{};
+
+    /**
+     * The URL from which the tile's content was loaded, or an empty string if
+     * it was not loaded from a URL of its own.
+     */
+    std::string ContentUrl;
   };
 
   static TUniquePtr<HalfConstructed> CreateOffGameThread(
@@ -103,6 +118,23 @@ public:
       EncodedMetadata_DEPRECATED = std::nullopt;
   PRAGMA_ENABLE_DEPRECATION_WARNINGS
 
+  /**
+   * The memory used by the renderer resources of this glTF, which is counted
+   * towards the memory usage of the owning tileset.
+   */
+  CesiumMemoryUsage MemoryUsage{};
+
+  /**
+   * The times at which this glTF's tile reached each stage of its lifecycle.
+   */
+  CesiumTileLoadTimes LoadTimes{};
+
+  /**
+   * The URL from which this glTF's tile content was loaded, or an empty
+   * string if it was not loaded from a URL of its own.
+   */
+  std::string ContentUrl;
+
   void UpdateTransformFromCesium(const glm::dmat4& CesiumToUnrealTransform);
 
   void AttachRasterTile(
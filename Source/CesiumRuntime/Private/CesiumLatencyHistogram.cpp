@@ -0,0 +1,94 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumLatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+CesiumLatencyHistogram::CesiumLatencyHistogram() { this->reset(); }
+
+void CesiumLatencyHistogram::record(double seconds) {
+  if (!(seconds >= 0.0)) {
+    return;
+  }
+
+  const double microseconds = seconds * 1e6;
+  this->_buckets[getBucket(microseconds)].fetch_add(
+      1,
+      std::memory_order_relaxed);
+  this->_totalMicroseconds.fetch_add(
+      uint64(microseconds),
+      std::memory_order_relaxed);
+}
+
+void CesiumLatencyHistogram::reset() {
+  for (std::atomic<uint64>& bucket : this->_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  this->_totalMicroseconds.store(0, std::memory_order_relaxed);
+}
+
+int64 CesiumLatencyHistogram::getCount() const {
+  uint64 count = 0;
+  for (const std::atomic<uint64>& bucket : this->_buckets) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  return int64(count);
+}
+
+double CesiumLatencyHistogram::getMean() const {
+  const int64 count = this->getCount();
+  if (count == 0) {
+    return 0.0;
+  }
+
+  return double(this->_totalMicroseconds.load(std::memory_order_relaxed)) /
+         double(count) * 1e-6;
+}
+
+double CesiumLatencyHistogram::getPercentile(double percentile) const {
+  // Take a snapshot so that the buckets can't change while they're scanned.
+  std::array<uint64, BucketCount> buckets;
+  uint64 count = 0;
+  for (int32 i = 0; i < BucketCount; ++i) {
+    buckets[i] = this->_buckets[i].load(std::memory_order_relaxed);
+    count += buckets[i];
+  }
+
+  if (count == 0) {
+    return 0.0;
+  }
+
+  const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+  const uint64 target =
+      std::max(uint64(1), uint64(std::ceil(fraction * double(count))));
+
+  uint64 cumulative = 0;
+  for (int32 i = 0; i < BucketCount; ++i) {
+    cumulative += buckets[i];
+    if (cumulative >= target) {
+      return getBucketMicroseconds(i) * 1e-6;
+    }
+  }
+
+  return getBucketMicroseconds(BucketCount - 1) * 1e-6;
+}
+
+/*static*/ int32 CesiumLatencyHistogram::getBucket(double microseconds) {
+  if (microseconds < 1.0) {
+    return 0;
+  }
+
+  const int32 bucket =
+      1 + int32(std::floor(std::log2(microseconds) * BucketsPerOctave));
+  return std::min(bucket, BucketCount - 1);
+}
+
+/*static*/ double
+CesiumLatencyHistogram::getBucketMicroseconds(int32 bucket) {
+  if (bucket == 0) {
+    return 0.0;
+  }
+
+  // The geometric middle of the bucket's range.
+  return std::exp2((double(bucket) - 0.5) / BucketsPerOctave);
+}
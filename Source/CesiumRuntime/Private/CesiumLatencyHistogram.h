@@ -0,0 +1,56 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/Platform.h"
+#include <array>
+#include <atomic>
+
+/**
+ * A histogram of durations that can be recorded to from any thread without
+ * locking. Durations are counted in logarithmically-sized buckets, so
+ * percentiles are accurate to within about 5% from one microsecond up to
+ * about an hour.
+ */
+class CesiumLatencyHistogram {
+public:
+  static constexpr int32 BucketsPerOctave = 8;
+  static constexpr int32 Octaves = 32;
+
+  // The first bucket holds durations below one microsecond.
+  static constexpr int32 BucketCount = 1 + Octaves * BucketsPerOctave;
+
+  CesiumLatencyHistogram();
+
+  /**
+   * Records a duration in seconds. Negative durations are ignored.
+   */
+  void record(double seconds);
+
+  /**
+   * Removes all recorded durations. Durations recorded concurrently with a
+   * reset may or may not be removed.
+   */
+  void reset();
+
+  /** Gets the number of recorded durations. */
+  int64 getCount() const;
+
+  /** Gets the mean of the recorded durations, in seconds. */
+  double getMean() const;
+
+  /**
+   * Gets the duration, in seconds, below which the given percentage of the
+   * recorded durations fall, or 0.0 if nothing has been recorded.
+   *
+   * @param percentile The percentile, from 0.0 to 100.0.
+   */
+  double getPercentile(double percentile) const;
+
+private:
+  static int32 getBucket(double microseconds);
+  static double getBucketMicroseconds(int32 bucket);
+
+  std::array<std::atomic<uint64>, BucketCount> _buckets;
+  std::atomic<uint64> _totalMicroseconds;
+};
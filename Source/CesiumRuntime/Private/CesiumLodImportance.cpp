@@ -0,0 +1,135 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumLodImportance.h"
+#include "CalcBounds.h"
+#include "Cesium3DTilesSelection/Tile.h"
+#include "Cesium3DTilesSelection/Tileset.h"
+#include "CesiumRuntime.h"
+#include <glm/gtc/matrix_inverse.hpp>
+#include <string>
+#include <variant>
+
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Tiles Scaled By LOD Importance Volumes"),
+    STAT_CesiumLodImportanceScaledTiles,
+    STATGROUP_Cesium);
+
+void CesiumLodImportance::update(
+    std::vector<CesiumLodImportanceIndex::Volume>&& volumes,
+    const glm::dmat4& tilesetToUnrealWorld,
+    Cesium3DTilesSelection::Tileset& tileset) {
+  TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::UpdateLodImportance)
+
+  if (tilesetToUnrealWorld != this->_tilesetToUnrealWorld ||
+      volumes != this->_index.getVolumes()) {
+    this->_index.build(std::move(volumes));
+    this->_tilesetToUnrealWorld = tilesetToUnrealWorld;
+    ++this->_generation;
+  }
+
+  // Nothing has ever been scaled, so there is nothing to do.
+  if (this->_index.isEmpty() && this->_tiles.empty()) {
+    return;
+  }
+
+  ++this->_update;
+
+  // The tile bounding volumes are in tileset coordinates, and the volumes are
+  // in Unreal world coordinates.
+  const glm::dmat4 unrealWorldToTileset =
+      glm::affineInverse(this->_tilesetToUnrealWorld);
+  const CalcBoundsOperation calcBounds{
+      FTransform::Identity,
+      unrealWorldToTileset};
+
+  uint32 scaledTiles = 0;
+  tileset.forEachLoadedTile([this, &calcBounds, &scaledTiles](
+                                Cesium3DTilesSelection::Tile& tile) {
+    auto it = this->_tiles.find(&tile);
+
+    // A tile whose geometric error is not the one it was given is a new tile
+    // at the address of a destroyed one.
+    const bool isKnown = it != this->_tiles.end() &&
+                         it->second.geometricError == tile.getGeometricError();
+
+    if (!isKnown || it->second.generation != this->_generation) {
+      TileState state;
+      state.originalGeometricError =
+          isKnown ? it->second.originalGeometricError
+                  : this->getOriginalGeometricError(tile);
+      state.screenSpaceErrorMultiplier =
+          this->_index.getScreenSpaceErrorMultiplier(
+              std::visit(calcBounds, tile.getBoundingVolume()));
+      state.geometricError =
+          state.originalGeometricError * state.screenSpaceErrorMultiplier;
+      state.generation = this->_generation;
+
+      tile.setGeometricError(state.geometricError);
+      it = this->_tiles.insert_or_assign(&tile, state).first;
+    }
+
+    it->second.update = this->_update;
+    if (it->second.screenSpaceErrorMultiplier != 1.0) {
+      ++scaledTiles;
+    }
+  });
+
+  // A tile that is no longer loaded, but was not unloaded through
+  // unloadTile, may have been destroyed, so its address may be reused. One
+  // that was not scaled has its original geometric error, so forgetting it
+  // loses nothing. One that was scaled is kept so that its original
+  // geometric error can be restored if it is loaded again.
+  for (auto it = this->_tiles.begin(); it != this->_tiles.end();) {
+    if (it->second.update != this->_update &&
+        it->second.screenSpaceErrorMultiplier == 1.0) {
+      it = this->_tiles.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  INC_DWORD_STAT_BY(STAT_CesiumLodImportanceScaledTiles, scaledTiles);
+}
+
+void CesiumLodImportance::unloadTile(Cesium3DTilesSelection::Tile& tile) {
+  auto it = this->_tiles.find(&tile);
+  if (it == this->_tiles.end()) {
+    return;
+  }
+
+  if (it->second.geometricError == tile.getGeometricError()) {
+    tile.setGeometricError(it->second.originalGeometricError);
+  }
+  this->_tiles.erase(it);
+}
+
+void CesiumLodImportance::reset() {
+  this->_tiles.clear();
+  ++this->_generation;
+}
+
+double CesiumLodImportance::getOriginalGeometricError(
+    const Cesium3DTilesSelection::Tile& tile) const {
+  const double geometricError = tile.getGeometricError();
+
+  // The tiles of explicit tilesets, whose IDs are strings, have the geometric
+  // errors they were authored with.
+  if (std::holds_alternative<std::string>(tile.getTileID())) {
+    return geometricError;
+  }
+
+  // Implicit tiling, quantized-mesh terrain and raster overlay upsampling give
+  // a new tile half of its parent's geometric error. If the parent's was
+  // scaled, so is this one's.
+  const Cesium3DTilesSelection::Tile* pParent = tile.getParent();
+  if (pParent) {
+    auto it = this->_tiles.find(pParent);
+    if (it != this->_tiles.end() &&
+        it->second.geometricError == pParent->getGeometricError() &&
+        geometricError == it->second.geometricError * 0.5) {
+      return it->second.originalGeometricError * 0.5;
+    }
+  }
+
+  return geometricError;
+}
@@ -0,0 +1,79 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumLodImportanceIndex.h"
+#include <glm/mat4x4.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+class Tile;
+class Tileset;
+} // namespace Cesium3DTilesSelection
+
+/**
+ * Applies the screen-space error multipliers of LOD importance volumes to the
+ * tiles of a tileset.
+ *
+ * cesium-native computes the screen-space error of a tile from its geometric
+ * error, so the multiplier of a tile is applied by scaling its geometric
+ * error. The original geometric error of every scaled tile is remembered, so
+ * that the multiplier can change when the volumes do, and is restored when the
+ * tile is unloaded. Tiles are only tested against the volumes when they are
+ * first selected, or when the volumes or the tileset's transform change.
+ */
+class CesiumLodImportance {
+public:
+  /**
+   * Applies the given volumes to the tiles visited by the tileset's previous
+   * selection. Tiles that are visited for the first time in a selection are
+   * scaled before the next one.
+   *
+   * @param volumes The volumes, in Unreal world coordinates.
+   * @param tilesetToUnrealWorld The transformation from the tileset's
+   * coordinates to Unreal world coordinates.
+   * @param tileset The tileset whose tiles to scale.
+   */
+  void update(
+      std::vector<CesiumLodImportanceIndex::Volume>&& volumes,
+      const glm::dmat4& tilesetToUnrealWorld,
+      Cesium3DTilesSelection::Tileset& tileset);
+
+  /**
+   * Restores the original geometric error of a tile whose content is being
+   * unloaded, and forgets it, because the tile may be destroyed afterward.
+   */
+  void unloadTile(Cesium3DTilesSelection::Tile& tile);
+
+  /**
+   * Forgets the tiles, which must be done before they are destroyed with
+   * their tileset.
+   */
+  void reset();
+
+private:
+  struct TileState {
+    double originalGeometricError;
+    double geometricError;
+    double screenSpaceErrorMultiplier;
+    uint32 generation;
+    uint32 update;
+  };
+
+  double
+  getOriginalGeometricError(const Cesium3DTilesSelection::Tile& tile) const;
+
+  CesiumLodImportanceIndex _index;
+  glm::dmat4 _tilesetToUnrealWorld{1.0};
+
+  // Incremented whenever the volumes or the tileset's transform change, so
+  // that every tile is tested against them again.
+  uint32 _generation = 0;
+
+  // Incremented by every update, so that the tiles that it did not find among
+  // the loaded tiles can be told apart.
+  uint32 _update = 0;
+
+  std::unordered_map<const Cesium3DTilesSelection::Tile*, TileState> _tiles;
+};
@@ -0,0 +1,250 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumLodImportanceIndex.h"
+#include "CesiumCartographicPolygon.h"
+#include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/SplineComponent.h"
+#include <algorithm>
+
+namespace {
+
+// The largest number of volumes in a leaf of the hierarchy. Testing a few
+// volumes directly is cheaper than descending further.
+constexpr int32 MaximumVolumesPerLeaf = 4;
+
+// Half of the height of the bounds of a polygon volume, which extends
+// infinitely up and down. This is far larger than the globe, but finite so
+// that the bounds can be combined.
+constexpr double PolygonHalfHeight = 1.0e12;
+
+bool isInsidePolygon(
+    const FVector2D& point,
+    const std::vector<FVector2D>& polygon) {
+  bool inside = false;
+  for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+    const FVector2D& a = polygon[i];
+    const FVector2D& b = polygon[j];
+    if ((a.Y > point.Y) != (b.Y > point.Y) &&
+        point.X < (b.X - a.X) * (point.Y - a.Y) / (b.Y - a.Y) + a.X) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+} // namespace
+
+bool CesiumLodImportanceIndex::Volume::operator==(const Volume& other) const {
+  return this->shape == other.shape &&
+         this->screenSpaceErrorMultiplier ==
+             other.screenSpaceErrorMultiplier &&
+         this->transform.Equals(other.transform, 0.0) &&
+         this->boxExtent == other.boxExtent &&
+         this->sphereRadius == other.sphereRadius &&
+         this->polygon == other.polygon;
+}
+
+/*static*/ std::optional<CesiumLodImportanceIndex::Volume>
+CesiumLodImportanceIndex::createVolume(
+    const ACesiumLodImportanceVolume& actor) {
+  Volume volume;
+  volume.shape = actor.Shape;
+  volume.screenSpaceErrorMultiplier = actor.ScreenSpaceErrorMultiplier;
+
+  switch (actor.Shape) {
+  case ECesiumLodImportanceVolumeShape::Box:
+    volume.transform = actor.Box->GetComponentTransform();
+    volume.boxExtent = actor.Box->GetUnscaledBoxExtent();
+    break;
+  case ECesiumLodImportanceVolumeShape::Sphere:
+    volume.transform = actor.Sphere->GetComponentTransform();
+    volume.sphereRadius = actor.Sphere->GetUnscaledSphereRadius();
+    break;
+  case ECesiumLodImportanceVolumeShape::Polygon: {
+    if (!IsValid(actor.Polygon)) {
+      return std::nullopt;
+    }
+    const USplineComponent* pSpline = actor.Polygon->Polygon;
+    const int32 pointCount = pSpline->GetNumberOfSplinePoints();
+    if (pointCount < 3) {
+      return std::nullopt;
+    }
+    volume.polygon.reserve(pointCount);
+    for (int32 i = 0; i < pointCount; ++i) {
+      volume.polygon.emplace_back(
+          pSpline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World));
+    }
+    break;
+  }
+  }
+
+  return volume;
+}
+
+void CesiumLodImportanceIndex::build(std::vector<Volume>&& volumes) {
+  this->_volumes = std::move(volumes);
+
+  this->_volumeBounds.clear();
+  this->_volumeBounds.reserve(this->_volumes.size());
+  this->_order.clear();
+  this->_order.reserve(this->_volumes.size());
+  for (size_t i = 0; i < this->_volumes.size(); ++i) {
+    this->_volumeBounds.emplace_back(computeBounds(this->_volumes[i]));
+    this->_order.emplace_back(int32(i));
+  }
+
+  this->_nodes.clear();
+  if (!this->_volumes.empty()) {
+    this->_nodes.reserve(2 * this->_volumes.size());
+    this->buildNode(0, int32(this->_volumes.size()));
+  }
+}
+
+double CesiumLodImportanceIndex::getScreenSpaceErrorMultiplier(
+    const FBoxSphereBounds& bounds) const {
+  if (this->_nodes.empty()) {
+    return 1.0;
+  }
+
+  const FBox box = bounds.GetBox();
+  double highest = -1.0;
+
+  TArray<int32, TInlineAllocator<32>> stack;
+  stack.Add(0);
+  while (stack.Num() > 0) {
+    const Node& node = this->_nodes[stack.Pop(false)];
+    if (!node.bounds.Intersect(box)) {
+      continue;
+    }
+
+    if (node.secondChild >= 0) {
+      // The first child follows its parent.
+      stack.Add(int32(&node - this->_nodes.data()) + 1);
+      stack.Add(node.secondChild);
+      continue;
+    }
+
+    for (int32 i = node.first; i < node.first + node.count; ++i) {
+      const int32 volumeIndex = this->_order[i];
+      const Volume& volume = this->_volumes[volumeIndex];
+      if (volume.screenSpaceErrorMultiplier > highest &&
+          this->_volumeBounds[volumeIndex].Intersect(box) &&
+          intersects(volume, bounds)) {
+        highest = volume.screenSpaceErrorMultiplier;
+      }
+    }
+  }
+
+  return highest >= 0.0 ? highest : 1.0;
+}
+
+int32 CesiumLodImportanceIndex::buildNode(int32 first, int32 count) {
+  const int32 index = int32(this->_nodes.size());
+  this->_nodes.emplace_back();
+
+  Node node;
+  node.bounds = FBox(ForceInit);
+  node.first = first;
+  node.count = count;
+  node.secondChild = -1;
+
+  FBox centers(ForceInit);
+  for (int32 i = first; i < first + count; ++i) {
+    const FBox& volumeBounds = this->_volumeBounds[this->_order[i]];
+    node.bounds += volumeBounds;
+    centers += volumeBounds.GetCenter();
+  }
+
+  if (count > MaximumVolumesPerLeaf) {
+    // Split the volumes in half along the longest axis of their centers.
+    const FVector size = centers.GetSize();
+    const int32 axis =
+        size.X >= size.Y && size.X >= size.Z ? 0 : (size.Y >= size.Z ? 1 : 2);
+    const int32 half = count / 2;
+    std::nth_element(
+        this->_order.begin() + first,
+        this->_order.begin() + first + half,
+        this->_order.begin() + first + count,
+        [this, axis](int32 a, int32 b) {
+          return this->_volumeBounds[a].GetCenter()[axis] <
+                 this->_volumeBounds[b].GetCenter()[axis];
+        });
+
+    this->buildNode(first, half);
+    node.secondChild = this->buildNode(first + half, count - half);
+    node.count = 0;
+  }
+
+  this->_nodes[index] = node;
+  return index;
+}
+
+/*static*/ FBox
+CesiumLodImportanceIndex::computeBounds(const Volume& volume) {
+  switch (volume.shape) {
+  case ECesiumLodImportanceVolumeShape::Box:
+    return FBox(-volume.boxExtent, volume.boxExtent)
+        .TransformBy(volume.transform);
+  case ECesiumLodImportanceVolumeShape::Sphere: {
+    const double radius =
+        volume.sphereRadius * volume.transform.GetMaximumAxisScale();
+    return FBox::BuildAABB(
+        volume.transform.GetLocation(),
+        FVector(radius, radius, radius));
+  }
+  case ECesiumLodImportanceVolumeShape::Polygon:
+  default: {
+    FBox bounds(ForceInit);
+    for (const FVector2D& point : volume.polygon) {
+      bounds += FVector(point.X, point.Y, -PolygonHalfHeight);
+      bounds += FVector(point.X, point.Y, PolygonHalfHeight);
+    }
+    return bounds;
+  }
+  }
+}
+
+/*static*/ bool CesiumLodImportanceIndex::intersects(
+    const Volume& volume,
+    const FBoxSphereBounds& bounds) {
+  const FVector& center = bounds.Origin;
+  const double radius = bounds.SphereRadius;
+
+  switch (volume.shape) {
+  case ECesiumLodImportanceVolumeShape::Box: {
+    // Find the point of the box closest to the center of the bounds.
+    const FVector local = volume.transform.InverseTransformPosition(center);
+    const FVector closest = volume.transform.TransformPosition(
+        local.BoundToBox(-volume.boxExtent, volume.boxExtent));
+    return FVector::DistSquared(closest, center) <= radius * radius;
+  }
+  case ECesiumLodImportanceVolumeShape::Sphere: {
+    const double sphereRadius =
+        volume.sphereRadius * volume.transform.GetMaximumAxisScale();
+    return FVector::Dist(volume.transform.GetLocation(), center) <=
+           sphereRadius + radius;
+  }
+  case ECesiumLodImportanceVolumeShape::Polygon:
+  default: {
+    const FVector2D point(center);
+    if (volume.polygon.size() < 3) {
+      return false;
+    }
+    if (isInsidePolygon(point, volume.polygon)) {
+      return true;
+    }
+    for (size_t i = 0, j = volume.polygon.size() - 1; i < volume.polygon.size();
+         j = i++) {
+      const FVector2D closest = FMath::ClosestPointOnSegment2D(
+          point,
+          volume.polygon[j],
+          volume.polygon[i]);
+      if (FVector2D::DistSquared(closest, point) <= radius * radius) {
+        return true;
+      }
+    }
+    return false;
+  }
+  }
+}
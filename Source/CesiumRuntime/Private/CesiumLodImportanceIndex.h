@@ -0,0 +1,84 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumLodImportanceVolume.h"
+#include "Math/Box.h"
+#include "Math/BoxSphereBounds.h"
+#include "Math/Transform.h"
+#include "Math/Vector2D.h"
+#include <optional>
+#include <vector>
+
+/**
+ * A bounding volume hierarchy over LOD importance volumes, which finds the
+ * screen-space error multiplier for a tile from its bounds without testing
+ * every volume.
+ */
+class CesiumLodImportanceIndex {
+public:
+  /**
+   * A snapshot of an ACesiumLodImportanceVolume, in Unreal world
+   * coordinates.
+   */
+  struct Volume {
+    ECesiumLodImportanceVolumeShape shape =
+        ECesiumLodImportanceVolumeShape::Box;
+    double screenSpaceErrorMultiplier = 1.0;
+
+    /** The transform of the box or sphere. */
+    FTransform transform = FTransform::Identity;
+    FVector boxExtent = FVector::ZeroVector;
+    double sphereRadius = 0.0;
+
+    /** The X and Y coordinates of the polygon's vertices. */
+    std::vector<FVector2D> polygon;
+
+    bool operator==(const Volume& other) const;
+    bool operator!=(const Volume& other) const { return !(*this == other); }
+  };
+
+  /**
+   * Creates a snapshot of the given actor, or returns std::nullopt if its
+   * Shape is Polygon and its polygon is missing or has fewer than three
+   * points.
+   */
+  static std::optional<Volume>
+  createVolume(const ACesiumLodImportanceVolume& actor);
+
+  /** Replaces the volumes in the index. */
+  void build(std::vector<Volume>&& volumes);
+
+  const std::vector<Volume>& getVolumes() const { return this->_volumes; }
+
+  bool isEmpty() const { return this->_volumes.empty(); }
+
+  /**
+   * Gets the screen-space error multiplier for a tile with the given bounds:
+   * the highest multiplier of the volumes it intersects, or one if it does
+   * not intersect any.
+   */
+  double getScreenSpaceErrorMultiplier(const FBoxSphereBounds& bounds) const;
+
+private:
+  struct Node {
+    FBox bounds;
+
+    // The range of _order holding this node's volumes, if it is a leaf.
+    int32 first;
+    int32 count;
+
+    // The index of the second child. The first child follows this node.
+    int32 secondChild;
+  };
+
+  int32 buildNode(int32 first, int32 count);
+
+  static FBox computeBounds(const Volume& volume);
+  static bool intersects(const Volume& volume, const FBoxSphereBounds& bounds);
+
+  std::vector<Volume> _volumes;
+  std::vector<FBox> _volumeBounds;
+  std::vector<int32> _order;
+  std::vector<Node> _nodes;
+};
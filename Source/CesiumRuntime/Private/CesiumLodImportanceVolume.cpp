@@ -0,0 +1,54 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumLodImportanceVolume.h"
+#include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
+
+namespace {
+
+void initializeShapeComponent(UShapeComponent* pShape) {
+  pShape->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+  pShape->SetGenerateOverlapEvents(false);
+  pShape->SetCanEverAffectNavigation(false);
+  pShape->SetHiddenInGame(true);
+  pShape->SetMobility(EComponentMobility::Movable);
+}
+
+} // namespace
+
+ACesiumLodImportanceVolume::ACesiumLodImportanceVolume() : AActor() {
+  PrimaryActorTick.bCanEverTick = false;
+
+  USceneComponent* pRoot =
+      CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+  pRoot->SetMobility(EComponentMobility::Movable);
+  this->SetRootComponent(pRoot);
+
+  this->Box = CreateDefaultSubobject<UBoxComponent>(TEXT("Box"));
+  this->Box->SetupAttachment(pRoot);
+  this->Box->InitBoxExtent(FVector(50000.0, 50000.0, 50000.0));
+  initializeShapeComponent(this->Box);
+
+  this->Sphere = CreateDefaultSubobject<USphereComponent>(TEXT("Sphere"));
+  this->Sphere->SetupAttachment(pRoot);
+  this->Sphere->InitSphereRadius(50000.0f);
+  initializeShapeComponent(this->Sphere);
+
+  this->UpdateShapeVisibility();
+}
+
+void ACesiumLodImportanceVolume::OnConstruction(const FTransform& Transform) {
+  Super::OnConstruction(Transform);
+  this->UpdateShapeVisibility();
+}
+
+void ACesiumLodImportanceVolume::BeginPlay() {
+  Super::BeginPlay();
+  this->UpdateShapeVisibility();
+}
+
+void ACesiumLodImportanceVolume::UpdateShapeVisibility() {
+  this->Box->SetVisibility(this->Shape == ECesiumLodImportanceVolumeShape::Box);
+  this->Sphere->SetVisibility(
+      this->Shape == ECesiumLodImportanceVolumeShape::Sphere);
+}
@@ -0,0 +1,275 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumMemoryBudget.h"
+#include "Cesium3DTileset.h"
+#include "CesiumRasterOverlay.h"
+#include "CesiumRuntime.h"
+#include "CesiumRuntimeSettings.h"
+#include "CoreGlobals.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// The GPU scale only grows again once the estimated GPU footprint is this
+// fraction below the GPU budget.
+constexpr double GpuBudgetHysteresis = 0.1;
+
+// The time constant, in seconds, with which the GPU scale approaches the
+// scale that would bring the estimated GPU footprint to its target.
+constexpr double GpuScaleTimeConstantSeconds = 1.0;
+
+// The smallest fraction of the budget that the GPU scale leaves.
+constexpr double MinimumGpuScale = 0.01;
+
+FAutoConsoleCommand LogMemoryBudgetCommand(
+    TEXT("cesium.budget"),
+    TEXT(
+        "Logs the share of the global Cesium memory budget currently allocated to each tileset."),
+    FConsoleCommandDelegate::CreateLambda(
+        []() { CesiumMemoryBudget::getInstance().logAllocations(); }));
+
+} // namespace
+
+CesiumMemoryBudget& CesiumMemoryBudget::getInstance() {
+  static CesiumMemoryBudget instance;
+  return instance;
+}
+
+void CesiumMemoryBudget::registerTileset(ACesium3DTileset* pTileset) {
+  this->_tilesets.AddUnique(pTileset);
+}
+
+void CesiumMemoryBudget::unregisterTileset(ACesium3DTileset* pTileset) {
+  this->_tilesets.Remove(pTileset);
+  pTileset->_memoryBudgetAllocation = -1;
+  pTileset->_budgetedCachedBytes = -1;
+}
+
+void CesiumMemoryBudget::update() {
+  if (this->_lastUpdateFrame == GFrameCounter) {
+    return;
+  }
+  this->_lastUpdateFrame = GFrameCounter;
+
+  this->_tilesets.RemoveAll(
+      [](const TWeakObjectPtr<ACesium3DTileset>& pTileset) {
+        return !pTileset.IsValid();
+      });
+
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  if (!pSettings->EnableMemoryBudget) {
+    if (this->_allocationsApplied) {
+      this->resetAllocations();
+    }
+    return;
+  }
+
+  TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::UpdateMemoryBudget)
+
+  // Tilesets in different worlds (e.g. the Editor world and a PIE world) do
+  // not compete for the same budget.
+  TMap<UWorld*, TArray<ACesium3DTileset*>> tilesetsByWorld;
+  for (const TWeakObjectPtr<ACesium3DTileset>& pTileset : this->_tilesets) {
+    tilesetsByWorld.FindOrAdd(pTileset->GetWorld()).Add(pTileset.Get());
+  }
+
+  for (const auto& worldAndTilesets : tilesetsByWorld) {
+    this->updateWorld(worldAndTilesets.Key, worldAndTilesets.Value);
+  }
+
+  for (auto it = this->_gpuScales.CreateIterator(); it; ++it) {
+    if (!tilesetsByWorld.Contains(it.Key().Get())) {
+      it.RemoveCurrent();
+    }
+  }
+
+  this->_allocationsApplied = true;
+}
+
+void CesiumMemoryBudget::updateWorld(
+    UWorld* pWorld,
+    const TArray<ACesium3DTileset*>& tilesets) {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+
+  int64 budget = std::max(int64(0), pSettings->MemoryBudgetBytes);
+
+  int64 estimatedGpuBytes = 0;
+  std::vector<double> weights;
+  weights.reserve(tilesets.Num());
+  for (ACesium3DTileset* pTileset : tilesets) {
+    estimatedGpuBytes += pTileset->GetEstimatedGpuBytes();
+    weights.push_back(
+        std::max(0.0f, pTileset->MemoryBudgetPriority) *
+        pTileset->_memoryBudgetImportance);
+  }
+
+  // If the GPU is over budget, shrink the cache budget so that enough tiles
+  // are evicted to bring it back under.
+  const int64 gpuBudget = std::max(int64(0), pSettings->GpuMemoryBudgetBytes);
+  double& gpuScale = this->_gpuScales.FindOrAdd(pWorld, 1.0);
+  gpuScale = CesiumMemoryBudget::updateGpuScale(
+      gpuScale,
+      estimatedGpuBytes,
+      gpuBudget,
+      FApp::GetDeltaTime());
+  budget = int64(double(budget) * gpuScale);
+
+  std::vector<int64> allocations = CesiumMemoryBudget::distribute(
+      budget,
+      pSettings->MinimumTilesetMemoryBudgetBytes,
+      weights);
+
+  for (int32 i = 0; i < tilesets.Num(); ++i) {
+    ACesium3DTileset* pTileset = tilesets[i];
+    int64 allocation = allocations[i];
+
+    TArray<UCesiumRasterOverlay*> overlays;
+    pTileset->GetComponents<UCesiumRasterOverlay>(overlays);
+
+    // Split the tileset's allocation between its own tile cache and the
+    // sub-tile caches of its overlays, in the same proportions as their
+    // configured limits.
+    double configuredTotal =
+        double(std::max(int64(0), pTileset->MaximumCachedBytes));
+    for (const UCesiumRasterOverlay* pOverlay : overlays) {
+      configuredTotal +=
+          double(std::max(int64(0), pOverlay->SubTileCacheBytes));
+    }
+
+    int64 overlayBytes = 0;
+    for (UCesiumRasterOverlay* pOverlay : overlays) {
+      int64 overlayAllocation =
+          configuredTotal > 0.0
+              ? int64(
+                    double(allocation) *
+                    double(std::max(int64(0), pOverlay->SubTileCacheBytes)) /
+                    configuredTotal)
+              : 0;
+      pOverlay->SetSubTileCacheBudget(overlayAllocation);
+      overlayBytes += overlayAllocation;
+    }
+
+    pTileset->_memoryBudgetAllocation = allocation;
+    pTileset->_budgetedCachedBytes = allocation - overlayBytes;
+  }
+}
+
+void CesiumMemoryBudget::resetAllocations() {
+  for (const TWeakObjectPtr<ACesium3DTileset>& pTileset : this->_tilesets) {
+    pTileset->_memoryBudgetAllocation = -1;
+    pTileset->_budgetedCachedBytes = -1;
+
+    TArray<UCesiumRasterOverlay*> overlays;
+    pTileset->GetComponents<UCesiumRasterOverlay>(overlays);
+    for (UCesiumRasterOverlay* pOverlay : overlays) {
+      pOverlay->SetSubTileCacheBudget(-1);
+    }
+  }
+
+  this->_gpuScales.Empty();
+  this->_allocationsApplied = false;
+}
+
+void CesiumMemoryBudget::logAllocations() const {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  if (!pSettings->EnableMemoryBudget) {
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT(
+            "The Cesium memory budget is disabled; each tileset uses its own MaximumCachedBytes."));
+  } else {
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT("Cesium memory budget: %lld bytes, GPU budget: %lld bytes"),
+        pSettings->MemoryBudgetBytes,
+        pSettings->GpuMemoryBudgetBytes);
+  }
+
+  for (const TWeakObjectPtr<ACesium3DTileset>& pTileset : this->_tilesets) {
+    if (!pTileset.IsValid()) {
+      continue;
+    }
+
+    UWorld* pWorld = pTileset->GetWorld();
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT(
+            "  %s (%s): importance %.1f, allocated %lld bytes, tile cache limit %lld bytes, loaded %lld bytes, estimated GPU %lld bytes"),
+        *pTileset->GetName(),
+        pWorld ? *pWorld->GetName() : TEXT("no world"),
+        pTileset->GetMemoryBudgetImportance(),
+        pTileset->GetMemoryBudgetAllocation(),
+        pTileset->GetEffectiveMaximumCachedBytes(),
+        pTileset->GetLoadedBytes(),
+        pTileset->GetEstimatedGpuBytes());
+  }
+}
+
+/*static*/ std::vector<int64> CesiumMemoryBudget::distribute(
+    int64 budget,
+    int64 minimumPerParticipant,
+    const std::vector<double>& weights) {
+  std::vector<int64> result(weights.size(), 0);
+  if (weights.empty() || budget <= 0) {
+    return result;
+  }
+
+  const int64 count = int64(weights.size());
+  const int64 floor =
+      std::clamp(minimumPerParticipant, int64(0), budget / count);
+  const int64 remaining = budget - floor * count;
+
+  double totalWeight = 0.0;
+  for (double weight : weights) {
+    totalWeight += std::max(0.0, weight);
+  }
+
+  for (size_t i = 0; i < weights.size(); ++i) {
+    double share = totalWeight > 0.0
+                       ? std::max(0.0, weights[i]) / totalWeight
+                       : 1.0 / double(count);
+    result[i] = floor + int64(double(remaining) * share);
+  }
+
+  return result;
+}
+
+/*static*/ double CesiumMemoryBudget::updateGpuScale(
+    double scale,
+    int64 estimatedGpuBytes,
+    int64 gpuBudget,
+    double deltaTime) {
+  if (gpuBudget <= 0) {
+    return 1.0;
+  }
+
+  // The estimated GPU footprint is roughly proportional to the scale that
+  // produced it, so this is the scale that brings it to the budget when over
+  // it, or to just under the budget when well under it.
+  double target;
+  const double lowerBytes = double(gpuBudget) * (1.0 - GpuBudgetHysteresis);
+  if (estimatedGpuBytes > gpuBudget) {
+    target = scale * double(gpuBudget) / double(estimatedGpuBytes);
+  } else if (double(estimatedGpuBytes) < lowerBytes) {
+    target = estimatedGpuBytes > 0
+                 ? scale * lowerBytes / double(estimatedGpuBytes)
+                 : 1.0;
+  } else {
+    return scale;
+  }
+  target = std::clamp(target, MinimumGpuScale, 1.0);
+
+  const double smoothing =
+      1.0 - std::exp(-std::max(deltaTime, 0.0) / GpuScaleTimeConstantSeconds);
+  return scale + (target - scale) * smoothing;
+}
@@ -0,0 +1,83 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include <vector>
+
+class ACesium3DTileset;
+class UWorld;
+
+/**
+ * Distributes a global, per-world memory budget across all of the tilesets
+ * and raster overlays in that world.
+ *
+ * When enabled in the Cesium runtime settings, each tileset's
+ * `MaximumCachedBytes` and each raster overlay's `SubTileCacheBytes` are
+ * replaced with a share of the global budget. Shares are proportional to the
+ * recent visible importance of each tileset (a smoothed count of the tiles it
+ * rendered) multiplied by its `MemoryBudgetPriority`, with a guaranteed
+ * minimum per tileset. When the estimated GPU footprint of all tilesets in a
+ * world exceeds the GPU budget, the whole budget is scaled down so that
+ * tiles are evicted until it fits again. The scale changes gradually, and
+ * only grows again once the footprint is well under the GPU budget, so that
+ * the evictions do not alternate with reloading the same tiles.
+ */
+class CesiumMemoryBudget {
+public:
+  static CesiumMemoryBudget& getInstance();
+
+  void registerTileset(ACesium3DTileset* pTileset);
+  void unregisterTileset(ACesium3DTileset* pTileset);
+
+  /**
+   * Recomputes the allocations of all registered tilesets. This may be called
+   * by every tileset every frame; only the first call in each frame does any
+   * work.
+   */
+  void update();
+
+  /**
+   * Logs the current allocation of every registered tileset.
+   */
+  void logAllocations() const;
+
+  /**
+   * Splits `budget` bytes between participants with the given weights. Each
+   * participant first receives `minimumPerParticipant` bytes (or an equal
+   * share of the budget, if that is smaller), and the remainder is
+   * distributed in proportion to the weights. If all weights are zero, the
+   * remainder is split evenly.
+   */
+  static std::vector<int64> distribute(
+      int64 budget,
+      int64 minimumPerParticipant,
+      const std::vector<double>& weights);
+
+  /**
+   * Gets the next factor by which the budget of a world is scaled to keep
+   * the estimated GPU footprint of its tilesets within the GPU budget.
+   *
+   * @param scale The current factor, which starts at 1.
+   * @param estimatedGpuBytes The estimated GPU footprint, which resulted from
+   * the current factor.
+   * @param gpuBudget The GPU budget, or 0 for none.
+   * @param deltaTime The time since the previous update, in seconds.
+   */
+  static double updateGpuScale(
+      double scale,
+      int64 estimatedGpuBytes,
+      int64 gpuBudget,
+      double deltaTime);
+
+private:
+  void updateWorld(UWorld* pWorld, const TArray<ACesium3DTileset*>& tilesets);
+  void resetAllocations();
+
+  TArray<TWeakObjectPtr<ACesium3DTileset>> _tilesets;
+  TMap<TWeakObjectPtr<UWorld>, double> _gpuScales;
+  uint64 _lastUpdateFrame = 0;
+  bool _allocationsApplied = false;
+};
@@ -0,0 +1,143 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumMemoryUsage.h"
+#include "Cesium3DTileset.h"
+#include "CesiumRuntime.h"
+#include "Engine/Texture.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_MEMORY_STAT(
+    TEXT("Vertex Buffers"),
+    STAT_CesiumVertexBufferMemory,
+    STATGROUP_Cesium);
+DECLARE_MEMORY_STAT(
+    TEXT("Index Buffers"),
+    STAT_CesiumIndexBufferMemory,
+    STATGROUP_Cesium);
+DECLARE_MEMORY_STAT(
+    TEXT("Textures"),
+    STAT_CesiumTextureMemory,
+    STATGROUP_Cesium);
+DECLARE_MEMORY_STAT(
+    TEXT("Metadata Textures"),
+    STAT_CesiumMetadataTextureMemory,
+    STATGROUP_Cesium);
+DECLARE_MEMORY_STAT(
+    TEXT("Collision Meshes"),
+    STAT_CesiumCollisionMemory,
+    STATGROUP_Cesium);
+DECLARE_MEMORY_STAT(
+    TEXT("glTF (CPU)"),
+    STAT_CesiumGltfMemory,
+    STATGROUP_Cesium);
+
+namespace {
+
+double toMegabytes(int64 bytes) { return double(bytes) / (1024.0 * 1024.0); }
+
+void logMemoryUsage() {
+  for (TObjectIterator<ACesium3DTileset> it; it; ++it) {
+    ACesium3DTileset* pTileset = *it;
+    if (!IsValid(pTileset) || pTileset->HasAnyFlags(RF_ClassDefaultObject)) {
+      continue;
+    }
+
+    UWorld* pWorld = pTileset->GetWorld();
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT(
+            "%s (%s): vertex buffers %.2f MB, index buffers %.2f MB, textures %.2f MB, metadata textures %.2f MB, collision %.2f MB, glTF %.2f MB"),
+        *pTileset->GetName(),
+        pWorld ? *pWorld->GetName() : TEXT("no world"),
+        toMegabytes(pTileset->GetVertexBufferBytes()),
+        toMegabytes(pTileset->GetIndexBufferBytes()),
+        toMegabytes(pTileset->GetTextureBytes()),
+        toMegabytes(pTileset->GetMetadataTextureBytes()),
+        toMegabytes(pTileset->GetCollisionBytes()),
+        toMegabytes(pTileset->GetGltfBytes()));
+
+    for (int32 group = 0; group < TEXTUREGROUP_MAX; ++group) {
+      int64 bytes = pTileset->GetTextureBytesForGroup(TextureGroup(group));
+      if (bytes > 0) {
+        UE_LOG(
+            LogCesium,
+            Display,
+            TEXT("  %s: %.2f MB"),
+            UTexture::GetTextureGroupString(TextureGroup(group)),
+            toMegabytes(bytes));
+      }
+    }
+  }
+}
+
+FAutoConsoleCommand LogMemoryUsageCommand(
+    TEXT("cesium.memory"),
+    TEXT(
+        "Logs the memory used by the vertex buffers, index buffers, textures, collision meshes, and glTF data of each Cesium3DTileset."),
+    FConsoleCommandDelegate::CreateStatic(logMemoryUsage));
+
+} // namespace
+
+int64 CesiumMemoryUsage::getTextureBytes() const {
+  int64 total = 0;
+  for (int64 bytes : this->textureBytes) {
+    total += bytes;
+  }
+  return total;
+}
+
+int64 CesiumMemoryUsage::getGpuBytes() const {
+  return this->vertexBufferBytes + this->indexBufferBytes +
+         this->getTextureBytes() + this->metadataTextureBytes;
+}
+
+CesiumMemoryUsage&
+CesiumMemoryUsage::operator+=(const CesiumMemoryUsage& rhs) {
+  this->vertexBufferBytes += rhs.vertexBufferBytes;
+  this->indexBufferBytes += rhs.indexBufferBytes;
+  for (int32 i = 0; i < TEXTUREGROUP_MAX; ++i) {
+    this->textureBytes[i] += rhs.textureBytes[i];
+  }
+  this->metadataTextureBytes += rhs.metadataTextureBytes;
+  this->collisionBytes += rhs.collisionBytes;
+  this->gltfBytes += rhs.gltfBytes;
+  return *this;
+}
+
+CesiumMemoryUsage&
+CesiumMemoryUsage::operator-=(const CesiumMemoryUsage& rhs) {
+  this->vertexBufferBytes -= rhs.vertexBufferBytes;
+  this->indexBufferBytes -= rhs.indexBufferBytes;
+  for (int32 i = 0; i < TEXTUREGROUP_MAX; ++i) {
+    this->textureBytes[i] -= rhs.textureBytes[i];
+  }
+  this->metadataTextureBytes -= rhs.metadataTextureBytes;
+  this->collisionBytes -= rhs.collisionBytes;
+  this->gltfBytes -= rhs.gltfBytes;
+  return *this;
+}
+
+void CesiumMemoryUsage::incrementStats() const {
+  INC_MEMORY_STAT_BY(STAT_CesiumVertexBufferMemory, this->vertexBufferBytes);
+  INC_MEMORY_STAT_BY(STAT_CesiumIndexBufferMemory, this->indexBufferBytes);
+  INC_MEMORY_STAT_BY(STAT_CesiumTextureMemory, this->getTextureBytes());
+  INC_MEMORY_STAT_BY(
+      STAT_CesiumMetadataTextureMemory,
+      this->metadataTextureBytes);
+  INC_MEMORY_STAT_BY(STAT_CesiumCollisionMemory, this->collisionBytes);
+  INC_MEMORY_STAT_BY(STAT_CesiumGltfMemory, this->gltfBytes);
+}
+
+void CesiumMemoryUsage::decrementStats() const {
+  DEC_MEMORY_STAT_BY(STAT_CesiumVertexBufferMemory, this->vertexBufferBytes);
+  DEC_MEMORY_STAT_BY(STAT_CesiumIndexBufferMemory, this->indexBufferBytes);
+  DEC_MEMORY_STAT_BY(STAT_CesiumTextureMemory, this->getTextureBytes());
+  DEC_MEMORY_STAT_BY(
+      STAT_CesiumMetadataTextureMemory,
+      this->metadataTextureBytes);
+  DEC_MEMORY_STAT_BY(STAT_CesiumCollisionMemory, this->collisionBytes);
+  DEC_MEMORY_STAT_BY(STAT_CesiumGltfMemory, this->gltfBytes);
+}
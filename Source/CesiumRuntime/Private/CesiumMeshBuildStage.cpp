@@ -0,0 +1,37 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumMeshBuildStage.h"
+
+namespace {
+thread_local ICesiumMeshBuildObserver* pCurrentObserver = nullptr;
+}
+
+const TCHAR* getMeshBuildStageName(CesiumMeshBuildStage stage) {
+  switch (stage) {
+  case CesiumMeshBuildStage::CopyIndices:
+    return TEXT("CopyIndices");
+  case CesiumMeshBuildStage::CopyPositions:
+    return TEXT("CopyPositions");
+  case CesiumMeshBuildStage::ComputeFlatNormals:
+    return TEXT("ComputeFlatNormals");
+  case CesiumMeshBuildStage::ComputeTangents:
+    return TEXT("ComputeTangents");
+  case CesiumMeshBuildStage::InitBuffers:
+    return TEXT("InitBuffers");
+  case CesiumMeshBuildStage::ChaosCook:
+    return TEXT("ChaosCook");
+  default:
+    return TEXT("Unknown");
+  }
+}
+
+/*static*/ ICesiumMeshBuildObserver* ICesiumMeshBuildObserver::getCurrent() {
+  return pCurrentObserver;
+}
+
+/*static*/ ICesiumMeshBuildObserver*
+ICesiumMeshBuildObserver::setCurrent(ICesiumMeshBuildObserver* pObserver) {
+  ICesiumMeshBuildObserver* pPrevious = pCurrentObserver;
+  pCurrentObserver = pObserver;
+  return pPrevious;
+}
@@ -0,0 +1,82 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/Platform.h"
+
+/**
+ * The stages of converting a glTF primitive into an Unreal static mesh that
+ * can be observed with an ICesiumMeshBuildObserver.
+ */
+enum class CesiumMeshBuildStage : uint8 {
+  CopyIndices,
+  CopyPositions,
+  ComputeFlatNormals,
+  ComputeTangents,
+  InitBuffers,
+  ChaosCook,
+  Count
+};
+
+/** Gets the name of the given stage, as used in its profiler event. */
+const TCHAR* getMeshBuildStageName(CesiumMeshBuildStage stage);
+
+/**
+ * Observes the stages of the glTF primitives that are converted into Unreal
+ * meshes on the current thread, so that benchmarks can measure each stage in
+ * isolation. When no observer is installed, a stage costs only a thread-local
+ * read.
+ */
+class ICesiumMeshBuildObserver {
+public:
+  virtual ~ICesiumMeshBuildObserver() = default;
+
+  /**
+   * Called when a primitive is converted, with the number of vertices in the
+   * Unreal mesh built from it. This is the number of indices, rather than of
+   * glTF positions, when vertices are duplicated to give triangles flat
+   * normals.
+   */
+  virtual void onPrimitive(int64 vertexCount) = 0;
+
+  virtual void onStageBegin(CesiumMeshBuildStage stage) = 0;
+  virtual void onStageEnd(CesiumMeshBuildStage stage) = 0;
+
+  /** Gets the observer installed on the current thread, if any. */
+  static ICesiumMeshBuildObserver* getCurrent();
+
+  /**
+   * Installs an observer on the current thread, or removes it if the given
+   * observer is nullptr. Returns the previously-installed observer.
+   */
+  static ICesiumMeshBuildObserver*
+  setCurrent(ICesiumMeshBuildObserver* pObserver);
+};
+
+/**
+ * Notifies the current thread's ICesiumMeshBuildObserver, if any, of the
+ * beginning and end of a stage.
+ */
+class CesiumMeshBuildStageScope {
+public:
+  explicit CesiumMeshBuildStageScope(CesiumMeshBuildStage stage)
+      : _stage(stage), _pObserver(ICesiumMeshBuildObserver::getCurrent()) {
+    if (this->_pObserver) {
+      this->_pObserver->onStageBegin(this->_stage);
+    }
+  }
+
+  ~CesiumMeshBuildStageScope() {
+    if (this->_pObserver) {
+      this->_pObserver->onStageEnd(this->_stage);
+    }
+  }
+
+  CesiumMeshBuildStageScope(const CesiumMeshBuildStageScope&) = delete;
+  CesiumMeshBuildStageScope&
+  operator=(const CesiumMeshBuildStageScope&) = delete;
+
+private:
+  CesiumMeshBuildStage _stage;
+  ICesiumMeshBuildObserver* _pObserver;
+};
@@ -0,0 +1,51 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumPreloadRegionAsyncAction.h"
+#include "Cesium3DTileset.h"
+
+/*static*/ UCesiumPreloadRegionAsyncAction*
+UCesiumPreloadRegionAsyncAction::PreloadRegion(
+    ACesium3DTileset* Tileset,
+    FVector LongitudeLatitudeHeight,
+    double Radius,
+    double MaximumScreenSpaceError,
+    double ViewHeight) {
+  UCesiumPreloadRegionAsyncAction* pAction =
+      NewObject<UCesiumPreloadRegionAsyncAction>();
+  pAction->Tileset = Tileset;
+  pAction->_longitudeLatitudeHeight = LongitudeLatitudeHeight;
+  pAction->_radius = Radius;
+  pAction->_maximumScreenSpaceError = MaximumScreenSpaceError;
+  pAction->_viewHeight = ViewHeight;
+  return pAction;
+}
+
+void UCesiumPreloadRegionAsyncAction::Activate() {
+  if (!IsValid(this->Tileset)) {
+    this->OnComplete.Broadcast(false);
+    this->SetReadyToDestroy();
+    return;
+  }
+
+  // Keep this action alive until the preload completes.
+  this->RegisterWithGameInstance(this->Tileset);
+
+  TWeakObjectPtr<UCesiumPreloadRegionAsyncAction> pWeakThis(this);
+  this->Tileset
+      ->PreloadRegion(
+          this->_longitudeLatitudeHeight,
+          this->_radius,
+          this->_maximumScreenSpaceError,
+          this->_viewHeight,
+          [pWeakThis](float progress) {
+            if (UCesiumPreloadRegionAsyncAction* pThis = pWeakThis.Get()) {
+              pThis->OnProgress.Broadcast(progress);
+            }
+          })
+      .Next([pWeakThis](bool succeeded) {
+        if (UCesiumPreloadRegionAsyncAction* pThis = pWeakThis.Get()) {
+          pThis->OnComplete.Broadcast(succeeded);
+          pThis->SetReadyToDestroy();
+        }
+      });
+}
@@ -12,7 +12,9 @@ FCesiumRasterOverlayLoadFailure OnCesiumRasterOverlayLoadFailure{};
 
 // Sets default values for this component's properties
 UCesiumRasterOverlay::UCesiumRasterOverlay()
-    : _pOverlay(nullptr), _overlaysBeingDestroyed(0) {
+    : _pOverlay(nullptr),
+      _overlaysBeingDestroyed(0),
+      _subTileCacheBudget(-1) {
   this->bAutoActivate = true;
 
   // Set this component to be initialized when the game starts, and to be ticked
@@ -47,7 +49,7 @@ void UCesiumRasterOverlay::AddToTileset() {
   options.maximumScreenSpaceError = this->MaximumScreenSpaceError;
   options.maximumSimultaneousTileLoads = this->MaximumSimultaneousTileLoads;
   options.maximumTextureSize = this->MaximumTextureSize;
-  options.subTileCacheBytes = this->SubTileCacheBytes;
+  options.subTileCacheBytes = this->GetEffectiveSubTileCacheBytes();
   options.showCreditsOnScreen = this->ShowCreditsOnScreen;
   options.rendererOptions = &this->rendererOptions;
   options.loadErrorCallback =
@@ -167,7 +169,22 @@ void UCesiumRasterOverlay::SetSubTileCacheBytes(int64 Value) {
   this->SubTileCacheBytes = Value;
 
   if (this->_pOverlay) {
-    this->_pOverlay->getOptions().subTileCacheBytes = Value;
+    this->_pOverlay->getOptions().subTileCacheBytes =
+        this->GetEffectiveSubTileCacheBytes();
+  }
+}
+
+int64 UCesiumRasterOverlay::GetEffectiveSubTileCacheBytes() const {
+  return this->_subTileCacheBudget >= 0 ? this->_subTileCacheBudget
+                                        : this->SubTileCacheBytes;
+}
+
+void UCesiumRasterOverlay::SetSubTileCacheBudget(int64 Value) {
+  this->_subTileCacheBudget = Value;
+
+  if (this->_pOverlay) {
+    this->_pOverlay->getOptions().subTileCacheBytes =
+        this->GetEffectiveSubTileCacheBytes();
   }
 }
 
@@ -0,0 +1,509 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumRegionPackager.h"
+#include "Cesium3DTileset.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumAsync/ICacheDatabase.h"
+#include "CesiumCartographicPolygon.h"
+#include "CesiumGeoreference.h"
+#include "CesiumGeospatial/Ellipsoid.h"
+#include "CesiumRuntime.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumTilesArchiveWriter.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+using namespace CesiumAsync;
+
+namespace {
+
+// The views look straight down with a square viewport, so that each sees a
+// square of ground twice as wide as its height above the ground.
+constexpr double ViewFieldOfViewDegrees = 90.0;
+constexpr double ViewportPixels = 1024.0;
+
+/** Whether a point is inside a polygon, by the even-odd rule. */
+bool isInside(const std::vector<glm::dvec2>& polygon, const glm::dvec2& point) {
+  bool inside = false;
+  for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+    const glm::dvec2& a = polygon[i];
+    const glm::dvec2& b = polygon[j];
+    if ((a.y > point.y) != (b.y > point.y) &&
+        point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+/** Removes the query and fragment of a URL. */
+std::string withoutQuery(const std::string& url) {
+  return url.substr(0, url.find_first_of("?#"));
+}
+
+/** Gets a URL up to and including the last slash of its path. */
+std::string getDirectory(const std::string& url) {
+  const std::string path = withoutQuery(url);
+  return path.substr(0, path.rfind('/') + 1);
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * The responses received for one tileset while it is packaged, which are
+ * recorded from the threads on which the requests complete.
+ */
+struct TilesetPackage {
+  FCriticalSection lock;
+  std::unordered_set<std::string> urls;
+  CesiumRegionPackager::Result counts;
+
+  // When writing an archive, the files in this directory are written to it,
+  // with their paths relative to it. It is the directory of the first JSON
+  // file received, which is the root of the tileset, if it is not known
+  // beforehand.
+  TUniquePtr<CesiumTilesArchiveWriter> pArchive;
+  std::string baseUrl;
+
+  // When not writing an archive, every response is stored in the cache.
+  std::shared_ptr<ICacheDatabase> pCacheDatabase;
+  std::time_t expiryTime = 0;
+
+  void record(const IAssetRequest& request) {
+    const IAssetResponse* pResponse = request.response();
+    const bool succeeded = pResponse && pResponse->statusCode() >= 200 &&
+                           pResponse->statusCode() < 300;
+
+    {
+      FScopeLock scopeLock(&this->lock);
+      if (!succeeded) {
+        ++this->counts.failedRequests;
+        return;
+      }
+      if (!this->urls.insert(request.url()).second) {
+        return;
+      }
+      ++this->counts.requests;
+      this->counts.bytes += int64(pResponse->data().size());
+
+      if (this->pArchive) {
+        const std::string path = withoutQuery(request.url());
+        if (this->baseUrl.empty() && endsWith(path, ".json")) {
+          this->baseUrl = getDirectory(path);
+        }
+
+        if (!this->baseUrl.empty() && path.size() > this->baseUrl.size() &&
+            path.compare(0, this->baseUrl.size(), this->baseUrl) == 0 &&
+            this->pArchive->addFile(
+                UTF8_TO_TCHAR(path.substr(this->baseUrl.size()).c_str()),
+                pResponse->data())) {
+          ++this->counts.storedResponses;
+        } else {
+          ++this->counts.unstoredResponses;
+        }
+        return;
+      }
+    }
+
+    if (this->store(request, *pResponse)) {
+      FScopeLock scopeLock(&this->lock);
+      ++this->counts.storedResponses;
+    } else {
+      FScopeLock scopeLock(&this->lock);
+      ++this->counts.unstoredResponses;
+    }
+  }
+
+  bool store(const IAssetRequest& request, const IAssetResponse& response) {
+    if (!this->pCacheDatabase) {
+      return false;
+    }
+
+    auto storeEntry = [this, &request, &response]() {
+      return this->pCacheDatabase->storeEntry(
+          request.url(),
+          this->expiryTime,
+          request.url(),
+          request.method(),
+          request.headers(),
+          response.statusCode(),
+          response.headers(),
+          response.data());
+    };
+
+    // The cache may refuse entries while too many are waiting to be written,
+    // so wait for them and try again.
+    if (storeEntry()) {
+      return true;
+    }
+    flushCacheDatabase();
+    return storeEntry();
+  }
+};
+
+void addCounts(
+    CesiumRegionPackager::Result& total,
+    const CesiumRegionPackager::Result& counts) {
+  total.requests += counts.requests;
+  total.failedRequests += counts.failedRequests;
+  total.bytes += counts.bytes;
+  total.storedResponses += counts.storedResponses;
+  total.unstoredResponses += counts.unstoredResponses;
+}
+
+bool hasName(const AActor& actor, const FString& name) {
+  return actor.GetName() == name || actor.GetActorNameOrLabel() == name;
+}
+
+/** Finds the world to package in: a game world if any, or else the editor's. */
+UWorld* findWorld() {
+  UWorld* pWorld = nullptr;
+  for (const FWorldContext& context : GEngine->GetWorldContexts()) {
+    UWorld* pContextWorld = context.World();
+    if (!pContextWorld) {
+      continue;
+    }
+    if (pContextWorld->IsGameWorld()) {
+      return pContextWorld;
+    }
+    if (context.WorldType == EWorldType::Editor) {
+      pWorld = pContextWorld;
+    }
+  }
+  return pWorld;
+}
+
+FAutoConsoleCommand PackageRegionCommand(
+    TEXT("cesium.region.package"),
+    TEXT(
+        "Downloads what the tilesets need within an ACesiumCartographicPolygon, for use without a network connection. Arguments: Polygon=<name> [Tilesets=<name>,...] [MaximumScreenSpaceError=16] [GroundHeight=0] [ViewHeight=500] [ViewsPerBatch=16] [MaximumSimultaneousTileLoads=32] [BatchTimeoutSeconds=600] [CacheLifetimeDays=365] [Archive=<directory>]. Without Archive, the responses are stored in the request cache."),
+    FConsoleCommandWithArgsDelegate::CreateLambda(
+        [](const TArray<FString>& args) {
+          UWorld* pWorld = findWorld();
+          if (!pWorld) {
+            UE_LOG(LogCesium, Error, TEXT("There is no world to package."));
+            return;
+          }
+          CesiumRegionPackager::packageWorld(
+              *pWorld,
+              *FString::Join(args, TEXT(" ")));
+        }));
+
+} // namespace
+
+/*static*/ CesiumRegionPackager::Options
+CesiumRegionPackager::parseOptions(const TCHAR* parameters) {
+  Options options;
+  FParse::Value(
+      parameters,
+      TEXT("MaximumScreenSpaceError="),
+      options.maximumScreenSpaceError);
+  FParse::Value(parameters, TEXT("GroundHeight="), options.groundHeight);
+  FParse::Value(parameters, TEXT("ViewHeight="), options.viewHeight);
+  FParse::Value(parameters, TEXT("ViewsPerBatch="), options.viewsPerBatch);
+  FParse::Value(
+      parameters,
+      TEXT("MaximumSimultaneousTileLoads="),
+      options.maximumSimultaneousTileLoads);
+  FParse::Value(
+      parameters,
+      TEXT("BatchTimeoutSeconds="),
+      options.batchTimeoutSeconds);
+  FParse::Value(
+      parameters,
+      TEXT("CacheLifetimeDays="),
+      options.cacheLifetimeDays);
+  FParse::Value(parameters, TEXT("Archive="), options.archiveDirectory);
+
+  options.viewsPerBatch = FMath::Max(options.viewsPerBatch, 1);
+  options.maximumSimultaneousTileLoads =
+      FMath::Max(options.maximumSimultaneousTileLoads, 1);
+  options.batchTimeoutSeconds = FMath::Max(options.batchTimeoutSeconds, 0.0);
+  return options;
+}
+
+/*static*/ std::vector<FCesiumCamera> CesiumRegionPackager::createRegionViews(
+    ACesium3DTileset& tileset,
+    const std::vector<glm::dvec2>& region,
+    double groundHeight,
+    double viewHeight) {
+  std::vector<FCesiumCamera> views;
+
+  ACesiumGeoreference* pGeoreference = tileset.ResolveGeoreference();
+  if (!pGeoreference || region.size() < 3 || viewHeight <= 0.0) {
+    return views;
+  }
+
+  // Views this far apart see overlapping squares of the lowest ground, and
+  // squares that just meet on ground half the view height above it.
+  const double spacing = viewHeight;
+  const double radius = CesiumGeospatial::Ellipsoid::WGS84.getRadii().x;
+  const double height = groundHeight + viewHeight;
+  const FTransform& tilesetToWorld = tileset.GetActorTransform();
+
+  // The region is placed like the polygons of a polygon raster overlay: its
+  // coordinates are relative to the tileset rather than to the world.
+  auto addView = [&](const glm::dvec2& position) {
+    const FVector relativeLocation =
+        pGeoreference->TransformLongitudeLatitudeHeightPositionToUnreal(
+            FVector(
+                FMath::RadiansToDegrees(position.x),
+                FMath::RadiansToDegrees(position.y),
+                height));
+    const FRotator relativeRotation =
+        pGeoreference->TransformEastSouthUpRotatorToUnreal(
+            FRotator(-90.0, 0.0, 0.0),
+            relativeLocation);
+    views.emplace_back(
+        FVector2D(ViewportPixels, ViewportPixels),
+        tilesetToWorld.TransformPosition(relativeLocation),
+        tilesetToWorld.TransformRotation(relativeRotation.Quaternion())
+            .Rotator(),
+        ViewFieldOfViewDegrees);
+  };
+
+  glm::dvec2 minimum = region[0];
+  glm::dvec2 maximum = region[0];
+  for (const glm::dvec2& corner : region) {
+    minimum = glm::min(minimum, corner);
+    maximum = glm::max(maximum, corner);
+  }
+
+  const double latitudeStep = spacing / radius;
+  for (double latitude = minimum.y + 0.5 * latitudeStep; latitude < maximum.y;
+       latitude += latitudeStep) {
+    const double longitudeStep =
+        spacing / (radius * std::max(std::cos(latitude), 0.01));
+    for (double longitude = minimum.x + 0.5 * longitudeStep;
+         longitude < maximum.x;
+         longitude += longitudeStep) {
+      const glm::dvec2 position(longitude, latitude);
+      if (isInside(region, position)) {
+        addView(position);
+      }
+    }
+  }
+
+  // The views along the edges cover the parts of the region that are
+  // narrower than the spacing of the grid.
+  for (size_t i = 0; i < region.size(); ++i) {
+    const glm::dvec2& start = region[i];
+    const glm::dvec2& end = region[(i + 1) % region.size()];
+    const double latitude = 0.5 * (start.y + end.y);
+    const double length =
+        radius * glm::length(glm::dvec2(
+                     (end.x - start.x) * std::cos(latitude),
+                     end.y - start.y));
+    const int32 count = FMath::Max(1, int32(std::ceil(length / spacing)));
+    for (int32 j = 0; j < count; ++j) {
+      addView(glm::mix(start, end, double(j) / double(count)));
+    }
+  }
+
+  return views;
+}
+
+/*static*/ CesiumRegionPackager::Result CesiumRegionPackager::package(
+    const ACesiumCartographicPolygon& region,
+    const TArray<ACesium3DTileset*>& tilesets,
+    const Options& options) {
+  Result result;
+  const bool writeArchives = !options.archiveDirectory.IsEmpty();
+  if (writeArchives) {
+    IFileManager::Get().MakeDirectory(*options.archiveDirectory, true);
+  }
+
+  for (ACesium3DTileset* pTileset : tilesets) {
+    if (!IsValid(pTileset)) {
+      continue;
+    }
+
+    const CesiumGeospatial::CartographicPolygon polygon =
+        region.CreateCartographicPolygon(
+            pTileset->GetActorTransform().Inverse());
+    const std::vector<FCesiumCamera> views = createRegionViews(
+        *pTileset,
+        polygon.getVertices(),
+        options.groundHeight,
+        options.viewHeight);
+    if (views.empty()) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("The region is empty, or %s has no georeference."),
+          *pTileset->GetName());
+      continue;
+    }
+
+    auto pPackage = std::make_shared<TilesetPackage>();
+    if (writeArchives) {
+      const FString filename = FPaths::Combine(
+          options.archiveDirectory,
+          pTileset->GetName() + TEXT(".3tz"));
+      pPackage->pArchive = MakeUnique<CesiumTilesArchiveWriter>(filename);
+      if (!pPackage->pArchive->isOpen()) {
+        UE_LOG(LogCesium, Error, TEXT("Could not create %s"), *filename);
+        continue;
+      }
+      if (pTileset->GetTilesetSource() == ETilesetSource::FromUrl) {
+        pPackage->baseUrl = getDirectory(TCHAR_TO_UTF8(*pTileset->GetUrl()));
+      }
+    } else {
+      pPackage->pCacheDatabase = getCacheDatabase();
+      pPackage->expiryTime =
+          std::time(nullptr) +
+          std::time_t(FMath::Max(options.cacheLifetimeDays, 0.0) * 86400.0);
+    }
+
+    pTileset->SetRequestObserver([pPackage](const IAssetRequest& request) {
+      pPackage->record(request);
+    });
+    pTileset->RefreshTileset();
+
+    const size_t batchSize = size_t(options.viewsPerBatch);
+    for (size_t i = 0; i < views.size(); i += batchSize) {
+      const std::vector<FCesiumCamera> batch(
+          views.begin() + i,
+          views.begin() + std::min(i + batchSize, views.size()));
+      const FCesiumLoadTilesForViewsResult batchResult =
+          pTileset->LoadTilesForViews(
+              batch,
+              options.maximumScreenSpaceError,
+              options.maximumSimultaneousTileLoads,
+              options.batchTimeoutSeconds);
+      result.tilesSelected += batchResult.TilesSelected;
+      if (batchResult.bTimedOut) {
+        ++result.timedOutBatches;
+        result.failedRequests += batchResult.RequestsTimedOut;
+      }
+
+      UE_LOG(
+          LogCesium,
+          Display,
+          TEXT("Packaging %s: %d of %d views"),
+          *pTileset->GetName(),
+          int32(std::min(i + batchSize, views.size())),
+          int32(views.size()));
+    }
+
+    pTileset->SetRequestObserver(nullptr);
+    result.views += int64(views.size());
+
+    FScopeLock scopeLock(&pPackage->lock);
+    if (pPackage->pArchive && !pPackage->pArchive->close()) {
+      UE_LOG(
+          LogCesium,
+          Error,
+          TEXT("Could not finish writing the archive of %s"),
+          *pTileset->GetName());
+    }
+    addCounts(result, pPackage->counts);
+  }
+
+  if (!writeArchives) {
+    flushCacheDatabase();
+  }
+
+  return result;
+}
+
+/*static*/ bool
+CesiumRegionPackager::packageWorld(UWorld& world, const TCHAR* parameters) {
+  FString polygonName;
+  if (!FParse::Value(parameters, TEXT("Polygon="), polygonName)) {
+    UE_LOG(
+        LogCesium,
+        Error,
+        TEXT("Choose the region to package with Polygon=<name>."));
+    return false;
+  }
+
+  ACesiumCartographicPolygon* pRegion = nullptr;
+  for (TActorIterator<ACesiumCartographicPolygon> it(&world); it; ++it) {
+    if (hasName(**it, polygonName)) {
+      pRegion = *it;
+      break;
+    }
+  }
+  if (!pRegion) {
+    UE_LOG(
+        LogCesium,
+        Error,
+        TEXT("There is no cartographic polygon named %s."),
+        *polygonName);
+    return false;
+  }
+
+  FString tilesetsOption;
+  FParse::Value(parameters, TEXT("Tilesets="), tilesetsOption, false);
+  TArray<FString> tilesetNames;
+  tilesetsOption.ParseIntoArray(tilesetNames, TEXT(","));
+
+  TArray<ACesium3DTileset*> tilesets;
+  for (TActorIterator<ACesium3DTileset> it(&world); it; ++it) {
+    if (tilesetNames.IsEmpty() ||
+        tilesetNames.ContainsByPredicate(
+            [pTileset = *it](const FString& name) {
+              return hasName(*pTileset, name);
+            })) {
+      tilesets.Add(*it);
+    }
+  }
+  if (tilesets.IsEmpty()) {
+    UE_LOG(LogCesium, Error, TEXT("There are no tilesets to package."));
+    return false;
+  }
+
+  const Options options = parseOptions(parameters);
+  const Result result = package(*pRegion, tilesets, options);
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT(
+          "Packaged %s for %d tilesets with %lld views: %lld tiles selected, %lld requests (%lld failed), %lld batches timed out, %.1f MiB, %lld responses stored, %lld not stored."),
+      *polygonName,
+      tilesets.Num(),
+      result.views,
+      result.tilesSelected,
+      result.requests,
+      result.failedRequests,
+      result.timedOutBatches,
+      double(result.bytes) / (1024.0 * 1024.0),
+      result.storedResponses,
+      result.unstoredResponses);
+
+  const int32 maxCacheItems =
+      GetDefault<UCesiumRuntimeSettings>()->MaxCacheItems;
+  if (options.archiveDirectory.IsEmpty() &&
+      result.storedResponses > int64(maxCacheItems)) {
+    UE_LOG(
+        LogCesium,
+        Warning,
+        TEXT(
+            "The request cache keeps at most %d entries, so some of the %lld packaged responses will be pruned. Increase Max Cache Items in the Cesium project settings."),
+        maxCacheItems,
+        result.storedResponses);
+  }
+
+  return result.failedRequests == 0 && result.timedOutBatches == 0;
+}
@@ -0,0 +1,112 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumRegionPreload.h"
+#include "Async/Async.h"
+#include "CesiumGeospatial/Ellipsoid.h"
+#include "CesiumRegionPackager.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/vec2.hpp>
+
+namespace {
+
+// The number of views whose tiles are selected together.
+constexpr size_t ViewsPerBatch = 16;
+
+// The number of corners of the polygon that approximates the region.
+constexpr int32 CircleCorners = 32;
+
+} // namespace
+
+/*static*/ std::vector<FCesiumCamera> CesiumRegionPreload::createViews(
+    ACesium3DTileset& tileset,
+    const FVector& center,
+    double radius,
+    double viewHeight) {
+  if (radius <= 0.0) {
+    return {};
+  }
+
+  const double ellipsoidRadius =
+      CesiumGeospatial::Ellipsoid::WGS84.getRadii().x;
+  const double longitude = FMath::DegreesToRadians(center.X);
+  const double latitude = FMath::DegreesToRadians(center.Y);
+  const double longitudeRadius =
+      radius / (ellipsoidRadius * std::max(std::cos(latitude), 0.01));
+  const double latitudeRadius = radius / ellipsoidRadius;
+
+  std::vector<glm::dvec2> region;
+  region.reserve(CircleCorners);
+  for (int32 i = 0; i < CircleCorners; ++i) {
+    const double angle = 2.0 * PI * double(i) / double(CircleCorners);
+    region.emplace_back(
+        longitude + longitudeRadius * std::cos(angle),
+        latitude + latitudeRadius * std::sin(angle));
+  }
+
+  return CesiumRegionPackager::createRegionViews(
+      tileset,
+      region,
+      center.Z,
+      viewHeight);
+}
+
+CesiumRegionPreload::CesiumRegionPreload(
+    std::vector<FCesiumCamera>&& views,
+    double maximumScreenSpaceError,
+    TFunction<void(float)>&& onProgress)
+    : _views(std::move(views)),
+      _maximumScreenSpaceError(maximumScreenSpaceError),
+      _onProgress(std::move(onProgress)),
+      _pPromise(MakeShared<TPromise<bool>>()),
+      _batchStart(0),
+      _progress(0.0f),
+      _finished(false) {}
+
+CesiumRegionPreload::~CesiumRegionPreload() {
+  if (!this->_finished) {
+    this->finish(false);
+  }
+}
+
+std::vector<FCesiumCamera> CesiumRegionPreload::getBatchViews() const {
+  const size_t batchEnd =
+      std::min(this->_batchStart + ViewsPerBatch, this->_views.size());
+  return std::vector<FCesiumCamera>(
+      this->_views.begin() + this->_batchStart,
+      this->_views.begin() + batchEnd);
+}
+
+bool CesiumRegionPreload::update(float loadProgress) {
+  const size_t batchCount =
+      (this->_views.size() + ViewsPerBatch - 1) / ViewsPerBatch;
+  if (loadProgress >= 100.0f) {
+    this->_batchStart += ViewsPerBatch;
+    loadProgress = 0.0f;
+  }
+
+  const size_t batchesDone = this->_batchStart / ViewsPerBatch;
+  const bool done = batchesDone >= batchCount;
+  const float progress =
+      done ? 1.0f
+           : (float(batchesDone) + loadProgress / 100.0f) / float(batchCount);
+
+  // A batch's load progress can go down as its tiles reveal children to load.
+  if (progress > this->_progress) {
+    this->_progress = progress;
+    if (this->_onProgress) {
+      this->_onProgress(progress);
+    }
+  }
+
+  return done;
+}
+
+void CesiumRegionPreload::finish(bool succeeded) {
+  this->_finished = true;
+  AsyncTask(
+      ENamedThreads::GameThread,
+      [pPromise = this->_pPromise, succeeded]() {
+        pPromise->SetValue(succeeded);
+      });
+}
@@ -0,0 +1,84 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CesiumCamera.h"
+#include "Templates/Function.h"
+#include "Templates/SharedPointer.h"
+#include <vector>
+
+class ACesium3DTileset;
+
+/**
+ * The state of an ACesium3DTileset's region preload: the synthetic views
+ * that cover the region, which batch of them the tileset is loading, and the
+ * promise to fulfill once every batch has loaded.
+ *
+ * The views are loaded a batch at a time, so that each update of the tileset
+ * selects a bounded number of tiles. A batch is done when the tileset has
+ * nothing left to load for it.
+ */
+class CesiumRegionPreload {
+public:
+  /**
+   * Creates the views that look straight down on a circular region.
+   *
+   * @param tileset The tileset whose georeference and transform place the
+   * region.
+   * @param center The longitude and latitude of the center of the region in
+   * degrees, and the height of its ground in meters above the ellipsoid.
+   * @param radius The radius of the region, in meters.
+   * @param viewHeight The height of the views above the ground.
+   */
+  static std::vector<FCesiumCamera> createViews(
+      ACesium3DTileset& tileset,
+      const FVector& center,
+      double radius,
+      double viewHeight);
+
+  CesiumRegionPreload(
+      std::vector<FCesiumCamera>&& views,
+      double maximumScreenSpaceError,
+      TFunction<void(float)>&& onProgress);
+
+  /** Fails the preload if it has not finished. */
+  ~CesiumRegionPreload();
+
+  TFuture<bool> getFuture() { return this->_pPromise->GetFuture(); }
+
+  double getMaximumScreenSpaceError() const {
+    return this->_maximumScreenSpaceError;
+  }
+
+  /** Gets the views of the batch being loaded. */
+  std::vector<FCesiumCamera> getBatchViews() const;
+
+  /**
+   * Moves on to the next batch if the tileset has finished loading this one,
+   * and reports the progress.
+   *
+   * @param loadProgress The load progress of the tileset, from 0 to 100,
+   * after it was updated with the views of the current batch.
+   * @return Whether every batch has been loaded.
+   */
+  bool update(float loadProgress);
+
+  /** Gets the fraction of the region that has been loaded, from 0 to 1. */
+  float getProgress() const { return this->_progress; }
+
+  /**
+   * Fulfills the promise. Its continuations run in a later game thread task,
+   * so that they may start another preload or destroy the tileset.
+   */
+  void finish(bool succeeded);
+
+private:
+  std::vector<FCesiumCamera> _views;
+  double _maximumScreenSpaceError;
+  TFunction<void(float)> _onProgress;
+  TSharedPtr<TPromise<bool>> _pPromise;
+  size_t _batchStart;
+  float _progress;
+  bool _finished;
+};
@@ -0,0 +1,151 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumRequestPolicy.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumUrlHost.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+TAutoConsoleVariable<int32> CVarHedging(
+    TEXT("cesium.Requests.Hedging"),
+    -1,
+    TEXT(
+        "Whether to duplicate slow Cesium HTTP requests: 1 to enable, 0 to disable, or -1 to use the project setting."),
+    ECVF_Default);
+
+TAutoConsoleVariable<float> CVarHedgeMinimumDelay(
+    TEXT("cesium.Requests.HedgeMinimumDelayMs"),
+    -1.0f,
+    TEXT(
+        "The shortest time in milliseconds after which a Cesium HTTP request is duplicated, or -1 to use the project setting."),
+    ECVF_Default);
+
+TAutoConsoleVariable<int32> CVarMaximumRetries(
+    TEXT("cesium.Requests.MaximumRetries"),
+    -1,
+    TEXT(
+        "The number of times a Cesium HTTP request that fails transiently is retried, or -1 to use the project setting."),
+    ECVF_Default);
+
+TAutoConsoleVariable<float> CVarRetryBaseDelay(
+    TEXT("cesium.Requests.RetryBaseDelayMs"),
+    -1.0f,
+    TEXT(
+        "The longest delay in milliseconds before the first retry of a Cesium HTTP request, or -1 to use the project setting."),
+    ECVF_Default);
+
+} // namespace
+
+/*static*/ CesiumRequestPolicy CesiumRequestPolicy::getCurrent() {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+
+  CesiumRequestPolicy result;
+  result.hedgingEnabled = pSettings->EnableHedgedRequests;
+  result.hedgePercentile = pSettings->HedgedRequestPercentile;
+  result.minimumHedgeDelaySeconds =
+      pSettings->MinimumHedgeDelayMilliseconds / 1000.0;
+  result.maximumRetries = pSettings->MaximumRequestRetries;
+  result.retryBaseDelaySeconds = pSettings->RetryBaseDelayMilliseconds / 1000.0;
+  result.retryMaximumDelaySeconds =
+      pSettings->RetryMaximumDelayMilliseconds / 1000.0;
+
+  const int32 hedging = CVarHedging.GetValueOnAnyThread();
+  if (hedging >= 0) {
+    result.hedgingEnabled = hedging != 0;
+  }
+
+  const float minimumHedgeDelay = CVarHedgeMinimumDelay.GetValueOnAnyThread();
+  if (minimumHedgeDelay >= 0.0f) {
+    result.minimumHedgeDelaySeconds = minimumHedgeDelay / 1000.0;
+  }
+
+  const int32 maximumRetries = CVarMaximumRetries.GetValueOnAnyThread();
+  if (maximumRetries >= 0) {
+    result.maximumRetries = maximumRetries;
+  }
+
+  const float retryBaseDelay = CVarRetryBaseDelay.GetValueOnAnyThread();
+  if (retryBaseDelay >= 0.0f) {
+    result.retryBaseDelaySeconds = retryBaseDelay / 1000.0;
+  }
+
+  result.hedgePercentile = std::clamp(result.hedgePercentile, 0.0, 100.0);
+  result.maximumRetries = std::max(result.maximumRetries, 0);
+  return result;
+}
+
+/*static*/ bool
+CesiumRequestPolicy::isTransientFailure(bool connected, int32 statusCode) {
+  if (!connected) {
+    return true;
+  }
+
+  switch (statusCode) {
+  case 408: // Request Timeout
+  case 429: // Too Many Requests
+  case 500: // Internal Server Error
+  case 502: // Bad Gateway
+  case 503: // Service Unavailable
+  case 504: // Gateway Timeout
+    return true;
+  default:
+    return false;
+  }
+}
+
+double CesiumRequestPolicy::getRetryDelay(
+    int32 retry,
+    double random,
+    double serverDelaySeconds) const {
+  // Past 2^30 times the base delay, the limit is the maximum anyway.
+  const int32 doublings = std::clamp(retry - 1, 0, 30);
+  const double limit = std::min(
+      this->retryBaseDelaySeconds * std::ldexp(1.0, doublings),
+      this->retryMaximumDelaySeconds);
+  const double delay = std::clamp(random, 0.0, 1.0) * limit;
+  return std::min(
+      std::max(delay, serverDelaySeconds),
+      this->retryMaximumDelaySeconds);
+}
+
+void CesiumResponseTimes::record(const std::string& url, double seconds) {
+  const std::string host = getUrlHost(url);
+
+  FScopeLock lock(&this->_lock);
+  Samples& samples = this->_hosts[host];
+  if (samples.seconds.size() < MaximumSamples) {
+    samples.seconds.push_back(seconds);
+  } else {
+    samples.seconds[samples.next] = seconds;
+    samples.next = (samples.next + 1) % MaximumSamples;
+  }
+}
+
+std::optional<double> CesiumResponseTimes::getPercentile(
+    const std::string& url,
+    double percentile) const {
+  const std::string host = getUrlHost(url);
+
+  std::vector<double> seconds;
+  {
+    FScopeLock lock(&this->_lock);
+    auto it = this->_hosts.find(host);
+    if (it == this->_hosts.end() ||
+        it->second.seconds.size() < MinimumSamples) {
+      return std::nullopt;
+    }
+    seconds = it->second.seconds;
+  }
+
+  const size_t rank = size_t(std::clamp(
+      int64(std::ceil(percentile / 100.0 * double(seconds.size()))) - 1,
+      int64(0),
+      int64(seconds.size()) - 1));
+  std::nth_element(seconds.begin(), seconds.begin() + rank, seconds.end());
+  return seconds[rank];
+}
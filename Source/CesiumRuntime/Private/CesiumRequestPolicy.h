@@ -0,0 +1,101 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/CriticalSection.h"
+#include "HAL/Platform.h"
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * How UnrealAssetAccessor hedges slow HTTP GET requests and retries failed
+ * ones.
+ */
+struct CesiumRequestPolicy {
+  /**
+   * Whether to send a duplicate of a request whose response has not started
+   * to arrive after the hedge delay, and use whichever response arrives
+   * first.
+   */
+  bool hedgingEnabled = false;
+
+  /**
+   * The percentile of the recent times to the first byte of a host's
+   * responses after which a request to it is hedged.
+   */
+  double hedgePercentile = 95.0;
+
+  /** The shortest time after which a request is hedged. */
+  double minimumHedgeDelaySeconds = 0.1;
+
+  /** The number of times a request that fails transiently is retried. */
+  int32 maximumRetries = 0;
+
+  /** The limit of the delay before the first retry. */
+  double retryBaseDelaySeconds = 0.25;
+
+  /** The limit of the delay before any retry. */
+  double retryMaximumDelaySeconds = 10.0;
+
+  /**
+   * Gets the current policy, from the Requests section of the Cesium project
+   * settings, overridden by any `cesium.Requests.*` console variables that
+   * have been set. May be called from any thread.
+   */
+  static CesiumRequestPolicy getCurrent();
+
+  /**
+   * Determines whether a request that failed to connect, or that completed
+   * with the given HTTP status code, may succeed if it is sent again.
+   */
+  static bool isTransientFailure(bool connected, int32 statusCode);
+
+  /**
+   * Gets the delay before the given retry, where 1 is the first. The limit of
+   * the delay doubles with each retry, up to the maximum, and the delay is
+   * the fraction `random`, from 0 to 1, of that limit, so that clients that
+   * failed together do not retry together. A delay that the server asked
+   * for, such as with a `Retry-After` header, is honored up to the maximum.
+   */
+  double getRetryDelay(int32 retry, double random, double serverDelaySeconds)
+      const;
+};
+
+/**
+ * The recent response times of each host, measured to the first byte of each
+ * response, from which the delay before a request to it is hedged is derived.
+ * May be used from any thread.
+ */
+class CesiumResponseTimes {
+public:
+  /**
+   * Records the time that the response to a request to the given URL took to
+   * start arriving.
+   */
+  void record(const std::string& url, double seconds);
+
+  /**
+   * Gets the given percentile, from 0 to 100, of the recent response times
+   * of the host of the given URL, or nothing if too few requests to it have
+   * completed for the percentile to be meaningful.
+   */
+  std::optional<double>
+  getPercentile(const std::string& url, double percentile) const;
+
+  /** The number of requests to a host that must complete before hedging. */
+  static constexpr size_t MinimumSamples = 20;
+
+  /** The number of the most recent response times kept for each host. */
+  static constexpr size_t MaximumSamples = 200;
+
+private:
+  struct Samples {
+    std::vector<double> seconds;
+    size_t next = 0;
+  };
+
+  mutable FCriticalSection _lock;
+  std::unordered_map<std::string, Samples> _hosts;
+};
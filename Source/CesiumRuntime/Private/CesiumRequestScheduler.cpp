@@ -0,0 +1,440 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumRequestScheduler.h"
+#include "CesiumRuntime.h"
+#include "CesiumRuntimeSettings.h"
+#include "CesiumUrlHost.h"
+#include "CoreGlobals.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/IAssetRequest.h>
+#include <algorithm>
+#include <stdexcept>
+
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Requests Queued"),
+    STAT_CesiumRequestsQueued,
+    STATGROUP_Cesium);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Requests In Flight"),
+    STAT_CesiumRequestsInFlight,
+    STATGROUP_Cesium);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Requests Canceled"),
+    STAT_CesiumRequestsCanceled,
+    STATGROUP_Cesium);
+DECLARE_MEMORY_STAT(
+    TEXT("Download Saved By Cancellation"),
+    STAT_CesiumBytesSavedByCancellation,
+    STATGROUP_Cesium);
+
+using namespace CesiumAsync;
+
+namespace {
+
+TAutoConsoleVariable<int32> CVarMaximumRequestsPerHost(
+    TEXT("cesium.Requests.MaximumPerHost"),
+    -1,
+    TEXT(
+        "The maximum number of Cesium HTTP requests in flight to each host (0 for no limit), or -1 to use the project setting."),
+    ECVF_Default);
+
+/**
+ * Queued requests that have waited at least this long are sent before newer
+ * requests, regardless of the frame in which they were made.
+ */
+constexpr double MaximumQueueSeconds = 2.0;
+
+} // namespace
+
+class CesiumRequestScheduler::GroupAssetAccessor : public IAssetAccessor {
+public:
+  GroupAssetAccessor(
+      const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+      const std::shared_ptr<CesiumRequestScheduler>& pScheduler,
+      uint64 group)
+      : _pAssetAccessor(pAssetAccessor),
+        _pScheduler(pScheduler),
+        _group(group) {}
+
+  virtual ~GroupAssetAccessor() {
+    this->_pScheduler->releaseGroup(this->_group);
+  }
+
+  virtual Future<std::shared_ptr<IAssetRequest>>
+  get(const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    std::shared_ptr<CesiumRequestScheduler> pScheduler = this->_pScheduler;
+    const uint64 group = this->_group;
+
+    if (!pScheduler->attribute(url, group)) {
+      Promise<std::shared_ptr<IAssetRequest>> promise =
+          asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>();
+      promise.reject(std::runtime_error(
+          "The request was canceled because its tileset no longer needs it."));
+      return promise.getFuture();
+    }
+
+    return this->_pAssetAccessor->get(asyncSystem, url, headers)
+        .thenImmediately([pScheduler, url, group](
+                             std::shared_ptr<IAssetRequest>&& pRequest) {
+          pScheduler->unattribute(url, group);
+          return std::move(pRequest);
+        })
+        .catchImmediately(
+            [pScheduler, url, group](
+                std::exception&& e) -> std::shared_ptr<IAssetRequest> {
+              pScheduler->unattribute(url, group);
+              throw std::runtime_error(e.what());
+            });
+  }
+
+  virtual Future<std::shared_ptr<IAssetRequest>> request(
+      const AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override {
+    return this->_pAssetAccessor
+        ->request(asyncSystem, verb, url, headers, contentPayload);
+  }
+
+  virtual void tick() noexcept override { this->_pAssetAccessor->tick(); }
+
+private:
+  std::shared_ptr<IAssetAccessor> _pAssetAccessor;
+  std::shared_ptr<CesiumRequestScheduler> _pScheduler;
+  uint64 _group;
+};
+
+/*static*/ const std::shared_ptr<CesiumRequestScheduler>&
+CesiumRequestScheduler::getInstance() {
+  static std::shared_ptr<CesiumRequestScheduler> pInstance =
+      std::make_shared<CesiumRequestScheduler>(
+          []() {
+            const int32 maximum =
+                CVarMaximumRequestsPerHost.GetValueOnAnyThread();
+            return maximum >= 0 ? maximum
+                                : GetDefault<UCesiumRuntimeSettings>()
+                                      ->MaximumRequestsPerHost;
+          },
+          []() { return GFrameCounter; });
+  return pInstance;
+}
+
+CesiumRequestScheduler::CesiumRequestScheduler(
+    std::function<int32()> getMaximumRequestsPerHost,
+    std::function<uint64()> getFrame)
+    : _getMaximumRequestsPerHost(std::move(getMaximumRequestsPerHost)),
+      _getFrame(std::move(getFrame)),
+      _lock(),
+      _hosts(),
+      _attributions(),
+      _groups(),
+      _nextGroup(1),
+      _nextSequence(0),
+      _statistics() {}
+
+CesiumRequestScheduler::~CesiumRequestScheduler() = default;
+
+uint64 CesiumRequestScheduler::createGroup() {
+  FScopeLock lock(&this->_lock);
+  return this->_nextGroup++;
+}
+
+std::shared_ptr<IAssetAccessor>
+CesiumRequestScheduler::createGroupAssetAccessor(
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+    uint64 group) {
+  {
+    FScopeLock lock(&this->_lock);
+    this->_groups.emplace(group, false);
+  }
+
+  return std::make_shared<GroupAssetAccessor>(
+      pAssetAccessor,
+      this->shared_from_this(),
+      group);
+}
+
+void CesiumRequestScheduler::cancelGroup(uint64 group) {
+  std::vector<std::function<void()>> toCancel;
+
+  {
+    FScopeLock lock(&this->_lock);
+    auto groupIt = this->_groups.find(group);
+    if (groupIt != this->_groups.end()) {
+      groupIt->second = true;
+    }
+
+    // The URLs that only this group was waiting for.
+    std::vector<std::string> abandoned;
+    for (auto it = this->_attributions.begin();
+         it != this->_attributions.end();) {
+      std::vector<uint64>& groups = it->second.groups;
+      groups.erase(
+          std::remove(groups.begin(), groups.end(), group),
+          groups.end());
+      std::vector<uint64>& unsubmitted = it->second.unsubmitted;
+      unsubmitted.erase(
+          std::remove(unsubmitted.begin(), unsubmitted.end(), group),
+          unsubmitted.end());
+      if (groups.empty()) {
+        abandoned.emplace_back(it->first);
+        it = this->_attributions.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    for (const std::string& url : abandoned) {
+      auto hostIt = this->_hosts.find(getUrlHost(url));
+      if (hostIt == this->_hosts.end()) {
+        continue;
+      }
+
+      // A queued request that belongs to a group, when no group is waiting
+      // for its URL, can only belong to this group or to one canceled
+      // earlier.
+      Host& host = hostIt->second;
+      auto [begin, end] = host.sequences.equal_range(url);
+      std::vector<uint64> sequences;
+      for (auto it = begin; it != end; ++it) {
+        if (host.queue.at(it->second).grouped) {
+          sequences.push_back(it->second);
+        }
+      }
+
+      for (uint64 sequence : sequences) {
+        auto it = host.queue.find(sequence);
+        toCancel.emplace_back(std::move(it->second.cancel));
+        this->removeQueued(host, it);
+        this->countCanceled(host.getMeanBytes());
+        --this->_statistics.queued;
+        DEC_DWORD_STAT(STAT_CesiumRequestsQueued);
+      }
+    }
+  }
+
+  for (const std::function<void()>& cancel : toCancel) {
+    cancel();
+  }
+}
+
+void CesiumRequestScheduler::submit(
+    const std::string& url,
+    std::function<void()>&& send,
+    std::function<void()>&& cancel) {
+  const std::string hostName = getUrlHost(url);
+  const int32 maximum = this->_getMaximumRequestsPerHost();
+
+  {
+    FScopeLock lock(&this->_lock);
+    Host& host = this->_hosts[hostName];
+
+    uint64 frame = this->_getFrame();
+    bool grouped = false;
+    auto it = this->_attributions.find(url);
+    if (it != this->_attributions.end()) {
+      frame = std::max(frame, it->second.frame);
+
+      std::vector<uint64>& unsubmitted = it->second.unsubmitted;
+      if (!unsubmitted.empty()) {
+        unsubmitted.erase(unsubmitted.begin());
+        grouped = true;
+      }
+    }
+
+    if (maximum > 0 && host.inFlight >= maximum) {
+      const uint64 sequence = this->_nextSequence++;
+      host.queue.emplace(
+          sequence,
+          QueuedRequest{
+              url,
+              grouped,
+              frame,
+              sequence,
+              FPlatformTime::Seconds(),
+              std::move(send),
+              std::move(cancel)});
+      host.priorities.insert(Priority{frame, sequence});
+      host.sequences.emplace(url, sequence);
+      ++this->_statistics.queued;
+      INC_DWORD_STAT(STAT_CesiumRequestsQueued);
+      return;
+    }
+
+    ++host.inFlight;
+    ++this->_statistics.inFlight;
+    ++this->_statistics.sent;
+    INC_DWORD_STAT(STAT_CesiumRequestsInFlight);
+  }
+
+  send();
+}
+
+bool CesiumRequestScheduler::trySend(const std::string& url) {
+  const std::string hostName = getUrlHost(url);
+  const int32 maximum = this->_getMaximumRequestsPerHost();
+
+  FScopeLock lock(&this->_lock);
+  Host& host = this->_hosts[hostName];
+  if (maximum > 0 && host.inFlight >= maximum) {
+    return false;
+  }
+
+  ++host.inFlight;
+  ++this->_statistics.inFlight;
+  ++this->_statistics.sent;
+  INC_DWORD_STAT(STAT_CesiumRequestsInFlight);
+  return true;
+}
+
+void CesiumRequestScheduler::complete(const std::string& url, int64 bytes) {
+  const std::string hostName = getUrlHost(url);
+  std::vector<std::function<void()>> toSend;
+
+  {
+    FScopeLock lock(&this->_lock);
+    Host& host = this->_hosts[hostName];
+    --host.inFlight;
+    ++host.completed;
+    host.completedBytes += bytes;
+    --this->_statistics.inFlight;
+    DEC_DWORD_STAT(STAT_CesiumRequestsInFlight);
+
+    this->dequeue(host, toSend);
+  }
+
+  for (const std::function<void()>& send : toSend) {
+    send();
+  }
+}
+
+CesiumRequestScheduler::Statistics
+CesiumRequestScheduler::getStatistics() const {
+  FScopeLock lock(&this->_lock);
+  return this->_statistics;
+}
+
+bool CesiumRequestScheduler::attribute(const std::string& url, uint64 group) {
+  FScopeLock lock(&this->_lock);
+  auto groupIt = this->_groups.find(group);
+  if (groupIt != this->_groups.end() && groupIt->second) {
+    auto hostIt = this->_hosts.find(getUrlHost(url));
+    this->countCanceled(
+        hostIt != this->_hosts.end() ? hostIt->second.getMeanBytes() : 0);
+    return false;
+  }
+
+  Attribution& attribution = this->_attributions[url];
+  attribution.groups.push_back(group);
+  attribution.unsubmitted.push_back(group);
+
+  const uint64 frame = this->_getFrame();
+  if (frame <= attribution.frame) {
+    return true;
+  }
+  attribution.frame = frame;
+
+  // Move any queued requests to the URL up to this frame.
+  auto hostIt = this->_hosts.find(getUrlHost(url));
+  if (hostIt != this->_hosts.end()) {
+    Host& host = hostIt->second;
+    auto [begin, end] = host.sequences.equal_range(url);
+    for (auto it = begin; it != end; ++it) {
+      QueuedRequest& request = host.queue.at(it->second);
+      if (request.frame < frame) {
+        host.priorities.erase(Priority{request.frame, request.sequence});
+        request.frame = frame;
+        host.priorities.insert(Priority{request.frame, request.sequence});
+      }
+    }
+  }
+
+  return true;
+}
+
+void CesiumRequestScheduler::unattribute(
+    const std::string& url,
+    uint64 group) {
+  FScopeLock lock(&this->_lock);
+  auto it = this->_attributions.find(url);
+  if (it == this->_attributions.end()) {
+    return;
+  }
+
+  std::vector<uint64>& groups = it->second.groups;
+  auto groupIt = std::find(groups.begin(), groups.end(), group);
+  if (groupIt != groups.end()) {
+    groups.erase(groupIt);
+  }
+
+  std::vector<uint64>& unsubmitted = it->second.unsubmitted;
+  auto unsubmittedIt = std::find(unsubmitted.begin(), unsubmitted.end(), group);
+  if (unsubmittedIt != unsubmitted.end()) {
+    unsubmitted.erase(unsubmittedIt);
+  }
+
+  if (groups.empty()) {
+    this->_attributions.erase(it);
+  }
+}
+
+void CesiumRequestScheduler::releaseGroup(uint64 group) {
+  FScopeLock lock(&this->_lock);
+  this->_groups.erase(group);
+}
+
+void CesiumRequestScheduler::countCanceled(int64 meanBytes) {
+  ++this->_statistics.canceled;
+  this->_statistics.estimatedBytesSaved += meanBytes;
+  INC_DWORD_STAT(STAT_CesiumRequestsCanceled);
+  INC_MEMORY_STAT_BY(STAT_CesiumBytesSavedByCancellation, meanBytes);
+}
+
+void CesiumRequestScheduler::removeQueued(
+    Host& host,
+    std::map<uint64, QueuedRequest>::iterator it) {
+  const QueuedRequest& request = it->second;
+  host.priorities.erase(Priority{request.frame, request.sequence});
+
+  auto [begin, end] = host.sequences.equal_range(request.url);
+  for (auto sequenceIt = begin; sequenceIt != end; ++sequenceIt) {
+    if (sequenceIt->second == request.sequence) {
+      host.sequences.erase(sequenceIt);
+      break;
+    }
+  }
+
+  host.queue.erase(it);
+}
+
+void CesiumRequestScheduler::dequeue(
+    Host& host,
+    std::vector<std::function<void()>>& toSend) {
+  const int32 maximum = this->_getMaximumRequestsPerHost();
+  const double now = FPlatformTime::Seconds();
+
+  while (!host.queue.empty() && (maximum <= 0 || host.inFlight < maximum)) {
+    // The queue is in the order in which the requests were queued, so if any
+    // request has waited too long, the first one has.
+    auto it = host.queue.begin();
+    if (now - it->second.queuedTime < MaximumQueueSeconds) {
+      it = host.queue.find(host.priorities.begin()->sequence);
+    }
+
+    toSend.emplace_back(std::move(it->second.send));
+    this->removeQueued(host, it);
+
+    ++host.inFlight;
+    ++this->_statistics.inFlight;
+    ++this->_statistics.sent;
+    --this->_statistics.queued;
+    INC_DWORD_STAT(STAT_CesiumRequestsInFlight);
+    DEC_DWORD_STAT(STAT_CesiumRequestsQueued);
+  }
+}
@@ -0,0 +1,235 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/CriticalSection.h"
+#include "HAL/Platform.h"
+#include <CesiumAsync/IAssetAccessor.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Limits the number of HTTP requests that UnrealAssetAccessor has in flight
+ * to each host, and decides which of the queued requests to send next.
+ *
+ * Requests made through the asset accessor of a request group, which each
+ * tileset has, are attributed to that group. cesium-native issues the
+ * requests of each tileset in order of screen-space error and distance, so
+ * the queued requests are sent in that order, except that requests made in
+ * later frames are sent before those made in earlier ones, because they
+ * reflect where the camera is now. A request that a group makes again, for
+ * example through another tileset, moves up to the frame in which it was
+ * made again. Requests that have been queued for too long are sent first, so
+ * that a busy host cannot starve them.
+ *
+ * When a group is canceled, such as when its tileset is destroyed, its queued
+ * requests that no other group is waiting for are failed without being sent.
+ * A queued request belongs to a group if it was submitted for a request made
+ * through that group, after whatever caching and coalescing lie in between.
+ * Requests that were not made through a group are never canceled.
+ * The number of these requests, and an estimate of the bytes they would have
+ * downloaded, are shown in the `stat Cesium` group.
+ */
+class CesiumRequestScheduler
+    : public std::enable_shared_from_this<CesiumRequestScheduler> {
+public:
+  struct Statistics {
+    /** The number of requests waiting for a free slot. */
+    int64 queued = 0;
+
+    /** The number of requests that have been sent but not completed. */
+    int64 inFlight = 0;
+
+    /** The total number of requests that have been sent. */
+    int64 sent = 0;
+
+    /** The total number of queued requests that were canceled. */
+    int64 canceled = 0;
+
+    /**
+     * An estimate of the bytes that the canceled requests would have
+     * downloaded, from the mean response size of their hosts.
+     */
+    int64 estimatedBytesSaved = 0;
+  };
+
+  /**
+   * Gets the scheduler used by UnrealAssetAccessor, whose limit comes from
+   * the Cesium runtime settings or the `cesium.Requests.MaximumPerHost`
+   * console variable.
+   */
+  static const std::shared_ptr<CesiumRequestScheduler>& getInstance();
+
+  /**
+   * Creates a scheduler.
+   *
+   * @param getMaximumRequestsPerHost Gets the maximum number of requests in
+   * flight to each host, or 0 for no limit. It is called from any thread.
+   * @param getFrame Gets the number of the current frame.
+   */
+  CesiumRequestScheduler(
+      std::function<int32()> getMaximumRequestsPerHost,
+      std::function<uint64()> getFrame);
+  ~CesiumRequestScheduler();
+
+  /** Creates a new request group. */
+  uint64 createGroup();
+
+  /**
+   * Wraps the given asset accessor so that the requests it makes are
+   * attributed to the given group.
+   */
+  std::shared_ptr<CesiumAsync::IAssetAccessor> createGroupAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor,
+      uint64 group);
+
+  /**
+   * Cancels the queued requests of the given group that no other group is
+   * waiting for, and any requests that the group makes from now on. Queued
+   * requests that were not made through a group are left alone. The group is
+   * forgotten once its asset accessor is destroyed.
+   */
+  void cancelGroup(uint64 group);
+
+  /**
+   * Sends a request to the given URL with `send` now, if its host has a free
+   * slot, or later, when it reaches the front of the host's queue. If the
+   * request is canceled while it is queued, `cancel` is called instead.
+   * Every request that is sent must be completed with `complete`. Neither
+   * function is called while the scheduler is locked.
+   */
+  void submit(
+      const std::string& url,
+      std::function<void()>&& send,
+      std::function<void()>&& cancel);
+
+  /**
+   * Counts a request to the given URL as sent, and returns true, only if its
+   * host has a free slot. The caller then sends the request itself and must
+   * complete it with `complete`. This is for requests that are not worth
+   * waiting for a slot, such as duplicates of slow requests.
+   */
+  bool trySend(const std::string& url);
+
+  /**
+   * Records that a sent request to the given URL has completed, having
+   * downloaded the given number of bytes, and sends the next queued request
+   * to its host.
+   */
+  void complete(const std::string& url, int64 bytes);
+
+  Statistics getStatistics() const;
+
+private:
+  class GroupAssetAccessor;
+
+  struct QueuedRequest {
+    std::string url;
+
+    /**
+     * Whether the request was made through a group, and so may be canceled
+     * when no group is waiting for it any more.
+     */
+    bool grouped;
+
+    uint64 frame;
+    uint64 sequence;
+    double queuedTime;
+    std::function<void()> send;
+    std::function<void()> cancel;
+  };
+
+  /** The position of a queued request in the order in which it is sent. */
+  struct Priority {
+    uint64 frame;
+    uint64 sequence;
+
+    /** Later frames first, and then the order in which they were queued. */
+    bool operator<(const Priority& other) const {
+      return this->frame != other.frame ? this->frame > other.frame
+                                        : this->sequence < other.sequence;
+    }
+  };
+
+  struct Host {
+    int32 inFlight = 0;
+    int64 completed = 0;
+    int64 completedBytes = 0;
+
+    /**
+     * The queued requests by sequence number, which is the order in which
+     * they were queued.
+     */
+    std::map<uint64, QueuedRequest> queue;
+
+    /** The queued requests in the order in which they are sent. */
+    std::set<Priority> priorities;
+
+    /** The sequence numbers of the queued requests to each URL. */
+    std::unordered_multimap<std::string, uint64> sequences;
+
+    int64 getMeanBytes() const {
+      return this->completed > 0 ? this->completedBytes / this->completed : 0;
+    }
+  };
+
+  struct Attribution {
+    /** The groups waiting for the URL, with one entry per request. */
+    std::vector<uint64> groups;
+
+    /**
+     * The groups whose requests for the URL have not reached the scheduler
+     * yet, in the order in which they were made. A request that is submitted
+     * while this is not empty was made through the first of them. Requests
+     * that are served from the cache, or coalesced with another, never reach
+     * the scheduler and are removed when they complete.
+     */
+    std::vector<uint64> unsubmitted;
+
+    /** The most recent frame in which one of the groups requested it. */
+    uint64 frame = 0;
+  };
+
+  /**
+   * Attributes a request to the given URL to the given group, or, if the
+   * group has been canceled, counts the request as canceled and returns
+   * false.
+   */
+  bool attribute(const std::string& url, uint64 group);
+  void unattribute(const std::string& url, uint64 group);
+
+  /** Forgets a group, which can make no more requests. */
+  void releaseGroup(uint64 group);
+
+  /**
+   * Counts a request as canceled before it was sent, which would have
+   * downloaded the given number of bytes.
+   */
+  void countCanceled(int64 meanBytes);
+
+  /** Removes a request from the queue of the given host. */
+  void removeQueued(Host& host, std::map<uint64, QueuedRequest>::iterator it);
+
+  /**
+   * Removes the requests that can be sent now from the queue of the given
+   * host and adds their `send` functions to `toSend`.
+   */
+  void dequeue(Host& host, std::vector<std::function<void()>>& toSend);
+
+  std::function<int32()> _getMaximumRequestsPerHost;
+  std::function<uint64()> _getFrame;
+
+  mutable FCriticalSection _lock;
+  std::unordered_map<std::string, Host> _hosts;
+  std::unordered_map<std::string, Attribution> _attributions;
+  // Whether each group that has an asset accessor has been canceled.
+  std::unordered_map<uint64, bool> _groups;
+  uint64 _nextGroup;
+  uint64 _nextSequence;
+  Statistics _statistics;
+};
@@ -1,17 +1,24 @@
 // Copyright 2020-2024 CesiumGS, Inc. and Contributors
 
 #include "CesiumRuntime.h"
+#include "ArchiveAssetAccessor.h"
+#include "AsyncCacheDatabase.h"
 #include "Cesium3DTilesContent/registerAllTileContentTypes.h"
+#include "CesiumAllocationCounter.h"
 #include "CesiumAsync/CachingAssetAccessor.h"
 #include "CesiumAsync/GunzipAssetAccessor.h"
 #include "CesiumAsync/SqliteCache.h"
 #include "CesiumRuntimeSettings.h"
 #include "CesiumUtility/Tracing.h"
+#include "CoalescingAssetAccessor.h"
 #include "HAL/FileManager.h"
 #include "HttpModule.h"
 #include "Interfaces/IPluginManager.h"
+#include "Misc/CoreDelegates.h"
 #include "Misc/Paths.h"
+#include "NetworkEmulationAssetAccessor.h"
 #include "ShaderCore.h"
+#include "ShardedFileCacheDatabase.h"
 #include "SpdlogUnrealLoggerSink.h"
 #include "UnrealAssetAccessor.h"
 #include "UnrealTaskProcessor.h"
@@ -28,7 +35,17 @@
 
 DEFINE_LOG_CATEGORY(LogCesium);
 
+namespace {
+
+/** The request cache, once getCacheDatabase has created it. */
+std::weak_ptr<AsyncCacheDatabase> CreatedCacheDatabase;
+
+} // namespace
+
 void FCesiumRuntimeModule::StartupModule() {
+  // This must happen before this module's own threads start allocating.
+  CesiumAllocationCounter::installIfRequested();
+
   Cesium3DTilesContent::registerAllTileContentTypes();
 
   std::shared_ptr<spdlog::logger> pLogger = spdlog::default_logger();
@@ -50,9 +67,26 @@ void FCesiumRuntimeModule::StartupModule() {
   AddShaderSourceDirectoryMapping(
       TEXT("/Plugin/CesiumForUnreal"),
       PluginShaderDir);
+
+  // Start opening the request cache in the background now, rather than on
+  // whichever thread first needs it. The settings it depends on are not
+  // available until the engine has been initialized.
+  if (GIsRunning) {
+    getCacheDatabase();
+  } else {
+    FCoreDelegates::OnPostEngineInit.AddLambda([]() { getCacheDatabase(); });
+  }
 }
 
-void FCesiumRuntimeModule::ShutdownModule() { CESIUM_TRACE_SHUTDOWN(); }
+void FCesiumRuntimeModule::ShutdownModule() {
+  // Write the cache entries that are still queued while the engine can.
+  if (std::shared_ptr<AsyncCacheDatabase> pCacheDatabase =
+          CreatedCacheDatabase.lock()) {
+    pCacheDatabase->shutdown();
+  }
+
+  CESIUM_TRACE_SHUTDOWN();
+}
 
 #undef LOCTEXT_NAMESPACE
 
@@ -70,7 +104,11 @@ CesiumAsync::AsyncSystem& getAsyncSystem() noexcept {
 
 namespace {
 
-std::string getCacheDatabaseName() {
+/**
+ * Gets the absolute path of the request cache with the given file or
+ * directory name.
+ */
+FString getCachePath(const TCHAR* name) {
 #if PLATFORM_ANDROID
   FString BaseDirectory = FPaths::ProjectPersistentDownloadDir();
 #elif PLATFORM_IOS
@@ -83,11 +121,10 @@ std::string getCacheDatabaseName() {
   FString BaseDirectory = FPaths::EngineUserDir();
 #endif
 
-  FString CesiumDBFile =
-      FPaths::Combine(*BaseDirectory, TEXT("cesium-request-cache.sqlite"));
+  FString CachePath = FPaths::Combine(*BaseDirectory, name);
   FString PlatformAbsolutePath =
       IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(
-          *CesiumDBFile);
+          *CachePath);
 
   UE_LOG(
       LogCesium,
@@ -95,33 +132,96 @@ std::string getCacheDatabaseName() {
       TEXT("Caching Cesium requests in %s"),
       *PlatformAbsolutePath);
 
-  return TCHAR_TO_UTF8(*PlatformAbsolutePath);
+  return PlatformAbsolutePath;
+}
+
+std::shared_ptr<AsyncCacheDatabase> createCacheDatabase() {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+  const uint64 maxItems = uint64(FMath::Max(pSettings->MaxCacheItems, 0));
+
+  std::function<std::shared_ptr<CesiumAsync::ICacheDatabase>()> open;
+  if (pSettings->CacheDatabase == ECesiumCacheDatabase::ShardedFiles) {
+    open = [directory = getCachePath(TEXT("cesium-request-cache")),
+            maxItems]() {
+      return std::make_shared<ShardedFileCacheDatabase>(directory, maxItems);
+    };
+  } else {
+    open = [filename = std::string(TCHAR_TO_UTF8(
+                *getCachePath(TEXT("cesium-request-cache.sqlite")))),
+            maxItems]() {
+      return std::make_shared<CesiumAsync::SqliteCache>(
+          spdlog::default_logger(),
+          filename,
+          maxItems);
+    };
+  }
+
+  std::shared_ptr<AsyncCacheDatabase> pCacheDatabase =
+      std::make_shared<AsyncCacheDatabase>(
+          std::move(open),
+          pSettings->MaximumQueuedCacheWriteBytes);
+  CreatedCacheDatabase = pCacheDatabase;
+  return pCacheDatabase;
 }
 
 } // namespace
 
 std::shared_ptr<CesiumAsync::ICacheDatabase>& getCacheDatabase() {
-  static int MaxCacheItems =
-      GetDefault<UCesiumRuntimeSettings>()->MaxCacheItems;
-
   static std::shared_ptr<CesiumAsync::ICacheDatabase> pCacheDatabase =
-      std::make_shared<CesiumAsync::SqliteCache>(
-          spdlog::default_logger(),
-          getCacheDatabaseName(),
-          MaxCacheItems);
-
+      createCacheDatabase();
   return pCacheDatabase;
 }
 
+void flushCacheDatabase() {
+  if (std::shared_ptr<AsyncCacheDatabase> pCacheDatabase =
+          CreatedCacheDatabase.lock()) {
+    pCacheDatabase->flush();
+  }
+}
+
+namespace {
+
+std::shared_ptr<CesiumAsync::IAssetAccessor> createAssetAccessor() {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> pNetworkAccessor =
+      std::make_shared<NetworkEmulationAssetAccessor>(
+          std::make_shared<ArchiveAssetAccessor>(
+              std::make_shared<UnrealAssetAccessor>()));
+
+  auto createCachingAccessor =
+      [pSettings](
+          const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor) {
+        return std::make_shared<CesiumAsync::CachingAssetAccessor>(
+            spdlog::default_logger(),
+            pAssetAccessor,
+            getCacheDatabase(),
+            pSettings->RequestsPerCachePrune);
+      };
+
+  if (pSettings->CacheDecompressedResponses) {
+    // Responses are gunzipped before they are cached, so cache hits need no
+    // inflating. The outer GunzipAssetAccessor only inflates responses that
+    // were cached compressed, before this setting was enabled; for the rest
+    // it just checks the first two bytes.
+    return std::make_shared<CoalescingAssetAccessor>(
+        std::make_shared<CesiumAsync::GunzipAssetAccessor>(
+            createCachingAccessor(
+                std::make_shared<CesiumAsync::GunzipAssetAccessor>(
+                    pNetworkAccessor))));
+  }
+
+  return std::make_shared<CoalescingAssetAccessor>(
+      std::make_shared<CesiumAsync::GunzipAssetAccessor>(
+          createCachingAccessor(pNetworkAccessor)));
+}
+
+} // namespace
+
 const std::shared_ptr<CesiumAsync::IAssetAccessor>& getAssetAccessor() {
-  static int RequestsPerCachePrune =
-      GetDefault<UCesiumRuntimeSettings>()->RequestsPerCachePrune;
   static std::shared_ptr<CesiumAsync::IAssetAccessor> pAssetAccessor =
-      std::make_shared<CesiumAsync::GunzipAssetAccessor>(
-          std::make_shared<CesiumAsync::CachingAssetAccessor>(
-              spdlog::default_logger(),
-              std::make_shared<UnrealAssetAccessor>(),
-              getCacheDatabase(),
-              RequestsPerCachePrune));
+      createAssetAccessor();
   return pAssetAccessor;
 }
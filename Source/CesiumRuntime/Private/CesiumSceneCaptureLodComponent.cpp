@@ -0,0 +1,7 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumSceneCaptureLodComponent.h"
+
+UCesiumSceneCaptureLodComponent::UCesiumSceneCaptureLodComponent() {
+  this->PrimaryComponentTick.bCanEverTick = false;
+}
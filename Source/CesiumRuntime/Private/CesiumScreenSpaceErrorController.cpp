@@ -0,0 +1,183 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumScreenSpaceErrorController.h"
+#include "CesiumRuntime.h"
+#include "CoreGlobals.h"
+#include <algorithm>
+#include <cmath>
+
+DECLARE_FLOAT_COUNTER_STAT(
+    TEXT("Highest Adaptive Screen Space Error"),
+    STAT_CesiumHighestAdaptiveScreenSpaceError,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Adaptive SSE Tilesets Within Targets"),
+    STAT_CesiumAdaptiveScreenSpaceErrorWithinTargets,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Adaptive SSE Tilesets Improving"),
+    STAT_CesiumAdaptiveScreenSpaceErrorImproving,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Adaptive SSE Tilesets Limited By Game Thread Time"),
+    STAT_CesiumAdaptiveScreenSpaceErrorGameThreadTime,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Adaptive SSE Tilesets Limited By GPU Memory"),
+    STAT_CesiumAdaptiveScreenSpaceErrorGpuMemory,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Adaptive SSE Tilesets Limited By Load Queue"),
+    STAT_CesiumAdaptiveScreenSpaceErrorLoadQueue,
+    STATGROUP_Cesium);
+
+namespace {
+
+// The factor by which the screen-space error is raised when a measurement is
+// over its target. This is larger than the factor by which it is lowered, so
+// that the controller reacts quickly to a hitch and recovers carefully.
+constexpr double RaiseFactor = 1.25;
+constexpr double LowerFactor = 1.1;
+
+// The lowest screen-space error the controller chooses, whatever its
+// minimum. A screen-space error of zero could never be raised by a factor.
+constexpr double LowestScreenSpaceError = 1.0;
+
+// The time constant, in seconds, over which the game thread time is smoothed.
+constexpr double GameThreadSmoothingSeconds = 0.5;
+
+} // namespace
+
+double CesiumScreenSpaceErrorController::update(
+    const FCesiumAdaptiveScreenSpaceError& settings,
+    double baseScreenSpaceError,
+    const Measurements& measurements,
+    double deltaTime) {
+  if (!settings.Enabled) {
+    this->reset();
+    this->_screenSpaceError = baseScreenSpaceError;
+    return this->_screenSpaceError;
+  }
+
+  this->adjust(settings, baseScreenSpaceError, measurements, deltaTime);
+  this->reportStatistics();
+  return this->_screenSpaceError;
+}
+
+void CesiumScreenSpaceErrorController::reset() {
+  this->_screenSpaceError = -1.0;
+  this->_reason = ECesiumAdaptiveScreenSpaceErrorReason::Disabled;
+  this->_smoothedGameThreadMilliseconds = 0.0;
+  this->_secondsSinceAdjustment = 0.0;
+}
+
+void CesiumScreenSpaceErrorController::adjust(
+    const FCesiumAdaptiveScreenSpaceError& settings,
+    double baseScreenSpaceError,
+    const Measurements& measurements,
+    double deltaTime) {
+  const double minimum =
+      std::max(settings.MinimumScreenSpaceError, LowestScreenSpaceError);
+  const double maximum = std::max(settings.MaximumScreenSpaceError, minimum);
+
+  if (this->_reason == ECesiumAdaptiveScreenSpaceErrorReason::Disabled) {
+    this->_screenSpaceError =
+        std::clamp(baseScreenSpaceError, minimum, maximum);
+    this->_smoothedGameThreadMilliseconds = measurements.gameThreadMilliseconds;
+    this->_secondsSinceAdjustment = 0.0;
+    this->_reason = ECesiumAdaptiveScreenSpaceErrorReason::WithinTargets;
+    return;
+  }
+
+  const double smoothing =
+      1.0 - std::exp(-std::max(deltaTime, 0.0) / GameThreadSmoothingSeconds);
+  this->_smoothedGameThreadMilliseconds +=
+      (measurements.gameThreadMilliseconds -
+       this->_smoothedGameThreadMilliseconds) *
+      smoothing;
+
+  // Keep the bounds current even between adjustments.
+  this->_screenSpaceError =
+      std::clamp(this->_screenSpaceError, minimum, maximum);
+
+  this->_secondsSinceAdjustment += deltaTime;
+  if (this->_secondsSinceAdjustment < settings.AdjustmentIntervalSeconds) {
+    return;
+  }
+  this->_secondsSinceAdjustment = 0.0;
+
+  // Find the measurement that is furthest over, or closest to, its target.
+  double highestRatio = 0.0;
+  ECesiumAdaptiveScreenSpaceErrorReason limitingReason =
+      ECesiumAdaptiveScreenSpaceErrorReason::WithinTargets;
+  auto consider = [&highestRatio, &limitingReason](
+                      double value,
+                      double target,
+                      ECesiumAdaptiveScreenSpaceErrorReason reason) {
+    if (target > 0.0 && value / target > highestRatio) {
+      highestRatio = value / target;
+      limitingReason = reason;
+    }
+  };
+  consider(
+      this->_smoothedGameThreadMilliseconds,
+      settings.TargetGameThreadMilliseconds,
+      ECesiumAdaptiveScreenSpaceErrorReason::GameThreadTime);
+  consider(
+      double(measurements.estimatedGpuBytes),
+      double(settings.TargetEstimatedGpuBytes),
+      ECesiumAdaptiveScreenSpaceErrorReason::EstimatedGpuMemory);
+  consider(
+      double(measurements.loadQueueLength),
+      double(settings.TargetLoadQueueLength),
+      ECesiumAdaptiveScreenSpaceErrorReason::LoadQueueLength);
+
+  if (highestRatio > 1.0) {
+    this->_screenSpaceError =
+        std::min(this->_screenSpaceError * RaiseFactor, maximum);
+    this->_reason = limitingReason;
+  } else if (
+      highestRatio < 1.0 - settings.Hysteresis &&
+      this->_screenSpaceError > minimum) {
+    this->_screenSpaceError =
+        std::max(this->_screenSpaceError / LowerFactor, minimum);
+    this->_reason = ECesiumAdaptiveScreenSpaceErrorReason::Improving;
+  } else {
+    this->_reason = ECesiumAdaptiveScreenSpaceErrorReason::WithinTargets;
+  }
+}
+
+void CesiumScreenSpaceErrorController::reportStatistics() const {
+  // Report the highest screen-space error of any tileset in this frame.
+  static uint64 highestFrame = 0;
+  static double highestScreenSpaceError = 0.0;
+  if (highestFrame != GFrameCounter) {
+    highestFrame = GFrameCounter;
+    highestScreenSpaceError = 0.0;
+  }
+  highestScreenSpaceError =
+      std::max(highestScreenSpaceError, this->_screenSpaceError);
+  SET_FLOAT_STAT(
+      STAT_CesiumHighestAdaptiveScreenSpaceError,
+      highestScreenSpaceError);
+
+  switch (this->_reason) {
+  case ECesiumAdaptiveScreenSpaceErrorReason::WithinTargets:
+    INC_DWORD_STAT(STAT_CesiumAdaptiveScreenSpaceErrorWithinTargets);
+    break;
+  case ECesiumAdaptiveScreenSpaceErrorReason::Improving:
+    INC_DWORD_STAT(STAT_CesiumAdaptiveScreenSpaceErrorImproving);
+    break;
+  case ECesiumAdaptiveScreenSpaceErrorReason::GameThreadTime:
+    INC_DWORD_STAT(STAT_CesiumAdaptiveScreenSpaceErrorGameThreadTime);
+    break;
+  case ECesiumAdaptiveScreenSpaceErrorReason::EstimatedGpuMemory:
+    INC_DWORD_STAT(STAT_CesiumAdaptiveScreenSpaceErrorGpuMemory);
+    break;
+  case ECesiumAdaptiveScreenSpaceErrorReason::LoadQueueLength:
+    INC_DWORD_STAT(STAT_CesiumAdaptiveScreenSpaceErrorLoadQueue);
+    break;
+  default:
+    break;
+  }
+}
@@ -0,0 +1,68 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAdaptiveScreenSpaceError.h"
+
+/**
+ * Chooses the maximum screen-space error of a tileset from measurements of
+ * its cost, as configured by an FCesiumAdaptiveScreenSpaceError.
+ *
+ * The game thread time is smoothed, because a single slow frame should not
+ * cost detail. The memory use and load queue lengths are used as they are,
+ * because they already change slowly.
+ */
+class CesiumScreenSpaceErrorController {
+public:
+  struct Measurements {
+    double gameThreadMilliseconds = 0.0;
+    int64 estimatedGpuBytes = 0;
+    int64 loadQueueLength = 0;
+  };
+
+  /**
+   * Updates the controller with the latest measurements.
+   *
+   * @param settings The controller's options.
+   * @param baseScreenSpaceError The tileset's own maximum screen-space error,
+   * which the controller starts from and which is used when it is disabled.
+   * @param measurements The tileset's cost in the previous frame.
+   * @param deltaTime The time since the previous update, in seconds.
+   * @return The maximum screen-space error to use.
+   */
+  double update(
+      const FCesiumAdaptiveScreenSpaceError& settings,
+      double baseScreenSpaceError,
+      const Measurements& measurements,
+      double deltaTime);
+
+  /** Gets the screen-space error chosen by the latest update. */
+  double getScreenSpaceError() const { return this->_screenSpaceError; }
+
+  /** Gets the reason for the latest decision. */
+  ECesiumAdaptiveScreenSpaceErrorReason getReason() const {
+    return this->_reason;
+  }
+
+  /** Starts over from the tileset's own screen-space error. */
+  void reset();
+
+private:
+  void adjust(
+      const FCesiumAdaptiveScreenSpaceError& settings,
+      double baseScreenSpaceError,
+      const Measurements& measurements,
+      double deltaTime);
+
+  /**
+   * Reports the decision to the `stat Cesium` group. Counter stats are reset
+   * every frame, so this is called in every update.
+   */
+  void reportStatistics() const;
+
+  double _screenSpaceError = -1.0;
+  ECesiumAdaptiveScreenSpaceErrorReason _reason =
+      ECesiumAdaptiveScreenSpaceErrorReason::Disabled;
+  double _smoothedGameThreadMilliseconds = 0.0;
+  double _secondsSinceAdjustment = 0.0;
+};
@@ -144,7 +144,7 @@ struct ExtensionUnrealTexture {
 namespace CesiumTextureUtility {
 
 ReferenceCountedUnrealTexture::ReferenceCountedUnrealTexture() noexcept
-    : _pUnrealTexture(nullptr), _pTextureResource(nullptr) {}
+    : _pUnrealTexture(nullptr), _pTextureResource(nullptr), _sizeBytes(0) {}
 
 ReferenceCountedUnrealTexture::~ReferenceCountedUnrealTexture() noexcept {
   UTexture2D* pLocal = this->_pUnrealTexture;
@@ -198,6 +198,14 @@ void ReferenceCountedUnrealTexture::setTextureResource(
   this->_pTextureResource = std::move(p);
 }
 
+int64 ReferenceCountedUnrealTexture::getSizeBytes() const {
+  return this->_sizeBytes;
+}
+
+void ReferenceCountedUnrealTexture::setSizeBytes(int64 sizeBytes) {
+  this->_sizeBytes = sizeBytes;
+}
+
 TUniquePtr<LoadedTextureResult> loadTextureFromModelAnyThreadPart(
     CesiumGltf::Model& model,
     CesiumGltf::Texture& texture,
@@ -492,6 +500,18 @@ TUniquePtr<LoadedTextureResult> loadTextureAnyThreadPart(
   // for caching purposes.
   imageCesium.sizeBytes = int64_t(imageCesium.pixelData.size());
 
+  // A new GPU texture has the mips in mipPositions, or only the full image if
+  // there are none, each padded to the block size of its pixel format.
+  if (!pExistingImageResource) {
+    const int32 mipCount =
+        FMath::Clamp(int32(imageCesium.mipPositions.size()), 1, 16);
+    pResult->pTexture->setSizeBytes(int64(CalcTextureSize(
+        uint32(imageCesium.width),
+        uint32(imageCesium.height),
+        pixelFormat,
+        uint32(mipCount))));
+  }
+
   if (pExistingImageResource) {
     pResult->pTexture->setTextureResource(
         MakeUnique<FCesiumUseExistingTextureResource>(
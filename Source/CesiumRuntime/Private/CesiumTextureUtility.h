@@ -50,9 +50,15 @@ struct ReferenceCountedUnrealTexture
   TUniquePtr<FCesiumTextureResourceBase>& getTextureResource();
   void setTextureResource(TUniquePtr<FCesiumTextureResourceBase>&& p);
 
+  // The number of bytes of pixel data this texture added to the GPU. This is
+  // zero if the texture reuses an RHI texture created for another one.
+  int64 getSizeBytes() const;
+  void setSizeBytes(int64 sizeBytes);
+
 private:
   TObjectPtr<UTexture2D> _pUnrealTexture;
   TUniquePtr<FCesiumTextureResourceBase> _pTextureResource;
+  int64 _sizeBytes;
 };
 
 /**
@@ -0,0 +1,124 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileLoadThrottle.h"
+#include "CesiumRuntime.h"
+#include <algorithm>
+#include <cmath>
+
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Effective Simultaneous Tile Loads"),
+    STAT_CesiumEffectiveSimultaneousTileLoads,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Tilesets Throttled By Frame Time"),
+    STAT_CesiumTilesetsThrottledByFrameTime,
+    STATGROUP_Cesium);
+
+namespace {
+
+// The factors by which the load limits are scaled down while frames are too
+// slow, and back up once they are fast enough. Scaling down is quicker, so
+// that a hitch is short, and scaling up is careful, so that it is not
+// repeated.
+constexpr double ThrottleFactor = 0.8;
+constexpr double RecoveryFactor = 1.1;
+
+// The load limits are never throttled below this fraction, so that tiles are
+// still loaded, slowly, however slow the frames are.
+constexpr double MinimumFrameTimeFactor = 0.1;
+
+// How far below the target, as a fraction of it, the frame time must be
+// before the load limits are scaled back up.
+constexpr double RecoveryThreshold = 0.9;
+
+// The time constant, in seconds, over which the frame time is smoothed, and
+// the time between adjustments of the load limits.
+constexpr double FrameTimeSmoothingSeconds = 0.5;
+constexpr double AdjustmentIntervalSeconds = 0.25;
+
+// The lowest main thread loading time, in milliseconds.
+constexpr double MinimumMainThreadLoadingMilliseconds = 0.5;
+
+} // namespace
+
+void CesiumTileLoadThrottle::update(
+    ECesiumLoadingPriorityMode mode,
+    int32 maximumSimultaneousTileLoads,
+    bool throttleByFrameTime,
+    double targetFrameSeconds,
+    double frameSeconds) {
+  if (!throttleByFrameTime || targetFrameSeconds <= 0.0) {
+    this->reset();
+  } else if (this->_smoothedFrameSeconds < 0.0) {
+    this->_smoothedFrameSeconds = frameSeconds;
+  } else {
+    const double smoothing =
+        1.0 -
+        std::exp(-std::max(frameSeconds, 0.0) / FrameTimeSmoothingSeconds);
+    this->_smoothedFrameSeconds +=
+        (frameSeconds - this->_smoothedFrameSeconds) * smoothing;
+
+    this->_secondsSinceAdjustment += frameSeconds;
+    if (this->_secondsSinceAdjustment >= AdjustmentIntervalSeconds) {
+      this->_secondsSinceAdjustment = 0.0;
+      if (this->_smoothedFrameSeconds > targetFrameSeconds) {
+        this->_frameTimeFactor = std::max(
+            this->_frameTimeFactor * ThrottleFactor,
+            MinimumFrameTimeFactor);
+      } else if (
+          this->_smoothedFrameSeconds <
+          targetFrameSeconds * RecoveryThreshold) {
+        this->_frameTimeFactor =
+            std::min(this->_frameTimeFactor * RecoveryFactor, 1.0);
+      }
+    }
+  }
+
+  INC_DWORD_STAT_BY(
+      STAT_CesiumEffectiveSimultaneousTileLoads,
+      this->getSimultaneousTileLoads(mode, maximumSimultaneousTileLoads));
+  if (mode != ECesiumLoadingPriorityMode::Aggressive &&
+      this->_frameTimeFactor < 1.0) {
+    INC_DWORD_STAT(STAT_CesiumTilesetsThrottledByFrameTime);
+  }
+}
+
+int32 CesiumTileLoadThrottle::getSimultaneousTileLoads(
+    ECesiumLoadingPriorityMode mode,
+    int32 maximumSimultaneousTileLoads) const {
+  if (maximumSimultaneousTileLoads <= 0) {
+    return 0;
+  }
+
+  // Keep at least one load going, so that the tileset always makes progress.
+  return std::max(
+      int32(std::lround(maximumSimultaneousTileLoads * this->getScale(mode))),
+      1);
+}
+
+double CesiumTileLoadThrottle::getMainThreadLoadingMilliseconds(
+    ECesiumLoadingPriorityMode mode) const {
+  return std::max(
+      DefaultMainThreadLoadingMilliseconds * this->getScale(mode),
+      MinimumMainThreadLoadingMilliseconds);
+}
+
+void CesiumTileLoadThrottle::reset() {
+  this->_frameTimeFactor = 1.0;
+  this->_smoothedFrameSeconds = -1.0;
+  this->_secondsSinceAdjustment = 0.0;
+}
+
+double CesiumTileLoadThrottle::getScale(ECesiumLoadingPriorityMode mode) const {
+  switch (mode) {
+  case ECesiumLoadingPriorityMode::Background:
+    return 0.25 * this->_frameTimeFactor;
+  case ECesiumLoadingPriorityMode::Aggressive:
+    // Loading as fast as possible was asked for explicitly, so the frame time
+    // is not considered.
+    return 2.0;
+  case ECesiumLoadingPriorityMode::Normal:
+  default:
+    return this->_frameTimeFactor;
+  }
+}
@@ -0,0 +1,76 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumLoadingPriorityMode.h"
+
+/**
+ * Chooses how many tiles a tileset loads at once, and how much main thread
+ * time it spends each frame finishing loaded tiles, from its loading priority
+ * mode and the measured frame time.
+ *
+ * While throttling by frame time, the load limits are scaled down quickly
+ * while the smoothed frame time is over its target, and scaled back up slowly
+ * once it is comfortably below it.
+ */
+class CesiumTileLoadThrottle {
+public:
+  /**
+   * The time, in milliseconds, that a tileset spends each frame finishing
+   * loaded tiles on the main thread in the Normal mode.
+   */
+  static constexpr double DefaultMainThreadLoadingMilliseconds = 5.0;
+
+  /**
+   * Updates the throttle with the duration of the previous frame, and reports
+   * the resulting load limits to the `stat Cesium` group.
+   *
+   * @param mode The tileset's loading priority mode.
+   * @param maximumSimultaneousTileLoads The tileset's own limit.
+   * @param throttleByFrameTime Whether to scale the load limits down while
+   * frames are slower than the target.
+   * @param targetFrameSeconds The target frame time, in seconds.
+   * @param frameSeconds The duration of the previous frame, in seconds.
+   */
+  void update(
+      ECesiumLoadingPriorityMode mode,
+      int32 maximumSimultaneousTileLoads,
+      bool throttleByFrameTime,
+      double targetFrameSeconds,
+      double frameSeconds);
+
+  /**
+   * Gets the number of tiles that may be loaded at once.
+   *
+   * @param mode The tileset's loading priority mode.
+   * @param maximumSimultaneousTileLoads The tileset's own limit, which is
+   * used as is in the Normal mode when frames are fast enough.
+   */
+  int32 getSimultaneousTileLoads(
+      ECesiumLoadingPriorityMode mode,
+      int32 maximumSimultaneousTileLoads) const;
+
+  /**
+   * Gets the time, in milliseconds, that may be spent each frame finishing
+   * loaded tiles on the main thread. This is never zero, because zero lets
+   * the tileset finish every loaded tile in a single frame.
+   */
+  double
+  getMainThreadLoadingMilliseconds(ECesiumLoadingPriorityMode mode) const;
+
+  /**
+   * Gets the factor, between 0 and 1, by which the load limits are currently
+   * scaled for the frame time.
+   */
+  double getFrameTimeFactor() const { return this->_frameTimeFactor; }
+
+  /** Starts over without any frame time throttling. */
+  void reset();
+
+private:
+  double getScale(ECesiumLoadingPriorityMode mode) const;
+
+  double _frameTimeFactor = 1.0;
+  double _smoothedFrameSeconds = -1.0;
+  double _secondsSinceAdjustment = 0.0;
+};
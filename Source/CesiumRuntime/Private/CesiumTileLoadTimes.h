@@ -0,0 +1,22 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+/**
+ * The times, from FPlatformTime::Seconds, at which a tile reached each stage
+ * of its lifecycle. A negative time means the stage has not been reached or
+ * its time is unknown.
+ */
+struct CesiumTileLoadTimes {
+  /** When the request for the tile's content started. */
+  double requestStarted = -1.0;
+
+  /** When the tile finished being prepared in a worker thread. */
+  double loadThreadFinished = -1.0;
+
+  /** When the tile's renderer resources were created in the game thread. */
+  double mainThreadFinished = -1.0;
+
+  /** When the tile was first shown. */
+  double firstShown = -1.0;
+};
@@ -0,0 +1,270 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumTilesArchiveWriter.h"
+#include "Containers/StringConv.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/SecureHash.h"
+#include <algorithm>
+
+namespace {
+
+constexpr uint32 LocalFileHeaderSignature = 0x04034b50;
+constexpr uint32 CentralDirectoryHeaderSignature = 0x02014b50;
+constexpr uint32 Zip64EndOfCentralDirectorySignature = 0x06064b50;
+constexpr uint32 Zip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+constexpr uint32 EndOfCentralDirectorySignature = 0x06054b50;
+
+constexpr uint16 Version = 20;
+constexpr uint16 Zip64Version = 45;
+constexpr uint16 Utf8NamesFlag = 0x0800;
+constexpr uint16 StoredMethod = 0;
+constexpr uint16 Zip64ExtraFieldId = 0x0001;
+
+// Every entry has the same modification time, midnight on 1 January 1980, so
+// that packaging the same files twice gives the same archive.
+constexpr uint16 DosTime = 0;
+constexpr uint16 DosDate = (1 << 5) | 1;
+
+constexpr uint64 Max16 = 0xFFFF;
+constexpr uint64 Max32 = 0xFFFFFFFF;
+
+// The central directory is written in pieces of about this size.
+constexpr int32 DirectoryBufferBytes = 1024 * 1024;
+
+void append16(TArray<uint8>& bytes, uint16 value) {
+  bytes.Add(uint8(value));
+  bytes.Add(uint8(value >> 8));
+}
+
+void append32(TArray<uint8>& bytes, uint32 value) {
+  append16(bytes, uint16(value));
+  append16(bytes, uint16(value >> 16));
+}
+
+void append64(TArray<uint8>& bytes, uint64 value) {
+  append32(bytes, uint32(value));
+  append32(bytes, uint32(value >> 32));
+}
+
+uint64 read64(const uint8* pBytes) {
+  uint64 value = 0;
+  for (int32 i = 7; i >= 0; --i) {
+    value = (value << 8) | pBytes[i];
+  }
+  return value;
+}
+
+TArray<uint8> toUtf8(const FString& text) {
+  FTCHARToUTF8 utf8(*text);
+  return TArray<uint8>(
+      reinterpret_cast<const uint8*>(utf8.Get()),
+      utf8.Length());
+}
+
+struct IndexRecord {
+  uint8 hash[16];
+  uint64 offset;
+};
+
+} // namespace
+
+/*static*/ const char* CesiumTilesArchiveWriter::IndexPath =
+    "@3dtilesIndex1@";
+
+CesiumTilesArchiveWriter::CesiumTilesArchiveWriter(const FString& filename)
+    : _pFile(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(
+          *filename,
+          false,
+          false)),
+      _paths(),
+      _entries(),
+      _offset(0) {}
+
+CesiumTilesArchiveWriter::~CesiumTilesArchiveWriter() {
+  if (this->isOpen()) {
+    this->close();
+  }
+}
+
+bool CesiumTilesArchiveWriter::addFile(
+    const FString& path,
+    const gsl::span<const std::byte>& data) {
+  if (!this->isOpen() || this->_paths.Contains(path) ||
+      data.size() > size_t(MAX_int32)) {
+    return false;
+  }
+
+  const TArray<uint8> pathBytes = toUtf8(path);
+  if (pathBytes.Num() == 0 || pathBytes.Num() > int32(Max16)) {
+    return false;
+  }
+
+  if (!this->writeEntry(
+          pathBytes,
+          reinterpret_cast<const uint8*>(data.data()),
+          uint32(data.size()))) {
+    return false;
+  }
+
+  this->_paths.Add(path);
+  return true;
+}
+
+bool CesiumTilesArchiveWriter::close() {
+  if (!this->isOpen()) {
+    return false;
+  }
+
+  // The index lists every entry but itself, sorted by the MD5 hash of the
+  // path, compared as two little-endian 64-bit integers.
+  TArray<IndexRecord> records;
+  records.SetNum(this->_entries.Num());
+  for (int32 i = 0; i < this->_entries.Num(); ++i) {
+    const Entry& entry = this->_entries[i];
+    FMD5 md5;
+    md5.Update(entry.path.GetData(), entry.path.Num());
+    md5.Final(records[i].hash);
+    records[i].offset = entry.offset;
+  }
+  std::sort(
+      records.GetData(),
+      records.GetData() + records.Num(),
+      [](const IndexRecord& a, const IndexRecord& b) {
+        const uint64 aLow = read64(a.hash);
+        const uint64 bLow = read64(b.hash);
+        if (aLow != bLow) {
+          return aLow < bLow;
+        }
+        return read64(a.hash + 8) < read64(b.hash + 8);
+      });
+
+  TArray<uint8> index;
+  index.Reserve(records.Num() * 24);
+  for (const IndexRecord& record : records) {
+    index.Append(record.hash, 16);
+    append64(index, record.offset);
+  }
+
+  bool succeeded = this->writeEntry(
+      toUtf8(UTF8_TO_TCHAR(IndexPath)),
+      index.GetData(),
+      uint32(index.Num()));
+
+  const uint64 directoryOffset = this->_offset;
+  TArray<uint8> buffer;
+  buffer.Reserve(DirectoryBufferBytes);
+
+  for (const Entry& entry : this->_entries) {
+    if (!succeeded) {
+      break;
+    }
+
+    const bool zip64 = entry.offset >= Max32;
+    append32(buffer, CentralDirectoryHeaderSignature);
+    append16(buffer, zip64 ? Zip64Version : Version);
+    append16(buffer, zip64 ? Zip64Version : Version);
+    append16(buffer, Utf8NamesFlag);
+    append16(buffer, StoredMethod);
+    append16(buffer, DosTime);
+    append16(buffer, DosDate);
+    append32(buffer, entry.crc);
+    append32(buffer, entry.size);
+    append32(buffer, entry.size);
+    append16(buffer, uint16(entry.path.Num()));
+    append16(buffer, zip64 ? 12 : 0);
+    append16(buffer, 0); // comment length
+    append16(buffer, 0); // disk number
+    append16(buffer, 0); // internal attributes
+    append32(buffer, 0); // external attributes
+    append32(buffer, zip64 ? uint32(Max32) : uint32(entry.offset));
+    buffer.Append(entry.path);
+    if (zip64) {
+      append16(buffer, Zip64ExtraFieldId);
+      append16(buffer, 8);
+      append64(buffer, entry.offset);
+    }
+
+    if (buffer.Num() >= DirectoryBufferBytes) {
+      succeeded = this->write(buffer);
+      buffer.Reset();
+    }
+  }
+
+  const uint64 directorySize =
+      this->_offset + uint64(buffer.Num()) - directoryOffset;
+  const uint64 entryCount = uint64(this->_entries.Num());
+
+  if (entryCount >= Max16 || directoryOffset >= Max32 ||
+      directorySize >= Max32) {
+    const uint64 zip64EndOffset = this->_offset + uint64(buffer.Num());
+    append32(buffer, Zip64EndOfCentralDirectorySignature);
+    append64(buffer, 44); // size of the rest of this record
+    append16(buffer, Zip64Version);
+    append16(buffer, Zip64Version);
+    append32(buffer, 0); // disk number
+    append32(buffer, 0); // disk with the central directory
+    append64(buffer, entryCount);
+    append64(buffer, entryCount);
+    append64(buffer, directorySize);
+    append64(buffer, directoryOffset);
+
+    append32(buffer, Zip64EndOfCentralDirectoryLocatorSignature);
+    append32(buffer, 0); // disk with the ZIP64 end of central directory
+    append64(buffer, zip64EndOffset);
+    append32(buffer, 1); // number of disks
+  }
+
+  append32(buffer, EndOfCentralDirectorySignature);
+  append16(buffer, 0); // disk number
+  append16(buffer, 0); // disk with the central directory
+  append16(buffer, uint16(std::min(entryCount, Max16)));
+  append16(buffer, uint16(std::min(entryCount, Max16)));
+  append32(buffer, uint32(std::min(directorySize, Max32)));
+  append32(buffer, uint32(std::min(directoryOffset, Max32)));
+  append16(buffer, 0); // comment length
+
+  succeeded = succeeded && this->write(buffer) && this->_pFile->Flush();
+  this->_pFile.Reset();
+  return succeeded;
+}
+
+bool CesiumTilesArchiveWriter::writeEntry(
+    const TArray<uint8>& path,
+    const uint8* pData,
+    uint32 size) {
+  Entry entry{path, FCrc::MemCrc32(pData, int32(size)), size, this->_offset};
+
+  TArray<uint8> header;
+  header.Reserve(30 + path.Num());
+  append32(header, LocalFileHeaderSignature);
+  append16(header, Version);
+  append16(header, Utf8NamesFlag);
+  append16(header, StoredMethod);
+  append16(header, DosTime);
+  append16(header, DosDate);
+  append32(header, entry.crc);
+  append32(header, size);
+  append32(header, size);
+  append16(header, uint16(path.Num()));
+  append16(header, 0); // extra field length
+  header.Append(path);
+
+  if (!this->write(header) || (size > 0 && !this->_pFile->Write(pData, size))) {
+    // The archive is incomplete, so stop writing it.
+    this->_pFile.Reset();
+    return false;
+  }
+
+  this->_offset += size;
+  this->_entries.Emplace(std::move(entry));
+  return true;
+}
+
+bool CesiumTilesArchiveWriter::write(const TArray<uint8>& bytes) {
+  if (!this->_pFile->Write(bytes.GetData(), bytes.Num())) {
+    return false;
+  }
+  this->_offset += uint64(bytes.Num());
+  return true;
+}
@@ -0,0 +1,77 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Set.h"
+#include "Containers/UnrealString.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Templates/UniquePtr.h"
+#include <cstddef>
+#include <gsl/span>
+
+/**
+ * Writes a 3D Tiles archive (`.3tz`): a ZIP file of uncompressed entries,
+ * the last of which is the `@3dtilesIndex1@` index that lets readers find an
+ * entry from the MD5 hash of its path without reading the central directory.
+ * ZIP64 records are written once the archive has more entries or bytes than
+ * a plain ZIP file can describe.
+ *
+ * The files are written as they are added, so only their paths and offsets
+ * are kept in memory. It is not safe to use from several threads at once.
+ */
+class CesiumTilesArchiveWriter {
+public:
+  /**
+   * Creates the archive, replacing any existing file. Use `isOpen` to find
+   * out whether that succeeded.
+   */
+  explicit CesiumTilesArchiveWriter(const FString& filename);
+
+  /** Closes the archive, if `close` has not been called. */
+  ~CesiumTilesArchiveWriter();
+
+  bool isOpen() const { return this->_pFile.IsValid(); }
+
+  /** Whether a file with the given path has been added. */
+  bool contains(const FString& path) const {
+    return this->_paths.Contains(path);
+  }
+
+  /**
+   * Adds a file with the given path, relative to the root of the archive.
+   * Returns false if the archive is not open, a file with the same path was
+   * added before, the file is too large for a ZIP entry, or it could not be
+   * written.
+   */
+  bool addFile(const FString& path, const gsl::span<const std::byte>& data);
+
+  /**
+   * Writes the index and the central directory, and closes the archive.
+   * Returns false if they could not be written.
+   */
+  bool close();
+
+  int64 getFileCount() const { return this->_entries.Num(); }
+
+  int64 getBytesWritten() const { return this->_offset; }
+
+  /** The name of the index entry. */
+  static const char* IndexPath;
+
+private:
+  struct Entry {
+    TArray<uint8> path;
+    uint32 crc;
+    uint32 size;
+    uint64 offset;
+  };
+
+  bool writeEntry(const TArray<uint8>& path, const uint8* pData, uint32 size);
+  bool write(const TArray<uint8>& bytes);
+
+  TUniquePtr<IFileHandle> _pFile;
+  TSet<FString> _paths;
+  TArray<Entry> _entries;
+  uint64 _offset;
+};
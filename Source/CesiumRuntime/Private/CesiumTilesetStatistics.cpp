@@ -0,0 +1,570 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumTilesetStatistics.h"
+#include "Cesium3DTilesSelection/ViewUpdateResult.h"
+#include "Cesium3DTileset.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "CoreGlobals.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "UObject/UObjectIterator.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <unordered_map>
+
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Tiles Rendered"),
+    STAT_CesiumTilesRendered,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Tiles Fading Out"),
+    STAT_CesiumTilesFadingOut,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Tiles Visited"),
+    STAT_CesiumTilesVisited,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Culled Tiles Visited"),
+    STAT_CesiumCulledTilesVisited,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Tiles Culled"),
+    STAT_CesiumTilesCulled,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Tiles Occluded"),
+    STAT_CesiumTilesOccluded,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Tiles Waiting For Occlusion Results"),
+    STAT_CesiumTilesWaitingForOcclusionResults,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Max Depth Visited"),
+    STAT_CesiumMaxDepthVisited,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Worker Thread Load Queue Length"),
+    STAT_CesiumWorkerThreadTileLoadQueueLength,
+    STATGROUP_Cesium);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Main Thread Load Queue Length"),
+    STAT_CesiumMainThreadTileLoadQueueLength,
+    STATGROUP_Cesium);
+DECLARE_FLOAT_COUNTER_STAT(
+    TEXT("Tiles Loaded Per Second"),
+    STAT_CesiumTilesLoadedPerSecond,
+    STATGROUP_Cesium);
+DECLARE_FLOAT_COUNTER_STAT(
+    TEXT("Tiles Unloaded Per Second"),
+    STAT_CesiumTilesUnloadedPerSecond,
+    STATGROUP_Cesium);
+DECLARE_FLOAT_COUNTER_STAT(
+    TEXT("Bytes Received Per Second"),
+    STAT_CesiumBytesReceivedPerSecond,
+    STATGROUP_Cesium);
+
+using namespace CesiumAsync;
+
+namespace {
+
+// The rates are recomputed once per window, so that they are not dominated by
+// frame-to-frame noise.
+constexpr float RateWindowSeconds = 1.0f;
+
+// Requests that never become tiles, such as those for external tilesets, are
+// never taken. Once there are this many, forget the ones that are too old to
+// be useful.
+constexpr size_t MaximumRequestStartTimes = 4096;
+constexpr double RequestStartTimeExpirySeconds = 60.0;
+
+void dumpLatency(const TArray<FString>& args) {
+  const FString path =
+      args.Num() > 0
+          ? args[0]
+          : FPaths::Combine(
+                FPaths::ProjectSavedDir(),
+                TEXT("Cesium"),
+                TEXT("TileLoadLatency.csv"));
+
+  const UEnum* pStageEnum = StaticEnum<ECesiumTileLoadStage>();
+
+  FString csv = TEXT("Tileset,Stage,Count,MeanMs,P50Ms,P95Ms,P99Ms\n");
+  for (TObjectIterator<ACesium3DTileset> it; it; ++it) {
+    ACesium3DTileset* pTileset = *it;
+    if (!IsValid(pTileset) || pTileset->HasAnyFlags(RF_ClassDefaultObject)) {
+      continue;
+    }
+
+    for (int32 i = 0; i < pStageEnum->NumEnums() - 1; ++i) {
+      const ECesiumTileLoadStage stage =
+          ECesiumTileLoadStage(pStageEnum->GetValueByIndex(i));
+      const FCesiumTileLoadLatency latency =
+          pTileset->GetTileLoadLatency(stage);
+      csv += FString::Printf(
+          TEXT("%s,%s,%lld,%.3f,%.3f,%.3f,%.3f\n"),
+          *pTileset->GetName(),
+          *pStageEnum->GetNameStringByIndex(i),
+          latency.Count,
+          latency.Mean * 1000.0,
+          latency.P50 * 1000.0,
+          latency.P95 * 1000.0,
+          latency.P99 * 1000.0);
+    }
+  }
+
+  if (FFileHelper::SaveStringToFile(csv, *path)) {
+    UE_LOG(LogCesium, Display, TEXT("Wrote tile load latency to %s"), *path);
+  } else {
+    UE_LOG(
+        LogCesium,
+        Error,
+        TEXT("Could not write tile load latency to %s"),
+        *path);
+  }
+}
+
+FAutoConsoleCommand DumpLatencyCommand(
+    TEXT("cesium.latency.dump"),
+    TEXT(
+        "Writes the tile load latency percentiles of each Cesium3DTileset to a CSV file. The optional argument is the path of the file, which defaults to Saved/Cesium/TileLoadLatency.csv."),
+    FConsoleCommandWithArgsDelegate::CreateStatic(dumpLatency));
+
+// The maximum depth over all tilesets in the current frame. Counter stats are
+// cleared every frame, so this is reset whenever a new frame starts.
+uint64 maxDepthFrame = 0;
+uint32 maxDepthVisited = 0;
+
+} // namespace
+
+struct CesiumTilesetStatistics::RequestState {
+  using Observer = std::function<void(const IAssetRequest&)>;
+
+  std::atomic<int64> bytesReceived{0};
+  std::atomic<int64> requestsInFlight{0};
+
+  FCriticalSection lock;
+  std::unordered_map<std::string, double> startTimes;
+  std::shared_ptr<const Observer> pObserver;
+
+  std::shared_ptr<const Observer> getObserver() {
+    FScopeLock scopeLock(&this->lock);
+    return this->pObserver;
+  }
+
+  double recordStart(const std::string& url) {
+    const double now = FPlatformTime::Seconds();
+
+    FScopeLock scopeLock(&this->lock);
+    if (this->startTimes.size() >= MaximumRequestStartTimes) {
+      for (auto it = this->startTimes.begin(); it != this->startTimes.end();) {
+        if (now - it->second > RequestStartTimeExpirySeconds) {
+          it = this->startTimes.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    // A URL requested again, such as after a failure, is timed from its
+    // latest request.
+    this->startTimes.insert_or_assign(url, now);
+    return now;
+  }
+
+  /**
+   * Forgets the start time of a request that failed, unless the URL has been
+   * requested again since.
+   */
+  void forgetStart(const std::string& url, double startTime) {
+    FScopeLock scopeLock(&this->lock);
+    auto it = this->startTimes.find(url);
+    if (it != this->startTimes.end() && it->second == startTime) {
+      this->startTimes.erase(it);
+    }
+  }
+};
+
+class CesiumTilesetStatistics::AssetAccessor : public IAssetAccessor {
+public:
+  AssetAccessor(
+      const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+      const std::shared_ptr<RequestState>& pRequestState)
+      : _pAssetAccessor(pAssetAccessor), _pRequestState(pRequestState) {}
+
+  virtual Future<std::shared_ptr<IAssetRequest>>
+  get(const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    const double startTime = this->_pRequestState->recordStart(url);
+    return this->_pAssetAccessor->get(asyncSystem, url, headers)
+        .thenImmediately(completed(this->_pRequestState))
+        .thenImmediately(
+            [pRequestState = this->_pRequestState, url, startTime](
+                std::shared_ptr<IAssetRequest>&& pRequest) {
+              // No tile is loaded from an unsuccessful response, so nothing
+              // takes its start time.
+              const IAssetResponse* pResponse = pRequest->response();
+              const uint16_t statusCode =
+                  pResponse ? pResponse->statusCode() : 0;
+              if (!pResponse ||
+                  (statusCode != 0 &&
+                   (statusCode < 200 || statusCode >= 300))) {
+                pRequestState->forgetStart(url, startTime);
+              }
+              return std::move(pRequest);
+            })
+        .catchImmediately(
+            [pRequestState = this->_pRequestState, url, startTime](
+                std::exception&& e) -> std::shared_ptr<IAssetRequest> {
+              // The request failed or was canceled.
+              pRequestState->forgetStart(url, startTime);
+              throw std::runtime_error(e.what());
+            });
+  }
+
+  virtual Future<std::shared_ptr<IAssetRequest>> request(
+      const AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override {
+    return this->_pAssetAccessor
+        ->request(asyncSystem, verb, url, headers, contentPayload)
+        .thenImmediately(completed(this->_pRequestState));
+  }
+
+  virtual void tick() noexcept override { this->_pAssetAccessor->tick(); }
+
+private:
+  /**
+   * Counts a request as in flight for as long as it exists. It is owned by
+   * the continuation of the request, which is destroyed whether the request
+   * completes or fails.
+   */
+  struct InFlight {
+    explicit InFlight(const std::shared_ptr<RequestState>& pRequestState_)
+        : pRequestState(pRequestState_) {
+      ++this->pRequestState->requestsInFlight;
+    }
+    ~InFlight() { --this->pRequestState->requestsInFlight; }
+
+    std::shared_ptr<RequestState> pRequestState;
+  };
+
+  static auto completed(const std::shared_ptr<RequestState>& pRequestState) {
+    return [pInFlight = std::make_shared<InFlight>(pRequestState)](
+               std::shared_ptr<IAssetRequest>&& pRequest) {
+      RequestState& state = *pInFlight->pRequestState;
+      const IAssetResponse* pResponse = pRequest->response();
+      if (pResponse) {
+        state.bytesReceived += int64(pResponse->data().size());
+      }
+
+      std::shared_ptr<const RequestState::Observer> pObserver =
+          state.getObserver();
+      if (pObserver) {
+        (*pObserver)(*pRequest);
+      }
+      return std::move(pRequest);
+    };
+  }
+
+  std::shared_ptr<IAssetAccessor> _pAssetAccessor;
+  std::shared_ptr<RequestState> _pRequestState;
+};
+
+#if COUNTERSTRACE_ENABLED
+
+namespace {
+
+/**
+ * An Insights counter that owns its name, because the name of a counter is
+ * not necessarily copied when the counter is constructed.
+ */
+template <typename ValueType, ETraceCounterType CounterType>
+struct NamedTraceCounter {
+  NamedTraceCounter(
+      const FString& tilesetName,
+      const TCHAR* counterName,
+      ETraceCounterDisplayHint displayHint = TraceCounterDisplayHint_None)
+      : name(FString::Printf(TEXT("Cesium/%s/%s"), *tilesetName, counterName)),
+        counter(*name, displayHint) {}
+
+  void Set(ValueType value) { this->counter.Set(value); }
+
+  FString name;
+  FCountersTrace::TCounter<ValueType, CounterType> counter;
+};
+
+using IntTraceCounter = NamedTraceCounter<int64, TraceCounterType_Int>;
+using FloatTraceCounter = NamedTraceCounter<double, TraceCounterType_Float>;
+
+} // namespace
+
+struct CesiumTilesetStatistics::TraceCounters {
+  explicit TraceCounters(const FString& tilesetName)
+      : tilesRendered(tilesetName, TEXT("Tiles Rendered")),
+        tilesFadingOut(tilesetName, TEXT("Tiles Fading Out")),
+        tilesVisited(tilesetName, TEXT("Tiles Visited")),
+        culledTilesVisited(tilesetName, TEXT("Culled Tiles Visited")),
+        tilesCulled(tilesetName, TEXT("Tiles Culled")),
+        tilesOccluded(tilesetName, TEXT("Tiles Occluded")),
+        tilesWaitingForOcclusionResults(
+            tilesetName,
+            TEXT("Tiles Waiting For Occlusion Results")),
+        maxDepthVisited(tilesetName, TEXT("Max Depth Visited")),
+        workerThreadTileLoadQueueLength(
+            tilesetName,
+            TEXT("Worker Thread Load Queue Length")),
+        mainThreadTileLoadQueueLength(
+            tilesetName,
+            TEXT("Main Thread Load Queue Length")),
+        tilesLoadedPerSecond(tilesetName, TEXT("Tiles Loaded Per Second")),
+        tilesUnloadedPerSecond(tilesetName, TEXT("Tiles Unloaded Per Second")),
+        bytesReceivedPerSecond(
+            tilesetName,
+            TEXT("Bytes Received Per Second"),
+            TraceCounterDisplayHint_Memory) {}
+
+  IntTraceCounter tilesRendered;
+  IntTraceCounter tilesFadingOut;
+  IntTraceCounter tilesVisited;
+  IntTraceCounter culledTilesVisited;
+  IntTraceCounter tilesCulled;
+  IntTraceCounter tilesOccluded;
+  IntTraceCounter tilesWaitingForOcclusionResults;
+  IntTraceCounter maxDepthVisited;
+  IntTraceCounter workerThreadTileLoadQueueLength;
+  IntTraceCounter mainThreadTileLoadQueueLength;
+  FloatTraceCounter tilesLoadedPerSecond;
+  FloatTraceCounter tilesUnloadedPerSecond;
+  FloatTraceCounter bytesReceivedPerSecond;
+};
+
+#else
+
+struct CesiumTilesetStatistics::TraceCounters {};
+
+#endif
+
+CesiumTilesetStatistics::CesiumTilesetStatistics()
+    : _pTraceCounters(nullptr),
+      _pRequestState(std::make_shared<RequestState>()),
+      _tilesLoaded(0),
+      _tilesUnloaded(0),
+      _tilesRendered(0),
+      _workerThreadTileLoadQueueLength(0),
+      _mainThreadTileLoadQueueLength(0),
+      _windowStartTilesLoaded(0),
+      _windowStartTilesUnloaded(0),
+      _windowStartBytesReceived(0),
+      _windowSeconds(0.0f),
+      _tilesLoadedPerSecond(0.0),
+      _tilesUnloadedPerSecond(0.0),
+      _bytesReceivedPerSecond(0.0) {}
+
+CesiumTilesetStatistics::~CesiumTilesetStatistics() = default;
+
+void CesiumTilesetStatistics::reset(const FString& tilesetName) {
+#if COUNTERSTRACE_ENABLED
+  this->_pTraceCounters = MakeUnique<TraceCounters>(tilesetName);
+#endif
+
+  this->_windowStartTilesLoaded = this->_tilesLoaded;
+  this->_windowStartTilesUnloaded = this->_tilesUnloaded;
+  this->_windowStartBytesReceived = this->_pRequestState->bytesReceived;
+  this->_windowSeconds = 0.0f;
+  this->_tilesLoadedPerSecond = 0.0;
+  this->_tilesUnloadedPerSecond = 0.0;
+  this->_bytesReceivedPerSecond = 0.0;
+}
+
+std::shared_ptr<IAssetAccessor> CesiumTilesetStatistics::createAssetAccessor(
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor) const {
+  return std::make_shared<AssetAccessor>(pAssetAccessor, this->_pRequestState);
+}
+
+double CesiumTilesetStatistics::takeRequestStartTime(const std::string& url) {
+  FScopeLock scopeLock(&this->_pRequestState->lock);
+  std::unordered_map<std::string, double>& startTimes =
+      this->_pRequestState->startTimes;
+  auto it = startTimes.find(url);
+  if (it == startTimes.end()) {
+    return -1.0;
+  }
+
+  const double startTime = it->second;
+  startTimes.erase(it);
+  return startTime;
+}
+
+void CesiumTilesetStatistics::setRequestObserver(
+    std::function<void(const IAssetRequest&)>&& observer) {
+  std::shared_ptr<const RequestState::Observer> pObserver;
+  if (observer) {
+    pObserver =
+        std::make_shared<const RequestState::Observer>(std::move(observer));
+  }
+
+  FScopeLock scopeLock(&this->_pRequestState->lock);
+  this->_pRequestState->pObserver = std::move(pObserver);
+}
+
+int64 CesiumTilesetStatistics::getRequestsInFlight() const {
+  return this->_pRequestState->requestsInFlight;
+}
+
+void CesiumTilesetStatistics::recordTileShown(
+    const CesiumTileLoadTimes& times) {
+  if (times.requestStarted >= 0.0 && times.loadThreadFinished >= 0.0) {
+    this->_loadingLatency.record(
+        times.loadThreadFinished - times.requestStarted);
+  }
+  if (times.loadThreadFinished >= 0.0 && times.mainThreadFinished >= 0.0) {
+    this->_mainThreadLatency.record(
+        times.mainThreadFinished - times.loadThreadFinished);
+  }
+  if (times.mainThreadFinished >= 0.0 && times.firstShown >= 0.0) {
+    this->_showingLatency.record(times.firstShown - times.mainThreadFinished);
+  }
+  if (times.requestStarted >= 0.0 && times.firstShown >= 0.0) {
+    this->_totalLatency.record(times.firstShown - times.requestStarted);
+  }
+}
+
+FCesiumTileLoadLatency
+CesiumTilesetStatistics::getLatency(ECesiumTileLoadStage stage) const {
+  const CesiumLatencyHistogram* pHistogram = nullptr;
+  switch (stage) {
+  case ECesiumTileLoadStage::Loading:
+    pHistogram = &this->_loadingLatency;
+    break;
+  case ECesiumTileLoadStage::MainThread:
+    pHistogram = &this->_mainThreadLatency;
+    break;
+  case ECesiumTileLoadStage::Showing:
+    pHistogram = &this->_showingLatency;
+    break;
+  case ECesiumTileLoadStage::Total:
+  default:
+    pHistogram = &this->_totalLatency;
+    break;
+  }
+
+  FCesiumTileLoadLatency result;
+  result.Count = pHistogram->getCount();
+  result.Mean = pHistogram->getMean();
+  result.P50 = pHistogram->getPercentile(50.0);
+  result.P95 = pHistogram->getPercentile(95.0);
+  result.P99 = pHistogram->getPercentile(99.0);
+  return result;
+}
+
+void CesiumTilesetStatistics::resetLatency() {
+  this->_loadingLatency.reset();
+  this->_mainThreadLatency.reset();
+  this->_showingLatency.reset();
+  this->_totalLatency.reset();
+}
+
+void CesiumTilesetStatistics::update(
+    const Cesium3DTilesSelection::ViewUpdateResult& result,
+    float deltaTime) {
+  this->updateRates(deltaTime);
+
+  const uint32 tilesRendered = uint32(result.tilesToRenderThisFrame.size());
+  const uint32 tilesFadingOut = uint32(result.tilesFadingOut.size());
+
+  this->_tilesRendered = tilesRendered;
+  this->_workerThreadTileLoadQueueLength =
+      result.workerThreadTileLoadQueueLength;
+  this->_mainThreadTileLoadQueueLength = result.mainThreadTileLoadQueueLength;
+
+  INC_DWORD_STAT_BY(STAT_CesiumTilesRendered, tilesRendered);
+  INC_DWORD_STAT_BY(STAT_CesiumTilesFadingOut, tilesFadingOut);
+  INC_DWORD_STAT_BY(STAT_CesiumTilesVisited, result.tilesVisited);
+  INC_DWORD_STAT_BY(STAT_CesiumCulledTilesVisited, result.culledTilesVisited);
+  INC_DWORD_STAT_BY(STAT_CesiumTilesCulled, result.tilesCulled);
+  INC_DWORD_STAT_BY(STAT_CesiumTilesOccluded, result.tilesOccluded);
+  INC_DWORD_STAT_BY(
+      STAT_CesiumTilesWaitingForOcclusionResults,
+      result.tilesWaitingForOcclusionResults);
+  INC_DWORD_STAT_BY(
+      STAT_CesiumWorkerThreadTileLoadQueueLength,
+      result.workerThreadTileLoadQueueLength);
+  INC_DWORD_STAT_BY(
+      STAT_CesiumMainThreadTileLoadQueueLength,
+      result.mainThreadTileLoadQueueLength);
+  INC_FLOAT_STAT_BY(
+      STAT_CesiumTilesLoadedPerSecond,
+      float(this->_tilesLoadedPerSecond));
+  INC_FLOAT_STAT_BY(
+      STAT_CesiumTilesUnloadedPerSecond,
+      float(this->_tilesUnloadedPerSecond));
+  INC_FLOAT_STAT_BY(
+      STAT_CesiumBytesReceivedPerSecond,
+      float(this->_bytesReceivedPerSecond));
+
+  if (maxDepthFrame != GFrameCounter) {
+    maxDepthFrame = GFrameCounter;
+    maxDepthVisited = 0;
+  }
+  maxDepthVisited = std::max(maxDepthVisited, result.maxDepthVisited);
+  SET_DWORD_STAT(STAT_CesiumMaxDepthVisited, maxDepthVisited);
+
+#if COUNTERSTRACE_ENABLED
+  TraceCounters* pCounters = this->_pTraceCounters.Get();
+  if (!pCounters) {
+    return;
+  }
+
+  pCounters->tilesRendered.Set(tilesRendered);
+  pCounters->tilesFadingOut.Set(tilesFadingOut);
+  pCounters->tilesVisited.Set(result.tilesVisited);
+  pCounters->culledTilesVisited.Set(result.culledTilesVisited);
+  pCounters->tilesCulled.Set(result.tilesCulled);
+  pCounters->tilesOccluded.Set(result.tilesOccluded);
+  pCounters->tilesWaitingForOcclusionResults.Set(
+      result.tilesWaitingForOcclusionResults);
+  pCounters->maxDepthVisited.Set(result.maxDepthVisited);
+  pCounters->workerThreadTileLoadQueueLength.Set(
+      result.workerThreadTileLoadQueueLength);
+  pCounters->mainThreadTileLoadQueueLength.Set(
+      result.mainThreadTileLoadQueueLength);
+  pCounters->tilesLoadedPerSecond.Set(this->_tilesLoadedPerSecond);
+  pCounters->tilesUnloadedPerSecond.Set(this->_tilesUnloadedPerSecond);
+  pCounters->bytesReceivedPerSecond.Set(this->_bytesReceivedPerSecond);
+#endif
+}
+
+void CesiumTilesetStatistics::updateRates(float deltaTime) {
+  this->_windowSeconds += std::max(0.0f, deltaTime);
+  if (this->_windowSeconds < RateWindowSeconds) {
+    return;
+  }
+
+  const int64 bytesReceived = this->_pRequestState->bytesReceived;
+  const double seconds = double(this->_windowSeconds);
+
+  this->_tilesLoadedPerSecond =
+      double(this->_tilesLoaded - this->_windowStartTilesLoaded) / seconds;
+  this->_tilesUnloadedPerSecond =
+      double(this->_tilesUnloaded - this->_windowStartTilesUnloaded) / seconds;
+  this->_bytesReceivedPerSecond =
+      double(bytesReceived - this->_windowStartBytesReceived) / seconds;
+
+  this->_windowStartTilesLoaded = this->_tilesLoaded;
+  this->_windowStartTilesUnloaded = this->_tilesUnloaded;
+  this->_windowStartBytesReceived = bytesReceived;
+  this->_windowSeconds = 0.0f;
+}
@@ -0,0 +1,161 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumLatencyHistogram.h"
+#include "CesiumTileLoadLatency.h"
+#include "CesiumTileLoadTimes.h"
+#include "Containers/UnrealString.h"
+#include "Templates/UniquePtr.h"
+#include <CesiumAsync/IAssetAccessor.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Cesium3DTilesSelection {
+class ViewUpdateResult;
+}
+
+/**
+ * Collects the tile selection and loading statistics of a single
+ * Cesium3DTileset and publishes them to the `stat Cesium` group and, when
+ * tracing is enabled, as per-tileset counters in Unreal Insights.
+ *
+ * The `stat Cesium` counters are the sums over all tilesets (except for the
+ * maximum depth visited, which is the maximum over all tilesets), while the
+ * Insights counters are named after the tileset that they belong to.
+ *
+ * It also keeps histograms of how long this tileset's tiles take to go from
+ * being requested to being shown.
+ */
+class CesiumTilesetStatistics {
+public:
+  CesiumTilesetStatistics();
+  ~CesiumTilesetStatistics();
+
+  /**
+   * Clears the accumulated rates and names the Insights counters after the
+   * given tileset. This is called whenever the tileset is (re)loaded.
+   */
+  void reset(const FString& tilesetName);
+
+  /**
+   * Wraps the given asset accessor so that the bytes of every response it
+   * receives are counted as received by this tileset, and the time that each
+   * request starts is remembered. Responses served from the request cache,
+   * archives and files are counted too, so this is not the network traffic.
+   *
+   * The returned accessor may safely outlive this instance.
+   */
+  std::shared_ptr<CesiumAsync::IAssetAccessor>
+  createAssetAccessor(const std::shared_ptr<CesiumAsync::IAssetAccessor>&
+                          pAssetAccessor) const;
+
+  /** Records that the renderer resources of a tile were created. */
+  void recordTileLoaded() { ++this->_tilesLoaded; }
+
+  /** Records that the renderer resources of a tile were freed. */
+  void recordTileUnloaded() { ++this->_tilesUnloaded; }
+
+  /**
+   * Gets the time at which the latest request for the given URL started, from
+   * FPlatformTime::Seconds, and forgets it. Returns a negative value if the
+   * URL was not requested through an accessor created by
+   * `createAssetAccessor`, or if its request failed. This may be called from
+   * any thread.
+   */
+  double takeRequestStartTime(const std::string& url);
+
+  /**
+   * Sets a function that is called with every request that completes through
+   * an accessor created by `createAssetAccessor`, on the thread on which it
+   * completes. An empty function stops the observing.
+   */
+  void setRequestObserver(
+      std::function<void(const CesiumAsync::IAssetRequest&)>&& observer);
+
+  /**
+   * Gets the number of requests made through an accessor created by
+   * `createAssetAccessor` that have not yet completed or failed.
+   */
+  int64 getRequestsInFlight() const;
+
+  /**
+   * Records the durations of the lifecycle stages of a tile that has just
+   * been shown for the first time.
+   */
+  void recordTileShown(const CesiumTileLoadTimes& times);
+
+  /**
+   * Gets a summary of how long this tileset's tiles took to complete the
+   * given lifecycle stage.
+   */
+  FCesiumTileLoadLatency getLatency(ECesiumTileLoadStage stage) const;
+
+  /** Forgets all recorded tile lifecycle durations. */
+  void resetLatency();
+
+  /**
+   * Publishes the result of this frame's tile selection, and updates the
+   * load, unload, and download rates.
+   */
+  void update(
+      const Cesium3DTilesSelection::ViewUpdateResult& result,
+      float deltaTime);
+
+  double getTilesLoadedPerSecond() const { return this->_tilesLoadedPerSecond; }
+
+  double getTilesUnloadedPerSecond() const {
+    return this->_tilesUnloadedPerSecond;
+  }
+
+  double getBytesReceivedPerSecond() const {
+    return this->_bytesReceivedPerSecond;
+  }
+
+  int64 getTilesRendered() const { return this->_tilesRendered; }
+
+  int64 getWorkerThreadTileLoadQueueLength() const {
+    return this->_workerThreadTileLoadQueueLength;
+  }
+
+  int64 getMainThreadTileLoadQueueLength() const {
+    return this->_mainThreadTileLoadQueueLength;
+  }
+
+private:
+  struct TraceCounters;
+  struct RequestState;
+  class AssetAccessor;
+
+  void updateRates(float deltaTime);
+
+  TUniquePtr<TraceCounters> _pTraceCounters;
+
+  // Shared with the asset accessors, which update it from worker threads as
+  // requests start and complete.
+  std::shared_ptr<RequestState> _pRequestState;
+
+  CesiumLatencyHistogram _loadingLatency;
+  CesiumLatencyHistogram _mainThreadLatency;
+  CesiumLatencyHistogram _showingLatency;
+  CesiumLatencyHistogram _totalLatency;
+
+  int64 _tilesLoaded;
+  int64 _tilesUnloaded;
+
+  // From the most recent view update.
+  int64 _tilesRendered;
+  int64 _workerThreadTileLoadQueueLength;
+  int64 _mainThreadTileLoadQueueLength;
+
+  // The totals at the start of the current rate window.
+  int64 _windowStartTilesLoaded;
+  int64 _windowStartTilesUnloaded;
+  int64 _windowStartBytesReceived;
+  float _windowSeconds;
+
+  double _tilesLoadedPerSecond;
+  double _tilesUnloadedPerSecond;
+  double _bytesReceivedPerSecond;
+};
@@ -0,0 +1,15 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include <string>
+
+/**
+ * Gets the host of the given URL, by which requests are scheduled and their
+ * response times are measured.
+ */
+inline std::string getUrlHost(const std::string& url) {
+  return TCHAR_TO_UTF8(
+      *FGenericPlatformHttp::GetUrlDomain(UTF8_TO_TCHAR(url.c_str())));
+}
@@ -0,0 +1,354 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumWarmStart.h"
+#include "Cesium3DTileset.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumIonServer.h"
+#include "CesiumRuntime.h"
+#include "Engine/World.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Warm Start Tiles Prefetched"),
+    STAT_CesiumWarmStartTilesPrefetched,
+    STATGROUP_Cesium);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Time To First Full View"),
+    STAT_CesiumTimeToFirstFullView,
+    STATGROUP_Cesium);
+DECLARE_FLOAT_ACCUMULATOR_STAT(
+    TEXT("Previous Time To First Full View"),
+    STAT_CesiumPreviousTimeToFirstFullView,
+    STATGROUP_Cesium);
+
+using namespace CesiumAsync;
+
+namespace {
+
+const TCHAR* SnapshotHeader = TEXT("CesiumWarmStart 1");
+const TCHAR* TimeToFirstFullViewKey = TEXT("TimeToFirstFullView ");
+
+/**
+ * Gets the scheme, host and port of a URL, which together decide whether
+ * the headers of a request to one URL may be sent with a request to another.
+ */
+std::string getOrigin(const std::string& url) {
+  const size_t schemeEnd = url.find("://");
+  if (schemeEnd == std::string::npos) {
+    return std::string();
+  }
+  return url.substr(0, url.find('/', schemeEnd + 3));
+}
+
+/**
+ * Whether a query parameter may hold a credential, such as an API key, an
+ * access token, a session, or the signature of a signed URL.
+ */
+bool isCredential(const std::string& parameter) {
+  std::string name = parameter.substr(0, parameter.find('='));
+  std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
+    return char(std::tolower(c));
+  });
+
+  for (const char* part :
+       {"key", "token", "session", "sig", "auth", "secret", "password"}) {
+    if (name.find(part) != std::string::npos) {
+      return true;
+    }
+  }
+  return name.rfind("x-amz-", 0) == 0 || name.rfind("x-goog-", 0) == 0 ||
+         name == "expires" || name == "policy";
+}
+
+/** A URL with its query split into parameters. */
+struct SplitUrl {
+  std::string path;
+  std::vector<std::string> parameters;
+  std::string fragment;
+
+  explicit SplitUrl(const std::string& url) {
+    const size_t fragmentStart = url.find('#');
+    if (fragmentStart != std::string::npos) {
+      this->fragment = url.substr(fragmentStart);
+    }
+
+    const std::string withoutFragment = url.substr(0, fragmentStart);
+    const size_t queryStart = withoutFragment.find('?');
+    this->path = withoutFragment.substr(0, queryStart);
+    if (queryStart == std::string::npos) {
+      return;
+    }
+
+    size_t start = queryStart + 1;
+    while (start <= withoutFragment.size()) {
+      const size_t end =
+          std::min(withoutFragment.find('&', start), withoutFragment.size());
+      if (end > start) {
+        this->parameters.emplace_back(
+            withoutFragment.substr(start, end - start));
+      }
+      start = end + 1;
+    }
+  }
+
+  std::string join() const {
+    std::string url = this->path;
+    for (size_t i = 0; i < this->parameters.size(); ++i) {
+      url += i == 0 ? '?' : '&';
+      url += this->parameters[i];
+    }
+    return url + this->fragment;
+  }
+};
+
+/**
+ * Removes the query parameters that may hold credentials from a URL, so that
+ * it can be written to disk.
+ */
+std::string removeCredentials(const std::string& url) {
+  SplitUrl split(url);
+  split.parameters.erase(
+      std::remove_if(
+          split.parameters.begin(),
+          split.parameters.end(),
+          isCredential),
+      split.parameters.end());
+  return split.join();
+}
+
+/**
+ * Adds the query parameters that may hold credentials of another URL, from
+ * the current session, to a URL from which they were removed.
+ */
+std::string
+addCredentials(const std::string& url, const std::string& credentialsUrl) {
+  SplitUrl split(url);
+  for (const std::string& parameter : SplitUrl(credentialsUrl).parameters) {
+    if (isCredential(parameter)) {
+      split.parameters.push_back(parameter);
+    }
+  }
+  return split.join();
+}
+
+class PrefetchingAssetAccessor : public IAssetAccessor {
+public:
+  PrefetchingAssetAccessor(
+      const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+      std::string&& origin,
+      std::vector<std::string>&& urls)
+      : _pAssetAccessor(pAssetAccessor),
+        _origin(std::move(origin)),
+        _urls(std::move(urls)),
+        _prefetched(false) {}
+
+  virtual Future<std::shared_ptr<IAssetRequest>>
+  get(const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    // Send this request first, so that the prefetched tiles do not delay the
+    // tileset.json that the traversal is waiting for.
+    Future<std::shared_ptr<IAssetRequest>> result =
+        this->_pAssetAccessor->get(asyncSystem, url, headers);
+    if (!this->_prefetched && getOrigin(url) == this->_origin &&
+        !this->_prefetched.exchange(true)) {
+      this->prefetch(asyncSystem, url, headers);
+    }
+    return result;
+  }
+
+  virtual Future<std::shared_ptr<IAssetRequest>> request(
+      const AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override {
+    return this->_pAssetAccessor
+        ->request(asyncSystem, verb, url, headers, contentPayload);
+  }
+
+  virtual void tick() noexcept override { this->_pAssetAccessor->tick(); }
+
+private:
+  void prefetch(
+      const AsyncSystem& asyncSystem,
+      const std::string& requestedUrl,
+      const std::vector<THeader>& headers) {
+    const std::string requestedPath = removeCredentials(requestedUrl);
+    int64 count = 0;
+    for (const std::string& url : this->_urls) {
+      if (url == requestedPath) {
+        continue;
+      }
+
+      // Nothing waits for the response; it only needs to reach the request
+      // cache. If the traversal asks for the same tile before then, it shares
+      // this request when cesium.Requests.Coalesce is on, and otherwise
+      // requests the tile again unless this response is already cached.
+      this->_pAssetAccessor->get(
+          asyncSystem,
+          addCredentials(url, requestedUrl),
+          headers);
+      ++count;
+    }
+
+    this->_urls.clear();
+    this->_urls.shrink_to_fit();
+
+    INC_DWORD_STAT_BY(STAT_CesiumWarmStartTilesPrefetched, count);
+    UE_LOG(
+        LogCesium,
+        Verbose,
+        TEXT("Prefetching %lld tiles from %s"),
+        count,
+        UTF8_TO_TCHAR(this->_origin.c_str()));
+  }
+
+  std::shared_ptr<IAssetAccessor> _pAssetAccessor;
+  std::string _origin;
+
+  // Only used by the request that wins _prefetched.
+  std::vector<std::string> _urls;
+  std::atomic<bool> _prefetched;
+};
+
+} // namespace
+
+/*static*/ FString
+CesiumWarmStart::getSnapshotFilename(const ACesium3DTileset& tileset) {
+  FString level;
+  if (const UWorld* pWorld = tileset.GetWorld()) {
+    level = UWorld::RemovePIEPrefix(pWorld->GetOutermost()->GetName());
+  }
+
+  FString source;
+  switch (tileset.GetTilesetSource()) {
+  case ETilesetSource::FromUrl:
+    source = tileset.GetUrl();
+    break;
+  case ETilesetSource::FromCesiumIon:
+    source = FString::Printf(
+        TEXT("%s/%lld"),
+        tileset.GetCesiumIonServer()
+            ? *tileset.GetCesiumIonServer()->ServerUrl
+            : TEXT(""),
+        tileset.GetIonAssetID());
+    break;
+  }
+
+  const uint32 key = FCrc::StrCrc32(
+      *FString::Printf(TEXT("%s|%s|%s"), *level, *tileset.GetName(), *source));
+  return FPaths::Combine(
+      FPaths::ProjectSavedDir(),
+      TEXT("Cesium"),
+      TEXT("WarmStart"),
+      FString::Printf(TEXT("%s-%08x.txt"), *tileset.GetName(), key));
+}
+
+/*static*/ bool CesiumWarmStart::saveSnapshot(
+    const FString& filename,
+    const Snapshot& snapshot) {
+  TArray<FString> lines;
+  lines.Reserve(int32(snapshot.urls.size()) + 2);
+  lines.Add(SnapshotHeader);
+  lines.Add(FString::Printf(
+      TEXT("%s%f"),
+      TimeToFirstFullViewKey,
+      snapshot.timeToFirstFullView));
+  for (const std::string& url : snapshot.urls) {
+    lines.Add(UTF8_TO_TCHAR(removeCredentials(url).c_str()));
+  }
+
+  return FFileHelper::SaveStringArrayToFile(
+      lines,
+      *filename,
+      FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+/*static*/ std::optional<CesiumWarmStart::Snapshot>
+CesiumWarmStart::loadSnapshot(const FString& filename) {
+  TArray<FString> lines;
+  if (!FFileHelper::LoadFileToStringArray(lines, *filename) ||
+      lines.Num() < 2 || lines[0] != SnapshotHeader ||
+      !lines[1].StartsWith(TimeToFirstFullViewKey)) {
+    return std::nullopt;
+  }
+
+  Snapshot snapshot;
+  snapshot.timeToFirstFullView = FCString::Atod(
+      *lines[1].RightChop(FCString::Strlen(TimeToFirstFullViewKey)));
+  snapshot.urls.reserve(lines.Num() - 2);
+  for (int32 i = 2; i < lines.Num(); ++i) {
+    if (!lines[i].IsEmpty()) {
+      snapshot.urls.emplace_back(TCHAR_TO_UTF8(*lines[i]));
+    }
+  }
+  return snapshot;
+}
+
+/*static*/ std::shared_ptr<IAssetAccessor>
+CesiumWarmStart::createAssetAccessor(
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
+    std::vector<std::string>&& urls) {
+  if (urls.empty()) {
+    return pAssetAccessor;
+  }
+
+  // The credentials of the current session are added when the URLs are
+  // prefetched. Snapshots are saved without them, but may have been saved by
+  // an older version.
+  for (std::string& url : urls) {
+    url = removeCredentials(url);
+  }
+
+  // The headers of the first request are only sent to the same origin, so
+  // that an access token is never sent to a server that it is not for.
+  std::string origin = getOrigin(urls.front());
+  urls.erase(
+      std::remove_if(
+          urls.begin(),
+          urls.end(),
+          [&origin](const std::string& url) {
+            return getOrigin(url) != origin;
+          }),
+      urls.end());
+
+  return std::make_shared<PrefetchingAssetAccessor>(
+      pAssetAccessor,
+      std::move(origin),
+      std::move(urls));
+}
+
+/*static*/ void CesiumWarmStart::reportTimeToFirstFullView(
+    const ACesium3DTileset& tileset,
+    double seconds,
+    double previousSeconds) {
+  SET_FLOAT_STAT(STAT_CesiumTimeToFirstFullView, float(seconds));
+  SET_FLOAT_STAT(
+      STAT_CesiumPreviousTimeToFirstFullView,
+      float(previousSeconds));
+
+  if (previousSeconds < 0.0) {
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT("%s: first completely loaded after %.2f seconds"),
+        *tileset.GetName(),
+        seconds);
+  } else {
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT(
+            "%s: first completely loaded after %.2f seconds, compared with %.2f seconds in the previous session"),
+        *tileset.GetName(),
+        seconds,
+        previousSeconds);
+  }
+}
@@ -0,0 +1,81 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumAsync/IAssetAccessor.h"
+#include "Containers/UnrealString.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+class ACesium3DTileset;
+
+/**
+ * Lets a tileset start where it left off. When play ends, the URLs of the
+ * tiles that the tileset was showing are written to a snapshot. The next time
+ * the tileset is loaded, they are all requested as soon as the tileset makes
+ * its first request to their server, so that they are in the request cache,
+ * or on their way, by the time the traversal reaches them.
+ *
+ * Query parameters that may hold credentials, such as API keys, access
+ * tokens, sessions and the signatures of signed URLs, are not written to the
+ * snapshot. The prefetched requests get those of that first request instead,
+ * along with its headers, so tiles from Cesium ion are requested with the new
+ * session's access token. Tiles whose URLs hold a session of their own, as
+ * those of some tile servers do, cannot be prefetched; their requests simply
+ * fail and the tiles are loaded as usual.
+ */
+class CesiumWarmStart {
+public:
+  struct Snapshot {
+    /** The URLs of the content of the tiles that were shown. */
+    std::vector<std::string> urls;
+
+    /**
+     * The number of seconds from loading the tileset until it was first
+     * completely loaded, in the session that wrote the snapshot, or -1 if it
+     * never was.
+     */
+    double timeToFirstFullView = -1.0;
+  };
+
+  /**
+   * Gets the file in which the snapshot of a tileset is kept. It is specific
+   * to the tileset's level, name and source, and is the same in the editor
+   * and in play-in-editor sessions.
+   */
+  static FString getSnapshotFilename(const ACesium3DTileset& tileset);
+
+  /**
+   * Writes a snapshot, without the query parameters of its URLs that may hold
+   * credentials.
+   */
+  static bool saveSnapshot(const FString& filename, const Snapshot& snapshot);
+
+  /**
+   * Reads a snapshot, or returns nothing if the file does not exist or is not
+   * a snapshot.
+   */
+  static std::optional<Snapshot> loadSnapshot(const FString& filename);
+
+  /**
+   * Creates an asset accessor that forwards requests to the given one and,
+   * on the first request to the server of the given URLs, also requests all
+   * of them with the same headers and credential query parameters. The
+   * responses of those requests are only used to fill the request cache.
+   */
+  static std::shared_ptr<CesiumAsync::IAssetAccessor> createAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor,
+      std::vector<std::string>&& urls);
+
+  /**
+   * Publishes how long a tileset took to be completely loaded to `stat
+   * Cesium` and the log, along with how long it took in the session that
+   * wrote its snapshot.
+   */
+  static void reportTimeToFirstFullView(
+      const ACesium3DTileset& tileset,
+      double seconds,
+      double previousSeconds);
+};
@@ -0,0 +1,149 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CoalescingAssetAccessor.h"
+#include "CesiumRuntime.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/IAssetRequest.h>
+#include <CesiumAsync/Promise.h>
+#include <CesiumAsync/SharedFuture.h>
+#include <atomic>
+#include <stdexcept>
+#include <unordered_map>
+
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Coalesced Requests"),
+    STAT_CesiumCoalescedRequests,
+    STATGROUP_Cesium);
+
+using namespace CesiumAsync;
+
+namespace {
+
+TAutoConsoleVariable<bool> CVarCoalesceRequests(
+    TEXT("cesium.Requests.Coalesce"),
+    true,
+    TEXT(
+        "Whether identical Cesium GET requests that are in flight at the same time are sent only once."),
+    ECVF_Default);
+
+std::string createKey(
+    const std::string& url,
+    const std::vector<IAssetAccessor::THeader>& headers) {
+  size_t size = url.size();
+  for (const IAssetAccessor::THeader& header : headers) {
+    size += header.first.size() + header.second.size() + 2;
+  }
+
+  // Neither URLs nor headers contain newlines, so they separate the parts
+  // unambiguously.
+  std::string key;
+  key.reserve(size);
+  key += url;
+  for (const IAssetAccessor::THeader& header : headers) {
+    key += '\n';
+    key += header.first;
+    key += ':';
+    key += header.second;
+  }
+
+  return key;
+}
+
+} // namespace
+
+struct CoalescingAssetAccessor::InFlightRequests {
+  FCriticalSection lock;
+  std::unordered_map<std::string, SharedFuture<std::shared_ptr<IAssetRequest>>>
+      requests;
+  std::atomic<int64> coalescedCount{0};
+};
+
+CoalescingAssetAccessor::CoalescingAssetAccessor(
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor)
+    : _pAssetAccessor(pAssetAccessor),
+      _pInFlight(std::make_shared<InFlightRequests>()) {}
+
+CoalescingAssetAccessor::~CoalescingAssetAccessor() = default;
+
+Future<std::shared_ptr<IAssetRequest>> CoalescingAssetAccessor::get(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers) {
+  if (!CVarCoalesceRequests.GetValueOnAnyThread()) {
+    return this->_pAssetAccessor->get(asyncSystem, url, headers);
+  }
+
+  std::string key = createKey(url, headers);
+  Promise<std::shared_ptr<IAssetRequest>> promise =
+      asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>();
+  SharedFuture<std::shared_ptr<IAssetRequest>> future =
+      promise.getFuture().share();
+
+  auto copyRequest = [](const std::shared_ptr<IAssetRequest>& pRequest) {
+    return pRequest;
+  };
+
+  {
+    FScopeLock lock(&this->_pInFlight->lock);
+    auto [it, inserted] = this->_pInFlight->requests.emplace(key, future);
+    if (!inserted) {
+      ++this->_pInFlight->coalescedCount;
+      INC_DWORD_STAT(STAT_CesiumCoalescedRequests);
+      return it->second.thenImmediately(copyRequest);
+    }
+  }
+
+  // The request is removed before its waiters are resumed, so that any
+  // identical request that starts from then on is sent again.
+  std::shared_ptr<InFlightRequests> pInFlight = this->_pInFlight;
+  this->_pAssetAccessor->get(asyncSystem, url, headers)
+      .thenImmediately(
+          [pInFlight, key, promise](std::shared_ptr<IAssetRequest>&& pRequest) {
+            {
+              FScopeLock lock(&pInFlight->lock);
+              pInFlight->requests.erase(key);
+            }
+            promise.resolve(std::move(pRequest));
+          })
+      .catchImmediately([pInFlight, key, promise](std::exception&& e) {
+        {
+          FScopeLock lock(&pInFlight->lock);
+          pInFlight->requests.erase(key);
+        }
+        // Rejecting with e itself would slice it to a std::exception, which
+        // loses the message on some platforms.
+        promise.reject(std::runtime_error(e.what()));
+      });
+
+  return future.thenImmediately(copyRequest);
+}
+
+Future<std::shared_ptr<IAssetRequest>> CoalescingAssetAccessor::request(
+    const AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  if (verb == "GET" && contentPayload.empty()) {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  return this->_pAssetAccessor
+      ->request(asyncSystem, verb, url, headers, contentPayload);
+}
+
+void CoalescingAssetAccessor::tick() noexcept {
+  this->_pAssetAccessor->tick();
+}
+
+int64 CoalescingAssetAccessor::getCoalescedRequestCount() const {
+  return this->_pInFlight->coalescedCount;
+}
+
+int64 CoalescingAssetAccessor::getInFlightRequestCount() const {
+  FScopeLock lock(&this->_pInFlight->lock);
+  return int64(this->_pInFlight->requests.size());
+}
@@ -0,0 +1,64 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/Platform.h"
+#include <CesiumAsync/IAssetAccessor.h>
+#include <memory>
+#include <string>
+
+/**
+ * An asset accessor that coalesces identical GET requests that are in flight
+ * at the same time, so that they are sent only once. This happens when
+ * several tilesets or raster overlays request the same `tileset.json`,
+ * `layer.json`, metadata, or imagery tile at once.
+ *
+ * Requests are identical if they have the same URL and the same headers in
+ * the same order. All of the coalesced requests complete with the same
+ * IAssetRequest, and so share its response buffer. A request that starts
+ * after an identical one has completed is sent again.
+ *
+ * Coalescing can be switched off with the `cesium.Requests.Coalesce` console
+ * variable, and the number of coalesced requests is shown in the
+ * `stat Cesium` group.
+ */
+class CoalescingAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  explicit CoalescingAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor);
+  virtual ~CoalescingAssetAccessor() override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers)
+      override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  virtual void tick() noexcept override;
+
+  /**
+   * Gets the number of requests that were served by an identical request
+   * that was already in flight, rather than being sent.
+   */
+  int64 getCoalescedRequestCount() const;
+
+  /** Gets the number of distinct requests that are currently in flight. */
+  int64 getInFlightRequestCount() const;
+
+private:
+  struct InFlightRequests;
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> _pAssetAccessor;
+
+  // Shared with the continuations of the in-flight requests, which remove
+  // them when they complete.
+  std::shared_ptr<InFlightRequests> _pInFlight;
+};
@@ -4,6 +4,7 @@
 
 #include "CesiumCommon.h"
 #include "CesiumEncodedFeaturesMetadata.h"
+#include "CesiumMemoryUsage.h"
 #include "CesiumMetadataPrimitive.h"
 #include "CesiumModelMetadata.h"
 #include "CesiumPrimitiveFeatures.h"
@@ -181,5 +182,8 @@ struct LoadModelResult {
   // For backwards compatibility with CesiumEncodedMetadataComponent.
   std::optional<CesiumEncodedMetadataUtility::EncodedMetadata>
       EncodedMetadata_DEPRECATED{};
+
+  // The memory that the renderer resources created from this result will use.
+  CesiumMemoryUsage MemoryUsage{};
 };
 } // namespace LoadGltfResult
@@ -0,0 +1,408 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "NetworkEmulationAssetAccessor.h"
+#include "CesiumRuntimeSettings.h"
+#include "HAL/Event.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Crc.h"
+#include "Misc/ScopeLock.h"
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/IAssetRequest.h>
+#include <CesiumAsync/IAssetResponse.h>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace CesiumAsync;
+
+namespace {
+
+/**
+ * Gets a number from 0 to 1 that depends only on the given URL, attempt,
+ * seed, and purpose.
+ */
+double hashToUnitInterval(
+    const std::string& url,
+    uint32 attempt,
+    uint32 seed,
+    uint32 purpose) {
+  uint32 hash = FCrc::MemCrc32(url.data(), int32(url.size()), seed);
+  hash = FCrc::MemCrc32(&attempt, sizeof(attempt), hash);
+  hash = FCrc::MemCrc32(&purpose, sizeof(purpose), hash);
+  return double(hash) / double(MAX_uint32);
+}
+
+TAutoConsoleVariable<int32> CVarNetworkEmulationEnabled(
+    TEXT("cesium.NetworkEmulation.Enabled"),
+    -1,
+    TEXT(
+        "Whether to emulate a slow network for Cesium requests: 1 to enable, 0 to disable, or -1 to use the project setting."),
+    ECVF_Default);
+
+TAutoConsoleVariable<float> CVarNetworkEmulationLatency(
+    TEXT("cesium.NetworkEmulation.LatencyMs"),
+    -1.0f,
+    TEXT(
+        "The emulated latency of Cesium requests in milliseconds, or -1 to use the project setting."),
+    ECVF_Default);
+
+TAutoConsoleVariable<float> CVarNetworkEmulationJitter(
+    TEXT("cesium.NetworkEmulation.JitterMs"),
+    -1.0f,
+    TEXT(
+        "The maximum variation of the emulated latency in milliseconds, or -1 to use the project setting."),
+    ECVF_Default);
+
+TAutoConsoleVariable<float> CVarNetworkEmulationBandwidth(
+    TEXT("cesium.NetworkEmulation.BandwidthKbps"),
+    -1.0f,
+    TEXT(
+        "The emulated bandwidth in kilobits per second (0 for unlimited), or -1 to use the project setting."),
+    ECVF_Default);
+
+TAutoConsoleVariable<float> CVarNetworkEmulationFailureRate(
+    TEXT("cesium.NetworkEmulation.FailureRate"),
+    -1.0f,
+    TEXT(
+        "The fraction of Cesium requests, from 0 to 1, that fail with HTTP 503, or -1 to use the project setting."),
+    ECVF_Default);
+
+class EmulatedFailureResponse : public IAssetResponse {
+public:
+  virtual uint16_t statusCode() const override { return 503; }
+
+  virtual std::string contentType() const override { return std::string(); }
+
+  virtual const HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const override { return {}; }
+
+private:
+  HttpHeaders _headers;
+};
+
+class EmulatedFailureRequest : public IAssetRequest {
+public:
+  EmulatedFailureRequest(const std::string& verb, const std::string& url)
+      : _method(verb), _url(url) {}
+
+  virtual const std::string& method() const override { return this->_method; }
+
+  virtual const std::string& url() const override { return this->_url; }
+
+  virtual const HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+
+  virtual const IAssetResponse* response() const override {
+    return &this->_response;
+  }
+
+private:
+  std::string _method;
+  std::string _url;
+  HttpHeaders _headers;
+  EmulatedFailureResponse _response;
+};
+
+} // namespace
+
+/*static*/ CesiumNetworkEmulationSettings
+CesiumNetworkEmulationSettings::getCurrent() {
+  const UCesiumRuntimeSettings* pSettings =
+      GetDefault<UCesiumRuntimeSettings>();
+
+  CesiumNetworkEmulationSettings result;
+  result.enabled = pSettings->EnableNetworkEmulation;
+  result.latencySeconds =
+      pSettings->NetworkEmulationLatencyMilliseconds / 1000.0;
+  result.jitterSeconds = pSettings->NetworkEmulationJitterMilliseconds / 1000.0;
+  result.bandwidthBytesPerSecond =
+      pSettings->NetworkEmulationBandwidthKilobitsPerSecond * 1000.0 / 8.0;
+  result.failureRate = pSettings->NetworkEmulationFailureRate;
+  result.seed = uint32(pSettings->NetworkEmulationSeed);
+
+  const int32 enabled = CVarNetworkEmulationEnabled.GetValueOnAnyThread();
+  if (enabled >= 0) {
+    result.enabled = enabled != 0;
+  }
+
+  const float latency = CVarNetworkEmulationLatency.GetValueOnAnyThread();
+  if (latency >= 0.0f) {
+    result.latencySeconds = latency / 1000.0;
+  }
+
+  const float jitter = CVarNetworkEmulationJitter.GetValueOnAnyThread();
+  if (jitter >= 0.0f) {
+    result.jitterSeconds = jitter / 1000.0;
+  }
+
+  const float bandwidth = CVarNetworkEmulationBandwidth.GetValueOnAnyThread();
+  if (bandwidth >= 0.0f) {
+    result.bandwidthBytesPerSecond = bandwidth * 1000.0 / 8.0;
+  }
+
+  const float failureRate =
+      CVarNetworkEmulationFailureRate.GetValueOnAnyThread();
+  if (failureRate >= 0.0f) {
+    result.failureRate = failureRate;
+  }
+
+  result.failureRate = std::clamp(result.failureRate, 0.0, 1.0);
+  return result;
+}
+
+/**
+ * Calls functions once their deadlines pass, and tracks the shared state of
+ * the emulated link. Pending functions are called immediately when the
+ * thread stops, so no request is left unresolved.
+ */
+class NetworkEmulationAssetAccessor::DelayThread : public FRunnable {
+public:
+  DelayThread()
+      : _pWakeEvent(FPlatformProcess::GetSynchEventFromPool()),
+        _stopping(false),
+        _linkAvailableTime(0.0) {
+    this->_pThread = FRunnableThread::Create(
+        this,
+        TEXT("CesiumNetworkEmulation"),
+        0,
+        TPri_AboveNormal);
+  }
+
+  virtual ~DelayThread() override {
+    if (this->_pThread) {
+      this->_pThread->Kill(true);
+      delete this->_pThread;
+    }
+    FPlatformProcess::ReturnSynchEventToPool(this->_pWakeEvent);
+  }
+
+  void schedule(double deadline, std::function<void()>&& callback) {
+    {
+      FScopeLock lock(&this->_lock);
+      if (!this->_stopping) {
+        this->_pending.HeapPush(
+            Pending{deadline, std::move(callback)},
+            PendingPredicate());
+        this->_pWakeEvent->Trigger();
+        return;
+      }
+    }
+    callback();
+  }
+
+  /**
+   * Returns the time at which a response of the given size, whose first byte
+   * is ready at the given time, has been completely received, and reserves
+   * the link until then.
+   */
+  double reserveLink(double firstByteTime, int64 bytes, double bytesPerSecond) {
+    if (bytesPerSecond <= 0.0) {
+      return firstByteTime;
+    }
+
+    FScopeLock lock(&this->_lock);
+    const double start = std::max(firstByteTime, this->_linkAvailableTime);
+    this->_linkAvailableTime = start + double(bytes) / bytesPerSecond;
+    return this->_linkAvailableTime;
+  }
+
+  /**
+   * Gets the number of times the given URL has been requested before, so
+   * that a retried request is not doomed to repeat the fate of the first.
+   */
+  uint32 nextAttempt(const std::string& url) {
+    FScopeLock lock(&this->_lock);
+    if (this->_attempts.size() > 65536) {
+      this->_attempts.clear();
+    }
+    return this->_attempts[url]++;
+  }
+
+  virtual uint32 Run() override {
+    while (true) {
+      TArray<std::function<void()>> due;
+      uint32 waitMilliseconds = MAX_uint32;
+      {
+        FScopeLock lock(&this->_lock);
+        const double now = FPlatformTime::Seconds();
+        while (this->_pending.Num() > 0 &&
+               (this->_stopping || this->_pending.HeapTop().deadline <= now)) {
+          Pending pending;
+          this->_pending.HeapPop(pending, PendingPredicate(), false);
+          due.Add(MoveTemp(pending.callback));
+        }
+
+        if (this->_stopping && due.Num() == 0) {
+          return 0;
+        }
+
+        if (this->_pending.Num() > 0) {
+          waitMilliseconds = uint32(FMath::CeilToDouble(
+              (this->_pending.HeapTop().deadline - now) * 1000.0));
+        }
+      }
+
+      for (std::function<void()>& callback : due) {
+        callback();
+      }
+
+      if (due.Num() == 0) {
+        this->_pWakeEvent->Wait(waitMilliseconds);
+      }
+    }
+  }
+
+  virtual void Stop() override {
+    FScopeLock lock(&this->_lock);
+    this->_stopping = true;
+    this->_pWakeEvent->Trigger();
+  }
+
+private:
+  struct Pending {
+    double deadline;
+    std::function<void()> callback;
+  };
+
+  struct PendingPredicate {
+    bool operator()(const Pending& lhs, const Pending& rhs) const {
+      return lhs.deadline < rhs.deadline;
+    }
+  };
+
+  FRunnableThread* _pThread;
+  FEvent* _pWakeEvent;
+  FCriticalSection _lock;
+  TArray<Pending> _pending;
+  bool _stopping;
+  double _linkAvailableTime;
+  std::unordered_map<std::string, uint32> _attempts;
+};
+
+NetworkEmulationAssetAccessor::NetworkEmulationAssetAccessor(
+    const std::shared_ptr<IAssetAccessor>& pAssetAccessor)
+    : _pAssetAccessor(pAssetAccessor), _delayThreadLock(), _pDelayThread() {}
+
+NetworkEmulationAssetAccessor::~NetworkEmulationAssetAccessor() = default;
+
+Future<std::shared_ptr<IAssetRequest>> NetworkEmulationAssetAccessor::get(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers) {
+  CesiumNetworkEmulationSettings settings =
+      CesiumNetworkEmulationSettings::getCurrent();
+  if (!settings.enabled) {
+    return this->_pAssetAccessor->get(asyncSystem, url, headers);
+  }
+
+  return this->emulate(
+      asyncSystem,
+      settings,
+      "GET",
+      url,
+      [this, &asyncSystem, &url, &headers]() {
+        return this->_pAssetAccessor->get(asyncSystem, url, headers);
+      });
+}
+
+Future<std::shared_ptr<IAssetRequest>> NetworkEmulationAssetAccessor::request(
+    const AsyncSystem& asyncSystem,
+    const std::string& verb,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  CesiumNetworkEmulationSettings settings =
+      CesiumNetworkEmulationSettings::getCurrent();
+  if (!settings.enabled) {
+    return this->_pAssetAccessor
+        ->request(asyncSystem, verb, url, headers, contentPayload);
+  }
+
+  return this->emulate(
+      asyncSystem,
+      settings,
+      verb,
+      url,
+      [this, &asyncSystem, &verb, &url, &headers, &contentPayload]() {
+        return this->_pAssetAccessor
+            ->request(asyncSystem, verb, url, headers, contentPayload);
+      });
+}
+
+void NetworkEmulationAssetAccessor::tick() noexcept {
+  this->_pAssetAccessor->tick();
+}
+
+std::shared_ptr<NetworkEmulationAssetAccessor::DelayThread>
+NetworkEmulationAssetAccessor::getDelayThread() {
+  FScopeLock lock(&this->_delayThreadLock);
+  if (!this->_pDelayThread) {
+    this->_pDelayThread = std::make_shared<DelayThread>();
+  }
+  return this->_pDelayThread;
+}
+
+Future<std::shared_ptr<IAssetRequest>> NetworkEmulationAssetAccessor::emulate(
+    const AsyncSystem& asyncSystem,
+    const CesiumNetworkEmulationSettings& settings,
+    const std::string& verb,
+    const std::string& url,
+    const std::function<Future<std::shared_ptr<IAssetRequest>>()>& send) {
+  const double start = FPlatformTime::Seconds();
+  const std::shared_ptr<DelayThread> pDelayThread = this->getDelayThread();
+
+  const uint32 attempt = pDelayThread->nextAttempt(url);
+  const double jitter =
+      (2.0 * hashToUnitInterval(url, attempt, settings.seed, 0) - 1.0) *
+      settings.jitterSeconds;
+  const double firstByteTime =
+      start + std::max(0.0, settings.latencySeconds + jitter);
+
+  Promise<std::shared_ptr<IAssetRequest>> promise =
+      asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>();
+
+  const double failure = hashToUnitInterval(url, attempt, settings.seed, 1);
+  if (failure < settings.failureRate) {
+    std::shared_ptr<IAssetRequest> pFailure =
+        std::make_shared<EmulatedFailureRequest>(verb, url);
+    pDelayThread->schedule(
+        firstByteTime,
+        [promise, pFailure = std::move(pFailure)]() {
+          promise.resolve(pFailure);
+        });
+    return promise.getFuture();
+  }
+
+  send()
+      .thenImmediately([promise,
+                        pDelayThread,
+                        firstByteTime,
+                        bytesPerSecond = settings.bandwidthBytesPerSecond](
+                           std::shared_ptr<IAssetRequest>&& pRequest) {
+        const IAssetResponse* pResponse = pRequest->response();
+        const int64 bytes = pResponse ? int64(pResponse->data().size()) : 0;
+        const double deadline =
+            pDelayThread->reserveLink(firstByteTime, bytes, bytesPerSecond);
+        pDelayThread->schedule(
+            deadline,
+            [promise, pRequest = std::move(pRequest)]() {
+              promise.resolve(pRequest);
+            });
+      })
+      .catchImmediately([promise](std::exception&& e) {
+        // Rejecting with e itself would slice it to a std::exception, which
+        // loses the message on some platforms.
+        promise.reject(std::runtime_error(e.what()));
+      });
+
+  return promise.getFuture();
+}
@@ -0,0 +1,107 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "HAL/CriticalSection.h"
+#include "HAL/Platform.h"
+#include <CesiumAsync/IAssetAccessor.h>
+#include <functional>
+#include <memory>
+
+/**
+ * The network conditions emulated by a NetworkEmulationAssetAccessor.
+ */
+struct CesiumNetworkEmulationSettings {
+  bool enabled = false;
+
+  /** The time from sending a request to receiving its first byte. */
+  double latencySeconds = 0.0;
+
+  /**
+   * The maximum random variation of the latency, in either direction. The
+   * variation of each request is derived from its URL and the seed, so
+   * repeated runs see the same delays.
+   */
+  double jitterSeconds = 0.0;
+
+  /**
+   * The rate at which response bodies are received, shared by all requests,
+   * or 0 for no limit.
+   */
+  double bandwidthBytesPerSecond = 0.0;
+
+  /**
+   * The fraction of requests, from 0 to 1, that fail with an HTTP 503
+   * response instead of being served.
+   */
+  double failureRate = 0.0;
+
+  uint32 seed = 0;
+
+  /**
+   * Gets the current settings, from the Network Emulation section of the
+   * Cesium project settings, overridden by any `cesium.NetworkEmulation.*`
+   * console variables that have been set. May be called from any thread.
+   */
+  static CesiumNetworkEmulationSettings getCurrent();
+};
+
+/**
+ * An asset accessor that delays and fails the requests of another accessor
+ * to emulate a slow or unreliable network, such as a satellite link. The
+ * underlying accessor may serve `file:///` URLs, in which case local files
+ * stand in for a server.
+ *
+ * The settings are read for every request, so emulation can be switched on
+ * and off while tilesets are loading. When it is disabled, requests pass
+ * through untouched.
+ */
+class NetworkEmulationAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  explicit NetworkEmulationAssetAccessor(
+      const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAssetAccessor);
+  virtual ~NetworkEmulationAssetAccessor() override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers)
+      override;
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override;
+
+  virtual void tick() noexcept override;
+
+private:
+  class DelayThread;
+
+  /**
+   * Sends a request with the given function, unless the emulated network
+   * fails it, and delays its response according to the given settings.
+   */
+  CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>> emulate(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const CesiumNetworkEmulationSettings& settings,
+      const std::string& verb,
+      const std::string& url,
+      const std::function<
+          CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>()>&
+          send);
+
+  /**
+   * Gets the thread that delays the responses, starting it if this is the
+   * first emulated request, so that no thread runs while emulation is
+   * disabled.
+   */
+  std::shared_ptr<DelayThread> getDelayThread();
+
+  std::shared_ptr<CesiumAsync::IAssetAccessor> _pAssetAccessor;
+  FCriticalSection _delayThreadLock;
+  std::shared_ptr<DelayThread> _pDelayThread;
+};
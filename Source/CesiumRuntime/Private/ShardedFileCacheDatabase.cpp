@@ -0,0 +1,771 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "ShardedFileCacheDatabase.h"
+#include "Async/MappedFileHandle.h"
+#include "CesiumRuntime.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/UniquePtr.h"
+#include <CesiumAsync/CacheItem.h>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <unordered_map>
+
+using namespace CesiumAsync;
+
+namespace {
+
+/** Marks the start of each record, and changes whenever its layout does. */
+constexpr uint32 RecordMagic = 0x31435343; // "CSC1"
+
+/** Set in the flags of a record that removes its key from the cache. */
+constexpr uint32 RemovedFlag = 1;
+
+/**
+ * The start of each record, which is followed by the key, the metadata and
+ * the response data. Records are written in the platform's byte order, which
+ * is little-endian on every platform that Unreal supports.
+ */
+struct RecordHeader {
+  uint32 magic;
+  uint32 flags;
+  uint32 keySize;
+  uint32 metadataSize;
+  uint64 dataSize;
+  int64 expiryTime;
+};
+static_assert(sizeof(RecordHeader) == 32, "RecordHeader must not be padded");
+
+/** Shard files smaller than this are never compacted. */
+constexpr uint64 MinimumCompactionBytes = 1024 * 1024;
+
+/**
+ * Entries appended since a shard file was mapped are read without the
+ * mapping until this many bytes have been appended, when the file is mapped
+ * again.
+ */
+constexpr uint64 RemapBytes = 16 * 1024 * 1024;
+
+void writeUint32(std::vector<uint8>& out, uint32 value) {
+  const uint8* pValue = reinterpret_cast<const uint8*>(&value);
+  out.insert(out.end(), pValue, pValue + sizeof(value));
+}
+
+void writeString(std::vector<uint8>& out, const std::string& value) {
+  writeUint32(out, uint32(value.size()));
+  out.insert(out.end(), value.begin(), value.end());
+}
+
+void writeHeaders(std::vector<uint8>& out, const HttpHeaders& headers) {
+  writeUint32(out, uint32(headers.size()));
+  for (const auto& [name, value] : headers) {
+    writeString(out, name);
+    writeString(out, value);
+  }
+}
+
+class MetadataReader {
+public:
+  MetadataReader(const std::vector<uint8>& metadata)
+      : _pCurrent(metadata.data()), _pEnd(metadata.data() + metadata.size()) {}
+
+  bool readUint32(uint32& value) {
+    if (size_t(this->_pEnd - this->_pCurrent) < sizeof(value)) {
+      return false;
+    }
+    std::memcpy(&value, this->_pCurrent, sizeof(value));
+    this->_pCurrent += sizeof(value);
+    return true;
+  }
+
+  bool readString(std::string& value) {
+    uint32 size;
+    if (!this->readUint32(size) ||
+        size_t(this->_pEnd - this->_pCurrent) < size) {
+      return false;
+    }
+    value.assign(reinterpret_cast<const char*>(this->_pCurrent), size);
+    this->_pCurrent += size;
+    return true;
+  }
+
+  bool readHeaders(HttpHeaders& headers) {
+    uint32 count;
+    if (!this->readUint32(count)) {
+      return false;
+    }
+    for (uint32 i = 0; i < count; ++i) {
+      std::string name;
+      std::string value;
+      if (!this->readString(name) || !this->readString(value)) {
+        return false;
+      }
+      headers.emplace(std::move(name), std::move(value));
+    }
+    return true;
+  }
+
+private:
+  const uint8* _pCurrent;
+  const uint8* _pEnd;
+};
+
+void appendRecord(
+    std::vector<uint8>& out,
+    const std::string& key,
+    uint32 flags,
+    std::time_t expiryTime,
+    const std::vector<uint8>& metadata,
+    const gsl::span<const std::byte>& data) {
+  const RecordHeader header{
+      RecordMagic,
+      flags,
+      uint32(key.size()),
+      uint32(metadata.size()),
+      uint64(data.size()),
+      int64(expiryTime)};
+  const uint8* pHeader = reinterpret_cast<const uint8*>(&header);
+  const uint8* pData = reinterpret_cast<const uint8*>(data.data());
+
+  out.reserve(out.size() + sizeof(header) + key.size() + metadata.size() +
+              data.size());
+  out.insert(out.end(), pHeader, pHeader + sizeof(header));
+  out.insert(out.end(), key.begin(), key.end());
+  out.insert(out.end(), metadata.begin(), metadata.end());
+  out.insert(out.end(), pData, pData + data.size());
+}
+
+FString getShardFilename(int32 shard, int32 shardCount) {
+  return FString::Printf(TEXT("shard-%d-of-%d.dat"), shard, shardCount);
+}
+
+/**
+ * The suffix of the name of a shard that is moved aside while its compacted
+ * copy is moved into its place.
+ */
+const TCHAR* ReplacedSuffix = TEXT(".replaced");
+
+} // namespace
+
+class ShardedFileCacheDatabase::Shard {
+public:
+  struct EntryInfo {
+    Shard* pShard;
+    std::string key;
+    std::time_t expiryTime;
+    uint64 lastAccess;
+  };
+
+  Shard(const FString& filename, std::atomic<uint64>& clock)
+      : _filename(filename),
+        _clock(clock),
+        _lock(),
+        _index(),
+        _fileSize(0),
+        _liveBytes(0),
+        _mappingFailed(false) {
+    this->scan();
+    this->openWriter();
+  }
+
+  ~Shard() { this->close(); }
+
+  std::optional<CacheItem> get(const std::string& key) {
+    RecordHeader header;
+    std::vector<uint8> metadata;
+    std::vector<std::byte> data;
+
+    {
+      FScopeLock lock(&this->_lock);
+      auto it = this->_index.find(key);
+      if (it == this->_index.end()) {
+        return std::nullopt;
+      }
+
+      Entry& entry = it->second;
+      entry.lastAccess = ++this->_clock;
+
+      if (!this->read(entry.offset, sizeof(header), &header) ||
+          header.magic != RecordMagic) {
+        return std::nullopt;
+      }
+
+      // The response data is copied straight from the file into the vector
+      // that the cache item takes ownership of.
+      const uint64 metadataOffset =
+          entry.offset + sizeof(header) + header.keySize;
+      metadata.resize(header.metadataSize);
+      data.resize(header.dataSize);
+      if (!this->read(metadataOffset, metadata.size(), metadata.data()) ||
+          !this->read(
+              metadataOffset + metadata.size(),
+              data.size(),
+              data.data())) {
+        return std::nullopt;
+      }
+    }
+
+    MetadataReader reader(metadata);
+    std::string url;
+    std::string method;
+    HttpHeaders requestHeaders;
+    uint32 statusCode;
+    HttpHeaders responseHeaders;
+    if (!reader.readString(url) || !reader.readString(method) ||
+        !reader.readHeaders(requestHeaders) || !reader.readUint32(statusCode) ||
+        !reader.readHeaders(responseHeaders)) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("Ignoring a corrupt entry in %s"),
+          *this->_filename);
+      return std::nullopt;
+    }
+
+    return CacheItem(
+        std::time_t(header.expiryTime),
+        CacheRequest(
+            std::move(requestHeaders),
+            std::move(method),
+            std::move(url)),
+        CacheResponse(
+            uint16_t(statusCode),
+            std::move(responseHeaders),
+            std::move(data)));
+  }
+
+  bool store(
+      const std::string& key,
+      const std::vector<uint8>& record,
+      std::time_t expiryTime) {
+    FScopeLock lock(&this->_lock);
+    const uint64 offset = this->_fileSize;
+    if (!this->append(record)) {
+      return false;
+    }
+
+    Entry& entry = this->_index[key];
+    this->_liveBytes -= entry.size;
+    entry = Entry{offset, uint64(record.size()), expiryTime, ++this->_clock};
+    this->_liveBytes += entry.size;
+    return true;
+  }
+
+  /**
+   * Removes the given entries, unless they have been accessed since they
+   * were chosen for removal.
+   */
+  void remove(const std::vector<std::pair<std::string, uint64>>& entries) {
+    FScopeLock lock(&this->_lock);
+    std::vector<uint8> tombstones;
+    for (const auto& [key, lastAccess] : entries) {
+      auto it = this->_index.find(key);
+      if (it == this->_index.end() || it->second.lastAccess != lastAccess) {
+        continue;
+      }
+
+      this->_liveBytes -= it->second.size;
+      this->_index.erase(it);
+      appendRecord(
+          tombstones,
+          key,
+          RemovedFlag,
+          0,
+          std::vector<uint8>(),
+          gsl::span<const std::byte>());
+    }
+
+    // If the tombstones cannot be written, the entries come back when the
+    // cache is next opened, and are pruned again.
+    this->append(tombstones);
+  }
+
+  /**
+   * Gets the number of bytes that compacting the file would free, or 0 if it
+   * is not worth compacting because less than half of it is dead or it is
+   * small.
+   */
+  uint64 getCompactableBytes() const {
+    FScopeLock lock(&this->_lock);
+    return this->isWasteful() ? this->_fileSize - this->_liveBytes : 0;
+  }
+
+  /** Rewrites the file without its dead space, if it is worth it. */
+  void compactIfWasteful() {
+    FScopeLock lock(&this->_lock);
+    if (this->isWasteful()) {
+      this->compact();
+    }
+  }
+
+  void clear() {
+    FScopeLock lock(&this->_lock);
+    this->close();
+    FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*this->_filename);
+    this->_index.clear();
+    this->_fileSize = 0;
+    this->_liveBytes = 0;
+    this->openWriter();
+  }
+
+  void collect(std::vector<EntryInfo>& entries) {
+    FScopeLock lock(&this->_lock);
+    for (const auto& [key, entry] : this->_index) {
+      entries.push_back(
+          EntryInfo{this, key, entry.expiryTime, entry.lastAccess});
+    }
+  }
+
+  int64 getEntryCount() const {
+    FScopeLock lock(&this->_lock);
+    return int64(this->_index.size());
+  }
+
+  int64 getFileBytes() const {
+    FScopeLock lock(&this->_lock);
+    return int64(this->_fileSize);
+  }
+
+private:
+  struct Entry {
+    uint64 offset = 0;
+    uint64 size = 0;
+    std::time_t expiryTime = 0;
+    uint64 lastAccess = 0;
+  };
+
+  bool isWasteful() const {
+    return this->_fileSize >= MinimumCompactionBytes &&
+           this->_liveBytes * 2 <= this->_fileSize;
+  }
+
+  /**
+   * Rebuilds the index from the file, and sets the file size to the end of
+   * its last complete record.
+   */
+  void scan() {
+    TUniquePtr<IFileHandle> pReader(
+        FPlatformFileManager::Get().GetPlatformFile().OpenRead(
+            *this->_filename,
+            true));
+    if (!pReader) {
+      return;
+    }
+
+    const uint64 size = uint64(pReader->Size());
+    std::string key;
+    while (this->_fileSize + sizeof(RecordHeader) <= size) {
+      RecordHeader header;
+      if (!pReader->Seek(int64(this->_fileSize)) ||
+          !pReader->Read(reinterpret_cast<uint8*>(&header), sizeof(header)) ||
+          header.magic != RecordMagic) {
+        break;
+      }
+
+      const uint64 recordSize = sizeof(header) + uint64(header.keySize) +
+                                uint64(header.metadataSize) + header.dataSize;
+      if (recordSize > size - this->_fileSize) {
+        break;
+      }
+
+      key.resize(header.keySize);
+      if (!pReader->Read(reinterpret_cast<uint8*>(key.data()), key.size())) {
+        break;
+      }
+
+      if (header.flags & RemovedFlag) {
+        auto it = this->_index.find(key);
+        if (it != this->_index.end()) {
+          this->_liveBytes -= it->second.size;
+          this->_index.erase(it);
+        }
+      } else {
+        Entry& entry = this->_index[key];
+        this->_liveBytes -= entry.size;
+        entry = Entry{
+            this->_fileSize,
+            recordSize,
+            std::time_t(header.expiryTime),
+            ++this->_clock};
+        this->_liveBytes += recordSize;
+      }
+
+      this->_fileSize += recordSize;
+    }
+
+    if (this->_fileSize < size) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("Discarding %llu bytes of incomplete cache entries from %s"),
+          size - this->_fileSize,
+          *this->_filename);
+    }
+  }
+
+  /**
+   * Opens the file for appending, removing anything after the last complete
+   * record.
+   */
+  void openWriter() {
+    IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+    this->_pWriter.Reset(platformFile.OpenWrite(*this->_filename, true, true));
+    if (!this->_pWriter) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("Could not open %s, so responses cannot be cached in it."),
+          *this->_filename);
+      return;
+    }
+
+    if (uint64(this->_pWriter->Size()) > this->_fileSize) {
+      this->_pWriter->Truncate(int64(this->_fileSize));
+    }
+    this->_pWriter->SeekFromEnd(0);
+  }
+
+  void close() {
+    // A region must be unmapped before its file is closed.
+    this->_pMappedRegion.Reset();
+    this->_pMappedFile.Reset();
+    this->_pReader.Reset();
+    this->_pWriter.Reset();
+  }
+
+  bool append(const std::vector<uint8>& bytes) {
+    if (bytes.empty()) {
+      return true;
+    }
+
+    if (!this->_pWriter ||
+        !this->_pWriter->Write(bytes.data(), int64(bytes.size()))) {
+      // Remove any partly written record, which would otherwise hide every
+      // record after it from the next scan.
+      if (this->_pWriter) {
+        this->_pWriter->Truncate(int64(this->_fileSize));
+        this->_pWriter->SeekFromEnd(0);
+      }
+      return false;
+    }
+
+    this->_fileSize += bytes.size();
+    return true;
+  }
+
+  /** Reads from the file, through the mapped view where possible. */
+  bool read(uint64 offset, uint64 size, void* pDestination) {
+    if (size == 0) {
+      return true;
+    }
+    if (offset + size > this->_fileSize) {
+      return false;
+    }
+
+    const uint64 mappedSize =
+        this->_pMappedRegion ? uint64(this->_pMappedRegion->GetMappedSize())
+                             : 0;
+    if (offset + size > mappedSize &&
+        (!this->_pMappedRegion ||
+         this->_fileSize - mappedSize >= RemapBytes)) {
+      this->remap();
+    }
+
+    if (this->_pMappedRegion &&
+        offset + size <= uint64(this->_pMappedRegion->GetMappedSize())) {
+      std::memcpy(
+          pDestination,
+          this->_pMappedRegion->GetMappedPtr() + offset,
+          size);
+      return true;
+    }
+
+    if (!this->_pReader) {
+      IPlatformFile& platformFile =
+          FPlatformFileManager::Get().GetPlatformFile();
+      this->_pReader.Reset(platformFile.OpenRead(*this->_filename, true));
+    }
+
+    return this->_pReader && this->_pReader->Seek(int64(offset)) &&
+           this->_pReader->Read(static_cast<uint8*>(pDestination), int64(size));
+  }
+
+  /**
+   * Maps the file as it is now. Each mapping covers only the records that
+   * existed when it was made.
+   */
+  void remap() {
+    this->_pMappedRegion.Reset();
+    this->_pMappedFile.Reset();
+    if (this->_mappingFailed || this->_fileSize == 0) {
+      return;
+    }
+
+    // Some platforms cannot map a file that is open for writing, in which
+    // case every read goes through the read handle.
+    this->_pMappedFile.Reset(
+        FPlatformFileManager::Get().GetPlatformFile().OpenMapped(
+            *this->_filename));
+    if (this->_pMappedFile) {
+      this->_pMappedRegion.Reset(
+          this->_pMappedFile->MapRegion(0, int64(this->_fileSize)));
+    }
+
+    if (!this->_pMappedRegion) {
+      this->_pMappedFile.Reset();
+      this->_mappingFailed = true;
+    }
+  }
+
+  void compact() {
+    IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const FString compactFilename = this->_filename + TEXT(".compact");
+
+    std::vector<std::pair<Entry*, uint64>> newOffsets;
+    newOffsets.reserve(this->_index.size());
+    uint64 newSize = 0;
+
+    {
+      TUniquePtr<IFileHandle> pOut(platformFile.OpenWrite(*compactFilename));
+      if (!pOut) {
+        return;
+      }
+
+      std::vector<uint8> record;
+      for (auto& [key, entry] : this->_index) {
+        record.resize(entry.size);
+        if (!this->read(entry.offset, entry.size, record.data()) ||
+            !pOut->Write(record.data(), int64(record.size()))) {
+          pOut.Reset();
+          platformFile.DeleteFile(*compactFilename);
+          return;
+        }
+        newOffsets.emplace_back(&entry, newSize);
+        newSize += entry.size;
+      }
+    }
+
+    this->close();
+
+    // The original is only deleted once the compacted copy is in its place,
+    // so that it is kept if the copy cannot be moved.
+    const FString replacedFilename = this->_filename + ReplacedSuffix;
+    platformFile.DeleteFile(*replacedFilename);
+    const bool movedAside =
+        platformFile.MoveFile(*replacedFilename, *this->_filename);
+    const bool replaced =
+        movedAside && platformFile.MoveFile(*this->_filename, *compactFilename);
+    if (movedAside && !replaced) {
+      platformFile.MoveFile(*this->_filename, *replacedFilename);
+    }
+
+    if (!replaced) {
+      UE_LOG(
+          LogCesium,
+          Warning,
+          TEXT("Could not replace %s with its compacted copy."),
+          *this->_filename);
+      platformFile.DeleteFile(*compactFilename);
+
+      // Start again from the original, unless it could not be moved back.
+      this->_index.clear();
+      this->_fileSize = 0;
+      this->_liveBytes = 0;
+      this->scan();
+      this->openWriter();
+      return;
+    }
+
+    platformFile.DeleteFile(*replacedFilename);
+
+    for (const auto& [pEntry, offset] : newOffsets) {
+      pEntry->offset = offset;
+    }
+    this->_fileSize = newSize;
+    this->_liveBytes = newSize;
+    this->_mappingFailed = false;
+    this->openWriter();
+  }
+
+  FString _filename;
+  std::atomic<uint64>& _clock;
+
+  mutable FCriticalSection _lock;
+  std::unordered_map<std::string, Entry> _index;
+  uint64 _fileSize;
+  uint64 _liveBytes;
+
+  TUniquePtr<IFileHandle> _pWriter;
+  TUniquePtr<IFileHandle> _pReader;
+  TUniquePtr<IMappedFileHandle> _pMappedFile;
+  TUniquePtr<IMappedFileRegion> _pMappedRegion;
+  bool _mappingFailed;
+};
+
+ShardedFileCacheDatabase::ShardedFileCacheDatabase(
+    const FString& directory,
+    uint64 maxItems,
+    int32 shardCount)
+    : _directory(directory), _maxItems(maxItems), _shards(), _clock(0) {
+  shardCount = FMath::Max(shardCount, 1);
+
+  IFileManager& fileManager = IFileManager::Get();
+  fileManager.MakeDirectory(*directory, true);
+
+  // Restore any shard that was moved aside by a compaction that did not
+  // finish.
+  for (int32 i = 0; i < shardCount; ++i) {
+    const FString filename =
+        FPaths::Combine(directory, getShardFilename(i, shardCount));
+    const FString replacedFilename = filename + ReplacedSuffix;
+    if (!fileManager.FileExists(*filename) &&
+        fileManager.FileExists(*replacedFilename)) {
+      fileManager.Move(*filename, *replacedFilename);
+    }
+  }
+
+  // Remove the shards of a cache with a different number of shards, whose
+  // entries would be looked for in the wrong shard, and any compacted copy
+  // that was not moved into place or original that was not deleted.
+  TArray<FString> existing;
+  fileManager.FindFiles(
+      existing,
+      *FPaths::Combine(directory, TEXT("shard-*")),
+      true,
+      false);
+  for (const FString& filename : existing) {
+    bool isShard = false;
+    for (int32 i = 0; i < shardCount && !isShard; ++i) {
+      isShard = filename == getShardFilename(i, shardCount);
+    }
+    if (!isShard) {
+      fileManager.Delete(*FPaths::Combine(directory, filename));
+    }
+  }
+
+  this->_shards.reserve(size_t(shardCount));
+  for (int32 i = 0; i < shardCount; ++i) {
+    this->_shards.emplace_back(std::make_unique<Shard>(
+        FPaths::Combine(directory, getShardFilename(i, shardCount)),
+        this->_clock));
+  }
+}
+
+ShardedFileCacheDatabase::~ShardedFileCacheDatabase() = default;
+
+std::optional<CacheItem>
+ShardedFileCacheDatabase::getEntry(const std::string& key) const {
+  return this->getShard(key).get(key);
+}
+
+bool ShardedFileCacheDatabase::storeEntry(
+    const std::string& key,
+    std::time_t expiryTime,
+    const std::string& url,
+    const std::string& requestMethod,
+    const HttpHeaders& requestHeaders,
+    uint16_t statusCode,
+    const HttpHeaders& responseHeaders,
+    const gsl::span<const std::byte>& responseData) {
+  std::vector<uint8> metadata;
+  writeString(metadata, url);
+  writeString(metadata, requestMethod);
+  writeHeaders(metadata, requestHeaders);
+  writeUint32(metadata, statusCode);
+  writeHeaders(metadata, responseHeaders);
+
+  std::vector<uint8> record;
+  appendRecord(record, key, 0, expiryTime, metadata, responseData);
+  return this->getShard(key).store(key, record, expiryTime);
+}
+
+bool ShardedFileCacheDatabase::prune() {
+  std::vector<Shard::EntryInfo> entries;
+  for (const std::unique_ptr<Shard>& pShard : this->_shards) {
+    pShard->collect(entries);
+  }
+
+  // Move the entries to remove to the front: first those that have expired,
+  // then the least recently used of the rest, beyond the maximum.
+  const std::time_t now = std::time(nullptr);
+  auto keep = std::partition(
+      entries.begin(),
+      entries.end(),
+      [now](const Shard::EntryInfo& entry) { return entry.expiryTime < now; });
+
+  const uint64 remaining = uint64(entries.end() - keep);
+  if (remaining > this->_maxItems) {
+    const int64 excess = int64(remaining - this->_maxItems);
+    std::nth_element(
+        keep,
+        keep + excess,
+        entries.end(),
+        [](const Shard::EntryInfo& a, const Shard::EntryInfo& b) {
+          return a.lastAccess < b.lastAccess;
+        });
+    keep += excess;
+  }
+
+  std::unordered_map<Shard*, std::vector<std::pair<std::string, uint64>>>
+      removals;
+  for (auto it = entries.begin(); it != keep; ++it) {
+    removals[it->pShard].emplace_back(std::move(it->key), it->lastAccess);
+  }
+
+  for (auto& [pShard, shardRemovals] : removals) {
+    pShard->remove(shardRemovals);
+  }
+
+  // Compact at most one shard, the most wasteful, so that no prune takes
+  // long. Later prunes compact the rest.
+  Shard* pMostWasteful = nullptr;
+  uint64 mostCompactableBytes = 0;
+  for (const std::unique_ptr<Shard>& pShard : this->_shards) {
+    const uint64 compactableBytes = pShard->getCompactableBytes();
+    if (compactableBytes > mostCompactableBytes) {
+      pMostWasteful = pShard.get();
+      mostCompactableBytes = compactableBytes;
+    }
+  }
+  if (pMostWasteful) {
+    pMostWasteful->compactIfWasteful();
+  }
+
+  return true;
+}
+
+bool ShardedFileCacheDatabase::clearAll() {
+  for (const std::unique_ptr<Shard>& pShard : this->_shards) {
+    pShard->clear();
+  }
+  return true;
+}
+
+int64 ShardedFileCacheDatabase::getEntryCount() const {
+  int64 count = 0;
+  for (const std::unique_ptr<Shard>& pShard : this->_shards) {
+    count += pShard->getEntryCount();
+  }
+  return count;
+}
+
+int64 ShardedFileCacheDatabase::getFileBytes() const {
+  int64 bytes = 0;
+  for (const std::unique_ptr<Shard>& pShard : this->_shards) {
+    bytes += pShard->getFileBytes();
+  }
+  return bytes;
+}
+
+ShardedFileCacheDatabase::Shard&
+ShardedFileCacheDatabase::getShard(const std::string& key) const {
+  // The hash must not change between runs, or entries would be looked for in
+  // the wrong shard, so std::hash will not do.
+  const uint32 hash = FCrc::MemCrc32(key.data(), int32(key.size()));
+  return *this->_shards[hash % this->_shards.size()];
+}
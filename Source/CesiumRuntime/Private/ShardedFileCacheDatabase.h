@@ -0,0 +1,88 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/UnrealString.h"
+#include "HAL/Platform.h"
+#include <CesiumAsync/ICacheDatabase.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * A request cache that stores its entries in append-only files rather than
+ * in a SQLite database, for higher throughput with many entries and many
+ * threads.
+ *
+ * Entries are spread across shards by a hash of their key. Each shard has its
+ * own file, lock, and in-memory index of the entries in the file, so requests
+ * for entries in different shards never wait for each other. An entry is
+ * stored by appending it to its shard's file, and read from a memory-mapped
+ * view of the file, or with an ordinary read where the file cannot be mapped
+ * while it is open for writing.
+ *
+ * Replaced entries, and removed entries along with the tombstones that record
+ * their removal, stay in the files until pruning compacts the shards whose
+ * files are mostly dead space, one shard per prune. The index is rebuilt by
+ * scanning the files when the cache is opened, and a partly written entry at
+ * the end of a file, such as one left by a crash, is discarded.
+ */
+class ShardedFileCacheDatabase : public CesiumAsync::ICacheDatabase {
+public:
+  /**
+   * Opens the cache in the given directory, creating it if necessary.
+   *
+   * @param directory The directory in which to store the shard files.
+   * @param maxItems The number of entries that are kept when the cache is
+   * pruned.
+   * @param shardCount The number of shards. The entries of a cache that was
+   * created with a different number of shards are discarded.
+   */
+  ShardedFileCacheDatabase(
+      const FString& directory,
+      uint64 maxItems,
+      int32 shardCount = 16);
+  virtual ~ShardedFileCacheDatabase() override;
+
+  virtual std::optional<CesiumAsync::CacheItem>
+  getEntry(const std::string& key) const override;
+
+  virtual bool storeEntry(
+      const std::string& key,
+      std::time_t expiryTime,
+      const std::string& url,
+      const std::string& requestMethod,
+      const CesiumAsync::HttpHeaders& requestHeaders,
+      uint16_t statusCode,
+      const CesiumAsync::HttpHeaders& responseHeaders,
+      const gsl::span<const std::byte>& responseData) override;
+
+  /**
+   * Removes the entries that have expired, and then the least recently used
+   * entries beyond the maximum number of items, and compacts the shard whose
+   * file has the most dead space, if it is mostly dead space.
+   */
+  virtual bool prune() override;
+
+  virtual bool clearAll() override;
+
+  /** Gets the number of entries in the cache. */
+  int64 getEntryCount() const;
+
+  /** Gets the total size of the shard files, including dead space. */
+  int64 getFileBytes() const;
+
+private:
+  class Shard;
+
+  Shard& getShard(const std::string& key) const;
+
+  FString _directory;
+  uint64 _maxItems;
+  std::vector<std::unique_ptr<Shard>> _shards;
+
+  // Orders accesses to entries across all shards, for pruning the least
+  // recently used.
+  mutable std::atomic<uint64> _clock;
+};
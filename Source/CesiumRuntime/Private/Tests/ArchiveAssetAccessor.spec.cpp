@@ -0,0 +1,273 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "ArchiveAssetAccessor.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Compression.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UnrealAssetAccessor.h"
+
+namespace {
+
+void writeUint16(TArray<uint8>& out, uint32 value) {
+  out.Add(uint8(value));
+  out.Add(uint8(value >> 8));
+}
+
+void writeUint32(TArray<uint8>& out, uint32 value) {
+  writeUint16(out, value & 0xFFFF);
+  writeUint16(out, value >> 16);
+}
+
+/**
+ * Builds a zip file containing the given entries, deflating those whose
+ * names end with ".deflated".
+ */
+TArray<uint8> buildZip(const TArray<TPair<FString, std::string>>& entries) {
+  TArray<uint8> zip;
+  TArray<uint8> directory;
+
+  for (const TPair<FString, std::string>& entry : entries) {
+    FTCHARToUTF8 name(*entry.Key);
+    const std::string& text = entry.Value;
+
+    TArray<uint8> data(
+        reinterpret_cast<const uint8*>(text.data()),
+        int32(text.size()));
+    uint16 method = 0;
+    if (entry.Key.EndsWith(TEXT(".deflated"))) {
+      int32 compressedSize =
+          FCompression::CompressMemoryBound(NAME_Zlib, data.Num());
+      TArray<uint8> compressed;
+      compressed.SetNumUninitialized(compressedSize);
+      FCompression::CompressMemory(
+          NAME_Zlib,
+          compressed.GetData(),
+          compressedSize,
+          data.GetData(),
+          data.Num(),
+          COMPRESS_NoFlags,
+          -15);
+      compressed.SetNum(compressedSize);
+      data = MoveTemp(compressed);
+      method = 8;
+    }
+
+    const uint32 crc = FCrc::MemCrc32(text.data(), int32(text.size()));
+    const uint32 localHeaderOffset = uint32(zip.Num());
+
+    writeUint32(zip, 0x04034b50);
+    writeUint16(zip, 20);
+    writeUint16(zip, 0);
+    writeUint16(zip, method);
+    writeUint32(zip, 0);
+    writeUint32(zip, crc);
+    writeUint32(zip, uint32(data.Num()));
+    writeUint32(zip, uint32(text.size()));
+    writeUint16(zip, uint32(name.Length()));
+    writeUint16(zip, 0);
+    zip.Append(reinterpret_cast<const uint8*>(name.Get()), name.Length());
+    zip.Append(data);
+
+    writeUint32(directory, 0x02014b50);
+    writeUint16(directory, 20);
+    writeUint16(directory, 20);
+    writeUint16(directory, 0);
+    writeUint16(directory, method);
+    writeUint32(directory, 0);
+    writeUint32(directory, crc);
+    writeUint32(directory, uint32(data.Num()));
+    writeUint32(directory, uint32(text.size()));
+    writeUint16(directory, uint32(name.Length()));
+    writeUint16(directory, 0);
+    writeUint16(directory, 0);
+    writeUint16(directory, 0);
+    writeUint16(directory, 0);
+    writeUint32(directory, 0);
+    writeUint32(directory, localHeaderOffset);
+    directory.Append(reinterpret_cast<const uint8*>(name.Get()), name.Length());
+  }
+
+  const uint32 directoryOffset = uint32(zip.Num());
+  zip.Append(directory);
+
+  writeUint32(zip, 0x06054b50);
+  writeUint16(zip, 0);
+  writeUint16(zip, 0);
+  writeUint16(zip, uint32(entries.Num()));
+  writeUint16(zip, uint32(entries.Num()));
+  writeUint32(zip, uint32(directory.Num()));
+  writeUint32(zip, directoryOffset);
+  writeUint16(zip, 0);
+
+  return zip;
+}
+
+FString toFileUri(const FString& filename) {
+  FString uri = TEXT("file:///") + filename;
+  uri.ReplaceCharInline('\\', '/');
+  uri.ReplaceInline(TEXT(" "), TEXT("%20"));
+  return uri;
+}
+
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+    FArchiveAssetAccessorSpec,
+    "Cesium.Unit.ArchiveAssetAccessor",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+FString Directory;
+FString ArchiveUri;
+std::string StoredText = "Some stored text.";
+std::string DeflatedText;
+
+/**
+ * Requests the given URL through a new archive accessor, and returns the
+ * status code and data of the response.
+ */
+std::pair<uint16_t, std::string> Request(const FString& uri) {
+  ArchiveAssetAccessor accessor(std::make_shared<UnrealAssetAccessor>());
+  return Request(accessor, uri);
+}
+
+/**
+ * Requests the given URL through the given archive accessor, and returns the
+ * status code and data of the response.
+ */
+std::pair<uint16_t, std::string>
+Request(ArchiveAssetAccessor& accessor, const FString& uri) {
+  bool done = false;
+  uint16_t statusCode = 0;
+  std::string data;
+
+  accessor.get(getAsyncSystem(), TCHAR_TO_UTF8(*uri), {})
+      .thenInMainThread(
+          [&](std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest) {
+            const CesiumAsync::IAssetResponse* pResponse =
+                pRequest->response();
+            if (TestNotNull("response", pResponse)) {
+              statusCode = pResponse->statusCode();
+              data.assign(
+                  reinterpret_cast<const char*>(pResponse->data().data()),
+                  pResponse->data().size());
+            }
+            done = true;
+          });
+
+  while (!done) {
+    accessor.tick();
+    getAsyncSystem().dispatchMainThreadTasks();
+  }
+
+  return {statusCode, data};
+}
+
+END_DEFINE_SPEC(FArchiveAssetAccessorSpec)
+
+void FArchiveAssetAccessorSpec::Define() {
+  BeforeEach([this]() {
+    Directory = FPaths::ConvertRelativePathToFull(
+        FPaths::CreateTempFilename(*FPaths::ProjectSavedDir()));
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    DeflatedText.clear();
+    for (int32 i = 0; i < 1000; ++i) {
+      DeflatedText += "Some text that deflates well. ";
+    }
+
+    TArray<TPair<FString, std::string>> entries;
+    entries.Emplace(TEXT("tileset.json"), StoredText);
+    entries.Emplace(TEXT("content/"), std::string());
+    entries.Emplace(TEXT("content/tile.deflated"), DeflatedText);
+    entries.Emplace(TEXT("content/with space.txt"), StoredText);
+
+    FString archiveFilename = Directory / TEXT("test archive.3tz");
+    FFileHelper::SaveArrayToFile(buildZip(entries), *archiveFilename);
+    ArchiveUri = toFileUri(archiveFilename);
+  });
+
+  AfterEach([this]() {
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+  });
+
+  It("serves stored entries", [this]() {
+    std::pair<uint16_t, std::string> result =
+        Request(ArchiveUri + TEXT("/tileset.json"));
+    TestEqual("status", result.first, uint16_t(200));
+    TestEqual("data", result.second, StoredText);
+  });
+
+  It("serves deflated entries", [this]() {
+    std::pair<uint16_t, std::string> result =
+        Request(ArchiveUri + TEXT("/content/tile.deflated"));
+    TestEqual("status", result.first, uint16_t(200));
+    TestEqual("data", result.second, DeflatedText);
+  });
+
+  It("decodes entry names and ignores query parameters", [this]() {
+    std::pair<uint16_t, std::string> result =
+        Request(ArchiveUri + TEXT("/content/with%20space.txt?v=1"));
+    TestEqual("status", result.first, uint16_t(200));
+    TestEqual("data", result.second, StoredText);
+  });
+
+  It("returns 404 for missing entries", [this]() {
+    TestEqual(
+        "missing entry",
+        Request(ArchiveUri + TEXT("/content/missing.glb")).first,
+        uint16_t(404));
+    TestEqual(
+        "directory",
+        Request(ArchiveUri + TEXT("/content/")).first,
+        uint16_t(404));
+  });
+
+  It("returns 404 for missing archives", [this]() {
+    FString uri = toFileUri(Directory / TEXT("missing.3tz/tileset.json"));
+    TestEqual("status", Request(uri).first, uint16_t(404));
+  });
+
+  It("opens an archive again when it changes", [this]() {
+    ArchiveAssetAccessor accessor(std::make_shared<UnrealAssetAccessor>());
+    TestEqual(
+        "before",
+        Request(accessor, ArchiveUri + TEXT("/tileset.json")).second,
+        StoredText);
+
+    const std::string changedText = "Some changed text.";
+    TArray<TPair<FString, std::string>> entries;
+    entries.Emplace(TEXT("tileset.json"), changedText);
+    const FString changedFilename = Directory / TEXT("changed.3tz");
+    FFileHelper::SaveArrayToFile(buildZip(entries), *changedFilename);
+    if (!IFileManager::Get().Move(
+            *(Directory / TEXT("test archive.3tz")),
+            *changedFilename)) {
+      // Some platforms do not allow a mapped file to be replaced.
+      return;
+    }
+
+    TestEqual(
+        "after",
+        Request(accessor, ArchiveUri + TEXT("/tileset.json")).second,
+        changedText);
+  });
+
+  It("passes other requests to the underlying accessor", [this]() {
+    FString filename = Directory / TEXT("plain.txt");
+    FFileHelper::SaveStringToFile(
+        UTF8_TO_TCHAR(StoredText.c_str()),
+        *filename,
+        FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+
+    std::pair<uint16_t, std::string> result = Request(toFileUri(filename));
+    TestEqual("status", result.first, uint16_t(200));
+    TestEqual("data", result.second, StoredText);
+  });
+}
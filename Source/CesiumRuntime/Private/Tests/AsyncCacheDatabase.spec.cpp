@@ -0,0 +1,196 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "AsyncCacheDatabase.h"
+#include "CesiumAsync/CacheItem.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+#include <map>
+
+namespace {
+
+/** Keeps entries in memory, and records which thread wrote them. */
+class MemoryCacheDatabase : public CesiumAsync::ICacheDatabase {
+public:
+  virtual std::optional<CesiumAsync::CacheItem>
+  getEntry(const std::string& key) const override {
+    FScopeLock lock(&this->_lock);
+    auto it = this->_entries.find(key);
+    if (it == this->_entries.end()) {
+      return std::nullopt;
+    }
+    return CesiumAsync::CacheItem(
+        0,
+        CesiumAsync::CacheRequest({}, "GET", std::string(key)),
+        CesiumAsync::CacheResponse(
+            200,
+            {},
+            std::vector<std::byte>(it->second)));
+  }
+
+  virtual bool storeEntry(
+      const std::string& key,
+      std::time_t expiryTime,
+      const std::string& url,
+      const std::string& requestMethod,
+      const CesiumAsync::HttpHeaders& requestHeaders,
+      uint16_t statusCode,
+      const CesiumAsync::HttpHeaders& responseHeaders,
+      const gsl::span<const std::byte>& responseData) override {
+    FScopeLock lock(&this->_lock);
+    this->_entries[key] =
+        std::vector<std::byte>(responseData.begin(), responseData.end());
+    this->writerThreadId = FPlatformTLS::GetCurrentThreadId();
+    return true;
+  }
+
+  virtual bool prune() override {
+    ++this->prunes;
+    return true;
+  }
+
+  virtual bool clearAll() override {
+    FScopeLock lock(&this->_lock);
+    this->_entries.clear();
+    return true;
+  }
+
+  int32 count() const {
+    FScopeLock lock(&this->_lock);
+    return int32(this->_entries.size());
+  }
+
+  std::atomic<int32> prunes = 0;
+  std::atomic<uint32> writerThreadId = 0;
+
+private:
+  mutable FCriticalSection _lock;
+  std::map<std::string, std::vector<std::byte>> _entries;
+};
+
+bool store(
+    CesiumAsync::ICacheDatabase& database,
+    const std::string& key,
+    size_t bytes) {
+  const std::vector<std::byte> data(bytes, std::byte(1));
+  return database.storeEntry(
+      key,
+      0,
+      key,
+      "GET",
+      {},
+      200,
+      {},
+      gsl::span<const std::byte>(data));
+}
+
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+    FAsyncCacheDatabaseSpec,
+    "Cesium.Unit.AsyncCacheDatabase",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+std::shared_ptr<MemoryCacheDatabase> pInner;
+std::shared_ptr<std::atomic<bool>> pOpenable;
+
+/**
+ * Creates a cache that opens the in-memory cache once pOpenable is set.
+ */
+std::unique_ptr<AsyncCacheDatabase> Create(int64 maximumQueuedBytes) {
+  return std::make_unique<AsyncCacheDatabase>(
+      [pInner = this->pInner, pOpenable = this->pOpenable]() {
+        while (!*pOpenable) {
+          FPlatformProcess::Sleep(0.001f);
+        }
+        return pInner;
+      },
+      maximumQueuedBytes);
+}
+
+END_DEFINE_SPEC(FAsyncCacheDatabaseSpec)
+
+void FAsyncCacheDatabaseSpec::Define() {
+  BeforeEach([this]() {
+    pInner = std::make_shared<MemoryCacheDatabase>();
+    pOpenable = std::make_shared<std::atomic<bool>>(false);
+  });
+
+  AfterEach([this]() { *pOpenable = true; });
+
+  It("finds queued entries before the cache is open", [this]() {
+    std::unique_ptr<AsyncCacheDatabase> pDatabase = Create(1024);
+    TestFalse("missing", pDatabase->getEntry("a").has_value());
+    TestTrue("stored", store(*pDatabase, "a", 10));
+
+    std::optional<CesiumAsync::CacheItem> item = pDatabase->getEntry("a");
+    if (TestTrue("queued", item.has_value())) {
+      TestEqual("size", int32(item->cacheResponse.data.size()), 10);
+    }
+    TestEqual("written", pInner->count(), 0);
+
+    *pOpenable = true;
+    pDatabase->flush();
+    TestEqual("written", pInner->count(), 1);
+    TestTrue("found", pDatabase->getEntry("a").has_value());
+    TestNotEqual(
+        "writer thread",
+        uint32(pInner->writerThreadId),
+        FPlatformTLS::GetCurrentThreadId());
+  });
+
+  It("drops entries while the queue is full", [this]() {
+    std::unique_ptr<AsyncCacheDatabase> pDatabase = Create(16);
+    TestTrue("first", store(*pDatabase, "a", 10));
+    TestFalse("over the limit", store(*pDatabase, "b", 10));
+
+    *pOpenable = true;
+    pDatabase->flush();
+    TestTrue("stored after writing", store(*pDatabase, "c", 10));
+    pDatabase->flush();
+    TestEqual("written", pInner->count(), 2);
+    TestFalse("dropped", pDatabase->getEntry("b").has_value());
+  });
+
+  It("prunes on the writer thread", [this]() {
+    *pOpenable = true;
+    std::unique_ptr<AsyncCacheDatabase> pDatabase = Create(1024);
+    TestTrue("pruned", pDatabase->prune());
+
+    const double timeout = FPlatformTime::Seconds() + 5.0;
+    while (pInner->prunes == 0 && FPlatformTime::Seconds() < timeout) {
+      FPlatformProcess::Sleep(0.001f);
+    }
+    TestEqual("prunes", int32(pInner->prunes), 1);
+  });
+
+  It("clears queued and written entries", [this]() {
+    *pOpenable = true;
+    std::unique_ptr<AsyncCacheDatabase> pDatabase = Create(1024);
+    store(*pDatabase, "a", 10);
+    pDatabase->flush();
+    store(*pDatabase, "b", 10);
+
+    TestTrue("cleared", pDatabase->clearAll());
+    pDatabase->flush();
+    TestFalse("written", pDatabase->getEntry("a").has_value());
+    TestFalse("queued", pDatabase->getEntry("b").has_value());
+    TestEqual("count", pInner->count(), 0);
+  });
+
+  It("writes queued entries when it shuts down", [this]() {
+    *pOpenable = true;
+    std::unique_ptr<AsyncCacheDatabase> pDatabase = Create(1024);
+    store(*pDatabase, "a", 10);
+    pDatabase->shutdown();
+    TestEqual("written", pInner->count(), 1);
+
+    TestTrue("stored after shutting down", store(*pDatabase, "b", 10));
+    TestEqual("written directly", pInner->count(), 2);
+  });
+}
@@ -0,0 +1,377 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumAsync/CachingAssetAccessor.h"
+#include "CesiumAsync/GunzipAssetAccessor.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumAsync/SqliteCache.h"
+#include "CesiumRuntime.h"
+#include "CesiumStreamingBenchmark.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+namespace {
+
+class OriginResponse : public CesiumAsync::IAssetResponse {
+public:
+  explicit OriginResponse(
+      const std::shared_ptr<const std::vector<std::byte>>& pPayload)
+      : _pPayload(pPayload),
+        _headers{
+            {"Cache-Control", "max-age=86400"},
+            {"Content-Type", "application/octet-stream"}} {}
+
+  virtual uint16_t statusCode() const override { return 200; }
+  virtual std::string contentType() const override {
+    return "application/octet-stream";
+  }
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+  virtual gsl::span<const std::byte> data() const override {
+    return gsl::span<const std::byte>(*this->_pPayload);
+  }
+
+private:
+  std::shared_ptr<const std::vector<std::byte>> _pPayload;
+  CesiumAsync::HttpHeaders _headers;
+};
+
+class OriginRequest : public CesiumAsync::IAssetRequest {
+public:
+  OriginRequest(
+      const std::string& url,
+      const std::shared_ptr<const std::vector<std::byte>>& pPayload)
+      : _url(url), _response(pPayload) {}
+
+  virtual const std::string& method() const override { return this->_method; }
+  virtual const std::string& url() const override { return this->_url; }
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+  virtual const CesiumAsync::IAssetResponse* response() const override {
+    return &this->_response;
+  }
+
+private:
+  std::string _method = "GET";
+  std::string _url;
+  CesiumAsync::HttpHeaders _headers;
+  OriginResponse _response;
+};
+
+/**
+ * Stands in for a server of gzipped tiles, answering every request with the
+ * same cacheable, gzipped payload.
+ */
+class GzippedOriginAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  explicit GzippedOriginAssetAccessor(
+      const std::shared_ptr<const std::vector<std::byte>>& pPayload)
+      : _pPayload(pPayload) {}
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    return asyncSystem.createResolvedFuture<
+        std::shared_ptr<CesiumAsync::IAssetRequest>>(
+        std::make_shared<OriginRequest>(url, this->_pPayload));
+  }
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  virtual void tick() noexcept override {}
+
+private:
+  std::shared_ptr<const std::vector<std::byte>> _pPayload;
+};
+
+/**
+ * Creates a payload that compresses about as well as typical tile content,
+ * by drawing words at random from a small vocabulary.
+ */
+std::vector<std::byte> createPayload(int64 size) {
+  FRandomStream random(1);
+  std::vector<uint64> vocabulary(256);
+  for (uint64& word : vocabulary) {
+    word = (uint64(random.GetUnsignedInt()) << 32) | random.GetUnsignedInt();
+  }
+
+  std::vector<std::byte> payload(size_t(size));
+  for (size_t i = 0; i + sizeof(uint64) <= payload.size();
+       i += sizeof(uint64)) {
+    const uint64 word = vocabulary[random.RandHelper(int32(vocabulary.size()))];
+    std::memcpy(payload.data() + i, &word, sizeof(uint64));
+  }
+  return payload;
+}
+
+std::vector<std::byte> gzip(const std::vector<std::byte>& data) {
+  int32 compressedSize =
+      FCompression::CompressMemoryBound(NAME_Gzip, int32(data.size()));
+  std::vector<std::byte> result(size_t(compressedSize));
+  if (!FCompression::CompressMemory(
+          NAME_Gzip,
+          result.data(),
+          compressedSize,
+          data.data(),
+          int32(data.size()))) {
+    return std::vector<std::byte>();
+  }
+  result.resize(size_t(compressedSize));
+  return result;
+}
+
+std::string getUrl(int32 index) {
+  return "https://tiles.example.com/" + std::to_string(index) + ".glb";
+}
+
+/**
+ * Requests the given URLs through the given accessor, all at once, and
+ * returns the number whose responses did not have the expected size.
+ */
+int32 requestAll(
+    CesiumAsync::IAssetAccessor& accessor,
+    const std::vector<std::string>& urls,
+    int64 expectedSize) {
+  std::atomic<int32> remaining = int32(urls.size());
+  std::atomic<int32> failures = 0;
+
+  for (const std::string& url : urls) {
+    accessor.get(getAsyncSystem(), url, {})
+        .thenImmediately(
+            [&remaining, &failures, expectedSize](
+                std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest) {
+              const CesiumAsync::IAssetResponse* pResponse =
+                  pRequest->response();
+              if (!pResponse ||
+                  int64(pResponse->data().size()) != expectedSize) {
+                ++failures;
+              }
+              --remaining;
+            })
+        .catchImmediately([&remaining, &failures](std::exception&&) {
+          ++failures;
+          --remaining;
+        });
+  }
+
+  while (remaining > 0) {
+    getAsyncSystem().dispatchMainThreadTasks();
+  }
+
+  return failures;
+}
+
+struct CacheHitResult {
+  bool decompressed;
+  int32 entries;
+  int64 databaseBytes;
+  TArray<double> milliseconds;
+};
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+    FCesiumCacheHitBenchmark,
+    "Cesium.Performance.CacheHitBenchmark",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::PerfFilter)
+
+bool FCesiumCacheHitBenchmark::RunTest(const FString& Parameters) {
+  // Measures the latency of request cache hits for gzipped tiles, with
+  // responses cached compressed (the default) and cached decompressed (the
+  // CacheDecompressedResponses setting), for a range of database sizes.
+  // Options:
+  //   -CacheBenchmarkEntries=500,2000,8000 sets the database sizes.
+  //   -CacheBenchmarkPayloadBytes=<n> sets the decompressed tile size.
+  //   -CacheBenchmarkHits=<n> sets the number of hits timed per database.
+  //   -CesiumBenchmarkOutput=<directory> sets where the JSON is written.
+  FString outputDirectory = FPaths::Combine(
+      FPaths::ProjectSavedDir(),
+      TEXT("Cesium"),
+      TEXT("Benchmarks"));
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkOutput="),
+      outputDirectory);
+
+  FString entriesOption = TEXT("500,2000,8000");
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CacheBenchmarkEntries="),
+      entriesOption,
+      false);
+  TArray<FString> entriesStrings;
+  entriesOption.ParseIntoArray(entriesStrings, TEXT(","));
+
+  int32 payloadBytes = 64 * 1024;
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CacheBenchmarkPayloadBytes="),
+      payloadBytes);
+
+  int32 hits = 1000;
+  FParse::Value(FCommandLine::Get(), TEXT("CacheBenchmarkHits="), hits);
+
+  const FString dataDirectory = FPaths::ConvertRelativePathToFull(
+      FPaths::Combine(outputDirectory, TEXT("CacheHitBenchmarkData")));
+  IFileManager::Get().MakeDirectory(*dataDirectory, true);
+
+  const std::vector<std::byte> payload = createPayload(payloadBytes);
+  auto pGzipped =
+      std::make_shared<const std::vector<std::byte>>(gzip(payload));
+  if (!TestFalse("gzipped the payload", pGzipped->empty())) {
+    return false;
+  }
+
+  TArray<CacheHitResult> results;
+
+  for (const FString& entriesString : entriesStrings) {
+    const int32 entries = FCString::Atoi(*entriesString);
+    if (entries <= 0) {
+      continue;
+    }
+
+    for (bool decompressed : {false, true}) {
+      const FString filename = FPaths::Combine(
+          dataDirectory,
+          FString::Printf(
+              TEXT("%s-%d.sqlite"),
+              decompressed ? TEXT("decompressed") : TEXT("compressed"),
+              entries));
+      IFileManager::Get().Delete(*filename);
+
+      CacheHitResult result{decompressed, entries, 0, {}};
+
+      {
+        std::shared_ptr<CesiumAsync::ICacheDatabase> pDatabase =
+            std::make_shared<CesiumAsync::SqliteCache>(
+                spdlog::default_logger(),
+                TCHAR_TO_UTF8(*filename),
+                uint64_t(entries));
+
+        // The same arrangement of accessors as getAssetAccessor.
+        std::shared_ptr<CesiumAsync::IAssetAccessor> pOrigin =
+            std::make_shared<GzippedOriginAssetAccessor>(pGzipped);
+        if (decompressed) {
+          pOrigin =
+              std::make_shared<CesiumAsync::GunzipAssetAccessor>(pOrigin);
+        }
+        std::shared_ptr<CesiumAsync::IAssetAccessor> pAccessor =
+            std::make_shared<CesiumAsync::GunzipAssetAccessor>(
+                std::make_shared<CesiumAsync::CachingAssetAccessor>(
+                    spdlog::default_logger(),
+                    pOrigin,
+                    pDatabase,
+                    std::numeric_limits<int32_t>::max()));
+
+        // Fill the cache.
+        constexpr int32 batchSize = 64;
+        int32 failures = 0;
+        for (int32 first = 0; first < entries; first += batchSize) {
+          std::vector<std::string> urls;
+          for (int32 i = first; i < FMath::Min(first + batchSize, entries);
+               ++i) {
+            urls.emplace_back(getUrl(i));
+          }
+          failures += requestAll(*pAccessor, urls, payloadBytes);
+        }
+        TestEqual("failed requests while filling", failures, 0);
+
+        // Time hits one at a time, so that each measures the latency of a
+        // single request rather than the throughput of many.
+        FRandomStream random(2);
+        failures = 0;
+        for (int32 i = 0; i < hits; ++i) {
+          const std::vector<std::string> urls{
+              getUrl(random.RandHelper(entries))};
+          const double start = FPlatformTime::Seconds();
+          failures += requestAll(*pAccessor, urls, payloadBytes);
+          result.milliseconds.Add(
+              (FPlatformTime::Seconds() - start) * 1000.0);
+        }
+        TestEqual("failed hits", failures, 0);
+      }
+
+      // The database is closed, so any write-ahead log has been merged.
+      result.databaseBytes = IFileManager::Get().FileSize(*filename);
+      results.Add(MoveTemp(result));
+    }
+  }
+
+  IFileManager::Get().DeleteDirectory(*dataDirectory, false, true);
+
+  FString json = FString::Printf(
+      TEXT(
+          "{\n  \"version\": 1,\n  \"payloadBytes\": %d,\n  \"gzippedBytes\": %lld,\n  \"results\": [\n"),
+      payloadBytes,
+      int64(pGzipped->size()));
+  for (int32 i = 0; i < results.Num(); ++i) {
+    const CacheHitResult& result = results[i];
+    double total = 0.0;
+    for (double milliseconds : result.milliseconds) {
+      total += milliseconds;
+    }
+    const double mean =
+        result.milliseconds.Num() > 0 ? total / result.milliseconds.Num()
+                                      : 0.0;
+    const double p50 = Cesium::computePercentile(result.milliseconds, 50.0);
+    const double p95 = Cesium::computePercentile(result.milliseconds, 95.0);
+    const double p99 = Cesium::computePercentile(result.milliseconds, 99.0);
+
+    json += FString::Printf(
+        TEXT(
+            "    { \"mode\": \"%s\", \"entries\": %d, \"databaseBytes\": %lld, \"hits\": %d, \"meanMs\": %.4f, \"p50Ms\": %.4f, \"p95Ms\": %.4f, \"p99Ms\": %.4f }%s\n"),
+        result.decompressed ? TEXT("decompressed") : TEXT("compressed"),
+        result.entries,
+        result.databaseBytes,
+        result.milliseconds.Num(),
+        mean,
+        p50,
+        p95,
+        p99,
+        i + 1 < results.Num() ? TEXT(",") : TEXT(""));
+
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT("Cache hits with %d %s entries (%lld bytes): p50 %.3f ms, p95 %.3f ms"),
+        result.entries,
+        result.decompressed ? TEXT("decompressed") : TEXT("compressed"),
+        result.databaseBytes,
+        p50,
+        p95);
+  }
+  json += TEXT("  ]\n}\n");
+
+  const FString outputFilename =
+      FPaths::Combine(outputDirectory, TEXT("CacheHitBenchmark.json"));
+  if (!FFileHelper::SaveStringToFile(json, *outputFilename)) {
+    AddError(FString::Printf(TEXT("Could not write %s"), *outputFilename));
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,244 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "Async/ParallelFor.h"
+#include "CesiumAsync/CacheItem.h"
+#include "CesiumAsync/SqliteCache.h"
+#include "CesiumRuntime.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "ShardedFileCacheDatabase.h"
+#include <atomic>
+#include <ctime>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+namespace {
+
+struct CacheDatabaseResult {
+  const TCHAR* backend;
+  int32 threads;
+  double storesPerSecond;
+  double getsPerSecond;
+  double mixedPerSecond;
+  int32 failures;
+};
+
+std::string getKey(int32 index) {
+  return "https://tiles.example.com/" + std::to_string(index) + ".glb";
+}
+
+/**
+ * Runs the given number of operations, spread evenly across the given number
+ * of threads, and returns the operations per second. `operation` is passed
+ * the index of the operation and a random stream for its thread, and returns
+ * false if it failed.
+ */
+double runParallel(
+    int32 threads,
+    int32 operations,
+    std::atomic<int32>& failures,
+    const TFunction<bool(int32, FRandomStream&)>& operation) {
+  const double start = FPlatformTime::Seconds();
+  ParallelFor(
+      threads,
+      [threads, operations, &failures, &operation](int32 thread) {
+        FRandomStream random(thread + 1);
+        for (int32 i = thread; i < operations; i += threads) {
+          if (!operation(i, random)) {
+            ++failures;
+          }
+        }
+      },
+      EParallelForFlags::Unbalanced);
+  const double seconds = FPlatformTime::Seconds() - start;
+  return seconds > 0.0 ? operations / seconds : 0.0;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+    FCesiumCacheDatabaseBenchmark,
+    "Cesium.Performance.CacheDatabaseBenchmark",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::PerfFilter)
+
+bool FCesiumCacheDatabaseBenchmark::RunTest(const FString& Parameters) {
+  // Compares the throughput of the SQLite and sharded file request caches
+  // when stores and gets come from several threads at once. The threads are
+  // task graph tasks, so no more run at once than there are workers.
+  // Options:
+  //   -CacheDatabaseBenchmarkThreads=1,4,16 sets the numbers of threads.
+  //   -CacheDatabaseBenchmarkEntries=<n> sets the number of entries stored.
+  //   -CacheDatabaseBenchmarkPayloadBytes=<n> sets the size of each entry.
+  //   -CacheDatabaseBenchmarkGets=<n> sets the number of gets timed.
+  //   -CesiumBenchmarkOutput=<directory> sets where the JSON is written.
+  FString outputDirectory = FPaths::Combine(
+      FPaths::ProjectSavedDir(),
+      TEXT("Cesium"),
+      TEXT("Benchmarks"));
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkOutput="),
+      outputDirectory);
+
+  FString threadsOption = TEXT("1,4,16");
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CacheDatabaseBenchmarkThreads="),
+      threadsOption,
+      false);
+  TArray<FString> threadsStrings;
+  threadsOption.ParseIntoArray(threadsStrings, TEXT(","));
+
+  int32 entries = 5000;
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CacheDatabaseBenchmarkEntries="),
+      entries);
+
+  int32 payloadBytes = 32 * 1024;
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CacheDatabaseBenchmarkPayloadBytes="),
+      payloadBytes);
+
+  int32 gets = 20000;
+  FParse::Value(FCommandLine::Get(), TEXT("CacheDatabaseBenchmarkGets="), gets);
+
+  if (!TestTrue("entries", entries > 0)) {
+    return false;
+  }
+
+  const FString dataDirectory = FPaths::ConvertRelativePathToFull(
+      FPaths::Combine(outputDirectory, TEXT("CacheDatabaseBenchmarkData")));
+  IFileManager::Get().MakeDirectory(*dataDirectory, true);
+
+  std::vector<std::byte> payload(size_t(FMath::Max(payloadBytes, 0)));
+  FRandomStream payloadRandom(1);
+  for (std::byte& byte : payload) {
+    byte = std::byte(payloadRandom.RandHelper(256));
+  }
+
+  const CesiumAsync::HttpHeaders requestHeaders{{"Accept", "*/*"}};
+  const CesiumAsync::HttpHeaders responseHeaders{
+      {"Cache-Control", "max-age=86400"},
+      {"Content-Type", "application/octet-stream"}};
+  const std::time_t expiryTime = std::time(nullptr) + 86400;
+
+  TArray<CacheDatabaseResult> results;
+
+  for (const FString& threadsString : threadsStrings) {
+    const int32 threads = FCString::Atoi(*threadsString);
+    if (threads <= 0) {
+      continue;
+    }
+
+    for (const TCHAR* backend : {TEXT("sqlite"), TEXT("sharded")}) {
+      const FString path = FPaths::Combine(
+          dataDirectory,
+          FString::Printf(TEXT("%s-%d"), backend, threads));
+      IFileManager::Get().DeleteDirectory(*path, false, true);
+      IFileManager::Get().MakeDirectory(*path, true);
+
+      CacheDatabaseResult result{backend, threads, 0.0, 0.0, 0.0, 0};
+
+      {
+        std::shared_ptr<CesiumAsync::ICacheDatabase> pDatabase;
+        if (FCString::Strcmp(backend, TEXT("sqlite")) == 0) {
+          pDatabase = std::make_shared<CesiumAsync::SqliteCache>(
+              spdlog::default_logger(),
+              TCHAR_TO_UTF8(*FPaths::Combine(path, TEXT("cache.sqlite"))),
+              uint64_t(entries));
+        } else {
+          pDatabase =
+              std::make_shared<ShardedFileCacheDatabase>(path, uint64(entries));
+        }
+
+        auto store = [&](int32 i, FRandomStream&) {
+          const std::string key = getKey(i % entries);
+          return pDatabase->storeEntry(
+              key,
+              expiryTime,
+              key,
+              "GET",
+              requestHeaders,
+              200,
+              responseHeaders,
+              gsl::span<const std::byte>(payload));
+        };
+        auto get = [&](int32, FRandomStream& random) {
+          std::optional<CesiumAsync::CacheItem> item =
+              pDatabase->getEntry(getKey(random.RandHelper(entries)));
+          return item && item->cacheResponse.data.size() == payload.size();
+        };
+
+        std::atomic<int32> failures = 0;
+        result.storesPerSecond = runParallel(threads, entries, failures, store);
+        result.getsPerSecond = runParallel(threads, gets, failures, get);
+
+        // Nine gets for each store, as when a warm cache is mostly hit and
+        // the occasional expired tile is downloaded again.
+        result.mixedPerSecond = runParallel(
+            threads,
+            gets,
+            failures,
+            [&](int32 i, FRandomStream& random) {
+              return i % 10 == 0 ? store(i, random) : get(i, random);
+            });
+        result.failures = failures;
+      }
+
+      TestEqual("failures", result.failures, 0);
+      IFileManager::Get().DeleteDirectory(*path, false, true);
+      results.Add(result);
+    }
+  }
+
+  IFileManager::Get().DeleteDirectory(*dataDirectory, false, true);
+
+  FString json = FString::Printf(
+      TEXT(
+          "{\n  \"version\": 1,\n  \"entries\": %d,\n  \"payloadBytes\": %d,\n  \"gets\": %d,\n  \"results\": [\n"),
+      entries,
+      payloadBytes,
+      gets);
+  for (int32 i = 0; i < results.Num(); ++i) {
+    const CacheDatabaseResult& result = results[i];
+    json += FString::Printf(
+        TEXT(
+            "    { \"backend\": \"%s\", \"threads\": %d, \"storesPerSecond\": %.1f, \"getsPerSecond\": %.1f, \"mixedPerSecond\": %.1f, \"failures\": %d }%s\n"),
+        result.backend,
+        result.threads,
+        result.storesPerSecond,
+        result.getsPerSecond,
+        result.mixedPerSecond,
+        result.failures,
+        i + 1 < results.Num() ? TEXT(",") : TEXT(""));
+
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT("%s cache with %d threads: %.0f stores/s, %.0f gets/s, %.0f mixed/s"),
+        result.backend,
+        result.threads,
+        result.storesPerSecond,
+        result.getsPerSecond,
+        result.mixedPerSecond);
+  }
+  json += TEXT("  ]\n}\n");
+
+  const FString outputFilename =
+      FPaths::Combine(outputDirectory, TEXT("CacheDatabaseBenchmark.json"));
+  if (!FFileHelper::SaveStringToFile(json, *outputFilename)) {
+    AddError(FString::Printf(TEXT("Could not write %s"), *outputFilename));
+    return false;
+  }
+
+  return true;
+}
@@ -53,6 +53,32 @@ void FCesiumCameraManagerSpec::Define() {
       TestEqual("Camera count returns to 0", camerasMapRef.Num(), 0);
     });
 
+    It("should keep the screen-space error multiplier of a camera", [this]() {
+      UWorld* world = CesiumTestHelpers::getGlobalWorldContext();
+      ACesiumCameraManager* cameraManager =
+          ACesiumCameraManager::GetDefaultCameraManager(world);
+      TestNotNull("Returned pointer is valid", cameraManager);
+
+      FCesiumCamera newCamera;
+      TestEqual(
+          "Default multiplier is 1",
+          newCamera.ScreenSpaceErrorMultiplier,
+          1.0);
+
+      newCamera.ScreenSpaceErrorMultiplier = 0.25;
+      int32 newCameraId = cameraManager->AddCamera(newCamera);
+      const FCesiumCamera* pCamera =
+          cameraManager->GetCameras().Find(newCameraId);
+      if (TestNotNull("Camera was added", pCamera)) {
+        TestEqual(
+            "Multiplier is kept",
+            pCamera->ScreenSpaceErrorMultiplier,
+            0.25);
+      }
+
+      cameraManager->RemoveCamera(newCameraId);
+    });
+
     It("should fail to remove a camera, when the id is invalid", [this]() {
       UWorld* world = CesiumTestHelpers::getGlobalWorldContext();
       ACesiumCameraManager* cameraManager =
@@ -0,0 +1,91 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumCameraPath.h"
+#include "CesiumStreamingBenchmark.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(
+    FCesiumCameraPathSpec,
+    "Cesium.Unit.CameraPath",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FCesiumCameraPathSpec)
+
+void FCesiumCameraPathSpec::Define() {
+  Describe("toString and fromString", [this]() {
+    It("round-trips every field of every frame", [this]() {
+      CesiumCameraPath path;
+      CesiumCameraPathFrame& first = path.frames.Emplace_GetRef();
+      first.time = 0.0;
+      first.longitudeLatitudeHeight = FVector(-105.25, 39.75, 1650.5);
+      first.eastSouthUpRotation = FRotator(-30.0, 45.0, 0.0);
+      CesiumCameraPathFrame& second = path.frames.Emplace_GetRef();
+      second.time = 1.0 / 60.0;
+      second.longitudeLatitudeHeight = FVector(151.2, -33.85, 120.0);
+      second.eastSouthUpRotation = FRotator(10.0, -90.0, 5.0);
+      second.fieldOfViewDegrees = 60.0;
+      second.viewportSize = FVector2D(1280.0, 720.0);
+
+      std::optional<CesiumCameraPath> maybeParsed =
+          CesiumCameraPath::fromString(path.toString());
+      if (!TestTrue("parsed", maybeParsed.has_value())) {
+        return;
+      }
+
+      const CesiumCameraPath& parsed = *maybeParsed;
+      if (!TestEqual("frames", parsed.frames.Num(), path.frames.Num())) {
+        return;
+      }
+
+      for (int32 i = 0; i < path.frames.Num(); ++i) {
+        const CesiumCameraPathFrame& expected = path.frames[i];
+        const CesiumCameraPathFrame& actual = parsed.frames[i];
+        TestEqual("time", actual.time, expected.time, 1e-6);
+        TestEqual(
+            "longitudeLatitudeHeight",
+            actual.longitudeLatitudeHeight,
+            expected.longitudeLatitudeHeight,
+            1e-6);
+        TestEqual(
+            "eastSouthUpRotation",
+            actual.eastSouthUpRotation,
+            expected.eastSouthUpRotation,
+            1e-6);
+        TestEqual(
+            "fieldOfViewDegrees",
+            actual.fieldOfViewDegrees,
+            expected.fieldOfViewDegrees,
+            1e-6);
+        TestEqual("viewportSize", actual.viewportSize, expected.viewportSize);
+      }
+    });
+
+    It("rejects text without the header", [this]() {
+      TestFalse(
+          "parsed",
+          CesiumCameraPath::fromString(TEXT("0,1,2,3,4,5,6,7,8,9"))
+              .has_value());
+    });
+
+    It("rejects lines with the wrong number of values", [this]() {
+      CesiumCameraPath path;
+      path.frames.Emplace();
+      FString text = path.toString() + TEXT("1,2,3\n");
+      TestFalse("parsed", CesiumCameraPath::fromString(text).has_value());
+    });
+  });
+
+  Describe("computePercentile", [this]() {
+    It("returns zero for no values", [this]() {
+      TestEqual("p50", Cesium::computePercentile({}, 50.0), 0.0);
+    });
+
+    It("uses the nearest rank", [this]() {
+      TArray<double> values{5.0, 1.0, 4.0, 2.0, 3.0};
+      TestEqual("p0", Cesium::computePercentile(values, 0.0), 1.0);
+      TestEqual("p50", Cesium::computePercentile(values, 50.0), 3.0);
+      TestEqual("p95", Cesium::computePercentile(values, 95.0), 5.0);
+      TestEqual("p100", Cesium::computePercentile(values, 100.0), 5.0);
+    });
+  });
+}
@@ -0,0 +1,107 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumCameraPrediction.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(
+    FCesiumCameraPredictionSpec,
+    "Cesium.Unit.CameraPrediction",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+const double DeltaTime = 1.0 / 60.0;
+
+CesiumCameraPrediction::Options Options;
+
+FCesiumCamera CreateCamera(const FVector& location) {
+  return FCesiumCamera(
+      FVector2D(1920.0, 1080.0),
+      location,
+      FRotator::ZeroRotator,
+      90.0);
+}
+
+/**
+ * Moves a camera from the given location at the given velocity for the given
+ * number of frames, and returns the predictions of the last frame.
+ */
+std::vector<FCesiumCamera> Move(
+    CesiumCameraPrediction& prediction,
+    FVector& location,
+    const FVector& velocity,
+    int32 frames) {
+  std::vector<FCesiumCamera> result;
+  for (int32 i = 0; i < frames; ++i) {
+    location += velocity * DeltaTime;
+    result = prediction.update({CreateCamera(location)}, DeltaTime, Options);
+  }
+  return result;
+}
+
+END_DEFINE_SPEC(FCesiumCameraPredictionSpec)
+
+void FCesiumCameraPredictionSpec::Define() {
+  BeforeEach([this]() { Options = CesiumCameraPrediction::Options(); });
+
+  It("predicts a camera moving steadily", [this]() {
+    CesiumCameraPrediction prediction;
+    FVector location(0.0, 0.0, 0.0);
+    const FVector velocity(25000.0, 0.0, 0.0);
+    prediction.update({CreateCamera(location)}, DeltaTime, Options);
+
+    std::vector<FCesiumCamera> predictions =
+        Move(prediction, location, velocity, 120);
+    if (!TestEqual("predictions", int32(predictions.size()), 1)) {
+      return;
+    }
+    TestTrue(
+        "location",
+        predictions[0].Location.Equals(
+            location + velocity * Options.predictionSeconds,
+            1.0));
+    TestEqual("viewport width", predictions[0].ViewportSize.X, 960.0);
+    TestEqual("viewport height", predictions[0].ViewportSize.Y, 540.0);
+  });
+
+  It("does not predict a camera that is not moving", [this]() {
+    CesiumCameraPrediction prediction;
+    FVector location(100.0, 200.0, 300.0);
+    prediction.update({CreateCamera(location)}, DeltaTime, Options);
+
+    std::vector<FCesiumCamera> predictions =
+        Move(prediction, location, FVector::ZeroVector, 120);
+    TestEqual("predictions", int32(predictions.size()), 0);
+  });
+
+  It("drops the prediction of a camera that turns", [this]() {
+    CesiumCameraPrediction prediction;
+    FVector location(0.0, 0.0, 0.0);
+    prediction.update({CreateCamera(location)}, DeltaTime, Options);
+    Move(prediction, location, FVector(25000.0, 0.0, 0.0), 120);
+
+    std::vector<FCesiumCamera> predictions =
+        Move(prediction, location, FVector(0.0, 25000.0, 0.0), 1);
+    TestEqual("predictions", int32(predictions.size()), 0);
+    TestEqual("divergences", int32(prediction.getDivergenceCount()), 1);
+
+    predictions = Move(prediction, location, FVector(0.0, 25000.0, 0.0), 120);
+    if (TestEqual("predictions after turning", int32(predictions.size()), 1)) {
+      TestTrue(
+          "predicted along the new direction",
+          predictions[0].Location.Y > location.Y);
+    }
+  });
+
+  It("starts over when the cameras change", [this]() {
+    CesiumCameraPrediction prediction;
+    FVector location(0.0, 0.0, 0.0);
+    prediction.update({CreateCamera(location)}, DeltaTime, Options);
+    Move(prediction, location, FVector(25000.0, 0.0, 0.0), 120);
+
+    std::vector<FCesiumCamera> predictions = prediction.update(
+        {CreateCamera(location), CreateCamera(location)},
+        DeltaTime,
+        Options);
+    TestEqual("predictions", int32(predictions.size()), 0);
+  });
+}
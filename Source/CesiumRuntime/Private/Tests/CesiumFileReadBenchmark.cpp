@@ -0,0 +1,193 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UnrealAssetAccessor.h"
+#include <atomic>
+#include <vector>
+
+namespace {
+
+struct FileReadResult {
+  bool memoryMapped;
+  int64 fileSize;
+  int32 requests;
+  double seconds;
+};
+
+/**
+ * Requests every file through the given accessor, all at once, and waits for
+ * the responses. Every page of each response is read, so that the cost of
+ * faulting in mapped pages is included.
+ */
+double requestAll(
+    UnrealAssetAccessor& accessor,
+    const TArray<FString>& uris,
+    int64 expectedSize,
+    FAutomationTestBase& test) {
+  std::atomic<int32> remaining = uris.Num();
+  std::atomic<int32> failures = 0;
+  std::atomic<uint64> checksum = 0;
+
+  const double start = FPlatformTime::Seconds();
+  for (const FString& uri : uris) {
+    accessor.get(getAsyncSystem(), TCHAR_TO_UTF8(*uri), {})
+        .thenInWorkerThread(
+            [&remaining, &failures, &checksum, expectedSize](
+                std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest) {
+              const CesiumAsync::IAssetResponse* pResponse =
+                  pRequest->response();
+              if (!pResponse ||
+                  int64(pResponse->data().size()) != expectedSize) {
+                ++failures;
+              } else {
+                gsl::span<const std::byte> data = pResponse->data();
+                uint64 sum = 0;
+                for (size_t i = 0; i < data.size(); i += 4096) {
+                  sum += uint64(data[i]);
+                }
+                checksum += sum;
+              }
+              --remaining;
+            });
+  }
+
+  while (remaining > 0) {
+    accessor.tick();
+    getAsyncSystem().dispatchMainThreadTasks();
+  }
+  const double end = FPlatformTime::Seconds();
+
+  test.TestEqual("failed requests", int32(failures), 0);
+  test.TestTrue("read the data", uris.Num() == 0 || checksum > 0);
+  return end - start;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+    FCesiumFileReadBenchmark,
+    "Cesium.Performance.FileReadBenchmark",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::PerfFilter)
+
+bool FCesiumFileReadBenchmark::RunTest(const FString& Parameters) {
+  // Compares the throughput of file:/// requests served from memory-mapped
+  // files with requests that read the files into memory, for a range of
+  // file sizes. -CesiumBenchmarkOutput=<directory> sets where the JSON is
+  // written.
+  FString outputDirectory = FPaths::Combine(
+      FPaths::ProjectSavedDir(),
+      TEXT("Cesium"),
+      TEXT("Benchmarks"));
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkOutput="),
+      outputDirectory);
+
+  const FString dataDirectory = FPaths::ConvertRelativePathToFull(
+      FPaths::Combine(outputDirectory, TEXT("FileReadBenchmarkData")));
+
+  IConsoleVariable* pMemoryMap = IConsoleManager::Get().FindConsoleVariable(
+      TEXT("cesium.FileRequests.MemoryMap"));
+  if (!TestNotNull("cesium.FileRequests.MemoryMap", pMemoryMap)) {
+    return false;
+  }
+  const bool originalMemoryMap = pMemoryMap->GetBool();
+
+  // Larger files are read fewer times so that each size takes a similar
+  // amount of time.
+  const std::vector<std::pair<int64, int32>> sizes{
+      {4 * 1024, 2000},
+      {256 * 1024, 400},
+      {4 * 1024 * 1024, 50},
+      {32 * 1024 * 1024, 8}};
+  constexpr int32 filesPerSize = 8;
+
+  UnrealAssetAccessor accessor;
+  TArray<FileReadResult> results;
+
+  for (const std::pair<int64, int32>& size : sizes) {
+    TArray<uint8> contents;
+    contents.SetNumUninitialized(int32(size.first));
+    for (int32 i = 0; i < contents.Num(); ++i) {
+      contents[i] = uint8(i * 31 + 7);
+    }
+
+    TArray<FString> uris;
+    for (int32 i = 0; i < filesPerSize; ++i) {
+      const FString filename = FPaths::Combine(
+          dataDirectory,
+          FString::Printf(TEXT("%lld_%d.bin"), size.first, i));
+      FFileHelper::SaveArrayToFile(contents, *filename);
+
+      FString uri = TEXT("file:///") + filename;
+      uri.ReplaceCharInline('\\', '/');
+      uri.ReplaceInline(TEXT(" "), TEXT("%20"));
+      uris.Add(uri);
+    }
+
+    TArray<FString> requests;
+    while (requests.Num() < size.second) {
+      requests.Append(uris);
+    }
+
+    for (bool memoryMapped : {true, false}) {
+      pMemoryMap->Set(memoryMapped, ECVF_SetByCode);
+
+      // Warm the file system cache, so that both modes read from memory.
+      requestAll(accessor, uris, size.first, *this);
+
+      const double seconds =
+          requestAll(accessor, requests, size.first, *this);
+      results.Add(
+          FileReadResult{memoryMapped, size.first, requests.Num(), seconds});
+    }
+  }
+
+  pMemoryMap->Set(originalMemoryMap, ECVF_SetByCode);
+  IFileManager::Get().DeleteDirectory(*dataDirectory, false, true);
+
+  FString json = TEXT("{\n  \"version\": 1,\n  \"results\": [\n");
+  for (int32 i = 0; i < results.Num(); ++i) {
+    const FileReadResult& result = results[i];
+    const double megabytes =
+        double(result.fileSize) * result.requests / (1024.0 * 1024.0);
+    json += FString::Printf(
+        TEXT(
+            "    { \"mode\": \"%s\", \"fileSize\": %lld, \"requests\": %d, \"megabytesPerSecond\": %.1f, \"msPerRequest\": %.4f }%s\n"),
+        result.memoryMapped ? TEXT("mapped") : TEXT("buffered"),
+        result.fileSize,
+        result.requests,
+        megabytes / result.seconds,
+        result.seconds * 1000.0 / result.requests,
+        i + 1 < results.Num() ? TEXT(",") : TEXT(""));
+
+    UE_LOG(
+        LogCesium,
+        Display,
+        TEXT("%s reads of %lld byte files: %.1f MB/s"),
+        result.memoryMapped ? TEXT("Mapped") : TEXT("Buffered"),
+        result.fileSize,
+        megabytes / result.seconds);
+  }
+  json += TEXT("  ]\n}\n");
+
+  const FString outputFilename =
+      FPaths::Combine(outputDirectory, TEXT("FileReadBenchmark.json"));
+  if (!FFileHelper::SaveStringToFile(json, *outputFilename)) {
+    AddError(FString::Printf(TEXT("Could not write %s"), *outputFilename));
+    return false;
+  }
+
+  return true;
+}
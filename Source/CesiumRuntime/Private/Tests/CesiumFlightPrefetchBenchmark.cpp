@@ -0,0 +1,349 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "Cesium3DTilesSelection/BoundingVolume.h"
+#include "Cesium3DTilesSelection/Tile.h"
+#include "Cesium3DTilesSelection/Tileset.h"
+#include "Cesium3DTileset.h"
+#include "CesiumAsync/ICacheDatabase.h"
+#include "CesiumCameraManager.h"
+#include "CesiumFlyToComponent.h"
+#include "CesiumGeoreference.h"
+#include "CesiumGlobeAnchorComponent.h"
+#include "CesiumGltfComponent.h"
+#include "CesiumRuntime.h"
+#include "CesiumSyntheticTileset.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "VecMath.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Cesium;
+
+namespace {
+
+constexpr double FrameSeconds = 1.0 / 60.0;
+constexpr float FlightSeconds = 8.0f;
+constexpr double MetersPerDegreeLatitude = 111320.0;
+
+struct FlightBlurResult {
+  int32 frames = 0;
+  int32 blurryFrames = 0;
+  double blurSeconds = 0.0;
+  int32 maximumBlurryTiles = 0;
+};
+
+/**
+ * Counts the tiles that are shown in the given camera's view in less detail
+ * than the tileset's maximum screen-space error asks for, because their
+ * children have not loaded yet.
+ *
+ * The distance to a tile is taken to its center, so this underestimates the
+ * screen-space error of large tiles close to the camera.
+ */
+int32 countBlurryTiles(
+    ACesium3DTileset& tileset,
+    const ACesiumGeoreference& georeference,
+    const FCesiumCamera& camera) {
+  Cesium3DTilesSelection::Tileset* pNativeTileset = tileset.GetTileset();
+  if (!pNativeTileset || camera.ViewportSize.X <= 0.0) {
+    return 0;
+  }
+
+  const double aspectRatio = camera.ViewportSize.X / camera.ViewportSize.Y;
+  const double halfHorizontalFov =
+      FMath::DegreesToRadians(camera.FieldOfViewDegrees) * 0.5;
+  const double tanHalfVerticalFov = std::tan(halfHorizontalFov) / aspectRatio;
+  const double halfDiagonalFov = std::atan(std::sqrt(
+      std::tan(halfHorizontalFov) * std::tan(halfHorizontalFov) +
+      tanHalfVerticalFov * tanHalfVerticalFov));
+  const FVector forward = camera.Rotation.Vector();
+  const double maximumScreenSpaceError = tileset.GetMaximumScreenSpaceError();
+
+  int32 blurryTiles = 0;
+  pNativeTileset->forEachLoadedTile([&](Cesium3DTilesSelection::Tile& tile) {
+    if (tile.getChildren().empty() ||
+        tile.getState() != Cesium3DTilesSelection::TileLoadState::Done) {
+      return;
+    }
+    const Cesium3DTilesSelection::TileRenderContent* pRenderContent =
+        tile.getContent().getRenderContent();
+    if (!pRenderContent) {
+      return;
+    }
+    const UCesiumGltfComponent* pGltf = static_cast<UCesiumGltfComponent*>(
+        pRenderContent->getRenderResources());
+    if (!pGltf || !pGltf->IsVisible()) {
+      return;
+    }
+
+    const glm::dvec3 centerEcef =
+        Cesium3DTilesSelection::getBoundingVolumeCenter(
+            tile.getBoundingVolume());
+    const FVector center =
+        georeference.TransformEarthCenteredEarthFixedPositionToUnreal(
+            VecMath::createVector(centerEcef));
+    const FVector toCenter = center - camera.Location;
+    const double distanceMeters = toCenter.Length() / 100.0;
+    if (distanceMeters <= 0.0 ||
+        FMath::Acos(FVector::DotProduct(forward, toCenter.GetSafeNormal())) >
+            halfDiagonalFov) {
+      return;
+    }
+
+    const double screenSpaceError =
+        tile.getGeometricError() * camera.ViewportSize.Y /
+        (2.0 * distanceMeters * tanHalfVerticalFov);
+    if (screenSpaceError > maximumScreenSpaceError) {
+      ++blurryTiles;
+    }
+  });
+
+  return blurryTiles;
+}
+
+/**
+ * Flies an Actor diagonally across the synthetic tileset, with a camera
+ * following it, and measures how long the view shows tiles that are waiting
+ * for more detail. The ticks are paced in real time, so that the tile loads
+ * have as long to finish as they would in a game.
+ */
+FlightBlurResult runFlight(
+    const FString& tilesetUrl,
+    const SyntheticTilesetOptions& tilesetOptions,
+    bool prefetch) {
+  FlightBlurResult result;
+
+  // Start each flight with an empty cache, so the second one is not served
+  // the first one's tiles.
+  getCacheDatabase()->clearAll();
+
+  UWorld* pWorld = UWorld::CreateWorld(
+      EWorldType::Game,
+      false,
+      FName(TEXT("CesiumFlightPrefetchBenchmark")));
+  GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(pWorld);
+  pWorld->InitializeActorsForPlay(FURL());
+  pWorld->BeginPlay();
+
+  const FVector& center = tilesetOptions.longitudeLatitudeHeight;
+  ACesiumGeoreference* pGeoreference =
+      ACesiumGeoreference::GetDefaultGeoreference(pWorld);
+  pGeoreference->SetOriginLongitudeLatitudeHeight(center);
+
+  ACesium3DTileset* pTileset = pWorld->SpawnActor<ACesium3DTileset>();
+  pTileset->SetTilesetSource(ETilesetSource::FromUrl);
+  pTileset->SetUrl(tilesetUrl);
+
+  AActor* pActor = pWorld->SpawnActor<AActor>();
+  pActor->AddComponentByClass(
+      USceneComponent::StaticClass(),
+      false,
+      FTransform::Identity,
+      false);
+  UCesiumGlobeAnchorComponent* pGlobeAnchor =
+      Cast<UCesiumGlobeAnchorComponent>(pActor->AddComponentByClass(
+          UCesiumGlobeAnchorComponent::StaticClass(),
+          false,
+          FTransform::Identity,
+          false));
+  UCesiumFlyToComponent* pFlyTo =
+      Cast<UCesiumFlyToComponent>(pActor->AddComponentByClass(
+          UCesiumFlyToComponent::StaticClass(),
+          false,
+          FTransform::Identity,
+          false));
+  pFlyTo->Duration = FlightSeconds;
+  pFlyTo->PrefetchAlongPath = prefetch;
+
+  // Fly between opposite corners, 80% of the way out from the center.
+  const double offsetMeters = tilesetOptions.extentMeters * 0.4;
+  const double latitudeOffset = offsetMeters / MetersPerDegreeLatitude;
+  const double longitudeOffset =
+      latitudeOffset / std::cos(FMath::DegreesToRadians(center.Y));
+  const double heightAboveGround = 200.0;
+  pGlobeAnchor->MoveToLongitudeLatitudeHeight(FVector(
+      center.X - longitudeOffset,
+      center.Y - latitudeOffset,
+      center.Z + heightAboveGround));
+  // Unreal's local frame is East-South-Up, so north-east is a yaw of -45.
+  pGlobeAnchor->SetEastSouthUpRotation(
+      FRotator(-30.0, -45.0, 0.0).Quaternion());
+
+  ACesiumCameraManager* pCameraManager =
+      ACesiumCameraManager::GetDefaultCameraManager(pWorld);
+  auto createCamera = [pActor]() {
+    return FCesiumCamera(
+        FVector2D(1920.0, 1080.0),
+        pActor->GetActorLocation(),
+        pActor->GetActorRotation(),
+        90.0);
+  };
+  const int32 cameraId = pCameraManager->AddCamera(createCamera());
+
+  auto tick = [pWorld]() {
+    const double start = FPlatformTime::Seconds();
+    pWorld->Tick(LEVELTICK_All, float(FrameSeconds));
+    FTaskGraphInterface::Get().ProcessThreadUntilIdle(
+        ENamedThreads::GameThread);
+    const double elapsed = FPlatformTime::Seconds() - start;
+    FPlatformProcess::Sleep(float(std::max(FrameSeconds - elapsed, 0.0)));
+  };
+
+  // Let the starting view load completely before taking off.
+  for (int32 i = 0; i < 1800 && pTileset->GetLoadProgress() < 100.0f; ++i) {
+    tick();
+  }
+
+  pFlyTo->FlyToLocationLongitudeLatitudeHeight(
+      FVector(
+          center.X + longitudeOffset,
+          center.Y + latitudeOffset,
+          center.Z + heightAboveGround),
+      -45.0,
+      -30.0,
+      false);
+
+  const int32 flightFrames = int32(std::ceil(FlightSeconds / FrameSeconds));
+  for (int32 i = 0; i < flightFrames; ++i) {
+    tick();
+    const FCesiumCamera camera = createCamera();
+    pCameraManager->UpdateCamera(cameraId, camera);
+
+    const int32 blurryTiles =
+        countBlurryTiles(*pTileset, *pGeoreference, camera);
+    ++result.frames;
+    if (blurryTiles > 0) {
+      ++result.blurryFrames;
+      result.blurSeconds += FrameSeconds;
+      result.maximumBlurryTiles =
+          std::max(result.maximumBlurryTiles, blurryTiles);
+    }
+  }
+
+  pCameraManager->RemoveCamera(cameraId);
+  pActor->Destroy();
+  pTileset->Destroy();
+  GEngine->DestroyWorldContext(pWorld);
+  pWorld->DestroyWorld(false);
+
+  return result;
+}
+
+FString formatResult(const FlightBlurResult& result) {
+  return FString::Printf(
+      TEXT(
+          "{ \"frames\": %d, \"blurryFrames\": %d, \"blurSeconds\": %.3f, \"maximumBlurryTiles\": %d }"),
+      result.frames,
+      result.blurryFrames,
+      result.blurSeconds,
+      result.maximumBlurryTiles);
+}
+
+void setConsoleVariable(const TCHAR* name, const FString& value) {
+  if (IConsoleVariable* pVariable =
+          IConsoleManager::Get().FindConsoleVariable(name)) {
+    pVariable->Set(*value, ECVF_SetByCode);
+  }
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+    FCesiumFlightPrefetchBenchmark,
+    "Cesium.Performance.FlightPrefetchBenchmark",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::PerfFilter)
+
+bool FCesiumFlightPrefetchBenchmark::RunTest(const FString& Parameters) {
+  // The emulated latency of each tile request, which can be given on the
+  // command line, for example:
+  //   -CesiumBenchmarkLatencyMs=300
+  float latencyMilliseconds = 300.0f;
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkLatencyMs="),
+      latencyMilliseconds);
+  FString outputDirectory = FPaths::Combine(
+      FPaths::ProjectSavedDir(),
+      TEXT("Cesium"),
+      TEXT("Benchmarks"));
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkOutput="),
+      outputDirectory);
+
+  SyntheticTilesetOptions tilesetOptions;
+  tilesetOptions.maximumDepth = 5;
+  tilesetOptions.trianglesPerTile = 512;
+  tilesetOptions.textureSize = 64;
+  const SyntheticTilesetResult tileset = generateSyntheticTileset(
+      FPaths::Combine(
+          FPaths::ProjectSavedDir(),
+          TEXT("Cesium"),
+          TEXT("Benchmarks"),
+          TEXT("FlightPrefetchTileset")),
+      tilesetOptions);
+  if (tileset.tilesetUrl.IsEmpty()) {
+    AddError(TEXT("Could not generate the synthetic tileset."));
+    return false;
+  }
+
+  // Local files load almost instantly, so emulate a network to give the
+  // tiles something to be fetched ahead of.
+  setConsoleVariable(TEXT("cesium.NetworkEmulation.Enabled"), TEXT("1"));
+  setConsoleVariable(
+      TEXT("cesium.NetworkEmulation.LatencyMs"),
+      FString::SanitizeFloat(latencyMilliseconds));
+
+  const FlightBlurResult withoutPrefetch =
+      runFlight(tileset.tilesetUrl, tilesetOptions, false);
+  const FlightBlurResult withPrefetch =
+      runFlight(tileset.tilesetUrl, tilesetOptions, true);
+
+  setConsoleVariable(TEXT("cesium.NetworkEmulation.Enabled"), TEXT("-1"));
+  setConsoleVariable(TEXT("cesium.NetworkEmulation.LatencyMs"), TEXT("-1"));
+
+  FString json = TEXT("{\n");
+  json += TEXT("  \"name\": \"FlightPrefetch\",\n");
+  json += FString::Printf(
+      TEXT("  \"flightSeconds\": %.3f,\n"),
+      double(FlightSeconds));
+  json += FString::Printf(
+      TEXT("  \"latencyMs\": %.1f,\n"),
+      double(latencyMilliseconds));
+  json += FString::Printf(
+      TEXT("  \"withoutPrefetch\": %s,\n"),
+      *formatResult(withoutPrefetch));
+  json += FString::Printf(
+      TEXT("  \"withPrefetch\": %s\n"),
+      *formatResult(withPrefetch));
+  json += TEXT("}\n");
+
+  const FString jsonFilename =
+      FPaths::Combine(outputDirectory, TEXT("FlightPrefetch.json"));
+  FFileHelper::SaveStringToFile(json, *jsonFilename);
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT(
+          "Blurry for %.2f s of a %.1f s flight without prefetching, and %.2f s with it; results written to %s"),
+      withoutPrefetch.blurSeconds,
+      double(FlightSeconds),
+      withPrefetch.blurSeconds,
+      *jsonFilename);
+
+  TestTrue("flew without prefetching", withoutPrefetch.frames > 0);
+  TestTrue("flew with prefetching", withPrefetch.frames > 0);
+
+  return true;
+}
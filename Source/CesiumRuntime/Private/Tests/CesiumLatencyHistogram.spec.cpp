@@ -0,0 +1,55 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumLatencyHistogram.h"
+#include "Misc/AutomationTest.h"
+#include <cmath>
+
+BEGIN_DEFINE_SPEC(
+    FCesiumLatencyHistogramSpec,
+    "Cesium.Unit.LatencyHistogram",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FCesiumLatencyHistogramSpec)
+
+void FCesiumLatencyHistogramSpec::Define() {
+  It("returns zero when nothing has been recorded", [this]() {
+    CesiumLatencyHistogram histogram;
+    TestEqual("count", histogram.getCount(), int64(0));
+    TestEqual("mean", histogram.getMean(), 0.0);
+    TestEqual("p50", histogram.getPercentile(50.0), 0.0);
+  });
+
+  It("ignores negative durations", [this]() {
+    CesiumLatencyHistogram histogram;
+    histogram.record(-1.0);
+    TestEqual("count", histogram.getCount(), int64(0));
+  });
+
+  It("computes percentiles to within the bucket precision", [this]() {
+    CesiumLatencyHistogram histogram;
+    for (int32 i = 1; i <= 100; ++i) {
+      histogram.record(double(i) * 0.001);
+    }
+
+    TestEqual("count", histogram.getCount(), int64(100));
+    TestEqual("mean", histogram.getMean(), 0.0505, 0.0001);
+    TestEqual("p50", histogram.getPercentile(50.0), 0.050, 0.050 * 0.05);
+    TestEqual("p95", histogram.getPercentile(95.0), 0.095, 0.095 * 0.05);
+    TestEqual("p99", histogram.getPercentile(99.0), 0.099, 0.099 * 0.05);
+    TestEqual("p100", histogram.getPercentile(100.0), 0.100, 0.100 * 0.05);
+  });
+
+  It("clamps very long durations into the last bucket", [this]() {
+    CesiumLatencyHistogram histogram;
+    histogram.record(1e9);
+    TestEqual("count", histogram.getCount(), int64(1));
+    TestTrue("p50 is finite", std::isfinite(histogram.getPercentile(50.0)));
+  });
+
+  It("is empty after a reset", [this]() {
+    CesiumLatencyHistogram histogram;
+    histogram.record(0.5);
+    histogram.reset();
+    TestEqual("count", histogram.getCount(), int64(0));
+  });
+}
@@ -0,0 +1,176 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumLodImportanceIndex.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(
+    FCesiumLodImportanceIndexSpec,
+    "Cesium.Unit.LodImportanceIndex",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+CesiumLodImportanceIndex::Volume
+CreateBox(const FVector& location, double extent, double multiplier) {
+  CesiumLodImportanceIndex::Volume volume;
+  volume.shape = ECesiumLodImportanceVolumeShape::Box;
+  volume.screenSpaceErrorMultiplier = multiplier;
+  volume.transform = FTransform(location);
+  volume.boxExtent = FVector(extent, extent, extent);
+  return volume;
+}
+
+FBoxSphereBounds CreateBounds(const FVector& center, double radius) {
+  return FBoxSphereBounds(center, FVector(radius, radius, radius), radius);
+}
+
+END_DEFINE_SPEC(FCesiumLodImportanceIndexSpec)
+
+void FCesiumLodImportanceIndexSpec::Define() {
+  It("uses a multiplier of one without volumes", [this]() {
+    CesiumLodImportanceIndex index;
+    index.build({});
+    TestEqual(
+        "multiplier",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector::ZeroVector, 100.0)),
+        1.0);
+  });
+
+  It("applies a box to the tiles that intersect it", [this]() {
+    CesiumLodImportanceIndex index;
+    CesiumLodImportanceIndex::Volume box =
+        CreateBox(FVector::ZeroVector, 1000.0, 4.0);
+    box.transform.SetRotation(FRotator(0.0, 45.0, 0.0).Quaternion());
+    index.build({box});
+
+    TestEqual(
+        "inside",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector::ZeroVector, 10.0)),
+        4.0);
+    TestEqual(
+        "near a corner",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(1400.0, 0.0, 0.0), 100.0)),
+        4.0);
+    TestEqual(
+        "outside a corner",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(1000.0, 1000.0, 0.0), 100.0)),
+        1.0);
+  });
+
+  It("applies a sphere to the tiles that intersect it", [this]() {
+    CesiumLodImportanceIndex::Volume sphere;
+    sphere.shape = ECesiumLodImportanceVolumeShape::Sphere;
+    sphere.screenSpaceErrorMultiplier = 0.5;
+    sphere.transform = FTransform(FVector(0.0, 0.0, 5000.0));
+    sphere.sphereRadius = 1000.0;
+
+    CesiumLodImportanceIndex index;
+    index.build({sphere});
+    TestEqual(
+        "intersecting",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(0.0, 0.0, 3500.0), 600.0)),
+        0.5);
+    TestEqual(
+        "outside",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(0.0, 0.0, 3500.0), 400.0)),
+        1.0);
+  });
+
+  It("applies a polygon at any height", [this]() {
+    CesiumLodImportanceIndex::Volume polygon;
+    polygon.shape = ECesiumLodImportanceVolumeShape::Polygon;
+    polygon.screenSpaceErrorMultiplier = 3.0;
+    polygon.polygon = {
+        FVector2D(0.0, 0.0),
+        FVector2D(1000.0, 0.0),
+        FVector2D(0.0, 1000.0)};
+
+    CesiumLodImportanceIndex index;
+    index.build({polygon});
+    TestEqual(
+        "inside and high above",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(100.0, 100.0, 1.0e6), 1.0)),
+        3.0);
+    TestEqual(
+        "near an edge",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(600.0, 600.0, 0.0), 200.0)),
+        3.0);
+    TestEqual(
+        "outside",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(900.0, 900.0, 0.0), 100.0)),
+        1.0);
+  });
+
+  It("uses the highest multiplier where volumes overlap", [this]() {
+    CesiumLodImportanceIndex index;
+    index.build(
+        {CreateBox(FVector::ZeroVector, 1000.0, 0.5),
+         CreateBox(FVector(1500.0, 0.0, 0.0), 1000.0, 8.0),
+         CreateBox(FVector(-1500.0, 0.0, 0.0), 1000.0, 2.0)});
+    TestEqual(
+        "overlap",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(700.0, 0.0, 0.0), 10.0)),
+        8.0);
+    TestEqual(
+        "single",
+        index.getScreenSpaceErrorMultiplier(
+            CreateBounds(FVector(-2200.0, 0.0, 0.0), 10.0)),
+        2.0);
+  });
+
+  It("finds the same volumes as testing each one", [this]() {
+    FRandomStream random(42);
+    std::vector<CesiumLodImportanceIndex::Volume> volumes;
+    for (int32 i = 0; i < 500; ++i) {
+      volumes.emplace_back(CreateBox(
+          FVector(
+              random.FRandRange(-1.0e6, 1.0e6),
+              random.FRandRange(-1.0e6, 1.0e6),
+              random.FRandRange(-1.0e4, 1.0e4)),
+          random.FRandRange(1000.0, 20000.0),
+          random.FRandRange(1.5, 10.0)));
+    }
+
+    std::vector<CesiumLodImportanceIndex> singles(volumes.size());
+    for (size_t i = 0; i < volumes.size(); ++i) {
+      singles[i].build({volumes[i]});
+    }
+
+    CesiumLodImportanceIndex index;
+    index.build(std::vector<CesiumLodImportanceIndex::Volume>(volumes));
+
+    for (int32 i = 0; i < 200; ++i) {
+      const FBoxSphereBounds bounds = CreateBounds(
+          FVector(
+              random.FRandRange(-1.0e6, 1.0e6),
+              random.FRandRange(-1.0e6, 1.0e6),
+              0.0),
+          random.FRandRange(100.0, 50000.0));
+
+      // Every multiplier is greater than one, so the highest is expected.
+      double expected = 1.0;
+      for (const CesiumLodImportanceIndex& single : singles) {
+        expected = FMath::Max(
+            expected,
+            single.getScreenSpaceErrorMultiplier(bounds));
+      }
+
+      if (!TestEqual(
+              "multiplier",
+              index.getScreenSpaceErrorMultiplier(bounds),
+              expected)) {
+        break;
+      }
+    }
+  });
+}
@@ -0,0 +1,133 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumMemoryBudget.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(
+    FCesiumMemoryBudgetSpec,
+    "Cesium.Unit.MemoryBudget",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+const int64 GpuBudget = 1000;
+const double DeltaTime = 1.0 / 60.0;
+
+END_DEFINE_SPEC(FCesiumMemoryBudgetSpec)
+
+void FCesiumMemoryBudgetSpec::Define() {
+  Describe("distribute", [this]() {
+    It("returns nothing when there are no participants", [this]() {
+      std::vector<int64> result =
+          CesiumMemoryBudget::distribute(1000, 100, {});
+      TestTrue("result is empty", result.empty());
+    });
+
+    It("gives nothing when the budget is zero", [this]() {
+      std::vector<int64> result =
+          CesiumMemoryBudget::distribute(0, 100, {1.0, 2.0});
+      TestEqual("size", result.size(), size_t(2));
+      TestEqual("first", result[0], int64(0));
+      TestEqual("second", result[1], int64(0));
+    });
+
+    It("distributes the remainder in proportion to the weights", [this]() {
+      std::vector<int64> result =
+          CesiumMemoryBudget::distribute(1000, 100, {1.0, 3.0});
+      TestEqual("first", result[0], int64(100 + 200));
+      TestEqual("second", result[1], int64(100 + 600));
+    });
+
+    It("splits evenly when every weight is zero", [this]() {
+      std::vector<int64> result =
+          CesiumMemoryBudget::distribute(900, 0, {0.0, 0.0, 0.0});
+      TestEqual("first", result[0], int64(300));
+      TestEqual("second", result[1], int64(300));
+      TestEqual("third", result[2], int64(300));
+    });
+
+    It("limits the minimum to an equal share of the budget", [this]() {
+      std::vector<int64> result =
+          CesiumMemoryBudget::distribute(100, 1000, {1.0, 0.0});
+      TestEqual("first", result[0], int64(50));
+      TestEqual("second", result[1], int64(50));
+    });
+
+    It("never exceeds the budget", [this]() {
+      std::vector<int64> result =
+          CesiumMemoryBudget::distribute(1001, 7, {0.3, 1.7, 5.0, 0.0});
+      int64 total = 0;
+      for (int64 allocation : result) {
+        TestTrue("allocation is at least the minimum", allocation >= 7);
+        total += allocation;
+      }
+      TestTrue("total is within budget", total <= 1001);
+    });
+  });
+
+  Describe("updateGpuScale", [this]() {
+    It("does not scale without a GPU budget", [this]() {
+      TestEqual(
+          "scale",
+          CesiumMemoryBudget::updateGpuScale(0.5, 5000, 0, DeltaTime),
+          1.0);
+    });
+
+    It("shrinks gradually while over the GPU budget", [this]() {
+      const double scale =
+          CesiumMemoryBudget::updateGpuScale(1.0, 2000, GpuBudget, DeltaTime);
+      TestTrue("shrunk", scale < 1.0);
+      TestTrue("gradually", scale > 0.9);
+    });
+
+    It("holds the scale just under the GPU budget", [this]() {
+      TestEqual(
+          "scale",
+          CesiumMemoryBudget::updateGpuScale(0.5, 950, GpuBudget, DeltaTime),
+          0.5);
+    });
+
+    It("grows again well under the GPU budget, up to one", [this]() {
+      double scale = 0.5;
+      for (int32 i = 0; i < 600; ++i) {
+        scale = CesiumMemoryBudget::updateGpuScale(
+            scale,
+            100,
+            GpuBudget,
+            DeltaTime);
+      }
+      TestEqual("scale", scale, 1.0, 1e-3);
+    });
+
+    It("settles under the GPU budget without oscillating", [this]() {
+      // The GPU footprint is proportional to the scale, and would be twice
+      // the GPU budget without it.
+      const double unscaledBytes = 2.0 * double(GpuBudget);
+      double scale = 1.0;
+      int32 reversals = 0;
+      double previousChange = 0.0;
+      for (int32 i = 0; i < 1200; ++i) {
+        const int64 estimatedGpuBytes = int64(scale * unscaledBytes);
+        const double next = CesiumMemoryBudget::updateGpuScale(
+            scale,
+            estimatedGpuBytes,
+            GpuBudget,
+            DeltaTime);
+        const double change = next - scale;
+        if (change * previousChange < 0.0) {
+          ++reversals;
+        }
+        if (change != 0.0) {
+          previousChange = change;
+        }
+        scale = next;
+      }
+
+      const int64 estimatedGpuBytes = int64(scale * unscaledBytes);
+      TestTrue("within the GPU budget", estimatedGpuBytes <= GpuBudget);
+      TestTrue(
+          "close to the GPU budget",
+          double(estimatedGpuBytes) >= 0.9 * double(GpuBudget));
+      TestEqual("reversals", reversals, 0);
+    });
+  });
+}
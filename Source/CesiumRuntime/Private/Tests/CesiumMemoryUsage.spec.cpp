@@ -0,0 +1,56 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumMemoryUsage.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(
+    FCesiumMemoryUsageSpec,
+    "Cesium.Unit.MemoryUsage",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FCesiumMemoryUsageSpec)
+
+void FCesiumMemoryUsageSpec::Define() {
+  It("sums texture groups into the texture total", [this]() {
+    CesiumMemoryUsage usage;
+    usage.textureBytes[TEXTUREGROUP_World] = 100;
+    usage.textureBytes[TEXTUREGROUP_WorldNormalMap] = 20;
+    TestEqual("texture bytes", usage.getTextureBytes(), int64(120));
+  });
+
+  It("excludes collision and glTF bytes from the GPU total", [this]() {
+    CesiumMemoryUsage usage;
+    usage.vertexBufferBytes = 1;
+    usage.indexBufferBytes = 2;
+    usage.textureBytes[TEXTUREGROUP_World] = 4;
+    usage.metadataTextureBytes = 8;
+    usage.collisionBytes = 16;
+    usage.gltfBytes = 32;
+    TestEqual("GPU bytes", usage.getGpuBytes(), int64(15));
+  });
+
+  It("returns to zero after adding and removing the same usage", [this]() {
+    CesiumMemoryUsage gltf;
+    gltf.vertexBufferBytes = 10;
+    gltf.indexBufferBytes = 20;
+    gltf.textureBytes[TEXTUREGROUP_World] = 30;
+    gltf.metadataTextureBytes = 40;
+    gltf.collisionBytes = 50;
+    gltf.gltfBytes = 60;
+
+    CesiumMemoryUsage total;
+    total += gltf;
+    total += gltf;
+    TestEqual("vertex bytes", total.vertexBufferBytes, int64(20));
+    TestEqual("texture bytes", total.getTextureBytes(), int64(60));
+
+    total -= gltf;
+    total -= gltf;
+    TestEqual("vertex bytes", total.vertexBufferBytes, int64(0));
+    TestEqual("index bytes", total.indexBufferBytes, int64(0));
+    TestEqual("texture bytes", total.getTextureBytes(), int64(0));
+    TestEqual("metadata bytes", total.metadataTextureBytes, int64(0));
+    TestEqual("collision bytes", total.collisionBytes, int64(0));
+    TestEqual("glTF bytes", total.gltfBytes, int64(0));
+  });
+}
@@ -0,0 +1,367 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumAllocationCounter.h"
+#include "CesiumGltfComponent.h"
+#include "CesiumMeshBuildStage.h"
+#include "CesiumRuntime.h"
+#include "CesiumSyntheticTileset.h"
+#include "CreateGltfOptions.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include <CesiumGltfReader/GltfReader.h>
+#include <algorithm>
+#include <array>
+#include <glm/mat4x4.hpp>
+
+namespace {
+
+constexpr int32 StageCount = int32(CesiumMeshBuildStage::Count);
+
+struct StageMeasurement {
+  int64 calls = 0;
+  int64 cycles = 0;
+  int64 allocations = 0;
+  int64 allocatedBytes = 0;
+  int64 peakBytes = 0;
+
+  StageMeasurement& operator+=(const StageMeasurement& rhs) {
+    this->calls += rhs.calls;
+    this->cycles += rhs.cycles;
+    this->allocations += rhs.allocations;
+    this->allocatedBytes += rhs.allocatedBytes;
+    this->peakBytes = std::max(this->peakBytes, rhs.peakBytes);
+    return *this;
+  }
+};
+
+struct ModelMeasurement {
+  FString name;
+  int64 primitives = 0;
+  int64 vertices = 0;
+  StageMeasurement total;
+  std::array<StageMeasurement, StageCount> stages;
+
+  ModelMeasurement& operator+=(const ModelMeasurement& rhs) {
+    this->primitives += rhs.primitives;
+    this->vertices += rhs.vertices;
+    this->total += rhs.total;
+    for (int32 i = 0; i < StageCount; ++i) {
+      this->stages[i] += rhs.stages[i];
+    }
+    return *this;
+  }
+};
+
+/**
+ * Times each stage and attributes the current thread's allocations to it.
+ */
+class MeshBuildRecorder : public ICesiumMeshBuildObserver {
+public:
+  explicit MeshBuildRecorder(ModelMeasurement& measurement)
+      : _measurement(measurement) {}
+
+  virtual void onPrimitive(int64 vertexCount) override {
+    ++this->_measurement.primitives;
+    this->_measurement.vertices += vertexCount;
+  }
+
+  virtual void onStageBegin(CesiumMeshBuildStage stage) override {
+    this->_stageCounters = CesiumAllocationCounter::Counters();
+    CesiumAllocationCounter::setCurrent(&this->_stageCounters);
+    this->_stageStart = FPlatformTime::Cycles64();
+  }
+
+  virtual void onStageEnd(CesiumMeshBuildStage stage) override {
+    const uint64 end = FPlatformTime::Cycles64();
+    CesiumAllocationCounter::setCurrent(&this->_modelCounters);
+
+    StageMeasurement& measurement = this->_measurement.stages[int32(stage)];
+    ++measurement.calls;
+    measurement.cycles += int64(end - this->_stageStart);
+    measurement.allocations += this->_stageCounters.allocations;
+    measurement.allocatedBytes += this->_stageCounters.allocatedBytes;
+    measurement.peakBytes =
+        std::max(measurement.peakBytes, this->_stageCounters.peakLiveBytes);
+
+    // Fold the stage's allocations into the whole-model counters, so that
+    // the model's peak includes memory that is still live from this stage.
+    this->_modelCounters.allocations += this->_stageCounters.allocations;
+    this->_modelCounters.allocatedBytes += this->_stageCounters.allocatedBytes;
+    this->_modelCounters.peakLiveBytes = std::max(
+        this->_modelCounters.peakLiveBytes,
+        this->_modelCounters.liveBytes + this->_stageCounters.peakLiveBytes);
+    this->_modelCounters.liveBytes += this->_stageCounters.liveBytes;
+  }
+
+  void begin() {
+    this->_modelCounters = CesiumAllocationCounter::Counters();
+    CesiumAllocationCounter::setCurrent(&this->_modelCounters);
+    this->_previousObserver = ICesiumMeshBuildObserver::setCurrent(this);
+    this->_modelStart = FPlatformTime::Cycles64();
+  }
+
+  void end() {
+    const uint64 end = FPlatformTime::Cycles64();
+    ICesiumMeshBuildObserver::setCurrent(this->_previousObserver);
+    CesiumAllocationCounter::setCurrent(nullptr);
+
+    StageMeasurement& total = this->_measurement.total;
+    ++total.calls;
+    total.cycles += int64(end - this->_modelStart);
+    total.allocations += this->_modelCounters.allocations;
+    total.allocatedBytes += this->_modelCounters.allocatedBytes;
+    total.peakBytes =
+        std::max(total.peakBytes, this->_modelCounters.peakLiveBytes);
+  }
+
+private:
+  ModelMeasurement& _measurement;
+  ICesiumMeshBuildObserver* _previousObserver = nullptr;
+  CesiumAllocationCounter::Counters _modelCounters;
+  CesiumAllocationCounter::Counters _stageCounters;
+  uint64 _modelStart = 0;
+  uint64 _stageStart = 0;
+};
+
+/**
+ * Formats a stage's measurements. Everything but the time per vertex and the
+ * peak is reported per iteration; the peak is the largest of any call.
+ */
+FString formatStage(
+    const StageMeasurement& stage,
+    int64 vertices,
+    int32 iterations) {
+  const double nanoseconds =
+      FPlatformTime::ToSeconds64(uint64(stage.cycles)) * 1.0e9;
+  return FString::Printf(
+      TEXT(
+          "{ \"calls\": %lld, \"ms\": %.3f, \"nsPerVertex\": %.3f, \"allocations\": %lld, \"allocatedBytes\": %lld, \"peakBytes\": %lld }"),
+      stage.calls / iterations,
+      nanoseconds / 1.0e6 / iterations,
+      vertices > 0 ? nanoseconds / double(vertices) : 0.0,
+      stage.allocations / iterations,
+      stage.allocatedBytes / iterations,
+      stage.peakBytes);
+}
+
+FString formatModel(
+    const ModelMeasurement& model,
+    const FString& indent,
+    int32 iterations) {
+  FString json = indent + TEXT("{\n");
+  json += FString::Printf(
+      TEXT("%s  \"name\": \"%s\",\n"),
+      *indent,
+      *model.name.ReplaceCharWithEscapedChar());
+  json += FString::Printf(
+      TEXT("%s  \"primitives\": %lld,\n"),
+      *indent,
+      model.primitives / iterations);
+  json += FString::Printf(
+      TEXT("%s  \"vertices\": %lld,\n"),
+      *indent,
+      model.vertices / iterations);
+  json += FString::Printf(
+      TEXT("%s  \"total\": %s,\n"),
+      *indent,
+      *formatStage(model.total, model.vertices, iterations));
+  json += FString::Printf(TEXT("%s  \"stages\": {\n"), *indent);
+  for (int32 i = 0; i < StageCount; ++i) {
+    json += FString::Printf(
+        TEXT("%s    \"%s\": %s%s\n"),
+        *indent,
+        getMeshBuildStageName(CesiumMeshBuildStage(i)),
+        *formatStage(model.stages[i], model.vertices, iterations),
+        i + 1 < StageCount ? TEXT(",") : TEXT(""));
+  }
+  json += FString::Printf(TEXT("%s  }\n%s}"), *indent, *indent);
+  return json;
+}
+
+/**
+ * Generates a small corpus from the synthetic tileset generator: terrain
+ * patches of increasing size, with and without normals, so that both the
+ * copy and the flat-normal paths are exercised.
+ */
+TArray<FString> generateCorpus(const FString& directory) {
+  TArray<FString> filenames;
+  for (int32 triangles : {2048, 32768, 131072}) {
+    for (bool includeNormals : {true, false}) {
+      Cesium::SyntheticTilesetOptions options;
+      options.maximumDepth = 0;
+      options.trianglesPerTile = triangles;
+      options.includeNormals = includeNormals;
+      options.textureSize = 0;
+
+      const FString subdirectory = FPaths::Combine(
+          directory,
+          FString::Printf(
+              TEXT("Terrain%d%s"),
+              triangles,
+              includeNormals ? TEXT("") : TEXT("NoNormals")));
+      Cesium::SyntheticTilesetResult result =
+          Cesium::generateSyntheticTileset(subdirectory, options);
+      if (!result.tilesetUrl.IsEmpty()) {
+        filenames.Add(
+            FPaths::Combine(subdirectory, TEXT("content"), TEXT("0_0_0.glb")));
+      }
+    }
+  }
+  return filenames;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+    FCesiumMeshBuildBenchmark,
+    "Cesium.Performance.MeshBuildBenchmark",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::PerfFilter)
+
+bool FCesiumMeshBuildBenchmark::RunTest(const FString& Parameters) {
+  // The corpus is a directory of .glb and self-contained .gltf files, given
+  // with -CesiumMeshBenchmarkCorpus=<directory>. Without it, a synthetic
+  // corpus is generated. -CesiumMeshBenchmarkIterations=<n> sets how many
+  // times each model is built, and -CesiumBenchmarkOutput=<directory> where
+  // the JSON is written. Allocations are only counted when the engine is
+  // started with -CesiumCountAllocations.
+  FString corpusDirectory;
+  int32 iterations = 5;
+  FString outputDirectory = FPaths::Combine(
+      FPaths::ProjectSavedDir(),
+      TEXT("Cesium"),
+      TEXT("Benchmarks"));
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumMeshBenchmarkCorpus="),
+      corpusDirectory);
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumMeshBenchmarkIterations="),
+      iterations);
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkOutput="),
+      outputDirectory);
+  iterations = std::max(1, iterations);
+
+  TArray<FString> filenames;
+  if (corpusDirectory.IsEmpty()) {
+    filenames = generateCorpus(FPaths::Combine(
+        FPaths::ProjectSavedDir(),
+        TEXT("Cesium"),
+        TEXT("Benchmarks"),
+        TEXT("MeshBuildCorpus")));
+  } else {
+    IFileManager::Get().FindFilesRecursive(
+        filenames,
+        *corpusDirectory,
+        TEXT("*.glb"),
+        true,
+        false);
+    IFileManager::Get().FindFilesRecursive(
+        filenames,
+        *corpusDirectory,
+        TEXT("*.gltf"),
+        true,
+        false,
+        false);
+  }
+  filenames.Sort();
+
+  if (filenames.Num() == 0) {
+    AddError(TEXT("The mesh build benchmark corpus is empty."));
+    return false;
+  }
+
+  CesiumGltfReader::GltfReader reader;
+  TArray<ModelMeasurement> measurements;
+  ModelMeasurement total;
+  total.name = TEXT("Total");
+
+  for (const FString& filename : filenames) {
+    TArray<uint8> data;
+    if (!FFileHelper::LoadFileToArray(data, *filename)) {
+      AddWarning(FString::Printf(TEXT("Could not read %s"), *filename));
+      continue;
+    }
+
+    CesiumGltfReader::GltfReaderResult readResult = reader.readGltf(
+        gsl::span<const std::byte>(
+            reinterpret_cast<const std::byte*>(data.GetData()),
+            data.Num()));
+    if (!readResult.model) {
+      AddWarning(FString::Printf(TEXT("Could not parse %s"), *filename));
+      continue;
+    }
+
+    ModelMeasurement& measurement = measurements.Emplace_GetRef();
+    measurement.name = FPaths::ConvertRelativePathToFull(filename);
+    if (!corpusDirectory.IsEmpty()) {
+      FPaths::MakePathRelativeTo(
+          measurement.name,
+          *(FPaths::ConvertRelativePathToFull(corpusDirectory) + TEXT("/")));
+    }
+
+    for (int32 i = 0; i < iterations; ++i) {
+      // Building may modify the model, so each iteration gets a fresh copy.
+      CesiumGltf::Model model = *readResult.model;
+
+      CreateGltfOptions::CreateModelOptions options;
+      options.pModel = &model;
+      options.alwaysIncludeTangents = true;
+      options.createPhysicsMeshes = true;
+
+      MeshBuildRecorder recorder(measurement);
+      recorder.begin();
+      TUniquePtr<UCesiumGltfComponent::HalfConstructed> pHalf =
+          UCesiumGltfComponent::CreateOffGameThread(glm::dmat4(1.0), options);
+      recorder.end();
+    }
+
+    total += measurement;
+  }
+
+  FString json = TEXT("{\n");
+  json += TEXT("  \"version\": 1,\n");
+  json += FString::Printf(TEXT("  \"iterations\": %d,\n"), iterations);
+  json += FString::Printf(
+      TEXT("  \"allocationsCounted\": %s,\n"),
+      CesiumAllocationCounter::isInstalled() ? TEXT("true") : TEXT("false"));
+  json += FString::Printf(
+      TEXT("  \"total\":\n%s,\n"),
+      *formatModel(total, TEXT("  "), iterations));
+  json += TEXT("  \"models\": [\n");
+  for (int32 i = 0; i < measurements.Num(); ++i) {
+    json += formatModel(measurements[i], TEXT("    "), iterations);
+    json += i + 1 < measurements.Num() ? TEXT(",\n") : TEXT("\n");
+  }
+  json += TEXT("  ]\n}\n");
+
+  const FString outputFilename =
+      FPaths::Combine(outputDirectory, TEXT("MeshBuildBenchmark.json"));
+  if (!FFileHelper::SaveStringToFile(json, *outputFilename)) {
+    AddError(FString::Printf(TEXT("Could not write %s"), *outputFilename));
+    return false;
+  }
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Mesh build benchmark of %d models written to %s"),
+      measurements.Num(),
+      *outputFilename);
+
+  if (!CesiumAllocationCounter::isInstalled()) {
+    AddInfo(TEXT("Allocations were not counted. Start the engine with "
+                 "-CesiumCountAllocations to count them."));
+  }
+
+  TestTrue("built at least one primitive", total.primitives > 0);
+  return true;
+}
@@ -0,0 +1,117 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumMeshBuildStage.h"
+#include "CesiumGltfComponent.h"
+#include "CesiumGltfSpecUtility.h"
+#include "CreateGltfOptions.h"
+#include "Misc/AutomationTest.h"
+#include <array>
+#include <glm/mat4x4.hpp>
+
+using namespace CesiumGltf;
+
+namespace {
+
+class CountingObserver : public ICesiumMeshBuildObserver {
+public:
+  int64 primitives = 0;
+  int64 vertices = 0;
+  std::array<int32, size_t(CesiumMeshBuildStage::Count)> begins{};
+  std::array<int32, size_t(CesiumMeshBuildStage::Count)> ends{};
+
+  virtual void onPrimitive(int64 vertexCount) override {
+    ++this->primitives;
+    this->vertices += vertexCount;
+  }
+
+  virtual void onStageBegin(CesiumMeshBuildStage stage) override {
+    ++this->begins[size_t(stage)];
+  }
+
+  virtual void onStageEnd(CesiumMeshBuildStage stage) override {
+    ++this->ends[size_t(stage)];
+  }
+};
+
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+    FCesiumMeshBuildStageSpec,
+    "Cesium.Unit.MeshBuildStage",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+Model model;
+END_DEFINE_SPEC(FCesiumMeshBuildStageSpec)
+
+void FCesiumMeshBuildStageSpec::Define() {
+  BeforeEach([this]() {
+    model = Model();
+    Mesh& mesh = model.meshes.emplace_back();
+    MeshPrimitive& primitive = mesh.primitives.emplace_back();
+    primitive.mode = MeshPrimitive::Mode::TRIANGLES;
+
+    std::vector<glm::vec3> positions{
+        glm::vec3(0, 0, 0),
+        glm::vec3(1, 0, 0),
+        glm::vec3(0, 1, 0),
+        glm::vec3(1, 1, 0)};
+    CreateAttributeForPrimitive(
+        model,
+        primitive,
+        "POSITION",
+        AccessorSpec::Type::VEC3,
+        AccessorSpec::ComponentType::FLOAT,
+        positions);
+
+    std::vector<uint16_t> indices{0, 1, 2, 2, 1, 3};
+    CreateIndicesForPrimitive(
+        model,
+        primitive,
+        AccessorSpec::ComponentType::UNSIGNED_SHORT,
+        indices);
+
+    Node& node = model.nodes.emplace_back();
+    node.mesh = 0;
+    Scene& scene = model.scenes.emplace_back();
+    scene.nodes.push_back(0);
+    model.scene = 0;
+  });
+
+  It("has no observer by default", [this]() {
+    TestNull("observer", ICesiumMeshBuildObserver::getCurrent());
+  });
+
+  It("notifies the current thread's observer of each stage", [this]() {
+    CountingObserver observer;
+    ICesiumMeshBuildObserver* pPrevious =
+        ICesiumMeshBuildObserver::setCurrent(&observer);
+
+    CreateGltfOptions::CreateModelOptions options;
+    options.pModel = &model;
+    options.createPhysicsMeshes = false;
+    TUniquePtr<UCesiumGltfComponent::HalfConstructed> pHalf =
+        UCesiumGltfComponent::CreateOffGameThread(glm::dmat4(1.0), options);
+
+    ICesiumMeshBuildObserver::setCurrent(pPrevious);
+
+    TestEqual("primitives", observer.primitives, int64(1));
+    TestEqual("vertices", observer.vertices, int64(4));
+
+    for (size_t i = 0; i < observer.begins.size(); ++i) {
+      TestEqual("balanced", observer.begins[i], observer.ends[i]);
+    }
+
+    auto count = [&observer](CesiumMeshBuildStage stage) {
+      return observer.ends[size_t(stage)];
+    };
+    TestEqual("CopyIndices", count(CesiumMeshBuildStage::CopyIndices), 1);
+    TestEqual("CopyPositions", count(CesiumMeshBuildStage::CopyPositions), 1);
+    // There are no normals, so flat normals must be computed.
+    TestEqual(
+        "ComputeFlatNormals",
+        count(CesiumMeshBuildStage::ComputeFlatNormals),
+        1);
+    TestEqual("InitBuffers", count(CesiumMeshBuildStage::InitBuffers), 1);
+    TestEqual("ChaosCook", count(CesiumMeshBuildStage::ChaosCook), 0);
+  });
+}
@@ -0,0 +1,103 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumRegionPackager.h"
+#include "Cesium3DTileset.h"
+#include "CesiumCartographicPolygon.h"
+#include "CesiumGeoreference.h"
+#include "CesiumSyntheticTileset.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+using namespace Cesium;
+
+BEGIN_DEFINE_SPEC(
+    FCesiumRegionPackagerSpec,
+    "Cesium.Unit.RegionPackager",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+FString Directory;
+SyntheticTilesetOptions Options;
+UWorld* pWorld;
+ACesium3DTileset* pTileset;
+ACesiumCartographicPolygon* pRegion;
+
+CesiumRegionPackager::Result Package(const FString& archiveName) {
+  CesiumRegionPackager::Options options;
+  options.maximumScreenSpaceError = 16.0;
+  options.viewHeight = 100.0;
+  options.batchTimeoutSeconds = 60.0;
+  options.archiveDirectory = FPaths::Combine(Directory, archiveName);
+  return CesiumRegionPackager::package(*pRegion, {pTileset}, options);
+}
+
+END_DEFINE_SPEC(FCesiumRegionPackagerSpec)
+
+void FCesiumRegionPackagerSpec::Define() {
+  BeforeEach([this]() {
+    Directory = FPaths::ConvertRelativePathToFull(FPaths::Combine(
+        FPaths::ProjectSavedDir(),
+        TEXT("Cesium"),
+        TEXT("Tests"),
+        TEXT("RegionPackager")));
+    Options = SyntheticTilesetOptions();
+    Options.extentMeters = 2000.0;
+    Options.maximumDepth = 3;
+    Options.trianglesPerTile = 32;
+    Options.textureSize = 0;
+    const SyntheticTilesetResult tileset = generateSyntheticTileset(
+        FPaths::Combine(Directory, TEXT("Tileset")),
+        Options);
+
+    pWorld = UWorld::CreateWorld(
+        EWorldType::Game,
+        false,
+        FName(TEXT("CesiumRegionPackagerSpec")));
+    GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(pWorld);
+    pWorld->InitializeActorsForPlay(FURL());
+    pWorld->BeginPlay();
+
+    ACesiumGeoreference::GetDefaultGeoreference(pWorld)
+        ->SetOriginLongitudeLatitudeHeight(Options.longitudeLatitudeHeight);
+    pTileset = pWorld->SpawnActor<ACesium3DTileset>();
+    pTileset->SetTilesetSource(ETilesetSource::FromUrl);
+    pTileset->SetUrl(tileset.tilesetUrl);
+
+    // The polygon's default spline is a square 200 meters across.
+    pRegion = pWorld->SpawnActor<ACesiumCartographicPolygon>();
+  });
+
+  AfterEach([this]() {
+    pRegion->Destroy();
+    pTileset->Destroy();
+    GEngine->DestroyWorldContext(pWorld);
+    pWorld->DestroyWorld(false);
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+  });
+
+  It("packages with its own screen-space error", [this]() {
+    const CesiumRegionPackager::Result expected = Package(TEXT("Expected"));
+    TestTrue("views", expected.views > 0);
+    TestTrue("tiles selected", expected.tilesSelected > 0);
+    TestEqual("failed requests", expected.failedRequests, int64(0));
+
+    // An adaptive screen-space error this high only selects the root tile.
+    pTileset->AdaptiveScreenSpaceError.Enabled = true;
+    pTileset->AdaptiveScreenSpaceError.MinimumScreenSpaceError = 1000.0;
+    pTileset->AdaptiveScreenSpaceError.MaximumScreenSpaceError = 1000.0;
+    pWorld->Tick(LEVELTICK_All, 1.0f / 60.0f);
+    TestEqual(
+        "adaptive screen-space error",
+        pTileset->GetEffectiveMaximumScreenSpaceError(),
+        1000.0);
+
+    const CesiumRegionPackager::Result actual = Package(TEXT("Adaptive"));
+    TestEqual("views", actual.views, expected.views);
+    TestEqual("tiles selected", actual.tilesSelected, expected.tilesSelected);
+    TestEqual("requests", actual.requests, expected.requests);
+    TestEqual("bytes", actual.bytes, expected.bytes);
+  });
+}
@@ -0,0 +1,127 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "Cesium3DTileset.h"
+#include "CesiumGeoreference.h"
+#include "CesiumGltfComponent.h"
+#include "CesiumSyntheticTileset.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+using namespace Cesium;
+
+BEGIN_DEFINE_SPEC(
+    FCesiumRegionPreloadSpec,
+    "Cesium.Unit.RegionPreload",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+FString Directory;
+SyntheticTilesetOptions Options;
+UWorld* pWorld;
+ACesium3DTileset* pTileset;
+
+/**
+ * Ticks the world, without any camera, until the future is ready or the
+ * frames run out.
+ */
+void TickUntilReady(const TFuture<bool>& future, int32 maximumFrames) {
+  for (int32 i = 0; i < maximumFrames && !future.IsReady(); ++i) {
+    pWorld->Tick(LEVELTICK_All, 1.0f / 60.0f);
+    FTaskGraphInterface::Get().ProcessThreadUntilIdle(
+        ENamedThreads::GameThread);
+    FPlatformProcess::Sleep(0.001f);
+  }
+}
+
+END_DEFINE_SPEC(FCesiumRegionPreloadSpec)
+
+void FCesiumRegionPreloadSpec::Define() {
+  BeforeEach([this]() {
+    Directory = FPaths::ConvertRelativePathToFull(FPaths::Combine(
+        FPaths::ProjectSavedDir(),
+        TEXT("Cesium"),
+        TEXT("Tests"),
+        TEXT("RegionPreload")));
+    Options = SyntheticTilesetOptions();
+    Options.extentMeters = 2000.0;
+    Options.maximumDepth = 2;
+    Options.trianglesPerTile = 32;
+    Options.textureSize = 0;
+    const SyntheticTilesetResult tileset =
+        generateSyntheticTileset(Directory, Options);
+
+    pWorld = UWorld::CreateWorld(
+        EWorldType::Game,
+        false,
+        FName(TEXT("CesiumRegionPreloadSpec")));
+    GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(pWorld);
+    pWorld->InitializeActorsForPlay(FURL());
+    pWorld->BeginPlay();
+
+    ACesiumGeoreference::GetDefaultGeoreference(pWorld)
+        ->SetOriginLongitudeLatitudeHeight(Options.longitudeLatitudeHeight);
+    pTileset = pWorld->SpawnActor<ACesium3DTileset>();
+    pTileset->SetTilesetSource(ETilesetSource::FromUrl);
+    pTileset->SetUrl(tileset.tilesetUrl);
+  });
+
+  AfterEach([this]() {
+    pTileset->Destroy();
+    GEngine->DestroyWorldContext(pWorld);
+    pWorld->DestroyWorld(false);
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+  });
+
+  It("loads the region's tiles without showing them", [this]() {
+    TArray<float> progress;
+    TFuture<bool> future = pTileset->PreloadRegion(
+        Options.longitudeLatitudeHeight,
+        500.0,
+        16.0,
+        200.0,
+        [&progress](float value) { progress.Add(value); });
+    TestEqual("started", pTileset->GetRegionPreloadProgress(), 0.0f);
+
+    TickUntilReady(future, 2000);
+    if (!TestTrue("ready", future.IsReady())) {
+      return;
+    }
+    TestTrue("succeeded", future.Get());
+    TestEqual("finished", pTileset->GetRegionPreloadProgress(), -1.0f);
+    if (TestTrue("progress reported", progress.Num() > 0)) {
+      TestEqual("progress complete", progress.Last(), 1.0f);
+    }
+
+    TArray<UCesiumGltfComponent*> gltfComponents;
+    pTileset->GetComponents<UCesiumGltfComponent>(gltfComponents);
+    TestTrue("tiles loaded", gltfComponents.Num() > 0);
+    for (UCesiumGltfComponent* pGltf : gltfComponents) {
+      TestFalse("tile shown", pGltf->IsVisible());
+    }
+  });
+
+  It("fails when canceled", [this]() {
+    TFuture<bool> future =
+        pTileset->PreloadRegion(Options.longitudeLatitudeHeight, 500.0, 16.0);
+    pTileset->CancelRegionPreload();
+
+    TickUntilReady(future, 10);
+    if (TestTrue("ready", future.IsReady())) {
+      TestFalse("succeeded", future.Get());
+    }
+  });
+
+  It("fails a region with no views", [this]() {
+    TFuture<bool> future =
+        pTileset->PreloadRegion(Options.longitudeLatitudeHeight, 0.0, 16.0);
+
+    TickUntilReady(future, 10);
+    if (TestTrue("ready", future.IsReady())) {
+      TestFalse("succeeded", future.Get());
+    }
+  });
+}
@@ -0,0 +1,84 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumRequestPolicy.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(
+    FCesiumRequestPolicySpec,
+    "Cesium.Unit.RequestPolicy",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FCesiumRequestPolicySpec)
+
+void FCesiumRequestPolicySpec::Define() {
+  It("retries only failures that may be transient", [this]() {
+    TestTrue(
+        "connection failure",
+        CesiumRequestPolicy::isTransientFailure(false, 0));
+    TestTrue("503", CesiumRequestPolicy::isTransientFailure(true, 503));
+    TestTrue("429", CesiumRequestPolicy::isTransientFailure(true, 429));
+    TestFalse("200", CesiumRequestPolicy::isTransientFailure(true, 200));
+    TestFalse("404", CesiumRequestPolicy::isTransientFailure(true, 404));
+  });
+
+  It("doubles the limit of the retry delay up to the maximum", [this]() {
+    CesiumRequestPolicy policy;
+    policy.retryBaseDelaySeconds = 0.25;
+    policy.retryMaximumDelaySeconds = 1.0;
+
+    TestEqual("first", policy.getRetryDelay(1, 1.0, 0.0), 0.25);
+    TestEqual("second", policy.getRetryDelay(2, 1.0, 0.0), 0.5);
+    TestEqual("third", policy.getRetryDelay(3, 1.0, 0.0), 1.0);
+    TestEqual("tenth", policy.getRetryDelay(10, 1.0, 0.0), 1.0);
+    TestEqual("jittered", policy.getRetryDelay(2, 0.5, 0.0), 0.25);
+    TestEqual("no delay", policy.getRetryDelay(1, 0.0, 0.0), 0.0);
+  });
+
+  It("honors the server's delay up to the maximum", [this]() {
+    CesiumRequestPolicy policy;
+    policy.retryBaseDelaySeconds = 0.25;
+    policy.retryMaximumDelaySeconds = 1.0;
+
+    TestEqual("longer", policy.getRetryDelay(1, 0.5, 0.75), 0.75);
+    TestEqual("shorter", policy.getRetryDelay(1, 1.0, 0.1), 0.25);
+    TestEqual("too long", policy.getRetryDelay(1, 0.5, 30.0), 1.0);
+  });
+
+  It("derives percentiles only from enough responses", [this]() {
+    CesiumResponseTimes responseTimes;
+    for (size_t i = 1; i < CesiumResponseTimes::MinimumSamples; ++i) {
+      responseTimes.record("https://a.com/" + std::to_string(i), 0.5);
+    }
+    TestFalse(
+        "too few",
+        responseTimes.getPercentile("https://a.com/x", 95.0).has_value());
+
+    responseTimes.record("https://a.com/last", 0.5);
+    TestEqual(
+        "enough",
+        responseTimes.getPercentile("https://a.com/x", 95.0).value_or(0.0),
+        0.5);
+    TestFalse(
+        "other host",
+        responseTimes.getPercentile("https://b.com/x", 95.0).has_value());
+  });
+
+  It("computes percentiles of the most recent responses", [this]() {
+    CesiumResponseTimes responseTimes;
+    for (int32 i = 1; i <= 100; ++i) {
+      responseTimes.record("https://a.com/", i / 1000.0);
+    }
+    TestEqual(
+        "p95",
+        responseTimes.getPercentile("https://a.com/", 95.0).value_or(0.0),
+        0.095);
+
+    for (size_t i = 0; i < CesiumResponseTimes::MaximumSamples; ++i) {
+      responseTimes.record("https://a.com/", 0.001);
+    }
+    TestEqual(
+        "p100",
+        responseTimes.getPercentile("https://a.com/", 100.0).value_or(0.0),
+        0.001);
+  });
+}
@@ -0,0 +1,323 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumRequestScheduler.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "CoalescingAssetAccessor.h"
+#include "Misc/AutomationTest.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+class FakeRequest : public CesiumAsync::IAssetRequest,
+                    public CesiumAsync::IAssetResponse {
+public:
+  explicit FakeRequest(const std::string& url) : _url(url) {}
+
+  virtual const std::string& method() const override { return this->_method; }
+  virtual const std::string& url() const override { return this->_url; }
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+  virtual const CesiumAsync::IAssetResponse* response() const override {
+    return this;
+  }
+  virtual uint16_t statusCode() const override { return 200; }
+  virtual std::string contentType() const override { return std::string(); }
+  virtual gsl::span<const std::byte> data() const override {
+    return gsl::span<const std::byte>();
+  }
+
+private:
+  std::string _method = "GET";
+  std::string _url;
+  CesiumAsync::HttpHeaders _headers;
+};
+
+/**
+ * An asset accessor that submits its requests to a scheduler, as
+ * UnrealAssetAccessor does, and records which ones the scheduler sends.
+ * Sent requests complete only when `complete` is called.
+ */
+class ScheduledAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  explicit ScheduledAssetAccessor(
+      const std::shared_ptr<CesiumRequestScheduler>& pScheduler)
+      : pScheduler(pScheduler) {}
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    auto promise = asyncSystem
+                       .createPromise<
+                           std::shared_ptr<CesiumAsync::IAssetRequest>>();
+    this->promises.emplace(url, promise);
+    this->pScheduler->submit(
+        url,
+        [this, url]() { this->sent.push_back(url); },
+        [promise]() { promise.reject(std::runtime_error("Canceled")); });
+    return promise.getFuture();
+  }
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  virtual void tick() noexcept override {}
+
+  /** Completes a sent request that downloaded the given number of bytes. */
+  void complete(const std::string& url, int64 bytes) {
+    auto it = this->promises.find(url);
+    if (it != this->promises.end()) {
+      this->pScheduler->complete(url, bytes);
+      it->second.resolve(std::make_shared<FakeRequest>(url));
+      this->promises.erase(it);
+    }
+  }
+
+  std::shared_ptr<CesiumRequestScheduler> pScheduler;
+  std::vector<std::string> sent;
+  std::unordered_map<
+      std::string,
+      CesiumAsync::Promise<std::shared_ptr<CesiumAsync::IAssetRequest>>>
+      promises;
+};
+
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+    FCesiumRequestSchedulerSpec,
+    "Cesium.Unit.RequestScheduler",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+int32 MaximumRequestsPerHost;
+uint64 Frame;
+std::shared_ptr<CesiumRequestScheduler> pScheduler;
+std::shared_ptr<ScheduledAssetAccessor> pScheduled;
+
+/**
+ * Requests the given URL through the given accessor, and records whether it
+ * was canceled.
+ */
+void Get(
+    const std::shared_ptr<CesiumAsync::IAssetAccessor>& pAccessor,
+    const std::string& url,
+    std::vector<std::string>* pCanceled = nullptr) {
+  pAccessor->get(getAsyncSystem(), url, {})
+      .thenImmediately([](std::shared_ptr<CesiumAsync::IAssetRequest>&&) {})
+      .catchImmediately([pCanceled, url](std::exception&&) {
+        if (pCanceled) {
+          pCanceled->push_back(url);
+        }
+      });
+}
+
+END_DEFINE_SPEC(FCesiumRequestSchedulerSpec)
+
+void FCesiumRequestSchedulerSpec::Define() {
+  BeforeEach([this]() {
+    MaximumRequestsPerHost = 2;
+    Frame = 1;
+    pScheduler = std::make_shared<CesiumRequestScheduler>(
+        [this]() { return MaximumRequestsPerHost; },
+        [this]() { return Frame; });
+    pScheduled = std::make_shared<ScheduledAssetAccessor>(pScheduler);
+  });
+
+  AfterEach([this]() {
+    pScheduled.reset();
+    pScheduler.reset();
+  });
+
+  It("limits the requests in flight to each host", [this]() {
+    Get(pScheduled, "https://a.com/1");
+    Get(pScheduled, "https://a.com/2");
+    Get(pScheduled, "https://a.com/3");
+    Get(pScheduled, "https://b.com/1");
+
+    TestEqual("sent", pScheduled->sent.size(), size_t(3));
+    TestEqual("queued", pScheduler->getStatistics().queued, int64(1));
+    TestEqual("in flight", pScheduler->getStatistics().inFlight, int64(3));
+
+    pScheduled->complete("https://a.com/1", 100);
+    TestEqual("sent after completion", pScheduled->sent.size(), size_t(4));
+    TestEqual(
+        "last sent",
+        pScheduled->sent.back(),
+        std::string("https://a.com/3"));
+    TestEqual("queued", pScheduler->getStatistics().queued, int64(0));
+  });
+
+  It("sends no more than the limit after it is lowered", [this]() {
+    MaximumRequestsPerHost = 0;
+    for (int32 i = 0; i < 4; ++i) {
+      Get(pScheduled, "https://a.com/" + std::to_string(i));
+    }
+    TestEqual("unlimited", pScheduled->sent.size(), size_t(4));
+
+    MaximumRequestsPerHost = 1;
+    Get(pScheduled, "https://a.com/4");
+    pScheduled->complete("https://a.com/0", 0);
+    TestEqual("still over the limit", pScheduled->sent.size(), size_t(4));
+  });
+
+  It("sends the requests of the latest frame first", [this]() {
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pGroup =
+        pScheduler->createGroupAssetAccessor(
+            pScheduled,
+            pScheduler->createGroup());
+
+    Get(pGroup, "https://a.com/busy1");
+    Get(pGroup, "https://a.com/busy2");
+    Get(pGroup, "https://a.com/old1");
+    Get(pGroup, "https://a.com/old2");
+    Frame = 2;
+    Get(pGroup, "https://a.com/new1");
+    Get(pGroup, "https://a.com/new2");
+
+    pScheduled->complete("https://a.com/busy1", 0);
+    pScheduled->complete("https://a.com/busy2", 0);
+    pScheduled->complete("https://a.com/new1", 0);
+    pScheduled->complete("https://a.com/new2", 0);
+
+    const std::vector<std::string> expected{
+        "https://a.com/busy1",
+        "https://a.com/busy2",
+        "https://a.com/new1",
+        "https://a.com/new2",
+        "https://a.com/old1",
+        "https://a.com/old2"};
+    TestTrue("order", pScheduled->sent == expected);
+  });
+
+  It("sends a request again made in a later frame first", [this]() {
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pGroup =
+        pScheduler->createGroupAssetAccessor(
+            std::make_shared<CoalescingAssetAccessor>(pScheduled),
+            pScheduler->createGroup());
+
+    Get(pGroup, "https://a.com/busy1");
+    Get(pGroup, "https://a.com/busy2");
+    Get(pGroup, "https://a.com/old1");
+    Get(pGroup, "https://a.com/old2");
+    Frame = 2;
+    Get(pGroup, "https://a.com/new1");
+    Frame = 3;
+    Get(pGroup, "https://a.com/old2");
+
+    pScheduled->complete("https://a.com/busy1", 0);
+    pScheduled->complete("https://a.com/busy2", 0);
+    pScheduled->complete("https://a.com/old2", 0);
+
+    const std::vector<std::string> expected{
+        "https://a.com/busy1",
+        "https://a.com/busy2",
+        "https://a.com/old2",
+        "https://a.com/new1",
+        "https://a.com/old1"};
+    TestTrue("order", pScheduled->sent == expected);
+  });
+
+  It("cancels the queued requests of a canceled group", [this]() {
+    // As in the global accessor chain, the groups' requests are coalesced
+    // before they are submitted.
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pCoalescing =
+        std::make_shared<CoalescingAssetAccessor>(pScheduled);
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pFirst =
+        pScheduler->createGroupAssetAccessor(
+            pCoalescing,
+            pScheduler->createGroup());
+    const uint64 second = pScheduler->createGroup();
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pSecond =
+        pScheduler->createGroupAssetAccessor(pCoalescing, second);
+
+    std::vector<std::string> canceled;
+    Get(pSecond, "https://a.com/sent1", &canceled);
+    Get(pSecond, "https://a.com/sent2", &canceled);
+    pScheduled->complete("https://a.com/sent1", 1000);
+    Get(pSecond, "https://a.com/sent3", &canceled);
+    Get(pSecond, "https://a.com/queued", &canceled);
+    Get(pFirst, "https://a.com/shared", &canceled);
+    Get(pSecond, "https://a.com/shared", &canceled);
+
+    pScheduler->cancelGroup(second);
+
+    TestEqual("canceled", canceled.size(), size_t(1));
+    TestEqual("canceled URL", canceled[0], std::string("https://a.com/queued"));
+
+    CesiumRequestScheduler::Statistics statistics =
+        pScheduler->getStatistics();
+    TestEqual("canceled count", statistics.canceled, int64(1));
+    TestEqual("bytes saved", statistics.estimatedBytesSaved, int64(1000));
+    TestEqual("queued", statistics.queued, int64(1));
+
+    // Requests that the canceled group makes from now on are canceled too.
+    pScheduled->complete("https://a.com/sent2", 0);
+    pScheduled->complete("https://a.com/sent3", 0);
+    Get(pSecond, "https://a.com/late", &canceled);
+    TestEqual("canceled late", canceled.size(), size_t(2));
+    TestTrue(
+        "shared request was sent",
+        std::find(
+            pScheduled->sent.begin(),
+            pScheduled->sent.end(),
+            "https://a.com/shared") != pScheduled->sent.end());
+  });
+
+  It("does not cancel other requests to a canceled group's URLs", [this]() {
+    MaximumRequestsPerHost = 0;
+    const uint64 group = pScheduler->createGroup();
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pGroup =
+        pScheduler->createGroupAssetAccessor(pScheduled, group);
+
+    std::vector<std::string> canceled;
+    Get(pGroup, "https://a.com/sent", &canceled);
+    pScheduler->cancelGroup(group);
+    Get(pGroup, "https://a.com/late", &canceled);
+    TestEqual("canceled", canceled.size(), size_t(1));
+
+    // Neither the request still in flight nor the one that was canceled
+    // before it was submitted affects other requests to the same URLs.
+    std::vector<std::string> ungroupedCanceled;
+    Get(pScheduled, "https://a.com/sent", &ungroupedCanceled);
+    Get(pScheduled, "https://a.com/late", &ungroupedCanceled);
+    TestEqual("ungrouped canceled", ungroupedCanceled.size(), size_t(0));
+    TestEqual("sent", pScheduled->sent.size(), size_t(3));
+  });
+
+  It("does not cancel queued requests made outside the group", [this]() {
+    MaximumRequestsPerHost = 1;
+    const uint64 group = pScheduler->createGroup();
+    std::shared_ptr<CesiumAsync::IAssetAccessor> pGroup =
+        pScheduler->createGroupAssetAccessor(pScheduled, group);
+
+    std::vector<std::string> canceled;
+    Get(pGroup, "https://a.com/busy", &canceled);
+    Get(pGroup, "https://a.com/shared", &canceled);
+    Get(pScheduled, "https://a.com/shared", &canceled);
+    Get(pScheduled, "https://a.com/direct", &canceled);
+    TestEqual("queued", pScheduler->getStatistics().queued, int64(3));
+
+    pScheduler->cancelGroup(group);
+
+    TestEqual("canceled", canceled.size(), size_t(1));
+    TestEqual("canceled URL", canceled[0], std::string("https://a.com/shared"));
+    TestEqual("still queued", pScheduler->getStatistics().queued, int64(2));
+
+    pScheduled->complete("https://a.com/busy", 0);
+    TestEqual(
+        "ungrouped request sent",
+        pScheduled->sent.back(),
+        std::string("https://a.com/shared"));
+  });
+}
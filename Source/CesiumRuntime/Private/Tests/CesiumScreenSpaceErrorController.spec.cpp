@@ -0,0 +1,151 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumScreenSpaceErrorController.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(
+    FCesiumScreenSpaceErrorControllerSpec,
+    "Cesium.Unit.ScreenSpaceErrorController",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+FCesiumAdaptiveScreenSpaceError Settings;
+
+/**
+ * Updates the controller once per adjustment interval, for the given number
+ * of adjustments, and returns the last screen-space error.
+ */
+double Adjust(
+    CesiumScreenSpaceErrorController& controller,
+    const CesiumScreenSpaceErrorController::Measurements& measurements,
+    int32 adjustments) {
+  double result = controller.getScreenSpaceError();
+  for (int32 i = 0; i < adjustments; ++i) {
+    result = controller.update(
+        Settings,
+        16.0,
+        measurements,
+        Settings.AdjustmentIntervalSeconds);
+  }
+  return result;
+}
+
+END_DEFINE_SPEC(FCesiumScreenSpaceErrorControllerSpec)
+
+void FCesiumScreenSpaceErrorControllerSpec::Define() {
+  BeforeEach([this]() {
+    Settings = FCesiumAdaptiveScreenSpaceError();
+    Settings.Enabled = true;
+    Settings.MinimumScreenSpaceError = 8.0;
+    Settings.MaximumScreenSpaceError = 64.0;
+    Settings.TargetGameThreadMilliseconds = 4.0f;
+    Settings.TargetEstimatedGpuBytes = 1000;
+    Settings.TargetLoadQueueLength = 100;
+  });
+
+  It("uses the tileset's screen-space error when disabled", [this]() {
+    Settings.Enabled = false;
+    CesiumScreenSpaceErrorController controller;
+    CesiumScreenSpaceErrorController::Measurements overloaded;
+    overloaded.gameThreadMilliseconds = 100.0;
+
+    TestEqual("screen-space error", Adjust(controller, overloaded, 10), 16.0);
+    TestEqual(
+        "reason",
+        controller.getReason(),
+        ECesiumAdaptiveScreenSpaceErrorReason::Disabled);
+  });
+
+  It("raises the screen-space error up to its bound", [this]() {
+    CesiumScreenSpaceErrorController controller;
+    CesiumScreenSpaceErrorController::Measurements measurements;
+    measurements.estimatedGpuBytes = 2000;
+
+    TestEqual("starts", Adjust(controller, measurements, 1), 16.0);
+    TestTrue("raised", Adjust(controller, measurements, 1) > 16.0);
+    TestEqual(
+        "reason",
+        controller.getReason(),
+        ECesiumAdaptiveScreenSpaceErrorReason::EstimatedGpuMemory);
+    TestEqual("bounded", Adjust(controller, measurements, 50), 64.0);
+  });
+
+  It("raises a screen-space error that starts at zero", [this]() {
+    Settings.MinimumScreenSpaceError = 0.0;
+    CesiumScreenSpaceErrorController controller;
+    CesiumScreenSpaceErrorController::Measurements measurements;
+    measurements.estimatedGpuBytes = 2000;
+
+    TestEqual(
+        "starts at the floor",
+        controller.update(
+            Settings,
+            0.0,
+            measurements,
+            Settings.AdjustmentIntervalSeconds),
+        1.0);
+    TestTrue(
+        "raised",
+        controller.update(
+            Settings,
+            0.0,
+            measurements,
+            Settings.AdjustmentIntervalSeconds) > 1.0);
+  });
+
+  It("reports the measurement furthest over its target", [this]() {
+    CesiumScreenSpaceErrorController controller;
+    CesiumScreenSpaceErrorController::Measurements measurements;
+    measurements.gameThreadMilliseconds = 5.0;
+    measurements.loadQueueLength = 300;
+
+    Adjust(controller, measurements, 2);
+    TestEqual(
+        "reason",
+        controller.getReason(),
+        ECesiumAdaptiveScreenSpaceErrorReason::LoadQueueLength);
+  });
+
+  It("keeps the screen-space error near the targets", [this]() {
+    CesiumScreenSpaceErrorController controller;
+    CesiumScreenSpaceErrorController::Measurements measurements;
+    measurements.loadQueueLength = 90;
+
+    TestEqual("held", Adjust(controller, measurements, 10), 16.0);
+    TestEqual(
+        "reason",
+        controller.getReason(),
+        ECesiumAdaptiveScreenSpaceErrorReason::WithinTargets);
+  });
+
+  It("lowers the screen-space error when under the targets", [this]() {
+    CesiumScreenSpaceErrorController controller;
+    CesiumScreenSpaceErrorController::Measurements measurements;
+
+    Adjust(controller, measurements, 1);
+    TestTrue("lowered", Adjust(controller, measurements, 1) < 16.0);
+    TestEqual(
+        "reason",
+        controller.getReason(),
+        ECesiumAdaptiveScreenSpaceErrorReason::Improving);
+    TestEqual("bounded", Adjust(controller, measurements, 50), 8.0);
+    TestEqual(
+        "reason at the bound",
+        controller.getReason(),
+        ECesiumAdaptiveScreenSpaceErrorReason::WithinTargets);
+  });
+
+  It("waits for the adjustment interval", [this]() {
+    CesiumScreenSpaceErrorController controller;
+    CesiumScreenSpaceErrorController::Measurements measurements;
+    measurements.loadQueueLength = 1000;
+
+    controller.update(Settings, 16.0, measurements, 0.0);
+    const double screenSpaceError = controller.update(
+        Settings,
+        16.0,
+        measurements,
+        Settings.AdjustmentIntervalSeconds * 0.5);
+    TestEqual("unchanged", screenSpaceError, 16.0);
+  });
+}
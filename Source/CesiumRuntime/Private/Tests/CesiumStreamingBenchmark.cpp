@@ -0,0 +1,390 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumStreamingBenchmark.h"
+#include "Cesium3DTileset.h"
+#include "CesiumCamera.h"
+#include "CesiumCameraManager.h"
+#include "CesiumGeoreference.h"
+#include "CesiumRuntime.h"
+#include "CesiumSyntheticTileset.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Cesium {
+
+namespace {
+
+StreamingBenchmarkFrame measureFrame(
+    int32 frame,
+    double time,
+    double worldTickSeconds,
+    const TArray<ACesium3DTileset*>& tilesets) {
+  StreamingBenchmarkFrame result;
+  result.frame = frame;
+  result.time = time;
+  result.worldTickMilliseconds = worldTickSeconds * 1000.0;
+  result.loadProgress = 100.0f;
+
+  for (ACesium3DTileset* pTileset : tilesets) {
+    result.tilesetUpdateMilliseconds += pTileset->GetLastUpdateMilliseconds();
+    result.tilesRendered += pTileset->GetNumberOfTilesRendered();
+    result.workerThreadTileLoadQueueLength +=
+        pTileset->GetWorkerThreadTileLoadQueueLength();
+    result.mainThreadTileLoadQueueLength +=
+        pTileset->GetMainThreadTileLoadQueueLength();
+    result.estimatedGpuBytes += pTileset->GetEstimatedGpuBytes();
+    result.loadedBytes += pTileset->GetLoadedBytes();
+    result.loadProgress =
+        std::min(result.loadProgress, pTileset->GetLoadProgress());
+  }
+
+  return result;
+}
+
+FString formatCsv(const TArray<StreamingBenchmarkFrame>& frames) {
+  FString csv = TEXT(
+      "Frame,Time,WorldTickMs,TilesetUpdateMs,TilesRendered,WorkerThreadLoadQueue,MainThreadLoadQueue,EstimatedGpuBytes,LoadedBytes,LoadProgress\n");
+  for (const StreamingBenchmarkFrame& frame : frames) {
+    csv += FString::Printf(
+        TEXT("%d,%.6f,%.3f,%.3f,%lld,%lld,%lld,%lld,%lld,%.1f\n"),
+        frame.frame,
+        frame.time,
+        frame.worldTickMilliseconds,
+        frame.tilesetUpdateMilliseconds,
+        frame.tilesRendered,
+        frame.workerThreadTileLoadQueueLength,
+        frame.mainThreadTileLoadQueueLength,
+        frame.estimatedGpuBytes,
+        frame.loadedBytes,
+        frame.loadProgress);
+  }
+  return csv;
+}
+
+FString formatPercentiles(const TArray<double>& values) {
+  return FString::Printf(
+      TEXT(
+          "{ \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f }"),
+      computePercentile(values, 50.0),
+      computePercentile(values, 95.0),
+      computePercentile(values, 99.0),
+      computePercentile(values, 100.0));
+}
+
+FString formatJson(
+    const StreamingBenchmarkOptions& options,
+    const StreamingBenchmarkResult& result,
+    const FCesiumTileLoadLatency& latency) {
+  TArray<double> worldTickMilliseconds;
+  TArray<double> tilesetUpdateMilliseconds;
+  TArray<double> tilesRendered;
+  TArray<double> workerQueue;
+  TArray<double> mainQueue;
+  TArray<double> gpuMegabytes;
+  for (const StreamingBenchmarkFrame& frame : result.frames) {
+    worldTickMilliseconds.Add(frame.worldTickMilliseconds);
+    tilesetUpdateMilliseconds.Add(frame.tilesetUpdateMilliseconds);
+    tilesRendered.Add(double(frame.tilesRendered));
+    workerQueue.Add(double(frame.workerThreadTileLoadQueueLength));
+    mainQueue.Add(double(frame.mainThreadTileLoadQueueLength));
+    gpuMegabytes.Add(double(frame.estimatedGpuBytes) / (1024.0 * 1024.0));
+  }
+
+  FString json = TEXT("{\n");
+  json += FString::Printf(TEXT("  \"name\": \"%s\",\n"), *options.name);
+  json += FString::Printf(
+      TEXT("  \"frames\": %d,\n"),
+      result.frames.Num());
+  json += FString::Printf(
+      TEXT("  \"timeToFullyLoadedSeconds\": %.3f,\n"),
+      result.timeToFullyLoaded);
+  json += FString::Printf(
+      TEXT("  \"worldTickMs\": %s,\n"),
+      *formatPercentiles(worldTickMilliseconds));
+  json += FString::Printf(
+      TEXT("  \"tilesetUpdateMs\": %s,\n"),
+      *formatPercentiles(tilesetUpdateMilliseconds));
+  json += FString::Printf(
+      TEXT("  \"tilesRendered\": %s,\n"),
+      *formatPercentiles(tilesRendered));
+  json += FString::Printf(
+      TEXT("  \"workerThreadLoadQueue\": %s,\n"),
+      *formatPercentiles(workerQueue));
+  json += FString::Printf(
+      TEXT("  \"mainThreadLoadQueue\": %s,\n"),
+      *formatPercentiles(mainQueue));
+  json += FString::Printf(
+      TEXT("  \"estimatedGpuMegabytes\": %s,\n"),
+      *formatPercentiles(gpuMegabytes));
+  json += FString::Printf(
+      TEXT(
+          "  \"tileLoadLatencyMs\": { \"count\": %lld, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f }\n"),
+      latency.Count,
+      latency.P50 * 1000.0,
+      latency.P95 * 1000.0,
+      latency.P99 * 1000.0);
+  json += TEXT("}\n");
+  return json;
+}
+
+} // namespace
+
+double computePercentile(TArray<double> values, double percentile) {
+  if (values.Num() == 0) {
+    return 0.0;
+  }
+
+  values.Sort();
+  const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+  const int32 rank = int32(std::ceil(fraction * double(values.Num())));
+  return values[std::clamp(rank - 1, 0, values.Num() - 1)];
+}
+
+StreamingBenchmarkResult
+runStreamingBenchmark(const StreamingBenchmarkOptions& options) {
+  StreamingBenchmarkResult result;
+
+  const TArray<CesiumCameraPathFrame>& pathFrames = options.cameraPath.frames;
+  if (pathFrames.Num() == 0) {
+    UE_LOG(LogCesium, Error, TEXT("The benchmark camera path is empty."));
+    return result;
+  }
+
+  UWorld* pWorld = UWorld::CreateWorld(
+      EWorldType::Game,
+      false,
+      FName(TEXT("CesiumStreamingBenchmark")));
+  FWorldContext& worldContext =
+      GEngine->CreateNewWorldContext(EWorldType::Game);
+  worldContext.SetCurrentWorld(pWorld);
+  pWorld->InitializeActorsForPlay(FURL());
+  pWorld->BeginPlay();
+
+  ACesiumGeoreference* pGeoreference =
+      ACesiumGeoreference::GetDefaultGeoreference(pWorld);
+  pGeoreference->SetOriginLongitudeLatitudeHeight(
+      pathFrames[0].longitudeLatitudeHeight);
+
+  TArray<ACesium3DTileset*> tilesets;
+  for (const FString& url : options.tilesetUrls) {
+    ACesium3DTileset* pTileset = pWorld->SpawnActor<ACesium3DTileset>();
+    pTileset->SetTilesetSource(ETilesetSource::FromUrl);
+    pTileset->SetUrl(url);
+    if (options.configureTileset) {
+      options.configureTileset(*pTileset);
+    }
+    pTileset->ResetTileLoadLatency();
+    tilesets.Add(pTileset);
+  }
+
+  ACesiumCameraManager* pCameraManager =
+      ACesiumCameraManager::GetDefaultCameraManager(pWorld);
+  const int32 cameraId = pCameraManager->AddCamera(
+      CesiumCameraPath::toCamera(pathFrames[0], *pGeoreference));
+
+  // Replay the path at its recorded frame times, then keep ticking at the
+  // final pose until everything is loaded.
+  const int32 totalFrames = pathFrames.Num() + options.maximumSettleFrames;
+  double time = 0.0;
+  double lastDeltaTime = 1.0 / 60.0;
+
+  for (int32 i = 0; i < totalFrames; ++i) {
+    const int32 pathIndex = std::min(i, pathFrames.Num() - 1);
+    const CesiumCameraPathFrame& pathFrame = pathFrames[pathIndex];
+
+    double deltaTime = lastDeltaTime;
+    if (pathIndex + 1 < pathFrames.Num()) {
+      deltaTime = pathFrames[pathIndex + 1].time - pathFrame.time;
+      if (deltaTime <= 0.0) {
+        deltaTime = lastDeltaTime;
+      }
+    }
+    lastDeltaTime = deltaTime;
+
+    pCameraManager->UpdateCamera(
+        cameraId,
+        CesiumCameraPath::toCamera(pathFrame, *pGeoreference));
+
+    if (options.beforeFrame) {
+      options.beforeFrame(*pWorld, pathIndex);
+    }
+
+    const double start = FPlatformTime::Seconds();
+    pWorld->Tick(LEVELTICK_All, float(deltaTime));
+    const double end = FPlatformTime::Seconds();
+
+    result.frames.Add(measureFrame(i, time, end - start, tilesets));
+    time += deltaTime;
+
+    const bool loaded = result.frames.Last().loadProgress >= 100.0f;
+    if (loaded && result.timeToFullyLoaded < 0.0) {
+      result.timeToFullyLoaded = time;
+    }
+    if (!loaded) {
+      result.timeToFullyLoaded = -1.0;
+    }
+    if (loaded && i >= pathFrames.Num() - 1) {
+      break;
+    }
+  }
+
+  FCesiumTileLoadLatency latency;
+  for (ACesium3DTileset* pTileset : tilesets) {
+    FCesiumTileLoadLatency tilesetLatency =
+        pTileset->GetTileLoadLatency(ECesiumTileLoadStage::Total);
+    // Report the slowest tileset, which is what determines when the view is
+    // complete.
+    if (tilesetLatency.P50 >= latency.P50) {
+      latency = tilesetLatency;
+    }
+  }
+
+  const FString outputDirectory =
+      options.outputDirectory.IsEmpty()
+          ? FPaths::Combine(
+                FPaths::ProjectSavedDir(),
+                TEXT("Cesium"),
+                TEXT("Benchmarks"))
+          : options.outputDirectory;
+  result.csvFilename =
+      FPaths::Combine(outputDirectory, options.name + TEXT(".csv"));
+  result.jsonFilename =
+      FPaths::Combine(outputDirectory, options.name + TEXT(".json"));
+
+  FFileHelper::SaveStringToFile(formatCsv(result.frames), *result.csvFilename);
+  FFileHelper::SaveStringToFile(
+      formatJson(options, result, latency),
+      *result.jsonFilename);
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Benchmark %s ran %d frames; results written to %s"),
+      *options.name,
+      result.frames.Num(),
+      *result.jsonFilename);
+
+  for (ACesium3DTileset* pTileset : tilesets) {
+    pTileset->Destroy();
+  }
+  GEngine->DestroyWorldContext(pWorld);
+  pWorld->DestroyWorld(false);
+
+  return result;
+}
+
+} // namespace Cesium
+
+using namespace Cesium;
+
+namespace {
+
+/**
+ * Creates a ten second, 60 frames per second camera path that flies north
+ * while descending from 8 km to 500 m above the given location, looking
+ * forward and down.
+ */
+CesiumCameraPath createDescentPath(const FVector& longitudeLatitudeHeight) {
+  constexpr int32 frameCount = 600;
+  constexpr double metersPerDegreeLatitude = 111320.0;
+
+  CesiumCameraPath path;
+  path.frames.Reserve(frameCount);
+  for (int32 i = 0; i < frameCount; ++i) {
+    const double fraction = double(i) / double(frameCount - 1);
+    const double northMeters = -3000.0 + 3000.0 * fraction;
+
+    CesiumCameraPathFrame& frame = path.frames.Emplace_GetRef();
+    frame.time = double(i) / 60.0;
+    frame.longitudeLatitudeHeight = FVector(
+        longitudeLatitudeHeight.X,
+        longitudeLatitudeHeight.Y + northMeters / metersPerDegreeLatitude,
+        longitudeLatitudeHeight.Z + FMath::Lerp(8000.0, 500.0, fraction));
+    // Unreal's local frame is East-South-Up, so north is a yaw of -90.
+    frame.eastSouthUpRotation = FRotator(-45.0, -90.0, 0.0);
+  }
+  return path;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+    FCesiumStreamingBenchmark,
+    "Cesium.Performance.StreamingBenchmark",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::PerfFilter)
+
+bool FCesiumStreamingBenchmark::RunTest(const FString& Parameters) {
+  // The tilesets and camera path may be given on the command line, for
+  // example:
+  //   -CesiumBenchmarkTilesets=file:///data/city/tileset.json
+  //   -CesiumBenchmarkCameraPath=/data/city/flythrough.csv
+  // Multiple tilesets are separated by '+'. Without them, the benchmark
+  // generates a synthetic tileset and flies down over it, so that it can run
+  // offline.
+  FString tilesets;
+  FString cameraPathFilename;
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkTilesets="),
+      tilesets);
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkCameraPath="),
+      cameraPathFilename);
+
+  StreamingBenchmarkOptions options;
+  options.name = TEXT("Synthetic");
+  FParse::Value(
+      FCommandLine::Get(),
+      TEXT("CesiumBenchmarkOutput="),
+      options.outputDirectory);
+
+  SyntheticTilesetOptions syntheticOptions;
+  if (tilesets.IsEmpty()) {
+    SyntheticTilesetResult synthetic = generateSyntheticTileset(
+        FPaths::Combine(
+            FPaths::ProjectSavedDir(),
+            TEXT("Cesium"),
+            TEXT("Benchmarks"),
+            TEXT("SyntheticTileset")),
+        syntheticOptions);
+    if (synthetic.tilesetUrl.IsEmpty()) {
+      AddError(TEXT("Could not generate the synthetic tileset."));
+      return false;
+    }
+    options.tilesetUrls.Add(synthetic.tilesetUrl);
+  } else {
+    tilesets.ParseIntoArray(options.tilesetUrls, TEXT("+"));
+  }
+
+  if (cameraPathFilename.IsEmpty()) {
+    options.cameraPath =
+        createDescentPath(syntheticOptions.longitudeLatitudeHeight);
+  } else {
+    std::optional<CesiumCameraPath> maybePath =
+        CesiumCameraPath::load(cameraPathFilename);
+    if (!maybePath) {
+      AddError(FString::Printf(
+          TEXT("Could not read a camera path from %s"),
+          *cameraPathFilename));
+      return false;
+    }
+    options.name = FPaths::GetBaseFilename(cameraPathFilename);
+    options.cameraPath = std::move(*maybePath);
+  }
+
+  StreamingBenchmarkResult result = runStreamingBenchmark(options);
+  TestTrue("ran at least one frame", result.frames.Num() > 0);
+  TestTrue("tilesets finished loading", result.timeToFullyLoaded >= 0.0);
+
+  return true;
+}
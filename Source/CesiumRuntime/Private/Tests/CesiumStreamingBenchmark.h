@@ -0,0 +1,112 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumCameraPath.h"
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include <functional>
+
+class ACesium3DTileset;
+class UWorld;
+
+namespace Cesium {
+
+/**
+ * The measurements taken in one frame of a streaming benchmark. Counts and
+ * bytes are summed over all of the benchmark's tilesets.
+ */
+struct StreamingBenchmarkFrame {
+  int32 frame = 0;
+  double time = 0.0;
+
+  /**
+   * The time taken to tick the whole world, including every other actor and
+   * the rendering submissions.
+   */
+  double worldTickMilliseconds = 0.0;
+
+  /**
+   * The time the tilesets took to select and update their tiles, from
+   * ACesium3DTileset::GetLastUpdateMilliseconds.
+   */
+  double tilesetUpdateMilliseconds = 0.0;
+
+  int64 tilesRendered = 0;
+  int64 workerThreadTileLoadQueueLength = 0;
+  int64 mainThreadTileLoadQueueLength = 0;
+  int64 estimatedGpuBytes = 0;
+  int64 loadedBytes = 0;
+  float loadProgress = 0.0f;
+};
+
+struct StreamingBenchmarkOptions {
+  /** The name of the benchmark, used to name its output files. */
+  FString name;
+
+  /** The URLs of the tilesets to load, usually `file:///` URLs. */
+  TArray<FString> tilesetUrls;
+
+  /**
+   * The camera path to replay. The georeference origin is placed at the
+   * first frame of the path.
+   */
+  CesiumCameraPath cameraPath;
+
+  /**
+   * The maximum number of extra frames to run at the final camera pose
+   * while waiting for the tilesets to finish loading.
+   */
+  int32 maximumSettleFrames = 600;
+
+  /**
+   * The directory in which to write the per-frame CSV file and the summary
+   * JSON file. Defaults to Saved/Cesium/Benchmarks.
+   */
+  FString outputDirectory;
+
+  /**
+   * Called for each tileset after it is spawned, to configure it before it
+   * is first ticked.
+   */
+  std::function<void(ACesium3DTileset&)> configureTileset;
+
+  /**
+   * Called before each frame is ticked, with the index of the frame in the
+   * camera path (or the last index while settling).
+   */
+  std::function<void(UWorld&, int32)> beforeFrame;
+};
+
+struct StreamingBenchmarkResult {
+  TArray<StreamingBenchmarkFrame> frames;
+
+  /**
+   * The time in seconds from the start of the benchmark until every tileset
+   * was fully loaded, or a negative value if they never were.
+   */
+  double timeToFullyLoaded = -1.0;
+
+  FString csvFilename;
+  FString jsonFilename;
+};
+
+/**
+ * Replays a camera path against a set of tilesets in a new game world,
+ * ticking the world directly with the frame times recorded in the path so
+ * that every run selects tiles for the same sequence of views. This does not
+ * need a viewport, so it can run under `-nullrhi`.
+ *
+ * The per-frame measurements are written to a CSV file, and summary
+ * percentiles to a JSON file.
+ */
+StreamingBenchmarkResult
+runStreamingBenchmark(const StreamingBenchmarkOptions& options);
+
+/**
+ * Gets the value below which the given percentage of the values fall, using
+ * the nearest-rank method. Returns 0.0 if there are no values.
+ */
+double computePercentile(TArray<double> values, double percentile);
+
+} // namespace Cesium
@@ -0,0 +1,712 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumSyntheticTileset.h"
+#include "CesiumGeospatial/Cartographic.h"
+#include "CesiumGeospatial/Ellipsoid.h"
+#include "CesiumGeospatial/GlobeTransforms.h"
+#include "CesiumRuntime.h"
+#include "ImageUtils.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace Cesium {
+
+namespace {
+
+constexpr int32 ComponentTypeUnsignedInt = 5125;
+constexpr int32 ComponentTypeFloat = 5126;
+constexpr int32 TargetArrayBuffer = 34962;
+constexpr int32 TargetElementArrayBuffer = 34963;
+
+/**
+ * Accumulates the binary chunk, buffer views, and accessors of a GLB, and
+ * assembles the final file.
+ */
+class GlbBuilder {
+public:
+  int32 addBufferView(const void* pData, size_t size, int32 target = 0) {
+    const size_t offset = this->_binary.size();
+    this->_binary.resize(offset + ((size + 3) & ~size_t(3)));
+    std::memcpy(this->_binary.data() + offset, pData, size);
+
+    FString bufferView = FString::Printf(
+        TEXT("{\"buffer\":0,\"byteOffset\":%llu,\"byteLength\":%llu"),
+        uint64(offset),
+        uint64(size));
+    if (target != 0) {
+      bufferView += FString::Printf(TEXT(",\"target\":%d"), target);
+    }
+    bufferView += TEXT("}");
+    return this->_bufferViews.Add(MoveTemp(bufferView));
+  }
+
+  template <typename T>
+  int32 addAccessor(
+      const std::vector<T>& values,
+      int32 componentType,
+      int32 componentsPerElement,
+      const TCHAR* type,
+      int32 target,
+      const FString& minMax = FString()) {
+    const int32 bufferView =
+        this->addBufferView(values.data(), values.size() * sizeof(T), target);
+    FString accessor = FString::Printf(
+        TEXT(
+            "{\"bufferView\":%d,\"componentType\":%d,\"count\":%llu,\"type\":\"%s\"%s}"),
+        bufferView,
+        componentType,
+        uint64(values.size() / componentsPerElement),
+        type,
+        *minMax);
+    return this->_accessors.Add(MoveTemp(accessor));
+  }
+
+  /**
+   * Creates the GLB, adding the buffer, buffer views, and accessors to the
+   * given JSON members.
+   */
+  TArray<uint8> finish(const FString& jsonMembers) const {
+    const FString json = FString::Printf(
+        TEXT(
+            "{%s,\"buffers\":[{\"byteLength\":%llu}],\"bufferViews\":[%s],\"accessors\":[%s]}"),
+        *jsonMembers,
+        uint64(this->_binary.size()),
+        *FString::Join(this->_bufferViews, TEXT(",")),
+        *FString::Join(this->_accessors, TEXT(",")));
+
+    FTCHARToUTF8 utf8(*json);
+    const uint32 jsonLength = uint32(utf8.Length() + 3) & ~3u;
+    const uint32 binaryLength = uint32(this->_binary.size());
+    const uint32 totalLength = 12 + 8 + jsonLength + 8 + binaryLength;
+
+    TArray<uint8> glb;
+    glb.Reserve(totalLength);
+    auto appendUint32 = [&glb](uint32 value) {
+      glb.Append(reinterpret_cast<const uint8*>(&value), sizeof(value));
+    };
+
+    appendUint32(0x46546C67); // "glTF"
+    appendUint32(2);
+    appendUint32(totalLength);
+
+    appendUint32(jsonLength);
+    appendUint32(0x4E4F534A); // "JSON"
+    glb.Append(reinterpret_cast<const uint8*>(utf8.Get()), utf8.Length());
+    for (uint32 i = uint32(utf8.Length()); i < jsonLength; ++i) {
+      glb.Add(' ');
+    }
+
+    appendUint32(binaryLength);
+    appendUint32(0x004E4942); // "BIN"
+    glb.Append(
+        reinterpret_cast<const uint8*>(this->_binary.data()),
+        binaryLength);
+
+    return glb;
+  }
+
+private:
+  std::vector<std::byte> _binary;
+  TArray<FString> _bufferViews;
+  TArray<FString> _accessors;
+};
+
+struct TileCoordinates {
+  int32 level;
+  int32 x;
+  int32 y;
+};
+
+struct TileBounds {
+  double west;
+  double south;
+  double size;
+};
+
+TileBounds computeTileBounds(
+    const SyntheticTilesetOptions& options,
+    const TileCoordinates& tile) {
+  const double tilesPerAxis = std::pow(options.childrenPerAxis, tile.level);
+  const double size = options.extentMeters / tilesPerAxis;
+  return TileBounds{
+      -0.5 * options.extentMeters + tile.x * size,
+      -0.5 * options.extentMeters + tile.y * size,
+      size};
+}
+
+double computeHeight(
+    const SyntheticTilesetOptions& options,
+    double east,
+    double north) {
+  const double wavenumber = 2.0 * PI * 4.0 / options.extentMeters;
+  return options.terrainAmplitudeMeters * std::sin(east * wavenumber) *
+         std::cos(north * wavenumber);
+}
+
+glm::dvec3 computeNormal(
+    const SyntheticTilesetOptions& options,
+    double east,
+    double north) {
+  const double wavenumber = 2.0 * PI * 4.0 / options.extentMeters;
+  const double dHeightdEast = options.terrainAmplitudeMeters * wavenumber *
+                              std::cos(east * wavenumber) *
+                              std::cos(north * wavenumber);
+  const double dHeightdNorth = -options.terrainAmplitudeMeters * wavenumber *
+                               std::sin(east * wavenumber) *
+                               std::sin(north * wavenumber);
+  return glm::normalize(glm::dvec3(-dHeightdEast, -dHeightdNorth, 1.0));
+}
+
+double computeGeometricError(
+    const SyntheticTilesetOptions& options,
+    const TileCoordinates& tile) {
+  if (tile.level >= options.maximumDepth) {
+    return 0.0;
+  }
+  return computeTileBounds(options, tile).size / 8.0;
+}
+
+double computeMaximumHeight(const SyntheticTilesetOptions& options) {
+  double maximum = options.terrainAmplitudeMeters;
+  if (options.instancesPerTile > 0) {
+    maximum += options.instanceSizeMeters;
+  }
+  return maximum;
+}
+
+FString formatMinMax(const glm::dvec3& minimum, const glm::dvec3& maximum) {
+  return FString::Printf(
+      TEXT(",\"min\":[%.9g,%.9g,%.9g],\"max\":[%.9g,%.9g,%.9g]"),
+      minimum.x,
+      minimum.y,
+      minimum.z,
+      maximum.x,
+      maximum.y,
+      maximum.z);
+}
+
+FColor computeTileColor(const TileCoordinates& tile) {
+  static const FColor levelColors[] = {
+      FColor(230, 97, 92),
+      FColor(240, 180, 70),
+      FColor(120, 190, 90),
+      FColor(80, 160, 210),
+      FColor(150, 110, 200),
+      FColor(200, 120, 170)};
+  return levelColors[tile.level % UE_ARRAY_COUNT(levelColors)];
+}
+
+TArray64<uint8> createTexture(int32 size, const TileCoordinates& tile) {
+  const FColor color = computeTileColor(tile);
+  const int32 checkerSize = std::max(1, size / 8);
+
+  TArray64<FColor> pixels;
+  pixels.SetNumUninitialized(int64(size) * size);
+  for (int32 y = 0; y < size; ++y) {
+    for (int32 x = 0; x < size; ++x) {
+      const bool light = ((x / checkerSize) + (y / checkerSize)) % 2 == 0;
+      const uint8 shade = uint8(128 + (127 * x) / std::max(1, size - 1));
+      pixels[int64(y) * size + x] =
+          light ? FColor(shade, shade, shade) : color;
+    }
+  }
+
+  TArray64<uint8> png;
+  FImageUtils::PNGCompressImageArray(size, size, pixels, png);
+  return png;
+}
+
+/**
+ * Creates the GLB for the given tile. The positions are relative to the
+ * center of the tile, which is the translation of the tile's nodes. glTF is
+ * y-up, so an East-North-Up position (e, n, u) is stored as (e, u, -n).
+ */
+TArray<uint8> createTileContent(
+    const SyntheticTilesetOptions& options,
+    const TileCoordinates& tile,
+    SyntheticTilesetResult& result) {
+  const TileBounds bounds = computeTileBounds(options, tile);
+  const double centerEast = bounds.west + 0.5 * bounds.size;
+  const double centerNorth = bounds.south + 0.5 * bounds.size;
+
+  const int32 cells = std::max(
+      1,
+      int32(std::ceil(std::sqrt(0.5 * std::max(1, options.trianglesPerTile)))));
+  const int32 verticesPerSide = cells + 1;
+  const int32 vertexCount = verticesPerSide * verticesPerSide;
+
+  std::vector<float> positions;
+  std::vector<float> normals;
+  std::vector<float> texCoords;
+  std::vector<float> featureIds;
+  positions.reserve(vertexCount * 3);
+  normals.reserve(vertexCount * 3);
+  texCoords.reserve(vertexCount * 2);
+
+  const int32 featureCount = std::max(0, options.featuresPerTile);
+  if (featureCount > 0) {
+    featureIds.reserve(vertexCount);
+  }
+
+  glm::dvec3 minimum(std::numeric_limits<double>::max());
+  glm::dvec3 maximum(std::numeric_limits<double>::lowest());
+
+  for (int32 row = 0; row < verticesPerSide; ++row) {
+    for (int32 column = 0; column < verticesPerSide; ++column) {
+      const double u = double(column) / cells;
+      const double v = double(row) / cells;
+      const double east = bounds.west + u * bounds.size;
+      const double north = bounds.south + v * bounds.size;
+      const double height = computeHeight(options, east, north);
+
+      const glm::dvec3 position(
+          east - centerEast,
+          height,
+          -(north - centerNorth));
+      minimum = glm::min(minimum, position);
+      maximum = glm::max(maximum, position);
+      positions.push_back(float(position.x));
+      positions.push_back(float(position.y));
+      positions.push_back(float(position.z));
+
+      if (options.includeNormals) {
+        const glm::dvec3 normal = computeNormal(options, east, north);
+        normals.push_back(float(normal.x));
+        normals.push_back(float(normal.z));
+        normals.push_back(float(-normal.y));
+      }
+
+      texCoords.push_back(float(u));
+      texCoords.push_back(float(1.0 - v));
+
+      if (featureCount > 0) {
+        const int64 vertex = int64(row) * verticesPerSide + column;
+        featureIds.push_back(float((vertex * featureCount) / vertexCount));
+      }
+    }
+  }
+
+  std::vector<uint32> indices;
+  indices.reserve(size_t(cells) * cells * 6);
+  for (int32 row = 0; row < cells; ++row) {
+    for (int32 column = 0; column < cells; ++column) {
+      const uint32 i0 = uint32(row * verticesPerSide + column);
+      const uint32 i1 = i0 + 1;
+      const uint32 i2 = i0 + uint32(verticesPerSide);
+      const uint32 i3 = i2 + 1;
+      indices.insert(indices.end(), {i0, i1, i3, i0, i3, i2});
+    }
+  }
+
+  result.triangleCount += int64(indices.size() / 3);
+
+  GlbBuilder builder;
+  TArray<FString> extensionsUsed;
+
+  FString attributes = FString::Printf(
+      TEXT("\"POSITION\":%d,\"TEXCOORD_0\":%d"),
+      builder.addAccessor(
+          positions,
+          ComponentTypeFloat,
+          3,
+          TEXT("VEC3"),
+          TargetArrayBuffer,
+          formatMinMax(minimum, maximum)),
+      builder.addAccessor(
+          texCoords,
+          ComponentTypeFloat,
+          2,
+          TEXT("VEC2"),
+          TargetArrayBuffer));
+  if (options.includeNormals) {
+    attributes += FString::Printf(
+        TEXT(",\"NORMAL\":%d"),
+        builder.addAccessor(
+            normals,
+            ComponentTypeFloat,
+            3,
+            TEXT("VEC3"),
+            TargetArrayBuffer));
+  }
+
+  FString primitiveExtensions;
+  FString modelExtensions;
+  if (featureCount > 0) {
+    extensionsUsed.Add(TEXT("\"EXT_mesh_features\""));
+    extensionsUsed.Add(TEXT("\"EXT_structural_metadata\""));
+
+    attributes += FString::Printf(
+        TEXT(",\"_FEATURE_ID_0\":%d"),
+        builder.addAccessor(
+            featureIds,
+            ComponentTypeFloat,
+            1,
+            TEXT("SCALAR"),
+            TargetArrayBuffer));
+    primitiveExtensions = FString::Printf(
+        TEXT(
+            ",\"extensions\":{\"EXT_mesh_features\":{\"featureIds\":[{\"featureCount\":%d,\"attribute\":0,\"propertyTable\":0}]}}"),
+        featureCount);
+
+    TArray<FString> classProperties;
+    TArray<FString> tableProperties;
+    for (int32 property = 0; property < options.metadataPropertiesPerTile;
+         ++property) {
+      std::vector<float> values(featureCount);
+      for (int32 feature = 0; feature < featureCount; ++feature) {
+        values[feature] =
+            float(tile.level * 1000 + feature) + 0.25f * float(property);
+      }
+      const int32 bufferView =
+          builder.addBufferView(values.data(), values.size() * sizeof(float));
+
+      classProperties.Add(FString::Printf(
+          TEXT(
+              "\"property%d\":{\"type\":\"SCALAR\",\"componentType\":\"FLOAT32\"}"),
+          property));
+      tableProperties.Add(FString::Printf(
+          TEXT("\"property%d\":{\"values\":%d}"),
+          property,
+          bufferView));
+    }
+
+    modelExtensions = FString::Printf(
+        TEXT(
+            ",\"extensions\":{\"EXT_structural_metadata\":{\"schema\":{\"id\":\"synthetic\",\"classes\":{\"feature\":{\"properties\":{%s}}}},\"propertyTables\":[{\"class\":\"feature\",\"count\":%d,\"properties\":{%s}}]}}"),
+        *FString::Join(classProperties, TEXT(",")),
+        featureCount,
+        *FString::Join(tableProperties, TEXT(",")));
+  }
+
+  FString material;
+  FString textures;
+  if (options.textureSize > 0) {
+    TArray64<uint8> png = createTexture(options.textureSize, tile);
+    const int32 bufferView = builder.addBufferView(png.GetData(), png.Num());
+    material =
+        TEXT("{\"pbrMetallicRoughness\":{\"baseColorTexture\":{\"index\":0},")
+        TEXT("\"metallicFactor\":0,\"roughnessFactor\":1}}");
+    textures = FString::Printf(
+        TEXT(
+            ",\"images\":[{\"bufferView\":%d,\"mimeType\":\"image/png\"}],\"samplers\":[{\"magFilter\":9729,\"minFilter\":9987,\"wrapS\":33071,\"wrapT\":33071}],\"textures\":[{\"sampler\":0,\"source\":0}]"),
+        bufferView);
+  } else {
+    const FLinearColor color(computeTileColor(tile));
+    material = FString::Printf(
+        TEXT(
+            "{\"pbrMetallicRoughness\":{\"baseColorFactor\":[%.4f,%.4f,%.4f,1],\"metallicFactor\":0,\"roughnessFactor\":1}}"),
+        color.R,
+        color.G,
+        color.B);
+  }
+
+  const int32 indicesAccessor = builder.addAccessor(
+      indices,
+      ComponentTypeUnsignedInt,
+      1,
+      TEXT("SCALAR"),
+      TargetElementArrayBuffer);
+
+  TArray<FString> meshes;
+  meshes.Add(FString::Printf(
+      TEXT(
+          "{\"primitives\":[{\"attributes\":{%s},\"indices\":%d,\"material\":0%s}]}"),
+      *attributes,
+      indicesAccessor,
+      *primitiveExtensions));
+
+  const FString translation = FString::Printf(
+      TEXT("[%.9g,0,%.9g]"),
+      centerEast,
+      -centerNorth);
+  TArray<FString> nodes;
+  nodes.Add(
+      FString::Printf(TEXT("{\"mesh\":0,\"translation\":%s}"), *translation));
+
+  if (options.instancesPerTile > 0) {
+    extensionsUsed.Add(TEXT("\"EXT_mesh_gpu_instancing\""));
+
+    // A unit box standing on the ground, with a separate vertex per face so
+    // that its normals are flat.
+    const float half = float(0.5 * options.instanceSizeMeters);
+    const float top = float(options.instanceSizeMeters);
+    static const float faces[6][3] =
+        {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    std::vector<float> boxPositions;
+    std::vector<float> boxNormals;
+    std::vector<uint32> boxIndices;
+    for (const float* normal : faces) {
+      const glm::vec3 n(normal[0], normal[1], normal[2]);
+      const glm::vec3 tangent =
+          std::abs(n.y) > 0.5f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+      const glm::vec3 bitangent = glm::cross(n, tangent);
+      const uint32 first = uint32(boxPositions.size() / 3);
+      for (int32 corner = 0; corner < 4; ++corner) {
+        const float s = (corner & 1) ? 1.0f : -1.0f;
+        const float t = (corner & 2) ? 1.0f : -1.0f;
+        const glm::vec3 p = n + s * tangent + t * bitangent;
+        boxPositions.insert(
+            boxPositions.end(),
+            {p.x * half, (p.y + 1.0f) * 0.5f * top, p.z * half});
+        boxNormals.insert(boxNormals.end(), {n.x, n.y, n.z});
+      }
+      boxIndices.insert(
+          boxIndices.end(),
+          {first, first + 1, first + 3, first, first + 3, first + 2});
+    }
+
+    const int32 instancesPerSide =
+        int32(std::ceil(std::sqrt(double(options.instancesPerTile))));
+    std::vector<float> instanceTranslations;
+    instanceTranslations.reserve(options.instancesPerTile * 3);
+    for (int32 i = 0; i < options.instancesPerTile; ++i) {
+      const double u = (double(i % instancesPerSide) + 0.5) / instancesPerSide;
+      const double v = (double(i / instancesPerSide) + 0.5) / instancesPerSide;
+      const double east = bounds.west + u * bounds.size;
+      const double north = bounds.south + v * bounds.size;
+      instanceTranslations.insert(
+          instanceTranslations.end(),
+          {float(east - centerEast),
+           float(computeHeight(options, east, north)),
+           float(-(north - centerNorth))});
+    }
+
+    const int32 boxPositionsAccessor = builder.addAccessor(
+        boxPositions,
+        ComponentTypeFloat,
+        3,
+        TEXT("VEC3"),
+        TargetArrayBuffer,
+        formatMinMax(glm::dvec3(-half, 0, -half), glm::dvec3(half, top, half)));
+    const int32 boxNormalsAccessor = builder.addAccessor(
+        boxNormals,
+        ComponentTypeFloat,
+        3,
+        TEXT("VEC3"),
+        TargetArrayBuffer);
+    const int32 boxIndicesAccessor = builder.addAccessor(
+        boxIndices,
+        ComponentTypeUnsignedInt,
+        1,
+        TEXT("SCALAR"),
+        TargetElementArrayBuffer);
+    const int32 translationsAccessor = builder.addAccessor(
+        instanceTranslations,
+        ComponentTypeFloat,
+        3,
+        TEXT("VEC3"),
+        0);
+
+    meshes.Add(FString::Printf(
+        TEXT(
+            "{\"primitives\":[{\"attributes\":{\"POSITION\":%d,\"NORMAL\":%d},\"indices\":%d,\"material\":0}]}"),
+        boxPositionsAccessor,
+        boxNormalsAccessor,
+        boxIndicesAccessor));
+    nodes.Add(FString::Printf(
+        TEXT(
+            "{\"mesh\":1,\"translation\":%s,\"extensions\":{\"EXT_mesh_gpu_instancing\":{\"attributes\":{\"TRANSLATION\":%d}}}}"),
+        *translation,
+        translationsAccessor));
+
+    result.instanceCount += options.instancesPerTile;
+    result.triangleCount +=
+        int64(boxIndices.size() / 3) * options.instancesPerTile;
+  }
+
+  FString json = TEXT(
+      "\"asset\":{\"version\":\"2.0\",\"generator\":\"Cesium for Unreal synthetic tileset\"}");
+  if (extensionsUsed.Num() > 0) {
+    json += FString::Printf(
+        TEXT(",\"extensionsUsed\":[%s]"),
+        *FString::Join(extensionsUsed, TEXT(",")));
+  }
+  json += FString::Printf(
+      TEXT(
+          ",\"scene\":0,\"scenes\":[{\"nodes\":[%s]}],\"nodes\":[%s],\"meshes\":[%s],\"materials\":[%s]%s%s"),
+      nodes.Num() > 1 ? TEXT("0,1") : TEXT("0"),
+      *FString::Join(nodes, TEXT(",")),
+      *FString::Join(meshes, TEXT(",")),
+      *material,
+      *textures,
+      *modelExtensions);
+
+  return builder.finish(json);
+}
+
+FString getContentUri(const TileCoordinates& tile) {
+  return FString::Printf(
+      TEXT("content/%d_%d_%d.glb"),
+      tile.level,
+      tile.x,
+      tile.y);
+}
+
+/**
+ * Writes the content of the given tile and its descendants, and returns the
+ * JSON of the tile, including the given additional members. Returns an empty
+ * string if any content could not be written.
+ */
+FString writeTile(
+    const FString& directory,
+    const SyntheticTilesetOptions& options,
+    const TileCoordinates& tile,
+    const FString& additionalMembers,
+    SyntheticTilesetResult& result) {
+  TArray<uint8> glb = createTileContent(options, tile, result);
+  const FString contentUri = getContentUri(tile);
+  if (!FFileHelper::SaveArrayToFile(
+          glb,
+          *FPaths::Combine(directory, contentUri))) {
+    UE_LOG(
+        LogCesium,
+        Error,
+        TEXT("Could not write synthetic tile content %s"),
+        *contentUri);
+    return FString();
+  }
+  ++result.tileCount;
+  result.bytesWritten += glb.Num();
+
+  TArray<FString> children;
+  if (tile.level < options.maximumDepth) {
+    for (int32 y = 0; y < options.childrenPerAxis; ++y) {
+      for (int32 x = 0; x < options.childrenPerAxis; ++x) {
+        FString child = writeTile(
+            directory,
+            options,
+            TileCoordinates{
+                tile.level + 1,
+                tile.x * options.childrenPerAxis + x,
+                tile.y * options.childrenPerAxis + y},
+            FString(),
+            result);
+        if (child.IsEmpty()) {
+          return FString();
+        }
+        children.Add(MoveTemp(child));
+      }
+    }
+  }
+
+  const TileBounds bounds = computeTileBounds(options, tile);
+  const double minimumHeight = -options.terrainAmplitudeMeters;
+  const double maximumHeight = computeMaximumHeight(options);
+  FString json = FString::Printf(
+      TEXT(
+          "{\"boundingVolume\":{\"box\":[%.17g,%.17g,%.17g,%.17g,0,0,0,%.17g,0,0,0,%.17g]},\"geometricError\":%.17g,\"refine\":\"REPLACE\",\"content\":{\"uri\":\"%s\"}"),
+      bounds.west + 0.5 * bounds.size,
+      bounds.south + 0.5 * bounds.size,
+      0.5 * (minimumHeight + maximumHeight),
+      0.5 * bounds.size,
+      0.5 * bounds.size,
+      std::max(1.0, 0.5 * (maximumHeight - minimumHeight)),
+      computeGeometricError(options, tile),
+      *contentUri);
+  if (children.Num() > 0) {
+    json += FString::Printf(
+        TEXT(",\"children\":[%s]"),
+        *FString::Join(children, TEXT(",")));
+  }
+  json += additionalMembers;
+  json += TEXT("}");
+  return json;
+}
+
+FString formatTransform(const glm::dmat4& transform) {
+  TArray<FString> values;
+  for (int32 column = 0; column < 4; ++column) {
+    for (int32 row = 0; row < 4; ++row) {
+      values.Add(FString::Printf(TEXT("%.17g"), transform[column][row]));
+    }
+  }
+  return FString::Join(values, TEXT(","));
+}
+
+} // namespace
+
+int64 countSyntheticTiles(const SyntheticTilesetOptions& options) {
+  const int64 childrenPerTile =
+      int64(options.childrenPerAxis) * options.childrenPerAxis;
+  int64 tilesInLevel = 1;
+  int64 total = 0;
+  for (int32 level = 0; level <= options.maximumDepth; ++level) {
+    total += tilesInLevel;
+    tilesInLevel *= childrenPerTile;
+  }
+  return total;
+}
+
+SyntheticTilesetResult generateSyntheticTileset(
+    const FString& directory,
+    const SyntheticTilesetOptions& options) {
+  TRACE_CPUPROFILER_EVENT_SCOPE(Cesium::GenerateSyntheticTileset)
+
+  SyntheticTilesetResult result;
+  const FString fullDirectory = FPaths::ConvertRelativePathToFull(directory);
+
+  const CesiumGeospatial::Cartographic center =
+      CesiumGeospatial::Cartographic::fromDegrees(
+          options.longitudeLatitudeHeight.X,
+          options.longitudeLatitudeHeight.Y,
+          options.longitudeLatitudeHeight.Z);
+  const glm::dmat4 enuToFixed =
+      CesiumGeospatial::GlobeTransforms::eastNorthUpToFixedFrame(
+          CesiumGeospatial::Ellipsoid::WGS84.cartographicToCartesian(center));
+
+  const FString root = writeTile(
+      fullDirectory,
+      options,
+      TileCoordinates{0, 0, 0},
+      FString::Printf(
+          TEXT(",\"transform\":[%s]"),
+          *formatTransform(enuToFixed)),
+      result);
+  if (root.IsEmpty()) {
+    return SyntheticTilesetResult();
+  }
+
+  const double rootGeometricError =
+      std::max(options.extentMeters / 4.0, 1.0);
+  const FString tilesetJson = FString::Printf(
+      TEXT(
+          "{\"asset\":{\"version\":\"1.1\"},\"geometricError\":%.17g,\"root\":%s}"),
+      rootGeometricError,
+      *root);
+
+  result.tilesetFilename = FPaths::Combine(fullDirectory, TEXT("tileset.json"));
+  if (!FFileHelper::SaveStringToFile(
+          tilesetJson,
+          *result.tilesetFilename,
+          FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)) {
+    UE_LOG(
+        LogCesium,
+        Error,
+        TEXT("Could not write %s"),
+        *result.tilesetFilename);
+    return SyntheticTilesetResult();
+  }
+  result.bytesWritten += tilesetJson.Len();
+
+  result.tilesetUrl = TEXT("file:///") + result.tilesetFilename;
+  result.tilesetUrl.ReplaceCharInline('\\', '/');
+  result.tilesetUrl.ReplaceInline(TEXT(" "), TEXT("%20"));
+
+  UE_LOG(
+      LogCesium,
+      Display,
+      TEXT("Wrote a synthetic tileset with %lld tiles and %lld triangles to %s"),
+      result.tileCount,
+      result.triangleCount,
+      *result.tilesetFilename);
+
+  return result;
+}
+
+} // namespace Cesium
@@ -0,0 +1,111 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Containers/UnrealString.h"
+#include "Math/Vector.h"
+
+namespace Cesium {
+
+/**
+ * Describes a procedurally-generated 3D Tiles tileset. The tileset is a
+ * regular tree of square, gently-rolling terrain patches centered on a given
+ * location, so its size and content can be scaled independently of any
+ * network service.
+ */
+struct SyntheticTilesetOptions {
+  /**
+   * The longitude and latitude in degrees, and the height in meters, of the
+   * center of the tileset.
+   */
+  FVector longitudeLatitudeHeight = FVector(-105.25737, 39.736401, 1600.0);
+
+  /** The width and length of the root tile, in meters. */
+  double extentMeters = 10000.0;
+
+  /**
+   * The amplitude of the terrain's height variation, in meters. This keeps
+   * the tiles from being perfectly flat, so that they have distinct normals
+   * and bounding volumes with some height.
+   */
+  double terrainAmplitudeMeters = 50.0;
+
+  /**
+   * The number of levels below the root. A value of 0 creates a tileset with
+   * only a root tile.
+   */
+  int32 maximumDepth = 4;
+
+  /**
+   * The number of children of each non-leaf tile along each horizontal axis,
+   * so each non-leaf tile has the square of this many children.
+   */
+  int32 childrenPerAxis = 2;
+
+  /**
+   * The minimum number of triangles in each tile's terrain patch. The patch
+   * is a square grid, so the actual number is rounded up to twice a square
+   * number.
+   */
+  int32 trianglesPerTile = 2048;
+
+  /** Whether to include vertex normals rather than leaving them computed. */
+  bool includeNormals = true;
+
+  /**
+   * The width and height of each tile's texture, in pixels, or 0 to create
+   * untextured tiles. Every tile has its own texture.
+   */
+  int32 textureSize = 256;
+
+  /**
+   * The number of features in each tile. When this is greater than 0, each
+   * vertex gets a feature ID with EXT_mesh_features, and each tile gets an
+   * EXT_structural_metadata property table with a row per feature.
+   */
+  int32 featuresPerTile = 0;
+
+  /** The number of float properties in each tile's property table. */
+  int32 metadataPropertiesPerTile = 4;
+
+  /**
+   * The number of instances of a box mesh to place on each tile with
+   * EXT_mesh_gpu_instancing, or 0 for none.
+   */
+  int32 instancesPerTile = 0;
+
+  /** The width, length, and height of each instanced box, in meters. */
+  double instanceSizeMeters = 10.0;
+};
+
+struct SyntheticTilesetResult {
+  /** The absolute path of the written tileset.json. */
+  FString tilesetFilename;
+
+  /** The `file:///` URL of the written tileset.json. */
+  FString tilesetUrl;
+
+  int64 tileCount = 0;
+  int64 triangleCount = 0;
+  int64 instanceCount = 0;
+  int64 bytesWritten = 0;
+};
+
+/**
+ * Writes a synthetic tileset, as a tileset.json and one GLB per tile, to the
+ * given directory. The output depends only on the options, so the same
+ * options always produce the same tileset.
+ *
+ * Returns a result with an empty URL if any file could not be written.
+ */
+SyntheticTilesetResult generateSyntheticTileset(
+    const FString& directory,
+    const SyntheticTilesetOptions& options);
+
+/**
+ * Gets the number of tiles that generateSyntheticTileset would write for the
+ * given options.
+ */
+int64 countSyntheticTiles(const SyntheticTilesetOptions& options);
+
+} // namespace Cesium
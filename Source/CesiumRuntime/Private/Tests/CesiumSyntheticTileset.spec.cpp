@@ -0,0 +1,137 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumSyntheticTileset.h"
+#include "CesiumGltf/ExtensionExtMeshFeatures.h"
+#include "CesiumGltf/ExtensionExtMeshGpuInstancing.h"
+#include "CesiumGltf/ExtensionModelExtStructuralMetadata.h"
+#include "CesiumGltfReader/GltfReader.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+using namespace Cesium;
+using namespace CesiumGltf;
+
+BEGIN_DEFINE_SPEC(
+    FCesiumSyntheticTilesetSpec,
+    "Cesium.Unit.SyntheticTileset",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+FString Directory;
+SyntheticTilesetOptions Options;
+
+std::optional<Model> ReadContent(const FString& uri) {
+  TArray<uint8> data;
+  if (!FFileHelper::LoadFileToArray(data, *FPaths::Combine(Directory, uri))) {
+    return std::nullopt;
+  }
+
+  CesiumGltfReader::GltfReader reader;
+  CesiumGltfReader::GltfReaderResult result = reader.readGltf(
+      gsl::span<const std::byte>(
+          reinterpret_cast<const std::byte*>(data.GetData()),
+          data.Num()));
+  TestTrue("content has no errors", result.errors.empty());
+  return std::move(result.model);
+}
+END_DEFINE_SPEC(FCesiumSyntheticTilesetSpec)
+
+void FCesiumSyntheticTilesetSpec::Define() {
+  BeforeEach([this]() {
+    Directory = FPaths::ConvertRelativePathToFull(FPaths::Combine(
+        FPaths::ProjectSavedDir(),
+        TEXT("Cesium"),
+        TEXT("Tests"),
+        TEXT("SyntheticTileset")));
+    Options = SyntheticTilesetOptions();
+    Options.maximumDepth = 1;
+    Options.childrenPerAxis = 2;
+    Options.trianglesPerTile = 200;
+    Options.textureSize = 16;
+  });
+
+  AfterEach([this]() {
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+  });
+
+  It("counts the tiles in every level", [this]() {
+    Options.maximumDepth = 2;
+    Options.childrenPerAxis = 3;
+    TestEqual("tiles", countSyntheticTiles(Options), int64(1 + 9 + 81));
+  });
+
+  It("writes a tileset.json and a GLB for every tile", [this]() {
+    SyntheticTilesetResult result =
+        generateSyntheticTileset(Directory, Options);
+    TestFalse("has a URL", result.tilesetUrl.IsEmpty());
+    TestTrue("URL is a file URL", result.tilesetUrl.StartsWith("file:///"));
+    TestEqual("tiles", result.tileCount, countSyntheticTiles(Options));
+    TestTrue(
+        "tileset.json exists",
+        IFileManager::Get().FileExists(*result.tilesetFilename));
+
+    // 200 triangles is rounded up to a 10x10 grid.
+    TestEqual("triangles", result.triangleCount, int64(5 * 200));
+
+    std::optional<Model> maybeRoot = ReadContent(TEXT("content/0_0_0.glb"));
+    if (!TestTrue("root content is valid", maybeRoot.has_value())) {
+      return;
+    }
+    TestEqual("meshes", maybeRoot->meshes.size(), size_t(1));
+    TestEqual("images", maybeRoot->images.size(), size_t(1));
+    TestEqual("image width", maybeRoot->images[0].cesium.width, 16);
+
+    TestTrue(
+        "leaf content is valid",
+        ReadContent(TEXT("content/1_1_1.glb")).has_value());
+  });
+
+  It("adds feature IDs and property tables", [this]() {
+    Options.maximumDepth = 0;
+    Options.featuresPerTile = 10;
+    Options.metadataPropertiesPerTile = 3;
+    generateSyntheticTileset(Directory, Options);
+
+    std::optional<Model> maybeModel = ReadContent(TEXT("content/0_0_0.glb"));
+    if (!TestTrue("content is valid", maybeModel.has_value())) {
+      return;
+    }
+
+    const MeshPrimitive& primitive = maybeModel->meshes[0].primitives[0];
+    const ExtensionExtMeshFeatures* pFeatures =
+        primitive.getExtension<ExtensionExtMeshFeatures>();
+    if (TestNotNull("has EXT_mesh_features", pFeatures)) {
+      TestEqual("feature count", pFeatures->featureIds[0].featureCount, 10);
+    }
+
+    const ExtensionModelExtStructuralMetadata* pMetadata =
+        maybeModel->getExtension<ExtensionModelExtStructuralMetadata>();
+    if (TestNotNull("has EXT_structural_metadata", pMetadata)) {
+      TestEqual("rows", pMetadata->propertyTables[0].count, int64_t(10));
+      TestEqual(
+          "properties",
+          pMetadata->propertyTables[0].properties.size(),
+          size_t(3));
+    }
+  });
+
+  It("adds instanced meshes", [this]() {
+    Options.maximumDepth = 0;
+    Options.instancesPerTile = 9;
+    SyntheticTilesetResult result =
+        generateSyntheticTileset(Directory, Options);
+    TestEqual("instances", result.instanceCount, int64(9));
+
+    std::optional<Model> maybeModel = ReadContent(TEXT("content/0_0_0.glb"));
+    if (!TestTrue("content is valid", maybeModel.has_value())) {
+      return;
+    }
+
+    TestEqual("meshes", maybeModel->meshes.size(), size_t(2));
+    TestEqual("nodes", maybeModel->nodes.size(), size_t(2));
+    TestNotNull(
+        "has EXT_mesh_gpu_instancing",
+        maybeModel->nodes[1].getExtension<ExtensionExtMeshGpuInstancing>());
+  });
+}
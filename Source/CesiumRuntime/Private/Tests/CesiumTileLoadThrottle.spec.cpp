@@ -0,0 +1,147 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumTileLoadThrottle.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(
+    FCesiumTileLoadThrottleSpec,
+    "Cesium.Unit.TileLoadThrottle",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+const double TargetFrameSeconds = 1.0 / 60.0;
+
+/**
+ * Updates the throttle with frames of the given duration, for the given
+ * number of seconds.
+ */
+void Run(
+    CesiumTileLoadThrottle& throttle,
+    ECesiumLoadingPriorityMode mode,
+    double frameSeconds,
+    double seconds) {
+  for (double elapsed = 0.0; elapsed < seconds; elapsed += frameSeconds) {
+    throttle.update(mode, 20, true, TargetFrameSeconds, frameSeconds);
+  }
+}
+
+END_DEFINE_SPEC(FCesiumTileLoadThrottleSpec)
+
+void FCesiumTileLoadThrottleSpec::Define() {
+  It("scales the load limits by the loading priority mode", [this]() {
+    CesiumTileLoadThrottle throttle;
+    TestEqual(
+        "background loads",
+        throttle.getSimultaneousTileLoads(
+            ECesiumLoadingPriorityMode::Background,
+            20),
+        5);
+    TestEqual(
+        "normal loads",
+        throttle.getSimultaneousTileLoads(
+            ECesiumLoadingPriorityMode::Normal,
+            20),
+        20);
+    TestEqual(
+        "aggressive loads",
+        throttle.getSimultaneousTileLoads(
+            ECesiumLoadingPriorityMode::Aggressive,
+            20),
+        40);
+    TestEqual(
+        "normal main thread time",
+        throttle.getMainThreadLoadingMilliseconds(
+            ECesiumLoadingPriorityMode::Normal),
+        CesiumTileLoadThrottle::DefaultMainThreadLoadingMilliseconds);
+    TestTrue(
+        "background main thread time",
+        throttle.getMainThreadLoadingMilliseconds(
+            ECesiumLoadingPriorityMode::Background) <
+            CesiumTileLoadThrottle::DefaultMainThreadLoadingMilliseconds);
+  });
+
+  It("keeps at least one load going", [this]() {
+    CesiumTileLoadThrottle throttle;
+    TestEqual(
+        "loads",
+        throttle.getSimultaneousTileLoads(
+            ECesiumLoadingPriorityMode::Background,
+            1),
+        1);
+    TestEqual(
+        "no loads",
+        throttle.getSimultaneousTileLoads(
+            ECesiumLoadingPriorityMode::Aggressive,
+            0),
+        0);
+  });
+
+  It("throttles while frames are slow and recovers", [this]() {
+    CesiumTileLoadThrottle throttle;
+    Run(throttle,
+        ECesiumLoadingPriorityMode::Normal,
+        TargetFrameSeconds * 2.0,
+        5.0);
+    const int32 throttled = throttle.getSimultaneousTileLoads(
+        ECesiumLoadingPriorityMode::Normal,
+        20);
+    TestTrue("throttled", throttled < 20);
+    TestTrue("still loading", throttled >= 1);
+    TestTrue(
+        "main thread time throttled",
+        throttle.getMainThreadLoadingMilliseconds(
+            ECesiumLoadingPriorityMode::Normal) <
+            CesiumTileLoadThrottle::DefaultMainThreadLoadingMilliseconds);
+    TestEqual(
+        "aggressive ignores the frame time",
+        throttle.getSimultaneousTileLoads(
+            ECesiumLoadingPriorityMode::Aggressive,
+            20),
+        40);
+
+    Run(throttle,
+        ECesiumLoadingPriorityMode::Normal,
+        TargetFrameSeconds * 0.5,
+        30.0);
+    TestEqual(
+        "recovered",
+        throttle.getSimultaneousTileLoads(
+            ECesiumLoadingPriorityMode::Normal,
+            20),
+        20);
+  });
+
+  It("ignores a single slow frame", [this]() {
+    CesiumTileLoadThrottle throttle;
+    Run(throttle,
+        ECesiumLoadingPriorityMode::Normal,
+        TargetFrameSeconds * 0.5,
+        1.0);
+    Run(throttle, ECesiumLoadingPriorityMode::Normal, 0.04, 0.01);
+    Run(throttle,
+        ECesiumLoadingPriorityMode::Normal,
+        TargetFrameSeconds * 0.5,
+        0.3);
+    TestEqual("frame time factor", throttle.getFrameTimeFactor(), 1.0);
+  });
+
+  It("stops throttling when disabled", [this]() {
+    CesiumTileLoadThrottle throttle;
+    Run(throttle,
+        ECesiumLoadingPriorityMode::Normal,
+        TargetFrameSeconds * 2.0,
+        5.0);
+    throttle.update(
+        ECesiumLoadingPriorityMode::Normal,
+        20,
+        false,
+        TargetFrameSeconds,
+        TargetFrameSeconds * 2.0);
+    TestEqual(
+        "loads",
+        throttle.getSimultaneousTileLoads(
+            ECesiumLoadingPriorityMode::Normal,
+            20),
+        20);
+  });
+}
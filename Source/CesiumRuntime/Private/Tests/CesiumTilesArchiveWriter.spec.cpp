@@ -0,0 +1,166 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumTilesArchiveWriter.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include <cstring>
+#include <string>
+
+namespace {
+
+uint32 read16(const TArray<uint8>& bytes, int32 offset) {
+  return uint32(bytes[offset]) | (uint32(bytes[offset + 1]) << 8);
+}
+
+uint32 read32(const TArray<uint8>& bytes, int32 offset) {
+  return read16(bytes, offset) | (read16(bytes, offset + 2) << 16);
+}
+
+uint64 read64(const TArray<uint8>& bytes, int32 offset) {
+  return uint64(read32(bytes, offset)) |
+         (uint64(read32(bytes, offset + 4)) << 32);
+}
+
+struct ArchiveEntry {
+  FString path;
+  int32 offset;
+  TArray<uint8> data;
+};
+
+/**
+ * Reads the entries of an archive from its central directory, or returns
+ * nothing if it does not end with an end of central directory record.
+ */
+TArray<ArchiveEntry> readEntries(const TArray<uint8>& archive) {
+  TArray<ArchiveEntry> entries;
+  const int32 end = archive.Num() - 22;
+  if (end < 0 || read32(archive, end) != 0x06054b50) {
+    return entries;
+  }
+
+  const uint32 count = read16(archive, end + 10);
+  int32 offset = int32(read32(archive, end + 16));
+  for (uint32 i = 0; i < count; ++i) {
+    const uint32 pathLength = read16(archive, offset + 28);
+    const uint32 extraLength = read16(archive, offset + 30);
+    const uint32 commentLength = read16(archive, offset + 32);
+
+    ArchiveEntry& entry = entries.Emplace_GetRef();
+    const std::string path(
+        reinterpret_cast<const char*>(&archive[offset + 46]),
+        pathLength);
+    entry.path = UTF8_TO_TCHAR(path.c_str());
+    entry.offset = int32(read32(archive, offset + 42));
+
+    const int32 dataOffset = entry.offset + 30 +
+                             int32(read16(archive, entry.offset + 26)) +
+                             int32(read16(archive, entry.offset + 28));
+    entry.data = TArray<uint8>(
+        &archive[dataOffset],
+        int32(read32(archive, entry.offset + 22)));
+
+    offset += int32(46 + pathLength + extraLength + commentLength);
+  }
+
+  return entries;
+}
+
+gsl::span<const std::byte> span(const char* text) {
+  return gsl::span<const std::byte>(
+      reinterpret_cast<const std::byte*>(text),
+      std::strlen(text));
+}
+
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+    FCesiumTilesArchiveWriterSpec,
+    "Cesium.Unit.TilesArchiveWriter",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+FString Filename;
+
+END_DEFINE_SPEC(FCesiumTilesArchiveWriterSpec)
+
+void FCesiumTilesArchiveWriterSpec::Define() {
+  BeforeEach([this]() {
+    Filename = FPaths::ConvertRelativePathToFull(
+        FPaths::CreateTempFilename(*FPaths::ProjectSavedDir()));
+  });
+
+  AfterEach([this]() { IFileManager::Get().Delete(*Filename); });
+
+  It("writes the files followed by an index of them", [this]() {
+    {
+      CesiumTilesArchiveWriter writer(Filename);
+      if (!TestTrue("open", writer.isOpen())) {
+        return;
+      }
+      TestTrue("root", writer.addFile(TEXT("tileset.json"), span("{}")));
+      TestTrue("tile", writer.addFile(TEXT("tiles/0.glb"), span("glTF")));
+      TestTrue("closed", writer.close());
+    }
+
+    TArray<uint8> archive;
+    if (!TestTrue("read", FFileHelper::LoadFileToArray(archive, *Filename))) {
+      return;
+    }
+
+    const TArray<ArchiveEntry> entries = readEntries(archive);
+    if (!TestEqual("entries", entries.Num(), 3)) {
+      return;
+    }
+    TestEqual("root path", entries[0].path, FString(TEXT("tileset.json")));
+    TestEqual("root size", entries[0].data.Num(), 2);
+    TestEqual("tile path", entries[1].path, FString(TEXT("tiles/0.glb")));
+    TestEqual(
+        "index path",
+        entries[2].path,
+        FString(TEXT("@3dtilesIndex1@")));
+
+    // Each index record is the MD5 hash of a path and the offset of its
+    // entry, sorted by hash.
+    const TArray<uint8>& index = entries[2].data;
+    if (!TestEqual("index size", index.Num(), 2 * 24)) {
+      return;
+    }
+    TestTrue(
+        "sorted",
+        read64(index, 0) < read64(index, 24) ||
+            (read64(index, 0) == read64(index, 24) &&
+             read64(index, 8) < read64(index, 32)));
+
+    for (int32 i = 0; i < 2; ++i) {
+      const int32 offset = int32(read64(index, i * 24 + 16));
+      const ArchiveEntry* pEntry = entries.FindByPredicate(
+          [offset](const ArchiveEntry& entry) {
+            return entry.offset == offset;
+          });
+      if (!TestNotNull("indexed entry", pEntry)) {
+        continue;
+      }
+
+      FTCHARToUTF8 path(*pEntry->path);
+      uint8 hash[16];
+      FMD5 md5;
+      md5.Update(reinterpret_cast<const uint8*>(path.Get()), path.Length());
+      md5.Final(hash);
+      TestEqual(
+          "hash",
+          FMemory::Memcmp(hash, &index[i * 24], sizeof(hash)),
+          0);
+    }
+  });
+
+  It("does not add a path twice", [this]() {
+    CesiumTilesArchiveWriter writer(Filename);
+    TestTrue("first", writer.addFile(TEXT("tileset.json"), span("{}")));
+    TestFalse("second", writer.addFile(TEXT("tileset.json"), span("{}")));
+    TestTrue("contains", writer.contains(TEXT("tileset.json")));
+    TestEqual("files", writer.getFileCount(), int64(1));
+  });
+}
@@ -0,0 +1,217 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumWarmStart.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace {
+
+class FakeRequest : public CesiumAsync::IAssetRequest,
+                    public CesiumAsync::IAssetResponse {
+public:
+  explicit FakeRequest(const std::string& url) : _url(url) {}
+
+  virtual const std::string& method() const override { return this->_method; }
+  virtual const std::string& url() const override { return this->_url; }
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+  virtual const CesiumAsync::IAssetResponse* response() const override {
+    return this;
+  }
+  virtual uint16_t statusCode() const override { return 200; }
+  virtual std::string contentType() const override { return std::string(); }
+  virtual gsl::span<const std::byte> data() const override {
+    return gsl::span<const std::byte>();
+  }
+
+private:
+  std::string _method = "GET";
+  std::string _url;
+  CesiumAsync::HttpHeaders _headers;
+};
+
+/**
+ * An asset accessor that completes every request at once, and records the
+ * URL and headers of each.
+ */
+class RecordingAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    this->requests.emplace_back(url, headers);
+    return asyncSystem.createResolvedFuture<
+        std::shared_ptr<CesiumAsync::IAssetRequest>>(
+        std::make_shared<FakeRequest>(url));
+  }
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  virtual void tick() noexcept override {}
+
+  std::vector<std::pair<std::string, std::vector<THeader>>> requests;
+};
+
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+    FCesiumWarmStartSpec,
+    "Cesium.Unit.WarmStart",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+FString Filename;
+
+END_DEFINE_SPEC(FCesiumWarmStartSpec)
+
+void FCesiumWarmStartSpec::Define() {
+  Describe("snapshot", [this]() {
+    BeforeEach([this]() {
+      Filename = FPaths::ConvertRelativePathToFull(
+          FPaths::CreateTempFilename(*FPaths::ProjectSavedDir()));
+    });
+
+    AfterEach([this]() { IFileManager::Get().Delete(*Filename); });
+
+    It("reads back what was written", [this]() {
+      CesiumWarmStart::Snapshot snapshot;
+      snapshot.urls = {
+          "https://example.com/tiles/0.glb",
+          "https://example.com/tiles/1.glb?v=2"};
+      snapshot.timeToFirstFullView = 2.5;
+      TestTrue("saved", CesiumWarmStart::saveSnapshot(Filename, snapshot));
+
+      std::optional<CesiumWarmStart::Snapshot> maybeLoaded =
+          CesiumWarmStart::loadSnapshot(Filename);
+      if (!TestTrue("loaded", maybeLoaded.has_value())) {
+        return;
+      }
+      TestTrue("urls", maybeLoaded->urls == snapshot.urls);
+      TestEqual(
+          "time to first full view",
+          maybeLoaded->timeToFirstFullView,
+          2.5);
+    });
+
+    It("does not write credentials", [this]() {
+      CesiumWarmStart::Snapshot snapshot;
+      snapshot.urls = {
+          "https://example.com/tiles/0.glb?key=secret&v=2&session=abc#x",
+          "https://example.com/tiles/1.glb?X-Amz-Signature=secret"};
+      TestTrue("saved", CesiumWarmStart::saveSnapshot(Filename, snapshot));
+
+      FString contents;
+      FFileHelper::LoadFileToString(contents, *Filename);
+      TestFalse("has secret", contents.Contains(TEXT("secret")));
+
+      std::optional<CesiumWarmStart::Snapshot> maybeLoaded =
+          CesiumWarmStart::loadSnapshot(Filename);
+      if (!TestTrue("loaded", maybeLoaded.has_value())) {
+        return;
+      }
+      TestTrue(
+          "urls",
+          maybeLoaded->urls ==
+              std::vector<std::string>{
+                  "https://example.com/tiles/0.glb?v=2#x",
+                  "https://example.com/tiles/1.glb"});
+    });
+
+    It("ignores files that are not snapshots", [this]() {
+      FFileHelper::SaveStringToFile(
+          TEXT("https://example.com/tiles/0.glb\n"),
+          *Filename);
+      TestFalse(
+          "loaded",
+          CesiumWarmStart::loadSnapshot(Filename).has_value());
+      TestFalse(
+          "missing",
+          CesiumWarmStart::loadSnapshot(Filename + TEXT(".missing"))
+              .has_value());
+    });
+  });
+
+  Describe("asset accessor", [this]() {
+    It("prefetches once, with the headers of the first request", [this]() {
+      auto pRecording = std::make_shared<RecordingAssetAccessor>();
+      std::shared_ptr<CesiumAsync::IAssetAccessor> pAccessor =
+          CesiumWarmStart::createAssetAccessor(
+              pRecording,
+              {"https://tiles.example.com/1/a.glb",
+               "https://tiles.example.com/1/b.glb",
+               "https://other.example.com/c.glb"});
+
+      // A request to another server does not start the prefetch.
+      pAccessor->get(
+          getAsyncSystem(),
+          "https://api.example.com/v1/assets/1/endpoint",
+          {});
+      TestEqual("before", int32(pRecording->requests.size()), 1);
+
+      const std::vector<CesiumAsync::IAssetAccessor::THeader> headers{
+          {"Authorization", "Bearer token"}};
+      pAccessor->get(
+          getAsyncSystem(),
+          "https://tiles.example.com/1/tileset.json",
+          headers);
+      if (!TestEqual("after", int32(pRecording->requests.size()), 4)) {
+        return;
+      }
+      TestEqual(
+          "requested first",
+          FString(UTF8_TO_TCHAR(pRecording->requests[1].first.c_str())),
+          FString(TEXT("https://tiles.example.com/1/tileset.json")));
+      TestEqual(
+          "prefetched",
+          FString(UTF8_TO_TCHAR(pRecording->requests[3].first.c_str())),
+          FString(TEXT("https://tiles.example.com/1/b.glb")));
+      TestTrue("headers", pRecording->requests[2].second == headers);
+
+      pAccessor->get(
+          getAsyncSystem(),
+          "https://tiles.example.com/1/a.glb",
+          headers);
+      TestEqual("once", int32(pRecording->requests.size()), 5);
+    });
+
+    It("prefetches with the credentials of the first request", [this]() {
+      auto pRecording = std::make_shared<RecordingAssetAccessor>();
+      std::shared_ptr<CesiumAsync::IAssetAccessor> pAccessor =
+          CesiumWarmStart::createAssetAccessor(
+              pRecording,
+              {"https://tiles.example.com/a.glb?v=1",
+               "https://tiles.example.com/b.glb?key=old"});
+
+      pAccessor->get(
+          getAsyncSystem(),
+          "https://tiles.example.com/tileset.json?key=new&v=3",
+          {});
+      if (!TestEqual("requests", int32(pRecording->requests.size()), 3)) {
+        return;
+      }
+      TestEqual(
+          "with a query",
+          FString(UTF8_TO_TCHAR(pRecording->requests[1].first.c_str())),
+          FString(TEXT("https://tiles.example.com/a.glb?v=1&key=new")));
+      TestEqual(
+          "replacing old credentials",
+          FString(UTF8_TO_TCHAR(pRecording->requests[2].first.c_str())),
+          FString(TEXT("https://tiles.example.com/b.glb?key=new")));
+    });
+  });
+}
@@ -0,0 +1,230 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CoalescingAssetAccessor.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "Misc/AutomationTest.h"
+#include <optional>
+#include <stdexcept>
+
+namespace {
+
+class FakeRequest : public CesiumAsync::IAssetRequest,
+                    public CesiumAsync::IAssetResponse {
+public:
+  explicit FakeRequest(const std::string& url) : _url(url) {}
+
+  virtual const std::string& method() const override { return this->_method; }
+  virtual const std::string& url() const override { return this->_url; }
+  virtual const CesiumAsync::HttpHeaders& headers() const override {
+    return this->_headers;
+  }
+  virtual const CesiumAsync::IAssetResponse* response() const override {
+    return this;
+  }
+  virtual uint16_t statusCode() const override { return 200; }
+  virtual std::string contentType() const override { return std::string(); }
+  virtual gsl::span<const std::byte> data() const override {
+    return gsl::span<const std::byte>();
+  }
+
+private:
+  std::string _method = "GET";
+  std::string _url;
+  CesiumAsync::HttpHeaders _headers;
+};
+
+/**
+ * An asset accessor whose requests complete only when `complete` is called,
+ * and which counts the requests it is sent.
+ */
+class PendingAssetAccessor : public CesiumAsync::IAssetAccessor {
+public:
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  get(const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    ++this->requestCount;
+    this->pending.emplace_back(
+        url,
+        asyncSystem
+            .createPromise<std::shared_ptr<CesiumAsync::IAssetRequest>>());
+    return this->pending.back().second.getFuture();
+  }
+
+  virtual CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
+  request(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::string& verb,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& contentPayload) override {
+    return this->get(asyncSystem, url, headers);
+  }
+
+  virtual void tick() noexcept override {}
+
+  /** Completes all of the pending requests. */
+  void complete() {
+    for (auto& [url, promise] : this->pending) {
+      promise.resolve(std::make_shared<FakeRequest>(url));
+    }
+    this->pending.clear();
+  }
+
+  /** Fails all of the pending requests with the given message. */
+  void fail(const std::string& message) {
+    for (auto& [url, promise] : this->pending) {
+      promise.reject(std::runtime_error(message));
+    }
+    this->pending.clear();
+  }
+
+  int32 requestCount = 0;
+  std::vector<std::pair<
+      std::string,
+      CesiumAsync::Promise<std::shared_ptr<CesiumAsync::IAssetRequest>>>>
+      pending;
+};
+
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+    FCoalescingAssetAccessorSpec,
+    "Cesium.Unit.CoalescingAssetAccessor",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+std::shared_ptr<PendingAssetAccessor> pPending;
+std::shared_ptr<CoalescingAssetAccessor> pAccessor;
+
+/** Waits for the given requests and returns them. */
+std::vector<std::shared_ptr<CesiumAsync::IAssetRequest>> Wait(
+    std::vector<CesiumAsync::Future<
+        std::shared_ptr<CesiumAsync::IAssetRequest>>>&& futures) {
+  std::vector<std::shared_ptr<CesiumAsync::IAssetRequest>> result;
+  for (auto& future : futures) {
+    std::optional<std::shared_ptr<CesiumAsync::IAssetRequest>> maybeRequest;
+    std::move(future).thenImmediately(
+        [&maybeRequest](std::shared_ptr<CesiumAsync::IAssetRequest>&& p) {
+          maybeRequest = std::move(p);
+        });
+    while (!maybeRequest) {
+      getAsyncSystem().dispatchMainThreadTasks();
+    }
+    result.emplace_back(std::move(*maybeRequest));
+  }
+  return result;
+}
+
+END_DEFINE_SPEC(FCoalescingAssetAccessorSpec)
+
+void FCoalescingAssetAccessorSpec::Define() {
+  BeforeEach([this]() {
+    pPending = std::make_shared<PendingAssetAccessor>();
+    pAccessor = std::make_shared<CoalescingAssetAccessor>(pPending);
+  });
+
+  It("sends identical concurrent requests once", [this]() {
+    std::vector<CesiumAsync::Future<
+        std::shared_ptr<CesiumAsync::IAssetRequest>>>
+        futures;
+    for (int32 i = 0; i < 3; ++i) {
+      futures.emplace_back(
+          pAccessor->get(getAsyncSystem(), "https://example.com/a", {}));
+    }
+
+    TestEqual("requests sent", pPending->requestCount, 1);
+    TestEqual("in flight", pAccessor->getInFlightRequestCount(), int64(1));
+
+    pPending->complete();
+    std::vector<std::shared_ptr<CesiumAsync::IAssetRequest>> requests =
+        Wait(std::move(futures));
+
+    TestEqual("coalesced", pAccessor->getCoalescedRequestCount(), int64(2));
+    TestEqual("in flight", pAccessor->getInFlightRequestCount(), int64(0));
+    TestTrue("shared second", requests[1] == requests[0]);
+    TestTrue("shared third", requests[2] == requests[0]);
+  });
+
+  It("sends requests with different URLs or headers separately", [this]() {
+    std::vector<CesiumAsync::Future<
+        std::shared_ptr<CesiumAsync::IAssetRequest>>>
+        futures;
+    futures.emplace_back(
+        pAccessor->get(getAsyncSystem(), "https://example.com/a", {}));
+    futures.emplace_back(
+        pAccessor->get(getAsyncSystem(), "https://example.com/b", {}));
+    futures.emplace_back(pAccessor->get(
+        getAsyncSystem(),
+        "https://example.com/a",
+        {{"Authorization", "Bearer 1"}}));
+
+    TestEqual("requests sent", pPending->requestCount, 3);
+
+    pPending->complete();
+    Wait(std::move(futures));
+    TestEqual("coalesced", pAccessor->getCoalescedRequestCount(), int64(0));
+  });
+
+  It("sends a request again after it completes", [this]() {
+    std::vector<CesiumAsync::Future<
+        std::shared_ptr<CesiumAsync::IAssetRequest>>>
+        futures;
+    futures.emplace_back(
+        pAccessor->get(getAsyncSystem(), "https://example.com/a", {}));
+    pPending->complete();
+    Wait(std::move(futures));
+
+    futures.clear();
+    futures.emplace_back(
+        pAccessor->get(getAsyncSystem(), "https://example.com/a", {}));
+    pPending->complete();
+    Wait(std::move(futures));
+
+    TestEqual("requests sent", pPending->requestCount, 2);
+  });
+
+  It("keeps the message of a failed request", [this]() {
+    std::vector<std::optional<std::string>> messages(2);
+    for (std::optional<std::string>& message : messages) {
+      pAccessor->get(getAsyncSystem(), "https://example.com/a", {})
+          .thenImmediately(
+              [](std::shared_ptr<CesiumAsync::IAssetRequest>&&) {})
+          .catchImmediately([&message](std::exception&& e) {
+            message = e.what();
+          });
+    }
+
+    TestEqual("requests sent", pPending->requestCount, 1);
+    pPending->fail("Connection failed.");
+
+    for (const std::optional<std::string>& message : messages) {
+      while (!message) {
+        getAsyncSystem().dispatchMainThreadTasks();
+      }
+      TestEqual("message", *message, std::string("Connection failed."));
+    }
+    TestEqual("in flight", pAccessor->getInFlightRequestCount(), int64(0));
+  });
+
+  It("does not coalesce requests with a payload", [this]() {
+    const std::byte payload[] = {std::byte(1)};
+    std::vector<CesiumAsync::Future<
+        std::shared_ptr<CesiumAsync::IAssetRequest>>>
+        futures;
+    for (int32 i = 0; i < 2; ++i) {
+      futures.emplace_back(pAccessor->request(
+          getAsyncSystem(),
+          "POST",
+          "https://example.com/a",
+          {},
+          gsl::span<const std::byte>(payload)));
+    }
+
+    TestEqual("requests sent", pPending->requestCount, 2);
+    pPending->complete();
+    Wait(std::move(futures));
+  });
+}
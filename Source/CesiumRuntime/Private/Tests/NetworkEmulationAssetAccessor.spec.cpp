@@ -0,0 +1,123 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "NetworkEmulationAssetAccessor.h"
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRuntime.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UnrealAssetAccessor.h"
+
+BEGIN_DEFINE_SPEC(
+    FNetworkEmulationAssetAccessorSpec,
+    "Cesium.Unit.NetworkEmulationAssetAccessor",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+FString Filename;
+FString Uri;
+std::string Text = "Some emulated text.";
+
+void SetVariable(const TCHAR* name, const TCHAR* value) {
+  IConsoleVariable* pVariable =
+      IConsoleManager::Get().FindConsoleVariable(name);
+  if (TestNotNull(name, pVariable)) {
+    pVariable->Set(value, ECVF_SetByCode);
+  }
+}
+
+/**
+ * Requests the test file through a new emulating accessor, and returns the
+ * status code of the response and the time it took.
+ */
+std::pair<uint16_t, double> Request() {
+  NetworkEmulationAssetAccessor accessor(
+      std::make_shared<UnrealAssetAccessor>());
+
+  bool done = false;
+  uint16_t statusCode = 0;
+  const double start = FPlatformTime::Seconds();
+  double end = start;
+
+  accessor.get(getAsyncSystem(), TCHAR_TO_UTF8(*Uri), {})
+      .thenInMainThread(
+          [&](std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest) {
+            end = FPlatformTime::Seconds();
+            const CesiumAsync::IAssetResponse* pResponse =
+                pRequest->response();
+            if (TestNotNull("response", pResponse)) {
+              statusCode = pResponse->statusCode();
+            }
+            done = true;
+          });
+
+  while (!done) {
+    accessor.tick();
+    getAsyncSystem().dispatchMainThreadTasks();
+  }
+
+  return {statusCode, end - start};
+}
+
+END_DEFINE_SPEC(FNetworkEmulationAssetAccessorSpec)
+
+void FNetworkEmulationAssetAccessorSpec::Define() {
+  BeforeEach([this]() {
+    Filename = FPaths::ConvertRelativePathToFull(
+        FPaths::CreateTempFilename(*FPaths::ProjectSavedDir()));
+    FFileHelper::SaveStringToFile(
+        UTF8_TO_TCHAR(Text.c_str()),
+        *Filename,
+        FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+
+    Uri = TEXT("file:///") + Filename;
+    Uri.ReplaceCharInline('\\', '/');
+    Uri.ReplaceInline(TEXT(" "), TEXT("%20"));
+
+    SetVariable(TEXT("cesium.NetworkEmulation.Enabled"), TEXT("1"));
+    SetVariable(TEXT("cesium.NetworkEmulation.LatencyMs"), TEXT("0"));
+    SetVariable(TEXT("cesium.NetworkEmulation.JitterMs"), TEXT("0"));
+    SetVariable(TEXT("cesium.NetworkEmulation.BandwidthKbps"), TEXT("0"));
+    SetVariable(TEXT("cesium.NetworkEmulation.FailureRate"), TEXT("0"));
+  });
+
+  AfterEach([this]() {
+    FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*Filename);
+
+    SetVariable(TEXT("cesium.NetworkEmulation.Enabled"), TEXT("-1"));
+    SetVariable(TEXT("cesium.NetworkEmulation.LatencyMs"), TEXT("-1"));
+    SetVariable(TEXT("cesium.NetworkEmulation.JitterMs"), TEXT("-1"));
+    SetVariable(TEXT("cesium.NetworkEmulation.BandwidthKbps"), TEXT("-1"));
+    SetVariable(TEXT("cesium.NetworkEmulation.FailureRate"), TEXT("-1"));
+  });
+
+  It("passes requests through when disabled", [this]() {
+    SetVariable(TEXT("cesium.NetworkEmulation.Enabled"), TEXT("0"));
+    SetVariable(TEXT("cesium.NetworkEmulation.FailureRate"), TEXT("1"));
+    TestEqual("status", Request().first, uint16_t(200));
+  });
+
+  It("delays responses by the latency", [this]() {
+    SetVariable(TEXT("cesium.NetworkEmulation.LatencyMs"), TEXT("200"));
+    std::pair<uint16_t, double> result = Request();
+    TestEqual("status", result.first, uint16_t(200));
+    TestTrue("delayed", result.second >= 0.2);
+  });
+
+  It("limits the bandwidth", [this]() {
+    // 0.08 kilobits per second is 10 bytes per second.
+    SetVariable(TEXT("cesium.NetworkEmulation.BandwidthKbps"), TEXT("0.08"));
+    std::pair<uint16_t, double> result = Request();
+    TestEqual("status", result.first, uint16_t(200));
+    TestTrue("delayed", result.second >= double(Text.size()) / 10.0);
+  });
+
+  It("fails requests at the failure rate", [this]() {
+    SetVariable(TEXT("cesium.NetworkEmulation.FailureRate"), TEXT("1"));
+    TestEqual("status", Request().first, uint16_t(503));
+  });
+}
@@ -0,0 +1,198 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#include "CesiumAsync/CacheItem.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "ShardedFileCacheDatabase.h"
+#include <ctime>
+
+BEGIN_DEFINE_SPEC(
+    FShardedFileCacheDatabaseSpec,
+    "Cesium.Unit.ShardedFileCacheDatabase",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+FString Directory;
+
+std::vector<std::byte> Bytes(const std::string& text) {
+  const std::byte* pText = reinterpret_cast<const std::byte*>(text.data());
+  return std::vector<std::byte>(pText, pText + text.size());
+}
+
+bool Store(
+    ShardedFileCacheDatabase& database,
+    const std::string& key,
+    const std::string& data,
+    std::time_t expiryTime = std::time(nullptr) + 3600) {
+  const std::vector<std::byte> bytes = Bytes(data);
+  return database.storeEntry(
+      key,
+      expiryTime,
+      "https://example.com/" + key,
+      "GET",
+      CesiumAsync::HttpHeaders{{"Accept", "*/*"}},
+      200,
+      CesiumAsync::HttpHeaders{{"Content-Type", "application/octet-stream"}},
+      gsl::span<const std::byte>(bytes));
+}
+
+/** Gets the data of the given entry, or "missing" if it is not cached. */
+std::string Data(ShardedFileCacheDatabase& database, const std::string& key) {
+  std::optional<CesiumAsync::CacheItem> item = database.getEntry(key);
+  if (!item) {
+    return "missing";
+  }
+  return std::string(
+      reinterpret_cast<const char*>(item->cacheResponse.data.data()),
+      item->cacheResponse.data.size());
+}
+
+END_DEFINE_SPEC(FShardedFileCacheDatabaseSpec)
+
+void FShardedFileCacheDatabaseSpec::Define() {
+  BeforeEach([this]() {
+    Directory = FPaths::ConvertRelativePathToFull(
+        FPaths::CreateTempFilename(*FPaths::ProjectSavedDir()));
+  });
+
+  AfterEach([this]() {
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+  });
+
+  It("returns the entries that were stored", [this]() {
+    ShardedFileCacheDatabase database(Directory, 100);
+    const std::time_t expiryTime = std::time(nullptr) + 60;
+    TestTrue("stored", Store(database, "a", "first", expiryTime));
+
+    std::optional<CesiumAsync::CacheItem> item = database.getEntry("a");
+    if (!TestTrue("found", item.has_value())) {
+      return;
+    }
+    TestEqual("expiry time", int64(item->expiryTime), int64(expiryTime));
+    TestEqual(
+        "url",
+        item->cacheRequest.url,
+        std::string("https://example.com/a"));
+    TestEqual("method", item->cacheRequest.method, std::string("GET"));
+    TestEqual(
+        "request header",
+        item->cacheRequest.headers["accept"],
+        std::string("*/*"));
+    TestEqual("status", item->cacheResponse.statusCode, uint16_t(200));
+    TestEqual(
+        "response header",
+        item->cacheResponse.headers["Content-Type"],
+        std::string("application/octet-stream"));
+    TestEqual("data", Data(database, "a"), std::string("first"));
+    TestEqual("missing", Data(database, "b"), std::string("missing"));
+  });
+
+  It("returns the latest of several stores of an entry", [this]() {
+    ShardedFileCacheDatabase database(Directory, 100);
+    Store(database, "a", "first");
+    Store(database, "a", "second");
+    TestEqual("data", Data(database, "a"), std::string("second"));
+    TestEqual("entries", database.getEntryCount(), int64(1));
+  });
+
+  It("keeps its entries when it is opened again", [this]() {
+    {
+      ShardedFileCacheDatabase database(Directory, 100);
+      for (int32 i = 0; i < 100; ++i) {
+        Store(database, std::to_string(i), "data " + std::to_string(i));
+      }
+    }
+
+    ShardedFileCacheDatabase database(Directory, 100);
+    TestEqual("entries", database.getEntryCount(), int64(100));
+    TestEqual("first", Data(database, "0"), std::string("data 0"));
+    TestEqual("last", Data(database, "99"), std::string("data 99"));
+  });
+
+  It("prunes expired and then least recently used entries", [this]() {
+    {
+      ShardedFileCacheDatabase database(Directory, 2, 1);
+      Store(database, "a", "a");
+      Store(database, "b", "b");
+      Store(database, "c", "c");
+      Store(database, "expired", "expired", std::time(nullptr) - 60);
+      Data(database, "a");
+
+      TestTrue("pruned", database.prune());
+      TestEqual("entries", database.getEntryCount(), int64(2));
+      TestEqual("used", Data(database, "a"), std::string("a"));
+      TestEqual("unused", Data(database, "b"), std::string("missing"));
+      TestEqual("newest", Data(database, "c"), std::string("c"));
+      TestEqual(
+          "expired",
+          Data(database, "expired"),
+          std::string("missing"));
+    }
+
+    // The removals are recorded in the files.
+    ShardedFileCacheDatabase database(Directory, 2, 1);
+    TestEqual("entries after reopening", database.getEntryCount(), int64(2));
+    TestEqual("unused", Data(database, "b"), std::string("missing"));
+  });
+
+  It("removes everything when cleared", [this]() {
+    ShardedFileCacheDatabase database(Directory, 100);
+    Store(database, "a", "a");
+    Store(database, "b", "b");
+    TestTrue("cleared", database.clearAll());
+    TestEqual("entries", database.getEntryCount(), int64(0));
+    TestEqual("file bytes", database.getFileBytes(), int64(0));
+    TestEqual("data", Data(database, "a"), std::string("missing"));
+
+    TestTrue("stored after clearing", Store(database, "c", "c"));
+    TestEqual("data after clearing", Data(database, "c"), std::string("c"));
+  });
+
+  It("discards an entry that was only partly written", [this]() {
+    {
+      ShardedFileCacheDatabase database(Directory, 100, 1);
+      Store(database, "a", "complete");
+      Store(database, "b", "partly written");
+    }
+
+    const FString filename =
+        FPaths::Combine(Directory, TEXT("shard-0-of-1.dat"));
+    {
+      IPlatformFile& platformFile =
+          FPlatformFileManager::Get().GetPlatformFile();
+      TUniquePtr<IFileHandle> pFile(
+          platformFile.OpenWrite(*filename, true, true));
+      if (!TestNotNull("file", pFile.Get())) {
+        return;
+      }
+      pFile->Truncate(pFile->Size() - 4);
+    }
+
+    {
+      ShardedFileCacheDatabase database(Directory, 100, 1);
+      TestEqual("complete", Data(database, "a"), std::string("complete"));
+      TestEqual("partial", Data(database, "b"), std::string("missing"));
+      Store(database, "c", "after");
+    }
+
+    ShardedFileCacheDatabase database(Directory, 100, 1);
+    TestEqual("complete", Data(database, "a"), std::string("complete"));
+    TestEqual("stored after", Data(database, "c"), std::string("after"));
+  });
+
+  It("discards the shards of a different shard count", [this]() {
+    {
+      ShardedFileCacheDatabase database(Directory, 100, 4);
+      Store(database, "a", "a");
+    }
+
+    ShardedFileCacheDatabase database(Directory, 100, 8);
+    TestEqual("entries", database.getEntryCount(), int64(0));
+    TestFalse(
+        "old shard",
+        IFileManager::Get().FileExists(
+            *FPaths::Combine(Directory, TEXT("shard-0-of-4.dat"))));
+  });
+}
@@ -87,4 +87,21 @@ void FUnrealAssetAccessorSpec::Define() {
 
     TestAccessorRequest(Uri, randomText);
   });
+
+  It("Can access large, memory-mapped file:/// URLs", [this]() {
+    std::string largeText;
+    while (largeText.size() < 256 * 1024) {
+      largeText += randomText;
+    }
+    FFileHelper::SaveStringToFile(
+        UTF8_TO_TCHAR(largeText.c_str()),
+        *Filename,
+        FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+
+    FString Uri = TEXT("file:///") + Filename;
+    Uri.ReplaceCharInline('\\', '/');
+    Uri.ReplaceInline(TEXT(" "), TEXT("%20"));
+
+    TestAccessorRequest(Uri, largeText);
+  });
 }
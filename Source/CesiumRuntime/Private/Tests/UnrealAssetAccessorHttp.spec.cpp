@@ -0,0 +1,238 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#if WITH_EDITOR
+
+#include "CesiumAsync/IAssetRequest.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "CesiumRequestPolicy.h"
+#include "CesiumRuntime.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HttpPath.h"
+#include "HttpServerModule.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "IHttpRouter.h"
+#include "Misc/AutomationTest.h"
+#include "UnrealAssetAccessor.h"
+
+namespace {
+
+/** The port of the local server that stands in for a tile server. */
+constexpr uint32 ServerPort = 18731;
+
+const FString ServerUrl = TEXT("http://127.0.0.1:18731");
+
+} // namespace
+
+BEGIN_DEFINE_SPEC(
+    FUnrealAssetAccessorHttpSpec,
+    "Cesium.Unit.UnrealAssetAccessorHttp",
+    EAutomationTestFlags::ApplicationContextMask |
+        EAutomationTestFlags::ProductFilter)
+
+TSharedPtr<IHttpRouter> pRouter;
+TArray<FHttpRouteHandle> Routes;
+
+/** Responses that are held back, with the times at which to send them. */
+TArray<TPair<double, FHttpResultCallback>> Held;
+
+int32 RequestCount;
+
+void SetVariable(const TCHAR* name, const TCHAR* value) {
+  IConsoleVariable* pVariable =
+      IConsoleManager::Get().FindConsoleVariable(name);
+  if (TestNotNull(name, pVariable)) {
+    pVariable->Set(value, ECVF_SetByCode);
+  }
+}
+
+/**
+ * Serves GET requests to the given path with the given function, which is
+ * passed the number of requests to the path so far, including this one.
+ */
+void Bind(
+    const TCHAR* path,
+    TFunction<TUniquePtr<FHttpServerResponse>(int32)> respond) {
+  int32* pCount = &RequestCount;
+  Routes.Add(pRouter->BindRoute(
+      FHttpPath(path),
+      EHttpServerRequestVerbs::VERB_GET,
+      FHttpRequestHandler::CreateLambda(
+          [pCount, respond = MoveTemp(respond)](
+              const FHttpServerRequest& request,
+              const FHttpResultCallback& onComplete) {
+            onComplete(respond(++*pCount));
+            return true;
+          })));
+}
+
+/**
+ * Ticks the HTTP client, the local server and the core ticker, which runs
+ * the accessor's delays, until `isDone` returns true.
+ */
+void Pump(UnrealAssetAccessor& accessor, TFunctionRef<bool()> isDone) {
+  double last = FPlatformTime::Seconds();
+  while (!isDone()) {
+    const double now = FPlatformTime::Seconds();
+    FTSTicker::GetCoreTicker().Tick(float(now - last));
+    last = now;
+
+    for (int32 i = Held.Num() - 1; i >= 0; --i) {
+      if (Held[i].Key <= now) {
+        FHttpResultCallback onComplete = MoveTemp(Held[i].Value);
+        Held.RemoveAt(i);
+        onComplete(
+            FHttpServerResponse::Create(TEXT("slow"), TEXT("text/plain")));
+      }
+    }
+
+    accessor.tick();
+    getAsyncSystem().dispatchMainThreadTasks();
+    FPlatformProcess::Sleep(0.001f);
+  }
+}
+
+/**
+ * Requests the given path from the local server, and returns the status
+ * code of the response and the time it took.
+ */
+std::pair<uint16_t, double> Request(const TCHAR* path) {
+  UnrealAssetAccessor accessor;
+
+  bool done = false;
+  uint16_t statusCode = 0;
+  const double start = FPlatformTime::Seconds();
+  double end = start;
+
+  accessor.get(getAsyncSystem(), TCHAR_TO_UTF8(*(ServerUrl + path)), {})
+      .thenInMainThread(
+          [&](std::shared_ptr<CesiumAsync::IAssetRequest>&& pRequest) {
+            end = FPlatformTime::Seconds();
+            const CesiumAsync::IAssetResponse* pResponse =
+                pRequest->response();
+            if (TestNotNull("response", pResponse)) {
+              statusCode = pResponse->statusCode();
+            }
+            done = true;
+          })
+      .catchInMainThread([&](std::exception&& e) {
+        AddError(UTF8_TO_TCHAR(e.what()));
+        done = true;
+      });
+
+  Pump(accessor, [&done]() { return done; });
+  return {statusCode, end - start};
+}
+
+END_DEFINE_SPEC(FUnrealAssetAccessorHttpSpec)
+
+void FUnrealAssetAccessorHttpSpec::Define() {
+  BeforeEach([this]() {
+    RequestCount = 0;
+    pRouter = FHttpServerModule::Get().GetHttpRouter(ServerPort);
+    TestTrue("router", pRouter.IsValid());
+    FHttpServerModule::Get().StartAllListeners();
+
+    SetVariable(TEXT("cesium.Requests.Hedging"), TEXT("0"));
+    SetVariable(TEXT("cesium.Requests.MaximumRetries"), TEXT("0"));
+    SetVariable(TEXT("cesium.Requests.RetryBaseDelayMs"), TEXT("10"));
+  });
+
+  AfterEach([this]() {
+    // Send the responses that are still held back before their routes go.
+    UnrealAssetAccessor accessor;
+    Pump(accessor, [this]() { return Held.Num() == 0; });
+
+    if (pRouter) {
+      for (const FHttpRouteHandle& route : Routes) {
+        pRouter->UnbindRoute(route);
+      }
+    }
+    Routes.Empty();
+    pRouter.Reset();
+
+    SetVariable(TEXT("cesium.Requests.Hedging"), TEXT("-1"));
+    SetVariable(TEXT("cesium.Requests.HedgeMinimumDelayMs"), TEXT("-1"));
+    SetVariable(TEXT("cesium.Requests.MaximumRetries"), TEXT("-1"));
+    SetVariable(TEXT("cesium.Requests.RetryBaseDelayMs"), TEXT("-1"));
+  });
+
+  It("retries transient failures", [this]() {
+    SetVariable(TEXT("cesium.Requests.MaximumRetries"), TEXT("2"));
+    Bind(TEXT("/flaky"), [](int32 count) {
+      return count <= 2 ? FHttpServerResponse::Error(
+                              EHttpServerResponseCodes::ServiceUnavail)
+                        : FHttpServerResponse::Create(
+                              TEXT("ok"),
+                              TEXT("text/plain"));
+    });
+
+    TestEqual("status", Request(TEXT("/flaky")).first, uint16_t(200));
+    TestEqual("requests", RequestCount, 3);
+  });
+
+  It("reports the failure once the retries are used up", [this]() {
+    SetVariable(TEXT("cesium.Requests.MaximumRetries"), TEXT("1"));
+    Bind(TEXT("/failing"), [](int32) {
+      return FHttpServerResponse::Error(
+          EHttpServerResponseCodes::ServiceUnavail);
+    });
+
+    TestEqual("status", Request(TEXT("/failing")).first, uint16_t(503));
+    TestEqual("requests", RequestCount, 2);
+  });
+
+  It("does not retry other failures", [this]() {
+    SetVariable(TEXT("cesium.Requests.MaximumRetries"), TEXT("2"));
+    Bind(TEXT("/missing"), [](int32) {
+      return FHttpServerResponse::Error(EHttpServerResponseCodes::NotFound);
+    });
+
+    TestEqual("status", Request(TEXT("/missing")).first, uint16_t(404));
+    TestEqual("requests", RequestCount, 1);
+  });
+
+  It("duplicates a request whose response is slow", [this]() {
+    Bind(TEXT("/fast"), [](int32) {
+      return FHttpServerResponse::Create(TEXT("fast"), TEXT("text/plain"));
+    });
+
+    // The delay before a request is hedged comes from the response times of
+    // its host, so there must be enough of them first.
+    for (size_t i = 0; i < CesiumResponseTimes::MinimumSamples; ++i) {
+      Request(TEXT("/fast"));
+    }
+
+    SetVariable(TEXT("cesium.Requests.Hedging"), TEXT("1"));
+    SetVariable(TEXT("cesium.Requests.HedgeMinimumDelayMs"), TEXT("100"));
+
+    RequestCount = 0;
+    Routes.Add(pRouter->BindRoute(
+        FHttpPath(TEXT("/slow-once")),
+        EHttpServerRequestVerbs::VERB_GET,
+        FHttpRequestHandler::CreateLambda(
+            [this](
+                const FHttpServerRequest& request,
+                const FHttpResultCallback& onComplete) {
+              if (++RequestCount == 1) {
+                Held.Emplace(FPlatformTime::Seconds() + 2.0, onComplete);
+              } else {
+                onComplete(FHttpServerResponse::Create(
+                    TEXT("fast"),
+                    TEXT("text/plain")));
+              }
+              return true;
+            })));
+
+    const std::pair<uint16_t, double> result = Request(TEXT("/slow-once"));
+
+    TestEqual("status", result.first, uint16_t(200));
+    TestTrue("faster than the slow response", result.second < 1.5);
+    TestEqual("requests", RequestCount, 2);
+  });
+}
+
+#endif // #if WITH_EDITOR
@@ -3,11 +3,20 @@
 #include "UnrealAssetAccessor.h"
 #include "Async/Async.h"
 #include "Async/AsyncWork.h"
+#include "Async/MappedFileHandle.h"
 
 #include "CesiumAsync/AsyncSystem.h"
 #include "CesiumAsync/IAssetRequest.h"
 #include "CesiumAsync/IAssetResponse.h"
+#include "CesiumAsync/Promise.h"
+#include "CesiumRequestPolicy.h"
+#include "CesiumRequestScheduler.h"
 #include "CesiumRuntime.h"
+#include "Containers/Ticker.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
 #include "HttpManager.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
@@ -16,11 +25,29 @@
 #include "Misc/App.h"
 #include "Misc/EngineVersion.h"
 #include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/UniquePtr.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <functional>
 #include <optional>
 #include <set>
 #include <uriparser/Uri.h>
+#include <vector>
+
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Requests Retried"),
+    STAT_CesiumRequestsRetried,
+    STATGROUP_Cesium);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Requests Hedged"),
+    STAT_CesiumRequestsHedged,
+    STATGROUP_Cesium);
+DECLARE_DWORD_ACCUMULATOR_STAT(
+    TEXT("Hedged Requests Won"),
+    STAT_CesiumHedgedRequestsWon,
+    STATGROUP_Cesium);
 
 namespace {
 
@@ -103,7 +130,9 @@ private:
 } // namespace
 
 UnrealAssetAccessor::UnrealAssetAccessor()
-    : _userAgent(), _cesiumRequestHeaders() {
+    : _userAgent(),
+      _cesiumRequestHeaders(),
+      _pScheduler(CesiumRequestScheduler::getInstance()) {
   FString OsVersion, OsSubVersion;
   FPlatformMisc::GetOSVersions(OsVersion, OsSubVersion);
   OsVersion += " " + FPlatformMisc::GetOSVersion();
@@ -147,6 +176,356 @@ bool isFile(const std::string& url) {
   return url.compare(0, sizeof(fileProtocol) - 1, fileProtocol) == 0;
 }
 
+CesiumResponseTimes& getResponseTimes() {
+  static CesiumResponseTimes responseTimes;
+  return responseTimes;
+}
+
+/**
+ * Gets the delay that a server asked for before a request is retried. Only
+ * the delay-seconds form of the `Retry-After` header is understood, not the
+ * HTTP-date form.
+ */
+double getServerDelaySeconds(const FHttpResponsePtr& pResponse) {
+  if (!pResponse) {
+    return 0.0;
+  }
+
+  const FString retryAfter = pResponse->GetHeader(TEXT("Retry-After"));
+  return retryAfter.IsNumeric() ? FCString::Atod(*retryAfter) : 0.0;
+}
+
+/**
+ * An HTTP GET request that is retried after transient failures and, when its
+ * response is slow to start arriving, hedged with a duplicate request. It
+ * completes with the first response that is not a transient failure, or with
+ * the last failure once its retries are used up, and cancels any duplicate
+ * that is still in flight.
+ *
+ * Completion callbacks and delays run on the game thread, where the HTTP
+ * manager and the core ticker are ticked.
+ */
+class HttpGet : public std::enable_shared_from_this<HttpGet> {
+public:
+  HttpGet(
+      const std::string& url,
+      const std::vector<CesiumAsync::IAssetAccessor::THeader>& headers,
+      const FString& userAgent,
+      const TMap<FString, FString>& cesiumRequestHeaders,
+      const std::shared_ptr<CesiumRequestScheduler>& pScheduler,
+      const CesiumRequestPolicy& policy,
+      const CesiumAsync::Promise<std::shared_ptr<CesiumAsync::IAssetRequest>>&
+          promise,
+      std::function<void()>&& endTrace)
+      : _url(url),
+        _headers(),
+        _userAgent(userAgent),
+        _pScheduler(pScheduler),
+        _policy(policy),
+        _promise(promise),
+        _endTrace(std::move(endTrace)),
+        _lock(),
+        _inFlight(),
+        _retries(0),
+        _finished(false),
+        _hedgeTicker() {
+    for (const auto& header : headers) {
+      this->_headers.Emplace(
+          UTF8_TO_TCHAR(header.first.c_str()),
+          UTF8_TO_TCHAR(header.second.c_str()));
+    }
+
+    for (const auto& header : cesiumRequestHeaders) {
+      this->_headers.Emplace(header.Key, header.Value);
+    }
+  }
+
+  /** Sends the request once its host has a free slot. */
+  void send() {
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> pRequest =
+        this->createRequest();
+    std::shared_ptr<HttpGet> pThis = this->shared_from_this();
+    this->_pScheduler->submit(
+        this->_url,
+        [pThis, pRequest]() { pThis->start(pRequest); },
+        [pThis]() { pThis->cancel(); });
+  }
+
+private:
+  struct InFlight {
+    FHttpRequestPtr pRequest;
+    double sentTime;
+    bool isHedge;
+    bool responseStarted;
+  };
+
+  std::vector<InFlight>::iterator
+  findInFlight(const FHttpRequestPtr& pRequest) {
+    return std::find_if(
+        this->_inFlight.begin(),
+        this->_inFlight.end(),
+        [&pRequest](const InFlight& inFlight) {
+          return inFlight.pRequest == pRequest;
+        });
+  }
+
+  TSharedRef<IHttpRequest, ESPMode::ThreadSafe> createRequest() {
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> pRequest =
+        FHttpModule::Get().CreateRequest();
+    pRequest->SetURL(UTF8_TO_TCHAR(this->_url.c_str()));
+
+    for (const TPair<FString, FString>& header : this->_headers) {
+      pRequest->SetHeader(header.Key, header.Value);
+    }
+
+    pRequest->AppendToHeader(TEXT("User-Agent"), this->_userAgent);
+
+    std::shared_ptr<HttpGet> pThis = this->shared_from_this();
+    pRequest->OnProcessRequestComplete().BindLambda(
+        [pThis](
+            FHttpRequestPtr pRequest,
+            FHttpResponsePtr pResponse,
+            bool connectedSuccessfully) {
+          pThis->onComplete(pRequest, pResponse, connectedSuccessfully);
+        });
+    pRequest->OnHeaderReceived().BindLambda(
+        [pThis](FHttpRequestPtr pRequest, const FString&, const FString&) {
+          pThis->onResponseStarted(pRequest);
+        });
+    pRequest->OnRequestProgress().BindLambda(
+        [pThis](FHttpRequestPtr pRequest, int32, int32 bytesReceived) {
+          if (bytesReceived > 0) {
+            pThis->onResponseStarted(pRequest);
+          }
+        });
+
+    return pRequest;
+  }
+
+  /** Sends a request for which the scheduler has found a slot. */
+  void start(const FHttpRequestPtr& pRequest) {
+    {
+      FScopeLock lock(&this->_lock);
+      this->_inFlight.push_back(
+          InFlight{pRequest, FPlatformTime::Seconds(), false, false});
+      this->scheduleHedge();
+    }
+
+    pRequest->ProcessRequest();
+  }
+
+  /**
+   * Arranges for the request to be hedged if its response takes longer to
+   * start arriving than the policy's percentile of the recent times to the
+   * first byte of its host. Requests to hosts with too few recent responses
+   * are not hedged.
+   */
+  void scheduleHedge() {
+    if (!this->_policy.hedgingEnabled) {
+      return;
+    }
+
+    std::optional<double> percentile = getResponseTimes().getPercentile(
+        this->_url,
+        this->_policy.hedgePercentile);
+    if (!percentile) {
+      return;
+    }
+
+    const double delay =
+        std::max(*percentile, this->_policy.minimumHedgeDelaySeconds);
+    std::shared_ptr<HttpGet> pThis = this->shared_from_this();
+    this->_hedgeTicker = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateLambda([pThis](float) {
+          pThis->hedge();
+          return false;
+        }),
+        float(delay));
+  }
+
+  void hedge() {
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> pRequest =
+        this->createRequest();
+
+    {
+      FScopeLock lock(&this->_lock);
+      this->_hedgeTicker.Reset();
+
+      // A duplicate is not worth waiting for a slot, because by the time it
+      // gets one the original will probably have completed. Nor is it worth
+      // sending once the original's response has started, because it would
+      // download the whole response again.
+      if (this->_finished || this->_inFlight.size() != 1 ||
+          this->_inFlight[0].responseStarted ||
+          !this->_pScheduler->trySend(this->_url)) {
+        return;
+      }
+
+      this->_inFlight.push_back(
+          InFlight{pRequest, FPlatformTime::Seconds(), true, false});
+    }
+
+    INC_DWORD_STAT(STAT_CesiumRequestsHedged);
+    pRequest->ProcessRequest();
+  }
+
+  /**
+   * Records the time that a request's response took to start arriving, and
+   * cancels the pending hedge.
+   */
+  void onResponseStarted(const FHttpRequestPtr& pRequest) {
+    FTSTicker::FDelegateHandle hedgeTicker;
+    double timeToFirstByte;
+
+    {
+      FScopeLock lock(&this->_lock);
+      auto it = this->findInFlight(pRequest);
+      if (it == this->_inFlight.end() || it->responseStarted) {
+        return;
+      }
+
+      it->responseStarted = true;
+      timeToFirstByte = FPlatformTime::Seconds() - it->sentTime;
+      hedgeTicker = this->_hedgeTicker;
+      this->_hedgeTicker.Reset();
+    }
+
+    getResponseTimes().record(this->_url, timeToFirstByte);
+    FTSTicker::RemoveTicker(hedgeTicker);
+  }
+
+  void onComplete(
+      FHttpRequestPtr pRequest,
+      FHttpResponsePtr pResponse,
+      bool connectedSuccessfully) {
+    this->_pScheduler->complete(
+        this->_url,
+        pResponse ? int64(pResponse->GetContent().Num()) : 0);
+
+    const int32 statusCode = pResponse ? pResponse->GetResponseCode() : 0;
+    const bool transient = CesiumRequestPolicy::isTransientFailure(
+        connectedSuccessfully,
+        statusCode);
+
+    FTSTicker::FDelegateHandle hedgeTicker;
+    std::vector<FHttpRequestPtr> duplicates;
+    std::optional<double> retryDelay;
+    bool wasHedge = false;
+
+    {
+      FScopeLock lock(&this->_lock);
+      auto it = this->findInFlight(pRequest);
+      if (it == this->_inFlight.end()) {
+        return;
+      }
+
+      const InFlight completed = *it;
+      this->_inFlight.erase(it);
+
+      if (this->_finished) {
+        // This is a duplicate that lost, and was canceled.
+        return;
+      }
+
+      if (transient && !this->_inFlight.empty()) {
+        // A duplicate is still in flight, and may yet succeed.
+        return;
+      }
+
+      hedgeTicker = this->_hedgeTicker;
+      this->_hedgeTicker.Reset();
+
+      if (transient && this->_retries < this->_policy.maximumRetries) {
+        ++this->_retries;
+        retryDelay = this->_policy.getRetryDelay(
+            this->_retries,
+            FMath::FRand(),
+            getServerDelaySeconds(pResponse));
+      } else {
+        this->_finished = true;
+        wasHedge = completed.isHedge;
+        for (const InFlight& inFlight : this->_inFlight) {
+          duplicates.push_back(inFlight.pRequest);
+        }
+
+        // A response that arrived without reporting its progress started,
+        // at the latest, when it completed.
+        if (connectedSuccessfully && !completed.responseStarted) {
+          getResponseTimes().record(
+              this->_url,
+              FPlatformTime::Seconds() - completed.sentTime);
+        }
+      }
+    }
+
+    FTSTicker::RemoveTicker(hedgeTicker);
+
+    if (retryDelay) {
+      INC_DWORD_STAT(STAT_CesiumRequestsRetried);
+      std::shared_ptr<HttpGet> pThis = this->shared_from_this();
+      FTSTicker::GetCoreTicker().AddTicker(
+          FTickerDelegate::CreateLambda([pThis](float) {
+            pThis->send();
+            return false;
+          }),
+          float(*retryDelay));
+      return;
+    }
+
+    for (const FHttpRequestPtr& pDuplicate : duplicates) {
+      pDuplicate->CancelRequest();
+    }
+
+    if (wasHedge) {
+      INC_DWORD_STAT(STAT_CesiumHedgedRequestsWon);
+    }
+
+    this->_endTrace();
+
+    if (connectedSuccessfully) {
+      this->_promise.resolve(
+          std::make_unique<UnrealAssetRequest>(pRequest, pResponse));
+    } else {
+      switch (pRequest->GetStatus()) {
+      case EHttpRequestStatus::Failed_ConnectionError:
+        this->_promise.reject(std::runtime_error("Connection failed."));
+        break;
+      default:
+        this->_promise.reject(std::runtime_error("Request failed."));
+      }
+    }
+  }
+
+  /** Fails the request, which was canceled while it was queued. */
+  void cancel() {
+    {
+      FScopeLock lock(&this->_lock);
+      if (this->_finished) {
+        return;
+      }
+      this->_finished = true;
+    }
+
+    this->_endTrace();
+    this->_promise.reject(std::runtime_error(
+        "The request was canceled because its tileset no longer needs it."));
+  }
+
+  std::string _url;
+  TArray<TPair<FString, FString>> _headers;
+  FString _userAgent;
+  std::shared_ptr<CesiumRequestScheduler> _pScheduler;
+  CesiumRequestPolicy _policy;
+  CesiumAsync::Promise<std::shared_ptr<CesiumAsync::IAssetRequest>> _promise;
+  std::function<void()> _endTrace;
+
+  FCriticalSection _lock;
+  std::vector<InFlight> _inFlight;
+  int32 _retries;
+  bool _finished;
+  FTSTicker::FDelegateHandle _hedgeTicker;
+};
+
 } // namespace
 
 CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>
@@ -164,48 +543,26 @@ UnrealAssetAccessor::get(
   const FString& userAgent = this->_userAgent;
   const TMap<FString, FString>& cesiumRequestHeaders =
       this->_cesiumRequestHeaders;
+  const std::shared_ptr<CesiumRequestScheduler>& pScheduler =
+      this->_pScheduler;
+  const CesiumRequestPolicy policy = CesiumRequestPolicy::getCurrent();
 
   return asyncSystem.createFuture<std::shared_ptr<CesiumAsync::IAssetRequest>>(
-      [&url, &headers, &userAgent, &cesiumRequestHeaders](const auto& promise) {
-        FHttpModule& httpModule = FHttpModule::Get();
-        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> pRequest =
-            httpModule.CreateRequest();
-        pRequest->SetURL(UTF8_TO_TCHAR(url.c_str()));
-
-        for (const auto& header : headers) {
-          pRequest->SetHeader(
-              UTF8_TO_TCHAR(header.first.c_str()),
-              UTF8_TO_TCHAR(header.second.c_str()));
-        }
-
-        for (const auto& header : cesiumRequestHeaders) {
-          pRequest->SetHeader(header.Key, header.Value);
-        }
-
-        pRequest->AppendToHeader(TEXT("User-Agent"), userAgent);
-
-        pRequest->OnProcessRequestComplete().BindLambda(
-            [promise, CESIUM_TRACE_LAMBDA_CAPTURE_TRACK()](
-                FHttpRequestPtr pRequest,
-                FHttpResponsePtr pResponse,
-                bool connectedSuccessfully) mutable {
+      [&url, &headers, &userAgent, &cesiumRequestHeaders, &pScheduler, &policy](
+          const auto& promise) {
+        std::make_shared<HttpGet>(
+            url,
+            headers,
+            userAgent,
+            cesiumRequestHeaders,
+            pScheduler,
+            policy,
+            promise,
+            [CESIUM_TRACE_LAMBDA_CAPTURE_TRACK()]() mutable {
               CESIUM_TRACE_USE_CAPTURED_TRACK();
               CESIUM_TRACE_END_IN_TRACK("requestAsset");
-
-              if (connectedSuccessfully) {
-                promise.resolve(
-                    std::make_unique<UnrealAssetRequest>(pRequest, pResponse));
-              } else {
-                switch (pRequest->GetStatus()) {
-                case EHttpRequestStatus::Failed_ConnectionError:
-                  promise.reject(std::runtime_error("Connection failed."));
-                default:
-                  promise.reject(std::runtime_error("Request failed."));
-                }
-              }
-            });
-
-        pRequest->ProcessRequest();
+            })
+            ->send();
       });
 }
 
@@ -279,6 +636,19 @@ void UnrealAssetAccessor::tick() noexcept {
 
 namespace {
 
+TAutoConsoleVariable<bool> CVarMemoryMapFileRequests(
+    TEXT("cesium.FileRequests.MemoryMap"),
+    true,
+    TEXT(
+        "Whether to serve large file:/// requests from memory-mapped files rather than reading them into memory."),
+    ECVF_Default);
+
+/**
+ * Files smaller than this are read into memory rather than mapped, because
+ * for small files setting up the mapping costs more than the copy it saves.
+ */
+constexpr int64 MinimumMappedFileSize = 64 * 1024;
+
 class UnrealFileAssetRequestResponse : public CesiumAsync::IAssetRequest,
                                        public CesiumAsync::IAssetResponse {
 public:
@@ -286,7 +656,28 @@ public:
       std::string&& url,
       uint16_t statusCode,
       TArray64<uint8>&& data)
-      : _url(std::move(url)), _statusCode(statusCode), _data(data) {}
+      : _url(std::move(url)),
+        _statusCode(statusCode),
+        _data(std::move(data)) {}
+
+  /**
+   * Creates a response whose data is the given region of a memory-mapped
+   * file, which it keeps mapped for as long as it exists.
+   */
+  UnrealFileAssetRequestResponse(
+      std::string&& url,
+      TUniquePtr<IMappedFileHandle>&& pMappedFile,
+      TUniquePtr<IMappedFileRegion>&& pMappedRegion)
+      : _url(std::move(url)),
+        _statusCode(200),
+        _pMappedFile(std::move(pMappedFile)),
+        _pMappedRegion(std::move(pMappedRegion)) {}
+
+  virtual ~UnrealFileAssetRequestResponse() {
+    // The region must be unmapped before the file is closed.
+    this->_pMappedRegion.Reset();
+    this->_pMappedFile.Reset();
+  }
 
   virtual const std::string& method() const { return getMethod; }
 
@@ -305,6 +696,13 @@ public:
   virtual std::string contentType() const override { return std::string(); }
 
   virtual gsl::span<const std::byte> data() const override {
+    if (this->_pMappedRegion) {
+      return gsl::span<const std::byte>(
+          reinterpret_cast<const std::byte*>(
+              this->_pMappedRegion->GetMappedPtr()),
+          size_t(this->_pMappedRegion->GetMappedSize()));
+    }
+
     return gsl::span<const std::byte>(
         reinterpret_cast<const std::byte*>(this->_data.GetData()),
         size_t(this->_data.Num()));
@@ -317,6 +715,8 @@ private:
   std::string _url;
   uint16_t _statusCode;
   TArray64<uint8> _data;
+  TUniquePtr<IMappedFileHandle> _pMappedFile;
+  TUniquePtr<IMappedFileRegion> _pMappedRegion;
 };
 
 const std::string UnrealFileAssetRequestResponse::getMethod = "GET";
@@ -375,6 +775,26 @@ public:
   void DoWork() {
     FString filename =
         UTF8_TO_TCHAR(convertFileUriToFilename(this->_url).c_str());
+
+    if (CVarMemoryMapFileRequests.GetValueOnAnyThread() &&
+        IFileManager::Get().FileSize(*filename) >= MinimumMappedFileSize) {
+      // Not every platform or file (such as those in pak files) can be
+      // mapped, in which case the file is read normally below.
+      TUniquePtr<IMappedFileHandle> pMappedFile(
+          FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*filename));
+      if (pMappedFile) {
+        TUniquePtr<IMappedFileRegion> pMappedRegion(pMappedFile->MapRegion());
+        if (pMappedRegion) {
+          this->_promise.resolve(
+              std::make_shared<UnrealFileAssetRequestResponse>(
+                  std::move(this->_url),
+                  std::move(pMappedFile),
+                  std::move(pMappedRegion)));
+          return;
+        }
+      }
+    }
+
     TArray64<uint8> data;
     if (FFileHelper::LoadFileToArray(data, *filename)) {
       this->_promise.resolve(std::make_shared<UnrealFileAssetRequestResponse>(
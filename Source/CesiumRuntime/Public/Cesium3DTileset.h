@@ -2,16 +2,21 @@
 
 #pragma once
 
+#include "Async/Future.h"
 #include "Cesium3DTilesSelection/Tileset.h"
 #include "Cesium3DTilesSelection/ViewState.h"
 #include "Cesium3DTilesSelection/ViewUpdateResult.h"
 #include "Cesium3DTilesetLoadFailureDetails.h"
+#include "CesiumAdaptiveScreenSpaceError.h"
 #include "CesiumCreditSystem.h"
 #include "CesiumEncodedMetadataComponent.h"
 #include "CesiumFeaturesMetadataComponent.h"
 #include "CesiumGeoreference.h"
 #include "CesiumIonServer.h"
+#include "CesiumLoadingPriorityMode.h"
+#include "CesiumMemoryUsage.h"
 #include "CesiumPointCloudShading.h"
+#include "CesiumTileLoadLatency.h"
 #include "CoreMinimal.h"
 #include "CustomDepthParameters.h"
 #include "Engine/EngineTypes.h"
@@ -21,7 +26,9 @@
 #include <PhysicsEngine/BodyInstance.h>
 #include <atomic>
 #include <chrono>
+#include <functional>
 #include <glm/mat4x4.hpp>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 #include "Cesium3DTileset.generated.h"
@@ -31,8 +38,18 @@ class ACesiumCartographicSelection;
 class ACesiumCameraManager;
 class UCesiumBoundingVolumePoolComponent;
 class CesiumViewExtension;
+class CesiumTilesetStatistics;
+class CesiumCameraPrediction;
+class CesiumScreenSpaceErrorController;
+class CesiumTileLoadThrottle;
+class CesiumLodImportance;
+class CesiumRegionPreload;
 struct FCesiumCamera;
 
+namespace CesiumAsync {
+class IAssetRequest;
+}
+
 namespace Cesium3DTilesSelection {
 class Tileset;
 class TilesetView;
@@ -56,6 +73,23 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FCompletedLoadTrigger);
 CESIUMRUNTIME_API extern FCesium3DTilesetLoadFailure
     OnCesium3DTilesetLoadFailure;
 
+/**
+ * The result of ACesium3DTileset::LoadTilesForViews.
+ */
+struct FCesiumLoadTilesForViewsResult {
+  /**
+   * The number of tiles that the views need, or that they were known to need
+   * when the time ran out.
+   */
+  int64 TilesSelected = 0;
+
+  /** Whether the time ran out before the downloads were complete. */
+  bool bTimedOut = false;
+
+  /** The number of requests that were still in flight when time ran out. */
+  int64 RequestsTimedOut = 0;
+};
+
 UENUM(BlueprintType)
 enum class ETilesetSource : uint8 {
   /**
@@ -336,6 +370,44 @@ public:
       Category = "Cesium|Level of Detail")
   EApplyDpiScaling ApplyDpiScaling = EApplyDpiScaling::UseProjectDefault;
 
+  /**
+   * Options for adjusting the maximum screen-space error while playing, to
+   * keep the cost of this tileset under targets for game thread time, GPU
+   * memory, and load queue length. While it is enabled, it replaces
+   * MaximumScreenSpaceError, which is only its starting point.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Level of Detail")
+  FCesiumAdaptiveScreenSpaceError AdaptiveScreenSpaceError;
+
+  /**
+   * Gets the maximum screen-space error used to select tiles: the one chosen
+   * by the AdaptiveScreenSpaceError controller if it is enabled, or
+   * MaximumScreenSpaceError otherwise.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Level of Detail")
+  double GetEffectiveMaximumScreenSpaceError() const;
+
+  /**
+   * Gets the reason for the latest decision of the AdaptiveScreenSpaceError
+   * controller.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Level of Detail")
+  ECesiumAdaptiveScreenSpaceErrorReason
+  GetAdaptiveScreenSpaceErrorReason() const;
+
+  /**
+   * Whether the Cesium LOD Importance Volumes in the level change the level
+   * of detail of this tileset around them.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Level of Detail")
+  bool EnableLodImportanceVolumes = true;
+
   /**
    * Whether to preload ancestor tiles.
    *
@@ -384,6 +456,52 @@ public:
       meta = (ClampMin = 0))
   int32 MaximumSimultaneousTileLoads = 20;
 
+  /**
+   * How eagerly this tileset loads tiles. Lower the priority during combat or
+   * cinematic moments, when slower loading is better than a hitch, and raise
+   * it while the game is idle, to saturate the network.
+   *
+   * The mode scales both MaximumSimultaneousTileLoads and the time spent each
+   * frame finishing loaded tiles on the game thread.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintGetter = GetLoadingPriorityMode,
+      BlueprintSetter = SetLoadingPriorityMode,
+      Category = "Cesium|Tile Loading")
+  ECesiumLoadingPriorityMode LoadingPriorityMode =
+      ECesiumLoadingPriorityMode::Normal;
+
+  /**
+   * Whether to load fewer tiles at once, and spend less game thread time
+   * finishing them, while frames take longer than TargetFrameTimeMilliseconds.
+   * The limits recover gradually once frames are fast enough again. This is
+   * ignored in the Aggressive loading priority mode.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Loading")
+  bool ThrottleTileLoadsByFrameTime = false;
+
+  /**
+   * The frame time, in milliseconds, above which tile loads are throttled
+   * when ThrottleTileLoadsByFrameTime is true.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta =
+          (ClampMin = 1.0,
+           EditCondition = "ThrottleTileLoadsByFrameTime"))
+  float TargetFrameTimeMilliseconds = 16.7f;
+
+  /**
+   * Gets the number of tiles that are currently loaded at once, after
+   * applying the LoadingPriorityMode and any frame time throttling to
+   * MaximumSimultaneousTileLoads.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int32 GetEffectiveMaximumSimultaneousTileLoads() const;
+
   /**
    * @brief The maximum number of bytes that may be cached.
    *
@@ -396,6 +514,208 @@ public:
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Loading")
   int64 MaximumCachedBytes = 256 * 1024 * 1024;
 
+  /**
+   * The relative priority of this tileset when the global memory budget is
+   * enabled in the Cesium runtime settings.
+   *
+   * The budget is shared between tilesets in proportion to how many tiles
+   * each has recently rendered, multiplied by this value. A tileset with a
+   * priority of 2.0 receives twice the share of an equally-visible tileset
+   * with a priority of 1.0. When the memory budget is enabled,
+   * MaximumCachedBytes only determines how this tileset's share is split with
+   * the sub-tile caches of its raster overlays.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 0.0))
+  float MemoryBudgetPriority = 1.0f;
+
+  /**
+   * Gets the number of bytes of the global memory budget currently allocated
+   * to this tileset and its raster overlays, or -1 if the memory budget is
+   * disabled.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int64 GetMemoryBudgetAllocation() const;
+
+  /**
+   * Gets the maximum number of bytes this tileset may currently cache. This is
+   * its share of the global memory budget if that is enabled, or
+   * MaximumCachedBytes otherwise.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int64 GetEffectiveMaximumCachedBytes() const;
+
+  /**
+   * Gets the recent visible importance of this tileset that the global memory
+   * budget uses to decide how much of the budget it receives. This is a
+   * smoothed count of the tiles rendered in recent frames.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  float GetMemoryBudgetImportance() const;
+
+  /**
+   * Gets the total number of bytes of tile and raster overlay data currently
+   * loaded by this tileset.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int64 GetLoadedBytes() const;
+
+  /**
+   * Gets an estimate of the number of bytes of GPU memory used by this
+   * tileset. This is the sum of its vertex buffer, index buffer, texture, and
+   * metadata texture bytes.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int64 GetEstimatedGpuBytes() const;
+
+  /**
+   * Gets the number of bytes in the vertex buffers of this tileset's loaded
+   * tiles.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Memory")
+  int64 GetVertexBufferBytes() const;
+
+  /**
+   * Gets the number of bytes in the index buffers of this tileset's loaded
+   * tiles.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Memory")
+  int64 GetIndexBufferBytes() const;
+
+  /**
+   * Gets the number of bytes of textures used by this tileset's loaded tiles
+   * and raster overlays, not including the textures that encode features and
+   * metadata.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Memory")
+  int64 GetTextureBytes() const;
+
+  /**
+   * Gets the number of bytes of textures in the given texture group used by
+   * this tileset's loaded tiles and raster overlays.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Memory")
+  int64 GetTextureBytesForGroup(TEnumAsByte<TextureGroup> Group) const;
+
+  /**
+   * Gets the number of bytes of textures that encode features and metadata
+   * for use in materials.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Memory")
+  int64 GetMetadataTextureBytes() const;
+
+  /**
+   * Gets the approximate number of bytes used by the physics meshes of this
+   * tileset's loaded tiles.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Memory")
+  int64 GetCollisionBytes() const;
+
+  /**
+   * Gets the number of bytes of glTF buffers and images that this tileset's
+   * loaded tiles keep on the CPU.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Memory")
+  int64 GetGltfBytes() const;
+
+  /**
+   * Gets the number of tiles per second whose renderer resources were
+   * created, averaged over roughly the last second.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  double GetTilesLoadedPerSecond() const;
+
+  /**
+   * Gets the number of tiles per second whose renderer resources were freed,
+   * averaged over roughly the last second.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  double GetTilesUnloadedPerSecond() const;
+
+  /**
+   * Gets the number of bytes per second received by this tileset's requests,
+   * averaged over roughly the last second. This includes responses served
+   * from the request cache, archives and files, so it is not the network
+   * traffic.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  double GetBytesReceivedPerSecond() const;
+
+  /**
+   * Gets the time, in milliseconds, that the most recent Tick took to select
+   * tiles and update the tiles shown. This is the part of the game thread's
+   * time that this tileset's level of detail determines.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  double GetLastUpdateMilliseconds() const;
+
+  /**
+   * Gets the number of tiles selected for rendering in the most recent
+   * frame.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int64 GetNumberOfTilesRendered() const;
+
+  /**
+   * Gets the number of tiles waiting to be loaded in a worker thread as of
+   * the most recent frame.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int64 GetWorkerThreadTileLoadQueueLength() const;
+
+  /**
+   * Gets the number of tiles waiting to be loaded in the game thread as of
+   * the most recent frame.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  int64 GetMainThreadTileLoadQueueLength() const;
+
+  /**
+   * Gets the count, mean, and 50th, 95th, and 99th percentiles of how long
+   * this tileset's tiles took to complete the given stage of their lifecycle,
+   * from the start of the request for their content until they were first
+   * shown. All durations are in seconds.
+   *
+   * The latencies of all tilesets can also be written to a CSV file with the
+   * `cesium.latency.dump` console command.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  FCesiumTileLoadLatency GetTileLoadLatency(ECesiumTileLoadStage Stage) const;
+
+  /**
+   * Forgets the tile lifecycle durations recorded so far, so that
+   * GetTileLoadLatency only reports on tiles loaded from now on.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  void ResetTileLoadLatency();
+
+  /**
+   * Gets the number of seconds from when this tileset was loaded until it was
+   * first completely loaded, or -1 if it has not been yet. With the warm
+   * start enabled in the Cesium settings, the tiles shown at the end of the
+   * previous play session are prefetched, which shortens this.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  double GetTimeToFirstFullView() const;
+
+  /**
+   * Gets the fraction of the region being preloaded that has been loaded,
+   * from 0 to 1, or -1 if no region is being preloaded. Regions are preloaded
+   * with the Preload Region node.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  float GetRegionPreloadProgress() const;
+
+  /**
+   * Stops preloading a region, if one is being preloaded, and returns to
+   * selecting tiles for the usual cameras.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium|Tile Loading")
+  void CancelRegionPreload();
+
   /**
    * The number of loading descendents a tile should allow before deciding to
    * render itself instead of waiting.
@@ -414,6 +734,60 @@ public:
       meta = (ClampMin = 0))
   int32 LoadingDescendantLimit = 20;
 
+  /**
+   * Whether to also load the tiles that each player's camera will see a short
+   * time from now, if it keeps moving as it is. This helps fast-moving
+   * cameras, such as those of aircraft, whose tiles would otherwise only
+   * start loading once they are already in view.
+   *
+   * A camera is only predicted while it moves steadily. When it turns or
+   * changes speed by more than PredictionDivergenceDegrees or half its speed,
+   * its predicted view is dropped, so the tiles that only that view needed
+   * are no longer loaded.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Tile Loading")
+  bool PredictCameraMotion = false;
+
+  /**
+   * How far ahead to predict each player camera's motion, in seconds.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta = (ClampMin = 0.0, EditCondition = "PredictCameraMotion"))
+  float PredictionSeconds = 2.0f;
+
+  /**
+   * The resolution of a predicted view, as a fraction of its camera's
+   * viewport size. Values below 1.0 load the tiles ahead of the camera in
+   * less detail than the camera itself needs, so that they take less of the
+   * tileset's loading capacity away from the camera's current view.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta =
+          (ClampMin = 0.05,
+           ClampMax = 1.0,
+           EditCondition = "PredictCameraMotion"))
+  float PredictedViewResolution = 0.5f;
+
+  /**
+   * The angle in degrees by which a camera's direction of motion may change
+   * before its predicted view is dropped.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Tile Loading",
+      meta =
+          (ClampMin = 0.0,
+           ClampMax = 180.0,
+           EditCondition = "PredictCameraMotion"))
+  float PredictionDivergenceDegrees = 20.0f;
+
   /**
    * Whether to cull tiles that are outside the frustum.
    *
@@ -945,6 +1319,14 @@ public:
   UFUNCTION(BlueprintSetter, Category = "Cesium")
   void SetMaximumScreenSpaceError(double InMaximumScreenSpaceError);
 
+  UFUNCTION(BlueprintGetter, Category = "Cesium|Tile Loading")
+  ECesiumLoadingPriorityMode GetLoadingPriorityMode() const {
+    return LoadingPriorityMode;
+  }
+
+  UFUNCTION(BlueprintSetter, Category = "Cesium|Tile Loading")
+  void SetLoadingPriorityMode(ECesiumLoadingPriorityMode InLoadingPriorityMode);
+
   UFUNCTION(BlueprintGetter, Category = "Cesium|Tile Culling|Experimental")
   bool GetEnableOcclusionCulling() const;
 
@@ -1061,6 +1443,82 @@ public:
     return this->_pTileset.Get();
   }
 
+  /**
+   * Loads the tiles that the given views need down to the given screen-space
+   * error, and blocks until they, and the raster overlay images draped over
+   * them, have been downloaded. The tiles are not shown; the next Tick
+   * selects the tiles for the usual cameras again. This is meant for tools
+   * that download tiles ahead of time, such as to fill the request cache.
+   *
+   * The screen-space error and load limit are used as given. Neither the
+   * adaptive screen-space error, the LoadingPriorityMode, nor LOD importance
+   * volumes change them, so that the same tiles are loaded however the
+   * tileset is set up to be shown.
+   *
+   * The engine loop does not run meanwhile, so this ticks the HTTP module and
+   * the core ticker, on which request retries and hedges are scheduled,
+   * itself.
+   *
+   * @param Views The views, which need not be near any actual camera.
+   * @param MaximumScreenSpaceError The screen-space error down to which tiles
+   * are loaded.
+   * @param MaximumSimultaneousTileLoads The most tiles that are loaded at
+   * once.
+   * @param TimeoutSeconds The longest time to wait for the downloads. The
+   * requests still in flight after it are left to complete, or not, in the
+   * background.
+   */
+  FCesiumLoadTilesForViewsResult LoadTilesForViews(
+      const std::vector<FCesiumCamera>& Views,
+      double MaximumScreenSpaceError,
+      int32 MaximumSimultaneousTileLoads,
+      double TimeoutSeconds);
+
+  /**
+   * Sets a function that is called with every request made for this tileset
+   * and its raster overlays once it completes, on the thread on which it
+   * completes. The responses are decompressed. An empty function stops the
+   * observing.
+   */
+  void SetRequestObserver(
+      std::function<void(const CesiumAsync::IAssetRequest&)> Observer);
+
+  /**
+   * Starts loading the tiles that a circular region needs, such as while a
+   * loading screen is up, so that they are ready to be shown as soon as a
+   * camera looks at the region. The region is covered by views that look
+   * straight down on it, which are loaded a few at a time on each Tick. The
+   * tiles are not shown, and while the region is loading, the tileset does
+   * not select tiles for its usual cameras.
+   *
+   * The tiles of earlier views are only kept while they fit within
+   * `MaximumCachedBytes`, so it should be large enough for the whole region.
+   * The region is placed relative to the tileset, like the polygons of a
+   * polygon raster overlay. Starting another preload fails this one.
+   *
+   * @param LongitudeLatitudeHeight The longitude and latitude of the center
+   * of the region in degrees, and the height of its ground in meters above
+   * the ellipsoid.
+   * @param Radius The radius of the region, in meters.
+   * @param MaximumScreenSpaceError The screen-space error down to which the
+   * tiles are loaded, in place of this tileset's own.
+   * @param ViewHeight The height of the views above the ground, in meters.
+   * The tiles are loaded in the detail that they need when seen from this
+   * height.
+   * @param OnProgress Called on the game thread with the fraction of the
+   * region that has been loaded, from 0 to 1, whenever it increases.
+   * @return A future that is fulfilled on the game thread once the region
+   * has loaded, with false if the preload was canceled, another was started,
+   * the region had no views, or the tileset failed to load or was destroyed
+   * or reloaded.
+   */
+  TFuture<bool> PreloadRegion(
+      const FVector& LongitudeLatitudeHeight,
+      double Radius,
+      double MaximumScreenSpaceError,
+      double ViewHeight = 500.0,
+      TFunction<void(float)> OnProgress = TFunction<void(float)>());
+
   // AActor overrides (some or most of them should be protected)
   virtual bool ShouldTickIfViewportsOnly() const override;
   virtual void Tick(float DeltaTime) override;
@@ -1108,11 +1566,55 @@ private:
   void LoadTileset();
   void DestroyTileset();
 
+  /**
+   * Writes the URLs of the tiles being shown to this tileset's warm start
+   * snapshot, if the warm start is enabled.
+   */
+  void SaveWarmStartSnapshot() const;
+
+  /**
+   * Updates the tileset with the views of the region being preloaded rather
+   * than those of the cameras, without showing the tiles.
+   */
+  void TickRegionPreload(float DeltaTime);
+
+  /** Finishes the region preload, if there is one. */
+  void FinishRegionPreload(bool Succeeded);
+
+  /**
+   * Updates the adaptive screen-space error controller with this tileset's
+   * cost in the previous frame.
+   */
+  void UpdateAdaptiveScreenSpaceError(float DeltaTime);
+
+  /**
+   * Updates the tile load throttle with the duration of the previous frame.
+   */
+  void UpdateTileLoadThrottle();
+
+  /**
+   * Applies the Cesium LOD Importance Volumes in the level to the tiles
+   * visited by the previous selection.
+   */
+  void UpdateLodImportance();
+
   static Cesium3DTilesSelection::ViewState CreateViewStateFromViewParameters(
       const FCesiumCamera& camera,
       const glm::dmat4& unrealWorldToTileset);
 
-  std::vector<FCesiumCamera> GetCameras() const;
+  /**
+   * Creates the view states of the given cameras, or nothing if this
+   * tileset's transform cannot be inverted.
+   */
+  std::optional<std::vector<Cesium3DTilesSelection::ViewState>>
+  CreateViewStates(const std::vector<FCesiumCamera>& cameras) const;
+
+  /**
+   * Gets the views to select tiles for: those of the players, scene captures,
+   * editor viewports, and camera manager, and the predicted views of the
+   * players if PredictCameraMotion is enabled.
+   */
+  std::vector<FCesiumCamera> GetCameras(float DeltaTime);
   std::vector<FCesiumCamera> GetPlayerCameras() const;
   std::vector<FCesiumCamera> GetSceneCaptures() const;
 
@@ -1144,6 +1646,17 @@ private:
   void updateLastViewUpdateResultState(
       const Cesium3DTilesSelection::ViewUpdateResult& result);
 
+  void addMemoryUsage(const CesiumMemoryUsage& usage);
+  void removeMemoryUsage(const CesiumMemoryUsage& usage);
+
+  /**
+   * Updates the smoothed visible importance used by the global memory budget
+   * from the number of tiles rendered this frame.
+   */
+  void updateMemoryBudgetImportance(
+      const Cesium3DTilesSelection::ViewUpdateResult& result,
+      float deltaTime);
+
   /**
    * Creates the visual representations of the given tiles to
    * be rendered in the current frame.
@@ -1203,6 +1716,12 @@ private:
 
   std::chrono::high_resolution_clock::time_point _startTime;
 
+  // The seconds from loading the tileset until it was first completely
+  // loaded, in this session and in the one that wrote its warm start
+  // snapshot, or -1 if that has not happened.
+  double _timeToFirstFullView;
+  double _previousTimeToFirstFullView;
+
   bool _captureMovieMode;
   bool _beforeMoviePreloadAncestors;
   bool _beforeMoviePreloadSiblings;
@@ -1227,6 +1746,38 @@ private:
 
   int32 _tilesetsBeingDestroyed;
 
+  // The state used by the global memory budget. The allocations are -1 when
+  // the memory budget is disabled.
+  double _memoryBudgetImportance;
+  int64 _memoryBudgetAllocation;
+  int64 _budgetedCachedBytes;
+
+  // The memory used by the renderer resources of all loaded tiles, updated as
+  // they are prepared and freed.
+  CesiumMemoryUsage _memoryUsage;
+
+  // Selection and loading statistics published to `stat Cesium` and Unreal
+  // Insights.
+  TUniquePtr<CesiumTilesetStatistics> _pStatistics;
+
+  // The region being preloaded, if any.
+  TUniquePtr<CesiumRegionPreload> _pRegionPreload;
+  TUniquePtr<CesiumCameraPrediction> _pCameraPrediction;
+  TUniquePtr<CesiumScreenSpaceErrorController> _pScreenSpaceErrorController;
+  TUniquePtr<CesiumTileLoadThrottle> _pTileLoadThrottle;
+  TUniquePtr<CesiumLodImportance> _pLodImportance;
+
+  /**
+   * The time, in milliseconds, of the most recent tile selection and update
+   * of the tiles shown, for the adaptive screen-space error controller.
+   */
+  double _lastUpdateMilliseconds;
+
+  // The group of the CesiumRequestScheduler to which this tileset's requests
+  // are attributed.
+  uint64 _requestGroup;
+
   friend class UnrealResourcePreparer;
+  friend class CesiumMemoryBudget;
   friend class UCesiumGltfPointsComponent;
 };
@@ -0,0 +1,149 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "CesiumAdaptiveScreenSpaceError.generated.h"
+
+/**
+ * The reason for the latest decision of a tileset's adaptive screen-space
+ * error controller.
+ */
+UENUM(BlueprintType)
+enum class ECesiumAdaptiveScreenSpaceErrorReason : uint8 {
+  /**
+   * The controller is disabled, so the tileset's MaximumScreenSpaceError is
+   * used as is.
+   */
+  Disabled,
+
+  /**
+   * Every measurement is near its target, so the screen-space error is
+   * kept where it is.
+   */
+  WithinTargets,
+
+  /**
+   * Every measurement is comfortably below its target, so the screen-space
+   * error is lowered to show more detail.
+   */
+  Improving,
+
+  /**
+   * The time the tileset spends on the game thread is over its target, so
+   * the screen-space error is raised.
+   */
+  GameThreadTime,
+
+  /**
+   * The tileset's estimated GPU memory use is over its target, so the
+   * screen-space error is raised.
+   */
+  EstimatedGpuMemory,
+
+  /**
+   * The tileset's tile load queues are longer than their target, so the
+   * screen-space error is raised.
+   */
+  LoadQueueLength
+};
+
+/**
+ * Options for a closed-loop controller that adjusts a tileset's maximum
+ * screen-space error, within bounds, to keep its cost under targets.
+ *
+ * The controller raises the screen-space error, showing less detail, while
+ * any measurement is over its target. It lowers the screen-space error again
+ * only once every measurement is below its target by the Hysteresis
+ * fraction, so that it does not oscillate around a target.
+ */
+USTRUCT(BlueprintType)
+struct CESIUMRUNTIME_API FCesiumAdaptiveScreenSpaceError {
+  GENERATED_USTRUCT_BODY()
+
+  /**
+   * Whether to adjust the tileset's maximum screen-space error. When this is
+   * false, the tileset's MaximumScreenSpaceError is used as is.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool Enabled = false;
+
+  /**
+   * The lowest screen-space error, and therefore the most detail, that the
+   * controller may choose. Values below 1.0 are treated as 1.0.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 1.0))
+  double MinimumScreenSpaceError = 8.0;
+
+  /**
+   * The highest screen-space error, and therefore the least detail, that the
+   * controller may choose.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 1.0))
+  double MaximumScreenSpaceError = 64.0;
+
+  /**
+   * The target for the time, in milliseconds, that the tileset spends on the
+   * game thread each frame, including selecting tiles and creating their
+   * meshes. Zero ignores the game thread time.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.0))
+  float TargetGameThreadMilliseconds = 4.0f;
+
+  /**
+   * The target for the tileset's estimated GPU memory use, in bytes. Zero
+   * ignores the GPU memory use.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0))
+  int64 TargetEstimatedGpuBytes = 0;
+
+  /**
+   * The target for the total length of the tileset's worker thread and main
+   * thread tile load queues. Zero ignores the load queues.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0))
+  int32 TargetLoadQueueLength = 200;
+
+  /**
+   * How far below its target, as a fraction of the target, every
+   * measurement must be before the screen-space error is lowered again.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.0, ClampMax = 1.0))
+  float Hysteresis = 0.2f;
+
+  /**
+   * The time in seconds between adjustments, which gives the tileset time
+   * to load or unload tiles for the previous one.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.0))
+  float AdjustmentIntervalSeconds = 0.5f;
+};
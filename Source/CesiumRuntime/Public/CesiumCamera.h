@@ -56,6 +56,17 @@ public:
   UPROPERTY(BlueprintReadWrite, Category = "Cesium")
   double OverrideAspectRatio = 0.0;
 
+  /**
+   * @brief The factor by which the screen-space error of tiles is multiplied
+   * for this camera.
+   *
+   * Values less than one select coarser tiles, as if the viewport were
+   * smaller, so that an auxiliary view does not compete with the main view
+   * for load bandwidth. Values greater than one select finer tiles.
+   */
+  UPROPERTY(BlueprintReadWrite, Category = "Cesium")
+  double ScreenSpaceErrorMultiplier = 1.0;
+
   /**
    * @brief Construct an uninitialized FCesiumCamera object.
    */
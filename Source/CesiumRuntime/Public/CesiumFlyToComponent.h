@@ -2,10 +2,12 @@
 
 #pragma once
 
+#include "CesiumCamera.h"
 #include "CesiumGeospatial/SimplePlanarEllipsoidCurve.h"
 #include "CesiumGlobeAnchoredActorComponent.h"
 #include "CesiumFlyToComponent.generated.h"
 
+class ACesiumCameraManager;
 class UCurveFloat;
 class UCesiumGlobeAnchorComponent;
 
@@ -122,6 +124,53 @@ public:
   UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
   ECesiumFlyToRotation RotationToUse = ECesiumFlyToRotation::Actor;
 
+  /**
+   * Whether to load the tiles along the rest of the flight path before the
+   * Actor gets there. While flying, virtual cameras placed at points the
+   * Actor will reach within the next PrefetchLookAheadSeconds are added to
+   * the default CesiumCameraManager, so that tilesets select and load tiles
+   * for them too.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium|Prefetch")
+  bool PrefetchAlongPath = true;
+
+  /**
+   * The number of virtual cameras to place along the flight path ahead of the
+   * Actor. They are spread evenly over the look-ahead time.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Prefetch",
+      meta = (ClampMin = 1, ClampMax = 16, EditCondition = "PrefetchAlongPath"))
+  int32 PrefetchCameraCount = 4;
+
+  /**
+   * How far ahead of the Actor, in seconds of flight time, to load tiles.
+   * Once the destination is within this time, a camera is always placed at
+   * the destination.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Prefetch",
+      meta = (ClampMin = 0.0, EditCondition = "PrefetchAlongPath"))
+  float PrefetchLookAheadSeconds = 3.0f;
+
+  /**
+   * How quickly the detail loaded for a point on the path falls off with the
+   * time until the Actor reaches it. The resolution of the virtual camera at
+   * that point halves every this many seconds, so that the points the Actor
+   * will reach first are loaded in the most detail. Zero loads every point at
+   * full detail.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium|Prefetch",
+      meta = (ClampMin = 0.0, EditCondition = "PrefetchAlongPath"))
+  float PrefetchResolutionHalfLifeSeconds = 2.0f;
+
   /**
    * A delegate that will be called when the Actor finishes flying.
    *
@@ -204,10 +253,39 @@ protected:
       ELevelTick TickType,
       FActorComponentTickFunction* ThisTickFunction) override;
 
+  virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
   FQuat GetCurrentRotationEastSouthUp();
   void SetCurrentRotationEastSouthUp(const FQuat& EastSouthUpRotation);
 
+  /**
+   * Gets the fraction of the flight path that is traversed after the given
+   * time in flight.
+   */
+  float ComputeFlyPercentage(float FlyTime) const;
+
+  /**
+   * Gets the Earth-Centered, Earth-Fixed position on the flight path at the
+   * given fraction of it.
+   */
+  FVector ComputePositionEarthCenteredEarthFixed(float FlyPercentage) const;
+
+  /**
+   * Creates the virtual cameras at the points of the flight path that the
+   * Actor reaches within the look-ahead time.
+   */
+  TArray<FCesiumCamera> CreatePrefetchCameras();
+
+  /**
+   * Adds, moves, or removes the virtual cameras in the camera manager so that
+   * they match the rest of the flight path.
+   */
+  void UpdatePrefetchCameras();
+
+  /** Removes all of the virtual cameras from the camera manager. */
+  void RemovePrefetchCameras();
+
   bool _flightInProgress = false;
   bool _canInterruptByMoving;
   float _currentFlyTime;
@@ -218,4 +296,6 @@ private:
   FVector _previousPositionEcef;
   TUniquePtr<CesiumGeospatial::SimplePlanarEllipsoidCurve> _currentCurve;
   double _length;
+  TWeakObjectPtr<ACesiumCameraManager> _pPrefetchCameraManager;
+  TArray<int32> _prefetchCameraIds;
 };
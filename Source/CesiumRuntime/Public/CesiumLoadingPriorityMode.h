@@ -0,0 +1,34 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "CesiumLoadingPriorityMode.generated.h"
+
+/**
+ * How eagerly a tileset loads tiles, trading loading speed against the time
+ * it takes from each frame.
+ */
+UENUM(BlueprintType)
+enum class ECesiumLoadingPriorityMode : uint8 {
+  /**
+   * Loads tiles slowly, with a quarter of the tileset's
+   * MaximumSimultaneousTileLoads and main thread time, so that loading does
+   * not cause hitches during combat or cinematic moments.
+   */
+  Background,
+
+  /**
+   * Loads tiles with the tileset's MaximumSimultaneousTileLoads and the
+   * default main thread time.
+   */
+  Normal,
+
+  /**
+   * Loads tiles quickly, with twice the tileset's
+   * MaximumSimultaneousTileLoads and main thread time, to saturate the network
+   * while the game is idle. Frame time throttling is ignored in this mode.
+   */
+  Aggressive
+};
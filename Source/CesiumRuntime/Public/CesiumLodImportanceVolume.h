@@ -0,0 +1,100 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "CesiumLodImportanceVolume.generated.h"
+
+class ACesiumCartographicPolygon;
+class UBoxComponent;
+class USphereComponent;
+
+/**
+ * The shape of an ACesiumLodImportanceVolume.
+ */
+UENUM(BlueprintType)
+enum class ECesiumLodImportanceVolumeShape : uint8 {
+  /** The volume is the Box component. */
+  Box,
+
+  /** The volume is the Sphere component. */
+  Sphere,
+
+  /**
+   * The volume is the area inside the Polygon, extending infinitely up and
+   * down along the Unreal Z axis.
+   */
+  Polygon
+};
+
+/**
+ * A volume that changes the level of detail of Cesium 3D Tilesets around a
+ * gameplay point of interest, such as an objective or a landing zone.
+ *
+ * The screen-space error of every tile whose bounding volume intersects the
+ * volume is multiplied by ScreenSpaceErrorMultiplier when tiles are selected.
+ * A multiplier greater than one refines those tiles further, showing more
+ * detail, and a multiplier less than one shows less. Where volumes overlap,
+ * the highest multiplier is used.
+ *
+ * Volumes are kept in a small spatial index by each tileset, so a level may
+ * contain hundreds of them.
+ */
+UCLASS(ClassGroup = (Cesium))
+class CESIUMRUNTIME_API ACesiumLodImportanceVolume : public AActor {
+  GENERATED_BODY()
+
+public:
+  ACesiumLodImportanceVolume();
+
+  /**
+   * The shape of this volume.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  ECesiumLodImportanceVolumeShape Shape = ECesiumLodImportanceVolumeShape::Box;
+
+  /**
+   * The factor by which the screen-space error of the tiles intersecting this
+   * volume is multiplied. Values greater than one show more detail.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta = (ClampMin = 0.01, ClampMax = 100.0))
+  double ScreenSpaceErrorMultiplier = 2.0;
+
+  /**
+   * The polygon that bounds this volume when its Shape is Polygon.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta =
+          (EditCondition = "Shape == ECesiumLodImportanceVolumeShape::Polygon"))
+  ACesiumCartographicPolygon* Polygon = nullptr;
+
+  /**
+   * The box that bounds this volume when its Shape is Box.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  UBoxComponent* Box;
+
+  /**
+   * The sphere that bounds this volume when its Shape is Sphere.
+   */
+  UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cesium")
+  USphereComponent* Sphere;
+
+  virtual void OnConstruction(const FTransform& Transform) override;
+
+protected:
+  virtual void BeginPlay() override;
+
+private:
+  /** Shows the component of the current Shape in the editor. */
+  void UpdateShapeVisibility();
+};
@@ -0,0 +1,51 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/TextureDefines.h"
+
+/**
+ * The number of bytes of memory used by the renderer resources of a single
+ * tile, or of all of the tiles in a tileset.
+ */
+struct CESIUMRUNTIME_API CesiumMemoryUsage {
+  /** The bytes in static mesh vertex buffers. */
+  int64 vertexBufferBytes = 0;
+
+  /** The bytes in static mesh index buffers. */
+  int64 indexBufferBytes = 0;
+
+  /**
+   * The bytes of texture data, by texture group. This does not include the
+   * textures used to encode features and metadata for materials.
+   */
+  int64 textureBytes[TEXTUREGROUP_MAX] = {};
+
+  /** The bytes of textures that encode features and metadata for materials. */
+  int64 metadataTextureBytes = 0;
+
+  /** The approximate bytes used by physics collision meshes. */
+  int64 collisionBytes = 0;
+
+  /** The bytes of glTF buffers and images kept on the CPU. */
+  int64 gltfBytes = 0;
+
+  /** Gets the bytes of texture data in all texture groups. */
+  int64 getTextureBytes() const;
+
+  /**
+   * Gets the bytes uploaded to the GPU: vertex and index buffers, textures,
+   * and metadata textures.
+   */
+  int64 getGpuBytes() const;
+
+  CesiumMemoryUsage& operator+=(const CesiumMemoryUsage& rhs);
+  CesiumMemoryUsage& operator-=(const CesiumMemoryUsage& rhs);
+
+  /** Adds these bytes to the totals in the Cesium stat group. */
+  void incrementStats() const;
+
+  /** Removes these bytes from the totals in the Cesium stat group. */
+  void decrementStats() const;
+};
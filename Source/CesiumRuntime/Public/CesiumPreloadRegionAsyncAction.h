@@ -0,0 +1,78 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "CesiumPreloadRegionAsyncAction.generated.h"
+
+class ACesium3DTileset;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
+    FCesiumPreloadRegionProgress,
+    float,
+    Progress);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
+    FCesiumPreloadRegionComplete,
+    bool,
+    Success);
+
+UCLASS()
+class CESIUMRUNTIME_API UCesiumPreloadRegionAsyncAction
+    : public UBlueprintAsyncActionBase {
+  GENERATED_BODY()
+
+public:
+  /**
+   * Loads the tiles that a circular region of a tileset needs, such as while
+   * a loading screen is up, so that they are ready to be shown as soon as a
+   * camera looks at the region. The tiles are not shown, and while the
+   * region is loading, the tileset does not select tiles for its cameras.
+   * See ACesium3DTileset::PreloadRegion.
+   *
+   * @param Tileset The tileset to preload.
+   * @param LongitudeLatitudeHeight The longitude and latitude of the center
+   * of the region in degrees, and the height of its ground in meters above
+   * the ellipsoid.
+   * @param Radius The radius of the region, in meters.
+   * @param MaximumScreenSpaceError The screen-space error down to which the
+   * tiles are loaded.
+   * @param ViewHeight The height above the ground, in meters, from which the
+   * tiles should look right.
+   */
+  UFUNCTION(
+      BlueprintCallable,
+      Category = "Cesium|Tile Loading",
+      meta = (BlueprintInternalUseOnly = true, DisplayName = "Preload Region"))
+  static UCesiumPreloadRegionAsyncAction* PreloadRegion(
+      ACesium3DTileset* Tileset,
+      FVector LongitudeLatitudeHeight,
+      double Radius = 1000.0,
+      double MaximumScreenSpaceError = 16.0,
+      double ViewHeight = 500.0);
+
+  /**
+   * Called with the fraction of the region that has been loaded, from 0 to
+   * 1, whenever it increases.
+   */
+  UPROPERTY(BlueprintAssignable)
+  FCesiumPreloadRegionProgress OnProgress;
+
+  /**
+   * Called once the region has loaded, with false if the preload was
+   * canceled or the tileset could not be loaded.
+   */
+  UPROPERTY(BlueprintAssignable)
+  FCesiumPreloadRegionComplete OnComplete;
+
+  virtual void Activate() override;
+
+private:
+  UPROPERTY()
+  ACesium3DTileset* Tileset = nullptr;
+
+  FVector _longitudeLatitudeHeight = FVector::ZeroVector;
+  double _radius = 0.0;
+  double _maximumScreenSpaceError = 16.0;
+  double _viewHeight = 500.0;
+};
@@ -125,6 +125,14 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Cesium")
   void SetSubTileCacheBytes(int64 Value);
 
+  /**
+   * Gets the maximum number of bytes of sub-tiles this overlay may currently
+   * cache. This is its share of the global memory budget if that is enabled
+   * in the Cesium runtime settings, or SubTileCacheBytes otherwise.
+   */
+  UFUNCTION(BlueprintCallable, Category = "Cesium")
+  int64 GetEffectiveSubTileCacheBytes() const;
+
   virtual void Activate(bool bReset) override;
   virtual void Deactivate() override;
   virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
@@ -219,6 +227,15 @@ protected:
       CesiumRasterOverlays::RasterOverlay* pOverlay) {}
 
 private:
+  /**
+   * Sets this overlay's share of the global memory budget, or -1 to go back
+   * to using SubTileCacheBytes.
+   */
+  void SetSubTileCacheBudget(int64 Value);
+
   CesiumRasterOverlays::RasterOverlay* _pOverlay;
   int32 _overlaysBeingDestroyed;
+  int64 _subTileCacheBudget;
+
+  friend class CesiumMemoryBudget;
 };
@@ -0,0 +1,161 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "CesiumCamera.h"
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include <glm/vec2.hpp>
+#include <vector>
+
+class ACesium3DTileset;
+class ACesiumCartographicPolygon;
+class UWorld;
+
+/**
+ * Downloads everything that a set of tilesets, and the raster overlays on
+ * them, need in order to show a region down to a target screen-space error,
+ * so that the region can be viewed later without a network connection.
+ *
+ * Each tileset is traversed with synthetic views that look straight down on
+ * the region, a batch of views at a time, with the screen-space error and
+ * limit on simultaneous tile loads of the options rather than the tileset's
+ * own. The downloads are also bounded by the request scheduler's limit on
+ * requests per host. Each response is
+ * stored either in the request cache, with an expiry far enough away that it
+ * is used without being requested again, or in a 3D Tiles archive (`.3tz`)
+ * for each tileset.
+ *
+ * A region can be packaged from the editor with the `cesium.region.package`
+ * console command, or from the command line with the CesiumPackageRegion
+ * commandlet. This blocks the game thread until the downloads are complete.
+ */
+class CESIUMRUNTIME_API CesiumRegionPackager {
+public:
+  struct Options {
+    /** The screen-space error down to which the tiles are downloaded. */
+    double maximumScreenSpaceError = 16.0;
+
+    /**
+     * The height of the lowest ground in the region, in meters above the
+     * ellipsoid.
+     */
+    double groundHeight = 0.0;
+
+    /**
+     * The height of the views above the lowest ground, in meters. The tiles
+     * are downloaded in the detail that they need when seen from this height.
+     * The views are close enough together that they cover ground up to half
+     * this height above the lowest ground without gaps.
+     */
+    double viewHeight = 500.0;
+
+    /** The number of views whose tiles are loaded together. */
+    int32 viewsPerBatch = 16;
+
+    /** The most tiles of each tileset that are loaded at once. */
+    int32 maximumSimultaneousTileLoads = 32;
+
+    /**
+     * The longest time, in seconds, to wait for the downloads of a batch of
+     * views. The requests still in flight after it are counted as failed.
+     */
+    double batchTimeoutSeconds = 600.0;
+
+    /**
+     * The number of days for which the responses stored in the request cache
+     * are used without being requested again.
+     */
+    double cacheLifetimeDays = 365.0;
+
+    /**
+     * The directory in which to write a `<tileset name>.3tz` archive of each
+     * tileset. If this is empty, the responses are stored in the request
+     * cache instead.
+     */
+    FString archiveDirectory;
+  };
+
+  struct Result {
+    /** The number of views that the tilesets were traversed with. */
+    int64 views = 0;
+
+    /**
+     * The number of tiles that the views needed, summed over the batches of
+     * views, so that a tile needed by several batches is counted more than
+     * once.
+     */
+    int64 tilesSelected = 0;
+
+    /** The number of distinct URLs that were requested successfully. */
+    int64 requests = 0;
+
+    /**
+     * The number of requests that failed, including those still in flight
+     * when a batch timed out.
+     */
+    int64 failedRequests = 0;
+
+    /** The number of batches of views whose downloads timed out. */
+    int64 timedOutBatches = 0;
+
+    /** The number of bytes in the successful responses. */
+    int64 bytes = 0;
+
+    /** The number of responses stored in the request cache or an archive. */
+    int64 storedResponses = 0;
+
+    /**
+     * The number of successful responses that were not stored: when writing
+     * archives, those from outside a tileset's directory, such as raster
+     * overlay images, which are left to the request cache.
+     */
+    int64 unstoredResponses = 0;
+  };
+
+  /**
+   * Reads the options from parameters such as
+   * `MaximumScreenSpaceError=8 ViewHeight=300 Archive=D:/Region`, with the
+   * names of the Options fields and Archive for the archive directory.
+   */
+  static Options parseOptions(const TCHAR* parameters);
+
+  /**
+   * Creates views that look straight down on a region: a grid of them over
+   * its inside, and a line of them along each of its edges.
+   *
+   * @param tileset The tileset whose georeference and transform place the
+   * region, as for the polygons of a UCesiumPolygonRasterOverlay.
+   * @param region The longitudes and latitudes of the corners of the region,
+   * in radians.
+   * @param groundHeight The height of the lowest ground in the region, in
+   * meters above the ellipsoid.
+   * @param viewHeight The height of the views above the lowest ground.
+   */
+  static std::vector<FCesiumCamera> createRegionViews(
+      ACesium3DTileset& tileset,
+      const std::vector<glm::dvec2>& region,
+      double groundHeight,
+      double viewHeight);
+
+  /**
+   * Downloads what the given tilesets need within the given region. The
+   * tilesets are reloaded first, so that the requests for their roots are
+   * stored too.
+   */
+  static Result package(
+      const ACesiumCartographicPolygon& region,
+      const TArray<ACesium3DTileset*>& tilesets,
+      const Options& options);
+
+  /**
+   * Packages a region of the given world and logs the result. The parameters
+   * are those of `parseOptions`, plus `Polygon=<name>` to choose the
+   * ACesiumCartographicPolygon and, optionally,
+   * `Tilesets=<name>,<name>,...` to choose the tilesets rather than using all
+   * of them. Actors are found by name or label.
+   *
+   * @return Whether the region was packaged without errors.
+   */
+  static bool packageWorld(UWorld& world, const TCHAR* parameters);
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
 #include <memory>
 
 class ACesium3DTileset;
@@ -17,6 +18,8 @@ class ICacheDatabase;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCesium, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("Cesium"), STATGROUP_Cesium, STATCAT_Advanced);
+
 class FCesiumRuntimeModule : public IModuleInterface {
 public:
   /** IModuleInterface implementation */
@@ -52,3 +55,9 @@ getAssetAccessor();
 
 CESIUMRUNTIME_API std::shared_ptr<CesiumAsync::ICacheDatabase>&
 getCacheDatabase();
+
+/**
+ * Waits until every entry stored in the request cache so far has been
+ * written to it.
+ */
+CESIUMRUNTIME_API void flushCacheDatabase();
@@ -6,6 +6,25 @@
 #include "Engine/DeveloperSettings.h"
 #include "CesiumRuntimeSettings.generated.h"
 
+/**
+ * The kinds of database in which Cesium can cache the responses to its
+ * requests.
+ */
+UENUM()
+enum class ECesiumCacheDatabase : uint8 {
+  /**
+   * A single SQLite database, which suits caches of up to tens of thousands
+   * of items.
+   */
+  Sqlite UMETA(DisplayName = "SQLite"),
+
+  /**
+   * Append-only files spread across several shards, each with an index in
+   * memory. This suits larger caches, and many tilesets loading at once.
+   */
+  ShardedFiles
+};
+
 /**
  * Stores runtime settings for the Cesium plugin.
  */
@@ -57,7 +76,7 @@ public:
   int RequestsPerCachePrune = 10000;
 
   /**
-   * The maximum number of items that should be kept in the Sqlite database
+   * The maximum number of items that should be kept in the cache database
    * after pruning.
    */
   UPROPERTY(
@@ -66,4 +85,285 @@ public:
       Category = "Cache",
       meta = (ConfigRestartRequired = true))
   int MaxCacheItems = 4096;
+
+  /**
+   * The kind of database in which to cache responses. Each kind has its own
+   * files, so changing this starts with an empty cache.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Cache",
+      meta = (ConfigRestartRequired = true))
+  ECesiumCacheDatabase CacheDatabase = ECesiumCacheDatabase::Sqlite;
+
+  /**
+   * The largest total size, in bytes, of the responses that may wait to be
+   * written to the cache database. Responses are written on a thread of
+   * their own, so that no request waits for the database; while this many
+   * bytes are waiting, further responses are not cached.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Cache",
+      meta = (ClampMin = 0, ConfigRestartRequired = true))
+  int64 MaximumQueuedCacheWriteBytes = 64 * 1024 * 1024;
+
+  /**
+   * Whether to store responses in the request cache after they have been
+   * decompressed, rather than as they were downloaded. Gzipped tiles are then
+   * inflated once, when they are downloaded, instead of every time they are
+   * read from the cache, at the cost of a larger database. Responses cached
+   * before this was changed are still read correctly.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Cache",
+      meta = (ConfigRestartRequired = true))
+  bool CacheDecompressedResponses = false;
+
+  /**
+   * Whether each tileset remembers which tiles it was showing when play
+   * ended, and requests them all at once the next time it is loaded in play,
+   * rather than waiting for its traversal to reach them. The tiles are then
+   * read from the request cache, or downloaded, while the traversal is still
+   * loading their ancestors. The snapshots are kept in Saved/Cesium/WarmStart.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Cache")
+  bool EnableWarmStart = false;
+
+  /**
+   * The most tiles that each tileset remembers for the next time it is
+   * loaded.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Cache",
+      meta = (ClampMin = 0, EditCondition = "EnableWarmStart"))
+  int32 MaximumWarmStartTiles = 1024;
+
+  /**
+   * Whether to share a single memory budget between all tilesets and raster
+   * overlays in a world. When enabled, the `MaximumCachedBytes` of each
+   * tileset and the `SubTileCacheBytes` of each raster overlay are replaced
+   * with a share of the budget that depends on how much of each tileset has
+   * recently been visible.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Memory Budget")
+  bool EnableMemoryBudget = false;
+
+  /**
+   * The total number of bytes of tile data that may be cached by all
+   * tilesets and raster overlays in a world.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Memory Budget",
+      meta = (ClampMin = 0, EditCondition = "EnableMemoryBudget"))
+  int64 MemoryBudgetBytes = 1024 * 1024 * 1024;
+
+  /**
+   * The estimated number of bytes of GPU memory that may be used by all
+   * tilesets in a world. If this is exceeded, the memory budget is reduced
+   * proportionally until it is not. Set to 0 to ignore GPU memory.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Memory Budget",
+      meta = (ClampMin = 0, EditCondition = "EnableMemoryBudget"))
+  int64 GpuMemoryBudgetBytes = 1024 * 1024 * 1024;
+
+  /**
+   * The number of bytes each tileset is guaranteed, regardless of how little
+   * of it is visible.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Memory Budget",
+      meta = (ClampMin = 0, EditCondition = "EnableMemoryBudget"))
+  int64 MinimumTilesetMemoryBudgetBytes = 16 * 1024 * 1024;
+
+  /**
+   * The time, in seconds, over which a tileset's visible importance decays
+   * by half once it stops rendering tiles. Shorter times react faster to
+   * camera movement; longer times avoid evicting tiles that will soon be
+   * visible again.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Memory Budget",
+      meta = (ClampMin = 0.0, EditCondition = "EnableMemoryBudget"))
+  float MemoryBudgetImportanceHalfLife = 2.0f;
+
+  /**
+   * The maximum number of HTTP requests that Cesium has in flight to each
+   * host. Further requests wait in a queue, from which the requests for the
+   * tiles that are needed for the most recent view are sent first, and from
+   * which the requests of tilesets that have been destroyed are removed. Set
+   * to 0 for no limit. This can be overridden with the
+   * `cesium.Requests.MaximumPerHost` console variable.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Requests",
+      meta = (ClampMin = 0, DisplayName = "Maximum Requests Per Host"))
+  int32 MaximumRequestsPerHost = 16;
+
+  /**
+   * Whether to send a duplicate of an HTTP request whose response is
+   * unusually slow to start arriving, and use whichever response arrives
+   * first. This
+   * shortens the time taken to load the slowest tiles, at the cost of some
+   * duplicate downloads. A request is only duplicated if its host has a free
+   * slot. This can be overridden with the `cesium.Requests.Hedging` console
+   * variable.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Requests",
+      meta = (DisplayName = "Enable Hedged Requests"))
+  bool EnableHedgedRequests = false;
+
+  /**
+   * The percentile of the recent times to the first byte of a host's
+   * responses after which a request to it is duplicated, if its response has
+   * not started to arrive. Lower values duplicate more requests.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Requests",
+      meta =
+          (ClampMin = 50.0,
+           ClampMax = 99.9,
+           EditCondition = "EnableHedgedRequests"))
+  float HedgedRequestPercentile = 95.0f;
+
+  /**
+   * The shortest time, in milliseconds, after which a request is duplicated,
+   * however quickly its host usually responds. This can be overridden with
+   * the `cesium.Requests.HedgeMinimumDelayMs` console variable.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Requests",
+      meta = (ClampMin = 0.0, EditCondition = "EnableHedgedRequests"))
+  float MinimumHedgeDelayMilliseconds = 100.0f;
+
+  /**
+   * The number of times an HTTP request that fails to connect, or that fails
+   * with a status that suggests the server is briefly unavailable (408, 429,
+   * 500, 502, 503 or 504), is sent again before the failure is reported. This
+   * can be overridden with the `cesium.Requests.MaximumRetries` console
+   * variable.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Requests",
+      meta = (ClampMin = 0, DisplayName = "Maximum Request Retries"))
+  int32 MaximumRequestRetries = 2;
+
+  /**
+   * The longest delay, in milliseconds, before a failed request is first
+   * retried. The limit doubles with each further retry. Each delay is chosen
+   * at random up to the limit, so that the many requests that fail when a
+   * server is overloaded are not all retried at once. This can be overridden
+   * with the `cesium.Requests.RetryBaseDelayMs` console variable.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Requests",
+      meta = (ClampMin = 0.0))
+  float RetryBaseDelayMilliseconds = 250.0f;
+
+  /**
+   * The longest delay, in milliseconds, before any retry, including one
+   * whose delay the server asked for with a `Retry-After` header.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Requests",
+      meta = (ClampMin = 0.0))
+  float RetryMaximumDelayMilliseconds = 10000.0f;
+
+  /**
+   * Whether to delay and fail Cesium requests to emulate a slow or
+   * unreliable network. This applies to every request that is not served
+   * from the request cache, including `file:///` requests, so local files
+   * can stand in for a server. It can also be switched on and off with the
+   * `cesium.NetworkEmulation.Enabled` console variable.
+   */
+  UPROPERTY(Config, EditAnywhere, Category = "Network Emulation")
+  bool EnableNetworkEmulation = false;
+
+  /**
+   * The time, in milliseconds, from sending a request to receiving the first
+   * byte of its response.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Network Emulation",
+      meta = (ClampMin = 0.0, EditCondition = "EnableNetworkEmulation"))
+  float NetworkEmulationLatencyMilliseconds = 600.0f;
+
+  /**
+   * The maximum random variation of the latency, in milliseconds, in either
+   * direction.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Network Emulation",
+      meta = (ClampMin = 0.0, EditCondition = "EnableNetworkEmulation"))
+  float NetworkEmulationJitterMilliseconds = 100.0f;
+
+  /**
+   * The bandwidth of the emulated link in kilobits per second, shared by all
+   * requests. Set to 0 for unlimited bandwidth.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Network Emulation",
+      meta = (ClampMin = 0.0, EditCondition = "EnableNetworkEmulation"))
+  float NetworkEmulationBandwidthKilobitsPerSecond = 10000.0f;
+
+  /**
+   * The fraction of requests that fail with an HTTP 503 response.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Network Emulation",
+      meta =
+          (ClampMin = 0.0,
+           ClampMax = 1.0,
+           EditCondition = "EnableNetworkEmulation"))
+  float NetworkEmulationFailureRate = 0.0f;
+
+  /**
+   * The seed from which the latency variation and failures of each request
+   * are derived. The same seed and requests always produce the same delays
+   * and failures.
+   */
+  UPROPERTY(
+      Config,
+      EditAnywhere,
+      Category = "Network Emulation",
+      meta = (EditCondition = "EnableNetworkEmulation"))
+  int32 NetworkEmulationSeed = 0;
 };
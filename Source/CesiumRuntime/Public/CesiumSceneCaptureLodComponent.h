@@ -0,0 +1,45 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "CoreMinimal.h"
+#include "CesiumSceneCaptureLodComponent.generated.h"
+
+/**
+ * Controls how Cesium 3D Tilesets select tiles for the Scene Capture 2D Actor
+ * to which this component is attached.
+ *
+ * By default, tilesets select tiles for every Scene Capture 2D as if it were
+ * a main view. Auxiliary views, such as minimaps and security cameras, rarely
+ * need that much detail, and loading it for them competes with the player's
+ * view for load bandwidth.
+ */
+UCLASS(ClassGroup = "Cesium", Meta = (BlueprintSpawnableComponent))
+class CESIUMRUNTIME_API UCesiumSceneCaptureLodComponent
+    : public UActorComponent {
+  GENERATED_BODY()
+
+public:
+  UCesiumSceneCaptureLodComponent();
+
+  /**
+   * Whether tilesets select tiles for this scene capture. When this is false,
+   * the scene capture shows the tiles selected for the other views.
+   */
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cesium")
+  bool SelectTiles = true;
+
+  /**
+   * The factor by which the screen-space error of tiles is multiplied for
+   * this scene capture. Values less than one select coarser tiles, as if the
+   * render target were smaller.
+   */
+  UPROPERTY(
+      EditAnywhere,
+      BlueprintReadWrite,
+      Category = "Cesium",
+      meta =
+          (ClampMin = 0.01, ClampMax = 10.0, EditCondition = "SelectTiles"))
+  double ScreenSpaceErrorMultiplier = 0.5;
+};
@@ -0,0 +1,75 @@
+// Copyright 2020-2024 CesiumGS, Inc. and Contributors
+
+#pragma once
+
+#include "UObject/ObjectMacros.h"
+#include "CesiumTileLoadLatency.generated.h"
+
+/**
+ * A stage in the lifecycle of a tile, from the request for its content until
+ * it is first shown.
+ */
+UENUM(BlueprintType)
+enum class ECesiumTileLoadStage : uint8 {
+  /**
+   * From the start of the request for a tile's content until the content has
+   * been downloaded, decoded, and prepared in a worker thread.
+   */
+  Loading,
+
+  /**
+   * From the end of the Loading stage until the tile's renderer resources
+   * have been created in the game thread.
+   */
+  MainThread,
+
+  /**
+   * From the end of the MainThread stage until the tile is first shown.
+   */
+  Showing,
+
+  /**
+   * From the start of the request for a tile's content until the tile is
+   * first shown.
+   */
+  Total
+};
+
+/**
+ * Summary statistics of how long the tiles of a tileset took to complete a
+ * stage of their lifecycle. All durations are in seconds.
+ */
+USTRUCT(BlueprintType)
+struct CESIUMRUNTIME_API FCesiumTileLoadLatency {
+  GENERATED_USTRUCT_BODY()
+
+  /**
+   * The number of tiles that completed the stage.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  int64 Count = 0;
+
+  /**
+   * The mean duration of the stage.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  double Mean = 0.0;
+
+  /**
+   * The median duration of the stage.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  double P50 = 0.0;
+
+  /**
+   * The duration within which 95% of tiles completed the stage.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  double P95 = 0.0;
+
+  /**
+   * The duration within which 99% of tiles completed the stage.
+   */
+  UPROPERTY(BlueprintReadOnly, Category = "Cesium")
+  double P99 = 0.0;
+};
@@ -7,6 +7,9 @@
 #include "Containers/UnrealString.h"
 #include "HAL/Platform.h"
 #include <cstddef>
+#include <memory>
+
+class CesiumRequestScheduler;
 
 class CESIUMRUNTIME_API UnrealAssetAccessor
     : public CesiumAsync::IAssetAccessor {
@@ -37,4 +40,8 @@ private:
 
   FString _userAgent;
   TMap<FString, FString> _cesiumRequestHeaders;
+
+  // Limits the GET requests in flight to each host, and decides which queued
+  // request to send next.
+  std::shared_ptr<CesiumRequestScheduler> _pScheduler;
 };